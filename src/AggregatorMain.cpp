@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "FleetAggregator.h"
+
+// 多节点汇总服务：接收各训练节点无界面采集程序（--aggregator）上报的快照流，提供集群总览页面和 /fleet JSON。
+// Ctrl+C 或 SIGTERM 时退出。
+
+static std::atomic<bool> g_stopRequested{false};
+
+static void HandleStopSignal(int) {
+    g_stopRequested.store(true);
+}
+
+int main(int argc, char* argv[]) {
+    // 命令行参数：
+    //   --address <地址>     监听地址，默认 0.0.0.0
+    //   --port <端口>        节点上报端口，默认 9500
+    //   --http-port <端口>   集群总览 HTTP 端口，默认 9501
+    //   --workers <数量>     事件循环线程数，默认为 CPU 核心数（最多 8）
+    std::string address = "0.0.0.0";
+    int ingestPort = 9500;
+    int httpPort = 9501;
+    int workers = static_cast<int>(std::min(8u, std::max(1u, std::thread::hardware_concurrency())));
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--address" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            ingestPort = std::atoi(argv[++i]);
+        } else if (arg == "--http-port" && i + 1 < argc) {
+            httpPort = std::atoi(argv[++i]);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "用法: " << argv[0]
+                      << " [--address <地址>] [--port <上报端口>] [--http-port <端口>] [--workers <数量>]" << std::endl;
+            return -1;
+        }
+    }
+    if (ingestPort < 0 || ingestPort > 65535 || httpPort < 0 || httpPort > 65535) {
+        std::cerr << "无效的端口" << std::endl;
+        return -1;
+    }
+
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    FleetAggregator aggregator;
+    if (!aggregator.Start(address, static_cast<uint16_t>(ingestPort), static_cast<uint16_t>(httpPort), workers)) {
+        std::cerr << "汇总服务启动失败" << std::endl;
+        return -1;
+    }
+    std::cout << "汇总服务已启动，节点上报 " << address << ":" << aggregator.GetIngestPort()
+              << "，集群总览 http://" << address << ":" << aggregator.GetHttpPort() << "/" << std::endl;
+
+    while (!g_stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    aggregator.Stop();
+    std::cout << "汇总服务结束: " << aggregator.GetStore().GetNodeCount() << " 个节点，共 "
+              << aggregator.GetReceivedRecords() << " 条记录" << std::endl;
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "CompressedBlock.h"
+#include <cstring>
+#include <limits>
+
+static uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float BitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static unsigned int LeadingZeros(uint32_t x) {
+    unsigned int n = 0;
+    if ((x & 0xFFFF0000u) == 0) { n += 16; x <<= 16; }
+    if ((x & 0xFF000000u) == 0) { n += 8; x <<= 8; }
+    if ((x & 0xF0000000u) == 0) { n += 4; x <<= 4; }
+    if ((x & 0xC0000000u) == 0) { n += 2; x <<= 2; }
+    if ((x & 0x80000000u) == 0) { n += 1; }
+    return n;
+}
+
+static unsigned int TrailingZeros(uint32_t x) {
+    unsigned int n = 0;
+    if ((x & 0x0000FFFFu) == 0) { n += 16; x >>= 16; }
+    if ((x & 0x000000FFu) == 0) { n += 8; x >>= 8; }
+    if ((x & 0x0000000Fu) == 0) { n += 4; x >>= 4; }
+    if ((x & 0x00000003u) == 0) { n += 2; x >>= 2; }
+    if ((x & 0x00000001u) == 0) { n += 1; }
+    return n;
+}
+
+// 按位顺序读取（高位在前），与 CompressedBlock::WriteBits 对应
+class CompressedBlock::BitReader {
+public:
+    explicit BitReader(const uint64_t* words) : words_(words) {}
+
+    uint64_t Read(unsigned int bits) {
+        uint64_t result = 0;
+        while (bits > 0) {
+            size_t word = pos_ / 64;
+            unsigned int offset = static_cast<unsigned int>(pos_ % 64);
+            unsigned int available = 64 - offset;
+            unsigned int take = bits < available ? bits : available;
+            uint64_t chunk = (words_[word] << offset) >> (64 - take);
+            result = (take == 64) ? chunk : ((result << take) | chunk);
+            pos_ += take;
+            bits -= take;
+        }
+        return result;
+    }
+
+    bool ReadBit() { return Read(1) != 0; }
+
+private:
+    const uint64_t* words_;
+    size_t pos_ = 0;
+};
+
+void CompressedBlock::WriteBits(uint64_t value, unsigned int bits) {
+    while (bits > 0) {
+        size_t word = bitPos_ / 64;
+        unsigned int offset = static_cast<unsigned int>(bitPos_ % 64);
+        unsigned int available = 64 - offset;
+        unsigned int put = bits < available ? bits : available;
+        // 取 value 剩余部分的最高 put 位，写到当前字的 offset 处
+        uint64_t chunk = (put == 64) ? value : ((value >> (bits - put)) & ((uint64_t(1) << put) - 1));
+        words_[word] |= chunk << (available - put);
+        bitPos_ += put;
+        bits -= put;
+    }
+}
+
+bool CompressedBlock::Append(int64_t timestampMs, float value) {
+    uint32_t bits = FloatBits(value);
+
+    if (count_ == 0) {
+        firstTimestamp_ = timestampMs;
+        lastTimestamp_ = timestampMs;
+        lastDelta_ = 0;
+        WriteBits(bits, 32);
+        lastValue_ = bits;
+        count_ = 1;
+        return true;
+    }
+
+    if (bitPos_ + kMaxSampleBits > kWords * 64) {
+        return false;
+    }
+    int64_t delta = timestampMs - lastTimestamp_;
+    int64_t dod = delta - lastDelta_;
+    if (delta < 0 || dod < std::numeric_limits<int32_t>::min() || dod > std::numeric_limits<int32_t>::max()) {
+        return false;
+    }
+
+    // 时间戳：差值的差值
+    if (dod == 0) {
+        WriteBits(0x0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        WriteBits(0x2, 2);
+        WriteBits(static_cast<uint64_t>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        WriteBits(0x6, 3);
+        WriteBits(static_cast<uint64_t>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        WriteBits(0xE, 4);
+        WriteBits(static_cast<uint64_t>(dod + 2047), 12);
+    } else {
+        WriteBits(0xF, 4);
+        WriteBits(static_cast<uint32_t>(static_cast<int32_t>(dod)), 32);
+    }
+    lastDelta_ = delta;
+    lastTimestamp_ = timestampMs;
+
+    // 数值：与上一个值异或
+    uint32_t xorValue = bits ^ lastValue_;
+    if (xorValue == 0) {
+        WriteBits(0x0, 1);
+    } else {
+        unsigned int leading = LeadingZeros(xorValue);
+        unsigned int trailing = TrailingZeros(xorValue);
+        if (leading > 31) {
+            leading = 31;
+        }
+        if (lastLeading_ < 32 && leading >= lastLeading_ && trailing >= lastTrailing_) {
+            // 有效位落在上一次的窗口内，直接复用窗口
+            unsigned int significant = 32 - lastLeading_ - lastTrailing_;
+            WriteBits(0x2, 2);
+            WriteBits(xorValue >> lastTrailing_, significant);
+        } else {
+            unsigned int significant = 32 - leading - trailing;
+            WriteBits(0x3, 2);
+            WriteBits(leading, 5);
+            WriteBits(significant - 1, 5);
+            WriteBits(xorValue >> trailing, significant);
+            lastLeading_ = leading;
+            lastTrailing_ = trailing;
+        }
+    }
+    lastValue_ = bits;
+    count_++;
+    return true;
+}
+
+size_t CompressedBlock::Decode(ArchiveSample* out) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    BitReader reader(words_.data());
+    int64_t timestamp = firstTimestamp_;
+    int64_t delta = 0;
+    uint32_t value = static_cast<uint32_t>(reader.Read(32));
+    unsigned int leading = 32;
+    unsigned int trailing = 0;
+    out[0].timestampMs = timestamp;
+    out[0].value = BitsFloat(value);
+
+    for (size_t i = 1; i < count_; i++) {
+        int64_t dod = 0;
+        if (reader.ReadBit()) {
+            if (!reader.ReadBit()) {
+                dod = static_cast<int64_t>(reader.Read(7)) - 63;
+            } else if (!reader.ReadBit()) {
+                dod = static_cast<int64_t>(reader.Read(9)) - 255;
+            } else if (!reader.ReadBit()) {
+                dod = static_cast<int64_t>(reader.Read(12)) - 2047;
+            } else {
+                dod = static_cast<int32_t>(static_cast<uint32_t>(reader.Read(32)));
+            }
+        }
+        delta += dod;
+        timestamp += delta;
+
+        if (reader.ReadBit()) {
+            if (reader.ReadBit()) {
+                leading = static_cast<unsigned int>(reader.Read(5));
+                unsigned int significant = static_cast<unsigned int>(reader.Read(5)) + 1;
+                trailing = 32 - leading - significant;
+            }
+            unsigned int significant = 32 - leading - trailing;
+            value ^= static_cast<uint32_t>(reader.Read(significant)) << trailing;
+        }
+
+        out[i].timestampMs = timestamp;
+        out[i].value = BitsFloat(value);
+    }
+    return count_;
+}
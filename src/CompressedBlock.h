@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// 压缩历史中的一个样本：时间戳（毫秒）+ 数值
+struct ArchiveSample {
+    int64_t timestampMs = 0;
+    float value = 0.0f;
+};
+
+// 定长压缩块（Gorilla 编码）
+// - 时间戳：块头保存第一个时间戳，之后按 "差值的差值" 变长编码；采样周期稳定时每个样本只占 1 bit
+// - 数值：与上一个值按位异或，相同的值只占 1 bit，否则只保存有效位（前导零/后缀零之外的部分）
+// 每个块固定 4KB，写满后封存，之后只读；解码以整块为单位，顺序扫描，不需要随机访问
+class CompressedBlock {
+public:
+    static constexpr size_t kWords = 512;
+    static constexpr size_t kBytes = kWords * sizeof(uint64_t);
+
+    // 追加一个样本，块已满（或时间戳跨度超出编码范围）时返回 false，需要换一个新块
+    bool Append(int64_t timestampMs, float value);
+
+    size_t Count() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+    int64_t FirstTimestamp() const { return firstTimestamp_; }
+    int64_t LastTimestamp() const { return lastTimestamp_; }
+    size_t BitsUsed() const { return bitPos_; }
+
+    // 解码整个块到 out（至少能容纳 Count() 个样本），返回样本数
+    size_t Decode(ArchiveSample* out) const;
+
+private:
+    // 单个样本编码后的最大位数：时间戳 4+32，数值 2+5+5+32
+    static constexpr size_t kMaxSampleBits = 36 + 44;
+
+    class BitReader;
+    void WriteBits(uint64_t value, unsigned int bits);
+
+    std::array<uint64_t, kWords> words_{};
+    size_t bitPos_ = 0;
+    size_t count_ = 0;
+
+    int64_t firstTimestamp_ = 0;
+    int64_t lastTimestamp_ = 0;
+    int64_t lastDelta_ = 0;
+    uint32_t lastValue_ = 0;
+    unsigned int lastLeading_ = 32;    // 32 表示还没有可复用的有效位窗口
+    unsigned int lastTrailing_ = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SeriesStore.h"
+
+// 派生指标：由同一设备的其他字段按固定公式算出的值（如 PCIe 收发合计、显存 GB、等待占比）
+// - 每个派生指标声明依赖的输入字段，输入可以是原始字段，也可以是其他派生指标的输出；
+//   计算顺序按依赖关系排好（与表中的先后无关），有循环依赖的项不会被计算
+// - 采样线程每落地一个新样本计算一次，结果写回设备信息结构体，界面、导出器和诊断直接读取，
+//   不再各自重复计算；同时作为普通指标登记到 SeriesStore（名称为设备前缀 + name）
+template <typename Info>
+class DerivedMetrics {
+public:
+    using Field = float Info::*;
+    static constexpr size_t kMaxInputs = 3;
+
+    struct Definition {
+        const char* name;                       // 指标名称（设备前缀之后的部分）
+        const char* unit;
+        std::array<Field, kMaxInputs> inputs;   // 依赖的字段，未用的位置为 nullptr
+        bool quantiles;                         // 是否维护分位数草图（见 SeriesStore::Register）
+        float (*compute)(const Info& info);
+        Field output;
+        MetricId Info::* series;
+    };
+
+    template <size_t N>
+    explicit DerivedMetrics(const Definition (&definitions)[N]) : definitions_(definitions, definitions + N) {
+        SortByDependencies();
+    }
+
+    // 新样本落地后调用：按依赖顺序计算所有派生指标
+    void Update(std::vector<Info>& devices) const {
+        for (Info& device : devices) {
+            for (size_t index : order_) {
+                const Definition& definition = definitions_[index];
+                device.*definition.output = definition.compute(device);
+            }
+        }
+    }
+
+    // 登记派生指标（编号写回 series 字段）
+    void Register(SeriesStore& series, Info& device, const std::string& prefix) const {
+        for (size_t index : order_) {
+            const Definition& definition = definitions_[index];
+            device.*definition.series = series.Register(prefix + definition.name, definition.unit, definition.quantiles);
+        }
+    }
+
+    // 把派生指标的当前值写入 series 的当前行
+    void Store(SeriesStore& series, const Info& device) const {
+        for (size_t index : order_) {
+            const Definition& definition = definitions_[index];
+            series.Set(device.*definition.series, device.*definition.output);
+        }
+    }
+
+private:
+    // 拓扑排序：输入都已就绪（不是其他派生指标的输出，或该派生指标已排在前面）的项依次加入
+    void SortByDependencies() {
+        std::vector<bool> placed(definitions_.size(), false);
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (size_t i = 0; i < definitions_.size(); i++) {
+                if (!placed[i] && InputsReady(definitions_[i], placed)) {
+                    placed[i] = true;
+                    order_.push_back(i);
+                    progress = true;
+                }
+            }
+        }
+        for (size_t i = 0; i < definitions_.size(); i++) {
+            if (!placed[i]) {
+                std::cerr << "警告: 派生指标 " << definitions_[i].name << " 存在循环依赖，已忽略" << std::endl;
+            }
+        }
+    }
+
+    bool InputsReady(const Definition& definition, const std::vector<bool>& placed) const {
+        for (Field input : definition.inputs) {
+            if (input == nullptr) {
+                continue;
+            }
+            for (size_t j = 0; j < definitions_.size(); j++) {
+                if (definitions_[j].output == input && !placed[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<Definition> definitions_;
+    std::vector<size_t> order_;   // 计算顺序（definitions_ 的下标）
+};
@@ -0,0 +1,74 @@
+#include "Downsample.h"
+#include <cmath>
+#include <limits>
+
+void DownsampleLttb(const float* values, size_t count, size_t threshold, std::vector<float>& out) {
+    out.clear();
+    if (count <= threshold || threshold < 3) {
+        out.assign(values, values + count);
+        return;
+    }
+
+    out.reserve(threshold);
+    out.push_back(values[0]);
+
+    // 中间 count - 2 个点分成 threshold - 2 个桶
+    double bucketSize = static_cast<double>(count - 2) / static_cast<double>(threshold - 2);
+    size_t selected = 0;
+    for (size_t bucket = 0; bucket < threshold - 2; bucket++) {
+        size_t start = static_cast<size_t>(bucket * bucketSize) + 1;
+        size_t end = static_cast<size_t>((bucket + 1) * bucketSize) + 1;
+
+        // 下一个桶的均值（最后一个桶的下一个“桶”是末尾的点）
+        size_t nextStart = end;
+        size_t nextEnd = bucket + 3 < threshold ? static_cast<size_t>((bucket + 2) * bucketSize) + 1 : count;
+        if (nextEnd > count) {
+            nextEnd = count;
+        }
+        double nextX = 0.0;
+        double nextY = 0.0;
+        size_t nextCount = 0;
+        for (size_t i = nextStart; i < nextEnd; i++) {
+            if (!std::isnan(values[i])) {
+                nextX += static_cast<double>(i);
+                nextY += values[i];
+                nextCount++;
+            }
+        }
+
+        double selectedX = static_cast<double>(selected);
+        double selectedY = values[selected];
+        if (nextCount > 0) {
+            nextX /= static_cast<double>(nextCount);
+            nextY /= static_cast<double>(nextCount);
+        } else {
+            // 下一个桶全是空档：按水平方向选点
+            nextX = static_cast<double>(nextEnd);
+            nextY = selectedY;
+        }
+        double bestArea = -1.0;
+        size_t best = start;
+        bool gap = false;
+        for (size_t i = start; i < end; i++) {
+            if (std::isnan(values[i])) {
+                gap = true;
+                continue;
+            }
+            // 三角形面积的两倍（只比较大小）
+            double area = std::fabs((selectedX - nextX) * (values[i] - selectedY) -
+                                    (selectedX - static_cast<double>(i)) * (nextY - selectedY));
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+        if (gap) {
+            out.push_back(std::numeric_limits<float>::quiet_NaN());
+            continue;
+        }
+        out.push_back(values[best]);
+        selected = best;
+    }
+
+    out.push_back(values[count - 1]);
+}
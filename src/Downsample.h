@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Largest-Triangle-Three-Buckets 降采样（用于把长历史压缩到图表的像素宽度）
+// 首尾两点保留，中间的点均分为 threshold - 2 个桶，每个桶选出与前一个选中点、后一个桶均值构成三角形面积最大的点。
+// 与等间隔抽样或桶均值不同，尖峰和谷值会被保留下来。横坐标为下标（与 ImGui::PlotLines 一致，样本等间隔）。
+// NaN 表示没有样本的空档：含有 NaN 的桶输出 NaN，曲线在降采样后仍在该处断开。
+// count <= threshold 或 threshold < 3 时原样复制。out 会被覆盖（复用已有容量）。
+void DownsampleLttb(const float* values, size_t count, size_t threshold, std::vector<float>& out);
@@ -0,0 +1,135 @@
+#include "EventPoller.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+EventPoller::~EventPoller() {
+    Close();
+}
+
+#ifdef __linux__
+
+bool EventPoller::Open() {
+    Close();
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    return epoll_ >= 0;
+}
+
+void EventPoller::Close() {
+    if (epoll_ >= 0) {
+        ::close(epoll_);
+        epoll_ = -1;
+    }
+}
+
+bool EventPoller::Add(SocketHandle socket, bool shared) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (shared) {
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    }
+    event.data.fd = socket;
+    return epoll_ctl(epoll_, EPOLL_CTL_ADD, socket, &event) == 0;
+}
+
+bool EventPoller::SetWritable(SocketHandle socket, bool writable) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (writable) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = socket;
+    return epoll_ctl(epoll_, EPOLL_CTL_MOD, socket, &event) == 0;
+}
+
+void EventPoller::Remove(SocketHandle socket) {
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, socket, nullptr);
+}
+
+int EventPoller::Wait(int timeoutMs) {
+    int count = epoll_wait(epoll_, ready_, kMaxEvents, timeoutMs);
+    for (int i = 0; i < count; i++) {
+        Event& event = events_[i];
+        event.socket = ready_[i].data.fd;
+        event.readable = (ready_[i].events & (EPOLLIN | EPOLLRDHUP)) != 0;
+        event.writable = (ready_[i].events & EPOLLOUT) != 0;
+        event.closed = (ready_[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+    }
+    return count < 0 ? 0 : count;
+}
+
+bool EventPoller::SupportsSharedListeners() {
+    return true;
+}
+
+#else
+
+bool EventPoller::Open() {
+    watches_.clear();
+    open_ = true;
+    return true;
+}
+
+void EventPoller::Close() {
+    watches_.clear();
+    open_ = false;
+}
+
+bool EventPoller::Add(SocketHandle socket, bool) {
+    if (!open_) {
+        return false;
+    }
+    PollFd watch{};
+    watch.fd = socket;
+    watch.events = POLLIN;
+    watches_.push_back(watch);
+    return true;
+}
+
+bool EventPoller::SetWritable(SocketHandle socket, bool writable) {
+    for (PollFd& watch : watches_) {
+        if (watch.fd == socket) {
+            watch.events = static_cast<short>(POLLIN | (writable ? POLLOUT : 0));
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventPoller::Remove(SocketHandle socket) {
+    watches_.erase(std::remove_if(watches_.begin(), watches_.end(),
+                                  [socket](const PollFd& watch) { return watch.fd == socket; }),
+                   watches_.end());
+}
+
+int EventPoller::Wait(int timeoutMs) {
+    if (watches_.empty()) {
+        return 0;
+    }
+#ifdef _WIN32
+    int ready = WSAPoll(watches_.data(), static_cast<ULONG>(watches_.size()), timeoutMs);
+#else
+    int ready = poll(watches_.data(), static_cast<nfds_t>(watches_.size()), timeoutMs);
+#endif
+    int count = 0;
+    for (size_t i = 0; ready > 0 && i < watches_.size() && count < kMaxEvents; i++) {
+        short revents = watches_[i].revents;
+        if (revents == 0) {
+            continue;
+        }
+        Event& event = events_[count++];
+        event.socket = static_cast<SocketHandle>(watches_[i].fd);
+        event.readable = (revents & POLLIN) != 0;
+        event.writable = (revents & POLLOUT) != 0;
+        event.closed = (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+    }
+    return count;
+}
+
+bool EventPoller::SupportsSharedListeners() {
+    return false;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "NetSocket.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#elif defined(_WIN32)
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+// 套接字就绪事件循环：Linux 上使用 epoll（就绪列表由内核维护，等待的开销与连接数无关），
+// 其他平台退化为 poll/WSAPoll。每个实例只由一个线程使用。
+class EventPoller {
+public:
+    struct Event {
+        SocketHandle socket = kInvalidSocket;
+        bool readable = false;
+        bool writable = false;
+        bool closed = false;        // 出错或对端挂断
+    };
+
+    EventPoller() = default;
+    ~EventPoller();
+    EventPoller(const EventPoller&) = delete;
+    EventPoller& operator=(const EventPoller&) = delete;
+
+    bool Open();
+    void Close();
+
+    // 关注 socket 的可读事件；shared 表示同一个监听套接字加入了多个实例，
+    // 新连接只唤醒其中一个（EPOLLEXCLUSIVE），避免惊群
+    bool Add(SocketHandle socket, bool shared = false);
+    // 是否同时关注可写事件（有待发送的数据时打开）
+    bool SetWritable(SocketHandle socket, bool writable);
+    void Remove(SocketHandle socket);
+
+    // 等待事件，最多 timeoutMs 毫秒；返回就绪事件数，结果在 GetEvent(0..n-1) 中
+    int Wait(int timeoutMs);
+    const Event& GetEvent(int index) const { return events_[index]; }
+
+    // 是否支持多个实例共享监听套接字（否则应只用一个事件循环线程）
+    static bool SupportsSharedListeners();
+
+private:
+    static constexpr int kMaxEvents = 256;
+
+    std::vector<Event> events_ = std::vector<Event>(kMaxEvents);
+#ifdef __linux__
+    int epoll_ = -1;
+    epoll_event ready_[kMaxEvents];
+#else
+#ifdef _WIN32
+    using PollFd = WSAPOLLFD;
+#else
+    using PollFd = pollfd;
+#endif
+    std::vector<PollFd> watches_;
+    bool open_ = false;
+#endif
+};
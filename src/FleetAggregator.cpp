@@ -0,0 +1,499 @@
+#include "FleetAggregator.h"
+#include "FleetProtocol.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+// 集群总览页面：每秒拉取一次 /fleet，每块 GPU 一个色块（颜色为利用率）
+static const char kDashboardPage[] = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>DeepInsight Fleet</title>
+<style>
+body{font-family:sans-serif;background:#16181d;color:#ddd;margin:16px}
+.node{display:inline-block;vertical-align:top;margin:4px;padding:6px;border:1px solid #333;border-radius:4px}
+.node.offline{opacity:.4}
+.name{font-size:12px;margin-bottom:4px}
+.gpu{display:inline-block;width:44px;height:44px;margin:1px;font-size:11px;text-align:center;line-height:14px;color:#000}
+</style></head><body>
+<div id="summary"></div><div id="fleet"></div>
+<script>
+function esc(s){return s.replace(/[&<>"]/g,c=>({'&':'&amp;','<':'&lt;','>':'&gt;','"':'&quot;'}[c]));}
+function color(u){return u==null?'#666':'hsl('+(120-1.2*Math.min(100,u))+',70%,55%)';}
+function num(v,d){return v==null?'-':v.toFixed(d);}
+async function refresh(){
+  try{
+    const fleet=await (await fetch('/fleet')).json();
+    document.getElementById('summary').textContent=fleet.nodes.length+' 节点 / '+fleet.gpu_count+' GPU，平均利用率 '+num(fleet.mean_utilization,1)+'%，p95 '+num(fleet.utilization_p95,1)+'%';
+    let html='';
+    for(const n of fleet.nodes){
+      html+='<div class="node'+(n.connected?'':' offline')+'"><div class="name">'+esc(n.name)+'</div>';
+      n.gpus.forEach((g,i)=>{html+='<div class="gpu" style="background:'+color(g.utilization)+'" title="'+esc(g.name)+'">'+i+'<br>'+num(g.utilization,0)+'%<br>'+num(g.temperature,0)+'°</div>';});
+      html+='</div>';
+    }
+    document.getElementById('fleet').innerHTML=html;
+  }catch(e){}
+}
+refresh();setInterval(refresh,1000);
+</script></body></html>
+)HTML";
+
+static void AppendJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+// JSON 没有 NaN/Infinity，节点发来的非有限值（完整记录编码保存原始浮点数）写为 null，否则整个文档都无法解析
+static void AppendJsonNumber(std::string& out, const char* key, double value) {
+    char text[64];
+    if (std::isfinite(value)) {
+        std::snprintf(text, sizeof(text), "\"%s\":%.2f", key, value);
+    } else {
+        std::snprintf(text, sizeof(text), "\"%s\":null", key);
+    }
+    out += text;
+}
+
+// 指标最近 window 时长的平均值，没有数据时返回当前值
+static float WindowMean(const SeriesStore& series, MetricId id, std::chrono::steady_clock::duration window,
+                        float current) {
+    HistoryBucket summary;
+    return series.Summarize(id, window, summary) ? summary.mean : current;
+}
+
+FleetAggregator::~FleetAggregator() {
+    Stop();
+}
+
+bool FleetAggregator::Start(const std::string& address, uint16_t ingestPort, uint16_t httpPort, int workerCount) {
+    if (IsRunning()) {
+        return true;
+    }
+    if (!InitializeSockets()) {
+        std::cerr << "警告: Winsock 初始化失败，汇总服务不可用" << std::endl;
+        return false;
+    }
+    socketsInitialized_ = true;
+
+    ingestListener_ = ListenTcp(address, ingestPort, 1024, &ingestPort_);
+    httpListener_ = ListenTcp(address, httpPort, 64, &httpPort_);
+    if (ingestListener_ == kInvalidSocket || httpListener_ == kInvalidSocket) {
+        std::cerr << "警告: 汇总服务无法监听 " << address << ":" << ingestPort << " / " << httpPort << std::endl;
+        Stop();
+        return false;
+    }
+
+    // 不支持共享监听套接字的平台只用一个事件循环
+    if (workerCount < 1 || !EventPoller::SupportsSharedListeners()) {
+        workerCount = 1;
+    }
+    for (int i = 0; i < workerCount; i++) {
+        std::unique_ptr<Worker> worker(new Worker());
+        if (!worker->poller.Open() || !worker->poller.Add(ingestListener_, true) ||
+            !worker->poller.Add(httpListener_, true)) {
+            std::cerr << "警告: 汇总服务事件循环创建失败" << std::endl;
+            Stop();
+            return false;
+        }
+        workers_.push_back(std::move(worker));
+    }
+
+    running_.store(true, std::memory_order_release);
+    for (std::unique_ptr<Worker>& worker : workers_) {
+        worker->thread = std::thread(&FleetAggregator::WorkerLoop, this, std::ref(*worker));
+    }
+    return true;
+}
+
+void FleetAggregator::Stop() {
+    running_.store(false, std::memory_order_release);
+    for (std::unique_ptr<Worker>& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        while (!worker->connections.empty()) {
+            CloseConnection(*worker, worker->connections.begin()->first);
+        }
+        worker->poller.Close();
+    }
+    workers_.clear();
+
+    CloseSocket(ingestListener_);
+    CloseSocket(httpListener_);
+    ingestListener_ = kInvalidSocket;
+    httpListener_ = kInvalidSocket;
+    if (socketsInitialized_) {
+        ShutdownSockets();
+        socketsInitialized_ = false;
+    }
+}
+
+void FleetAggregator::WorkerLoop(Worker& worker) {
+    // 短超时：定期检查 Stop 和空闲连接
+    constexpr int kWaitMs = 200;
+
+    while (running_.load(std::memory_order_acquire)) {
+        int count = worker.poller.Wait(kWaitMs);
+        for (int i = 0; i < count; i++) {
+            const EventPoller::Event& event = worker.poller.GetEvent(i);
+            if (event.socket == ingestListener_ || event.socket == httpListener_) {
+                AcceptConnections(worker, event.socket, event.socket == httpListener_);
+                continue;
+            }
+
+            auto it = worker.connections.find(event.socket);
+            if (it == worker.connections.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+            bool keep = true;
+            if (connection.http) {
+                if (connection.writing) {
+                    keep = event.writable ? WriteResponse(worker, connection) : !event.closed;
+                } else if (event.readable || event.closed) {
+                    keep = ReadRequest(worker, connection);
+                }
+            } else if (event.readable || event.closed) {
+                // 对端关闭前发送的数据仍然要读完
+                keep = ReadIngest(connection);
+            }
+            if (!keep) {
+                CloseConnection(worker, event.socket);
+            }
+        }
+        CloseIdleConnections(worker);
+    }
+}
+
+void FleetAggregator::AcceptConnections(Worker& worker, SocketHandle listener, bool http) {
+    for (;;) {
+        std::string address;
+        SocketHandle client = AcceptTcp(listener, &address);
+        if (client == kInvalidSocket) {
+            return;
+        }
+        std::unique_ptr<Connection> connection(new Connection());
+        connection->socket = client;
+        connection->http = http;
+        connection->address = address;
+        connection->lastActivity = std::chrono::steady_clock::now();
+        connection->input.resize(http ? kRequestBytes : kInputBytes);
+        if (!http) {
+            SetKeepAlive(client, kKeepAliveIdleSeconds, kKeepAliveIntervalSeconds, kKeepAliveProbes);
+        }
+        if (!worker.poller.Add(client)) {
+            CloseSocket(client);
+            continue;
+        }
+        worker.connections[client] = std::move(connection);
+    }
+}
+
+bool FleetAggregator::ReadIngest(Connection& connection) {
+    // 把套接字中已有的数据全部读完；缓冲区满时先处理其中完整的记录
+    for (;;) {
+        if (connection.inputBytes == connection.input.size()) {
+            if (!ConsumeIngest(connection) || connection.inputBytes == connection.input.size()) {
+                return false;
+            }
+        }
+        ptrdiff_t received = ReceiveSome(connection.socket, connection.input.data() + connection.inputBytes,
+                                         connection.input.size() - connection.inputBytes);
+        if (received > 0) {
+            connection.inputBytes += static_cast<size_t>(received);
+            connection.lastActivity = std::chrono::steady_clock::now();
+            receivedBytes_.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+            continue;
+        }
+        bool open = received < 0 && SocketWouldBlock();
+        // 连接关闭前收到的完整记录照常写入
+        return ConsumeIngest(connection) && open;
+    }
+}
+
+bool FleetAggregator::ConsumeIngest(Connection& connection) {
+    const uint8_t* data = connection.input.data();
+    size_t offset = 0;
+
+    if (connection.node.empty()) {
+        if (connection.inputBytes < sizeof(FleetHello)) {
+            return true;
+        }
+        FleetHello hello;
+        std::memcpy(&hello, data, sizeof(hello));
+        if (std::memcmp(hello.magic, kFleetMagic, sizeof(hello.magic)) != 0 || hello.version != kFleetVersion ||
+            hello.nameLength == 0 || hello.nameLength > kFleetMaxNameLength) {
+            std::cerr << "警告: 来自 " << connection.address << " 的连接不是兼容的节点上报协议，已断开" << std::endl;
+            return false;
+        }
+        if (connection.inputBytes < sizeof(FleetHello) + hello.nameLength) {
+            return true;
+        }
+
+        // 样本字段布局一致时使用差分编码，否则退回完整记录（记录自带设备数量，布局变化时会解码失败而不是读错）
+        FleetAccept accept{};
+        accept.version = kFleetVersion;
+        if ((hello.encodings & kFleetEncodingDelta) != 0 && hello.schemaId == SampleSchemaId()) {
+            accept.encoding = kFleetEncodingDelta;
+        } else if ((hello.encodings & kFleetEncodingRecords) != 0) {
+            accept.encoding = kFleetEncodingRecords;
+        }
+        // 新连接的发送缓冲区是空的，8 个字节可以一次发完
+        if (SendSome(connection.socket, &accept, sizeof(accept)) != static_cast<ptrdiff_t>(sizeof(accept)) ||
+            accept.encoding == 0) {
+            return false;
+        }
+        connection.encoding = accept.encoding;
+        connection.node.assign(reinterpret_cast<const char*>(data + sizeof(FleetHello)), hello.nameLength);
+        connection.storeConnection = store_.Connect(connection.node, connection.address, connection.encoding);
+        offset = sizeof(FleetHello) + hello.nameLength;
+    }
+
+    // 找出缓冲区中所有完整的记录，一次写入
+    size_t end = offset;
+    size_t records = 0;
+    for (;;) {
+        size_t size = 0;
+        bool error = false;
+        if (connection.encoding == kFleetEncodingDelta) {
+            size = DeltaFrameSize(data + end, connection.inputBytes - end, kFleetMaxRecordBytes, error);
+        } else if (connection.inputBytes - end >= sizeof(SessionRecordHeader)) {
+            SessionRecordHeader header;
+            std::memcpy(&header, data + end, sizeof(header));
+            error = header.size < sizeof(header) || header.size > kFleetMaxRecordBytes;
+            size = !error && connection.inputBytes - end >= header.size ? header.size : 0;
+        }
+        if (error) {
+            std::cerr << "警告: 节点 " << connection.node << " 发送了无效的记录，已断开" << std::endl;
+            return false;
+        }
+        if (size == 0) {
+            break;
+        }
+        end += size;
+        records++;
+    }
+    if (records > 0) {
+        if (!store_.Apply(connection.node, connection.storeConnection, data + offset, end - offset)) {
+            std::cerr << "警告: 节点 " << connection.node << " 来自 " << connection.address
+                      << " 的连接已由同名的新连接取代，已断开" << std::endl;
+            return false;
+        }
+        receivedRecords_.fetch_add(records, std::memory_order_relaxed);
+    }
+
+    // 未完整的记录移到缓冲区开头
+    if (end > 0) {
+        std::memmove(connection.input.data(), data + end, connection.inputBytes - end);
+        connection.inputBytes -= end;
+    }
+    return true;
+}
+
+bool FleetAggregator::ReadRequest(Worker& worker, Connection& connection) {
+    size_t space = connection.input.size() - 1 - connection.inputBytes;
+    if (space == 0) {
+        Respond(connection, "431 Request Header Fields Too Large", "text/plain; charset=utf-8", "");
+        return WriteResponse(worker, connection);
+    }
+    char* request = reinterpret_cast<char*>(connection.input.data());
+    ptrdiff_t received = ReceiveSome(connection.socket, request + connection.inputBytes, space);
+    if (received < 0 && SocketWouldBlock()) {
+        return true;
+    }
+    if (received <= 0) {
+        return false;
+    }
+    connection.inputBytes += static_cast<size_t>(received);
+    request[connection.inputBytes] = '\0';
+    connection.lastActivity = std::chrono::steady_clock::now();
+
+    // 请求头完整后处理（忽略请求体）
+    if (std::strstr(request, "\r\n\r\n") == nullptr) {
+        return true;
+    }
+    if (std::strncmp(request, "GET ", 4) != 0) {
+        Respond(connection, "405 Method Not Allowed", "text/plain; charset=utf-8", "");
+        return WriteResponse(worker, connection);
+    }
+    const char* path = request + 4;
+    size_t pathLength = std::strcspn(path, " ?\r\n");
+    if (pathLength == 1 && path[0] == '/') {
+        Respond(connection, "200 OK", "text/html; charset=utf-8", kDashboardPage);
+    } else if (pathLength == 6 && std::strncmp(path, "/fleet", 6) == 0) {
+        std::string body;
+        RenderFleet(body);
+        Respond(connection, "200 OK", "application/json; charset=utf-8", body);
+    } else {
+        Respond(connection, "404 Not Found", "text/plain; charset=utf-8", "Not Found\n");
+    }
+    return WriteResponse(worker, connection);
+}
+
+void FleetAggregator::Respond(Connection& connection, const char* status, const char* contentType,
+                              const std::string& body) {
+    char header[256];
+    int length = std::snprintf(header, sizeof(header),
+                               "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                               "Cache-Control: no-cache\r\nConnection: close\r\n\r\n",
+                               status, contentType, body.size());
+    connection.output.assign(header, length > 0 ? static_cast<size_t>(length) : 0);
+    connection.output += body;
+    connection.sent = 0;
+    connection.writing = true;
+}
+
+bool FleetAggregator::WriteResponse(Worker& worker, Connection& connection) {
+    while (connection.sent < connection.output.size()) {
+        ptrdiff_t sent = SendSome(connection.socket, connection.output.data() + connection.sent,
+                                  connection.output.size() - connection.sent);
+        if (sent < 0 && SocketWouldBlock()) {
+            // 发送缓冲区已满，等可写时继续
+            worker.poller.SetWritable(connection.socket, true);
+            return true;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        connection.sent += static_cast<size_t>(sent);
+        connection.lastActivity = std::chrono::steady_clock::now();
+    }
+    return false;   // 发送完毕，关闭连接
+}
+
+void FleetAggregator::CloseConnection(Worker& worker, SocketHandle socket) {
+    auto it = worker.connections.find(socket);
+    if (it == worker.connections.end()) {
+        return;
+    }
+    if (!it->second->http && !it->second->node.empty()) {
+        store_.Disconnect(it->second->node, it->second->storeConnection);
+    }
+    worker.poller.Remove(socket);
+    CloseSocket(socket);
+    worker.connections.erase(it);
+}
+
+void FleetAggregator::CloseIdleConnections(Worker& worker) {
+    // 卡住的 HTTP 连接、迟迟不握手的连接和长时间没有数据的上报连接都关闭；
+    // 节点断开后 FleetStore 把它标为离线，节点恢复后由 FleetUplink 负责重连
+    auto now = std::chrono::steady_clock::now();
+    std::vector<SocketHandle> idle;
+    for (const auto& entry : worker.connections) {
+        const Connection& connection = *entry.second;
+        int timeoutMs = connection.http ? kHttpTimeoutMs
+                      : connection.node.empty() ? kHelloTimeoutMs
+                      : kIngestTimeoutMs;
+        if (now - connection.lastActivity <= std::chrono::milliseconds(timeoutMs)) {
+            continue;
+        }
+        if (!connection.http) {
+            std::cerr << "警告: " << (connection.node.empty() ? "来自 " + connection.address + " 的连接"
+                                                                : "节点 " + connection.node + " ")
+                      << "超过 " << timeoutMs / 1000 << " 秒没有数据，已断开" << std::endl;
+        }
+        idle.push_back(entry.first);
+    }
+    for (SocketHandle socket : idle) {
+        CloseConnection(worker, socket);
+    }
+}
+
+void FleetAggregator::RenderFleet(std::string& out) const {
+    // 每个节点在自己的分片锁内渲染为一段 JSON，之后按名称排序拼接
+    std::vector<std::pair<std::string, std::string>> nodes;
+    size_t gpuCount = 0;
+    double utilizationSum = 0.0;
+    auto now = std::chrono::steady_clock::now();
+    auto window = std::chrono::seconds(kHistoryWindowSeconds);
+    // 各节点窗口内的分位数草图合并后得到整个集群的利用率分布
+    QuantileSketch fleetUtilization;
+    QuantileSketch gpuUtilization;
+
+    store_.ForEachNode([&](const FleetNode& node) {
+        std::string json = "{\"name\":";
+        AppendJsonString(json, node.name);
+        json += ",\"address\":";
+        AppendJsonString(json, node.address);
+        json += node.connection != 0 ? ",\"connected\":true," : ",\"connected\":false,";
+        AppendJsonNumber(json, "age_seconds",
+                         std::chrono::duration<double>(now - node.lastSeen).count());
+        json += ",\"samples\":" + std::to_string(node.samples) +
+                ",\"received_bytes\":" + std::to_string(node.receivedBytes) + ",";
+        AppendJsonNumber(json, "cpu_utilization", node.cpu.utilization);
+        json += ',';
+        AppendJsonNumber(json, "memory_percent", node.memory.percent);
+        json += ",\"gpus\":[";
+        for (size_t i = 0; i < node.gpus.size(); i++) {
+            const GPUInfo& gpu = node.gpus[i];
+            json += i > 0 ? ",{\"name\":" : "{\"name\":";
+            AppendJsonString(json, gpu.name);
+            json += ',';
+            AppendJsonNumber(json, "utilization", gpu.utilization);
+            json += ',';
+            AppendJsonNumber(json, "utilization_mean",
+                             WindowMean(node.series, gpu.utilizationSeries, window, gpu.utilization));
+            json += ',';
+            bool hasQuantiles = node.series.SelectQuantiles(gpu.utilizationSeries, window, gpuUtilization);
+            if (hasQuantiles && node.connection != 0) {
+                fleetUtilization.Merge(gpuUtilization);
+            }
+            AppendJsonNumber(json, "utilization_p95",
+                             hasQuantiles ? gpuUtilization.Quantile(0.95) : gpu.utilization);
+            json += ',';
+            AppendJsonNumber(json, "memory_percent", gpu.memoryPercent);
+            json += ',';
+            AppendJsonNumber(json, "temperature", gpu.temperature);
+            json += ',';
+            AppendJsonNumber(json, "power", gpu.powerUsage);
+            json += ',';
+            AppendJsonNumber(json, "power_percent", gpu.powerPercent);
+            json += '}';
+            if (node.connection != 0) {
+                gpuCount++;
+                utilizationSum += gpu.utilization;
+            }
+        }
+        json += "]}";
+        nodes.emplace_back(node.name, std::move(json));
+    });
+    std::sort(nodes.begin(), nodes.end(),
+              [](const std::pair<std::string, std::string>& a, const std::pair<std::string, std::string>& b) {
+                  return a.first < b.first;
+              });
+
+    out = "{\"gpu_count\":" + std::to_string(gpuCount) + ",";
+    AppendJsonNumber(out, "mean_utilization", gpuCount > 0 ? utilizationSum / gpuCount : 0.0);
+    out += ',';
+    AppendJsonNumber(out, "utilization_p50", fleetUtilization.Quantile(0.50));
+    out += ',';
+    AppendJsonNumber(out, "utilization_p95", fleetUtilization.Quantile(0.95));
+    out += ',';
+    AppendJsonNumber(out, "utilization_p99", fleetUtilization.Quantile(0.99));
+    out += ",\"nodes\":[";
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += nodes[i].second;
+    }
+    out += "]}";
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "EventPoller.h"
+#include "FleetStore.h"
+#include "NetSocket.h"
+
+// 多节点汇总服务：接收各采集节点（FleetUplink）的快照流，合并到按节点分片的时序存储，并提供集群视图
+//
+// - 上报端口：节点协议见 FleetProtocol.h
+// - HTTP 端口：GET / 为集群总览页面，GET /fleet 为所有节点和 GPU 的最新状态（JSON）
+//
+// 事件驱动，不为每个连接创建线程：若干个事件循环线程各自持有一个 EventPoller（Linux 上为 epoll），
+// 监听套接字加入所有事件循环，新连接只唤醒其中一个，之后该连接始终由它处理。
+// 每次可读时把套接字中已有的数据一次读完，其中所有完整的记录在一次分片加锁内批量写入 FleetStore。
+class FleetAggregator {
+public:
+    static constexpr size_t kInputBytes = 64 * 1024;     // 每个上报连接的接收缓冲区（不小于一条记录的上限）
+    static constexpr size_t kRequestBytes = 2048;
+    static constexpr int kHttpTimeoutMs = 5000;
+    // 上报连接超过该时长没有收到数据时断开（节点每个采样周期都会发送一帧，10 Hz 时约为 100 个周期），
+    // 节点掉电或网络分区时不会发送 FIN，否则它最后的状态会一直算作在线
+    static constexpr int kIngestTimeoutMs = 10000;
+    static constexpr int kHelloTimeoutMs = 5000;         // 新的上报连接需要在该时长内完成握手
+    static constexpr int kKeepAliveIdleSeconds = 30;     // TCP keepalive 探测参数（见 SetKeepAlive）
+    static constexpr int kKeepAliveIntervalSeconds = 5;
+    static constexpr int kKeepAliveProbes = 3;
+    static constexpr int kHistoryWindowSeconds = 60;     // /fleet 中平均利用率和分位数的统计窗口
+
+    FleetAggregator() = default;
+    ~FleetAggregator();
+    FleetAggregator(const FleetAggregator&) = delete;
+    FleetAggregator& operator=(const FleetAggregator&) = delete;
+
+    // 监听上报端口和 HTTP 端口（为 0 时由系统分配，见 Get*Port），启动 workerCount 个事件循环线程
+    bool Start(const std::string& address, uint16_t ingestPort, uint16_t httpPort, int workerCount);
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+    uint16_t GetIngestPort() const { return ingestPort_; }
+    uint16_t GetHttpPort() const { return httpPort_; }
+
+    const FleetStore& GetStore() const { return store_; }
+    uint64_t GetReceivedBytes() const { return receivedBytes_.load(std::memory_order_relaxed); }
+    uint64_t GetReceivedRecords() const { return receivedRecords_.load(std::memory_order_relaxed); }
+
+    // 按节点名称排序的集群状态 JSON
+    void RenderFleet(std::string& out) const;
+
+private:
+    struct Connection {
+        SocketHandle socket = kInvalidSocket;
+        bool http = false;
+        std::string address;
+        std::chrono::steady_clock::time_point lastActivity;   // 最近一次收发数据的时间（新连接为接受时间）
+
+        // 上报连接
+        std::string node;                  // 握手完成后为节点名称
+        uint64_t storeConnection = 0;      // FleetStore 中的连接编号（见 FleetStore::Connect）
+        uint32_t encoding = 0;             // 协商的数据编码（kFleetEncoding*）
+        std::vector<uint8_t> input;
+        size_t inputBytes = 0;
+
+        // HTTP 连接
+        std::string output;
+        size_t sent = 0;
+        bool writing = false;
+    };
+
+    struct Worker {
+        EventPoller poller;
+        std::thread thread;
+        std::unordered_map<SocketHandle, std::unique_ptr<Connection>> connections;
+    };
+
+    void WorkerLoop(Worker& worker);
+    void AcceptConnections(Worker& worker, SocketHandle listener, bool http);
+    bool ReadIngest(Connection& connection);
+    bool ConsumeIngest(Connection& connection);
+    bool ReadRequest(Worker& worker, Connection& connection);
+    void Respond(Connection& connection, const char* status, const char* contentType, const std::string& body);
+    bool WriteResponse(Worker& worker, Connection& connection);
+    void CloseConnection(Worker& worker, SocketHandle socket);
+    void CloseIdleConnections(Worker& worker);
+
+    FleetStore store_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> receivedBytes_{0};
+    std::atomic<uint64_t> receivedRecords_{0};
+    bool socketsInitialized_ = false;
+    SocketHandle ingestListener_ = kInvalidSocket;
+    SocketHandle httpListener_ = kInvalidSocket;
+    uint16_t ingestPort_ = 0;
+    uint16_t httpPort_ = 0;
+};
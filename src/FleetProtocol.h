@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// 节点上报协议（TCP，小端）
+//
+//   节点 -> 汇总服务：[FleetHello][节点名称 nameLength 字节][数据]...
+//   汇总服务 -> 节点：[FleetAccept]
+//
+// 连接建立后节点先发送 FleetHello 和节点名称，其中列出支持的数据编码和样本字段布局（SampleSchemaId）；
+// 汇总服务回复 FleetAccept 选定一种编码，之后节点只按该编码发送数据：
+//   - kFleetEncodingRecords：会话录制的记录编码（SessionFormat.h），每个样本都是完整记录
+//   - kFleetEncodingDelta：差分编码帧（SnapshotDelta.h），两端样本字段布局一致时才会选用
+// 每次连接（包括重连）的第一条数据必须是设备清单，设备清单变化时再发送一次。
+constexpr char kFleetMagic[8] = {'H', 'W', 'M', 'N', 'O', 'D', 'E', '1'};
+constexpr uint32_t kFleetVersion = 2;
+constexpr uint32_t kFleetMaxNameLength = 255;
+constexpr uint32_t kFleetMaxRecordBytes = 64 * 1024;   // 超过此长度的记录/帧视为协议错误
+
+constexpr uint32_t kFleetEncodingRecords = 1u << 0;
+constexpr uint32_t kFleetEncodingDelta = 1u << 1;
+
+struct FleetHello {
+    char magic[8];
+    uint32_t version;           // kFleetVersion
+    uint32_t nameLength;        // 紧随其后的节点名称字节数（不含结尾 0）
+    uint32_t encodings;         // 支持的编码（kFleetEncoding* 按位或）
+    uint32_t schemaId;          // SampleSchemaId()
+};
+static_assert(sizeof(FleetHello) == 24, "FleetHello layout changed");
+
+struct FleetAccept {
+    uint32_t version;           // kFleetVersion
+    uint32_t encoding;          // 选定的一种编码；0 表示拒绝
+};
+static_assert(sizeof(FleetAccept) == 8, "FleetAccept layout changed");
@@ -0,0 +1,150 @@
+#include "FleetStore.h"
+#include "FleetProtocol.h"
+#include <cstring>
+#include <functional>
+
+FleetStore::Shard& FleetStore::ShardFor(const std::string& name) {
+    return shards_[std::hash<std::string>()(name) % kShardCount];
+}
+
+FleetNode& FleetStore::NodeLocked(Shard& shard, const std::string& name) {
+    std::unique_ptr<FleetNode>& node = shard.nodes[name];
+    if (!node) {
+        node.reset(new FleetNode());
+        node->name = name;
+    }
+    return *node;
+}
+
+uint64_t FleetStore::Connect(const std::string& name, const std::string& address, uint32_t encoding) {
+    uint64_t connection = nextConnection_.fetch_add(1, std::memory_order_relaxed);
+    Shard& shard = ShardFor(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    FleetNode& node = NodeLocked(shard, name);
+    node.address = address;
+    node.connection = connection;
+    // 新连接会先发送清单；节点可能已经重启，时间也重新对齐
+    node.hasInventory = false;
+    node.encoding = encoding;
+    node.decoder.Reset();
+    node.hasTimeBase = false;
+    node.lastSeen = std::chrono::steady_clock::now();
+    return connection;
+}
+
+void FleetStore::Disconnect(const std::string& name, uint64_t connection) {
+    Shard& shard = ShardFor(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.nodes.find(name);
+    if (it != shard.nodes.end() && it->second->connection == connection) {
+        it->second->connection = 0;
+    }
+}
+
+bool FleetStore::Apply(const std::string& name, uint64_t connection, const uint8_t* data, size_t bytes) {
+    Shard& shard = ShardFor(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    FleetNode& node = NodeLocked(shard, name);
+    if (node.connection != connection) {
+        return false;   // 解码状态已属于新连接，旧连接的帧会把它破坏
+    }
+
+    size_t offset = 0;
+    while (offset < bytes) {
+        size_t size = 0;
+        if (node.encoding == kFleetEncodingDelta) {
+            bool error = false;
+            size = DeltaFrameSize(data + offset, bytes - offset, bytes - offset, error);
+            if (size > 0) {
+                ApplyFrame(node, data + offset, size);
+            }
+        } else if (bytes - offset >= sizeof(SessionRecordHeader)) {
+            SessionRecordHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            if (header.size >= sizeof(header) && header.size <= bytes - offset) {
+                size = header.size;
+                ApplyRecord(node, header, data + offset + sizeof(header));
+            }
+        }
+        if (size == 0) {
+            break;
+        }
+        offset += size;
+    }
+    node.receivedBytes += offset;
+    node.lastSeen = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool FleetStore::ApplyRecord(FleetNode& node, const SessionRecordHeader& header, const uint8_t* payload) {
+    SessionState state{&node.gpus, &node.cpu, &node.memory, &node.bandwidth, &node.disks, &node.pressures};
+
+    bool inventory = header.type == static_cast<uint32_t>(SessionRecordType::Inventory);
+    if (!inventory && !node.hasInventory) {
+        return false;   // 连接中途的样本（清单尚未到达），无法解码
+    }
+    if (!DecodeSessionRecord(header, payload, state)) {
+        node.decodeErrors++;
+        if (inventory) {
+            node.hasInventory = false;
+        }
+        return false;
+    }
+    if (inventory) {
+        // 设备列表已重建，按新清单补注册指标（同名指标保持原编号）
+        HardwareMonitor::RegisterSeries(node.series, state);
+        node.hasInventory = true;
+        return true;
+    }
+    AppendSample(node, header.timestampMs);
+    return true;
+}
+
+bool FleetStore::ApplyFrame(FleetNode& node, const uint8_t* frame, size_t bytes) {
+    SessionState state{&node.gpus, &node.cpu, &node.memory, &node.bandwidth, &node.disks, &node.pressures};
+    DeltaFrameType type;
+    int64_t timestampMs = 0;
+    bool error = false;
+    if (!node.decoder.Decode(frame, bytes, state, type, timestampMs, error)) {
+        // 解码端会丢弃差分帧，直到下一个 Keyframe 重新同步
+        node.decodeErrors += error ? 1 : 0;
+        return false;
+    }
+    if (type == DeltaFrameType::Inventory) {
+        HardwareMonitor::RegisterSeries(node.series, state);
+        node.hasInventory = true;
+        return true;
+    }
+    AppendSample(node, timestampMs);
+    return true;
+}
+
+void FleetStore::AppendSample(FleetNode& node, int64_t timestampMs) {
+    // 节点时间换算为本地时间，保证同一节点的历史数据时间戳单调
+    using namespace std::chrono;
+    steady_clock::time_point now = steady_clock::now();
+    if (!node.hasTimeBase) {
+        node.timeOffset = now.time_since_epoch() - duration_cast<steady_clock::duration>(milliseconds(timestampMs));
+        node.hasTimeBase = true;
+    }
+    steady_clock::time_point time(duration_cast<steady_clock::duration>(milliseconds(timestampMs)) + node.timeOffset);
+    if (node.series.Size() > 0 && time < node.series.TimeAt(node.series.Size() - 1)) {
+        time = node.series.TimeAt(node.series.Size() - 1);
+    }
+
+    SessionState state{&node.gpus, &node.cpu, &node.memory, &node.bandwidth, &node.disks, &node.pressures};
+    HardwareMonitor::UpdateDerived(state);
+    HardwareMonitor::StoreSeries(node.series, state);
+    node.series.Append(time);
+    node.samples++;
+    node.lastTimestampMs = timestampMs;
+}
+
+size_t FleetStore::GetNodeCount() const {
+    size_t count = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.nodes.size();
+    }
+    return count;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "HardwareMonitor.h"
+#include "SessionFormat.h"
+#include "SnapshotDelta.h"
+
+// 汇总服务中一个采集节点的状态：最新的设备清单和数值 + 该节点自己的历史数据
+struct FleetNode {
+    std::string name;
+    std::string address;               // 最近一次连接的对端地址
+
+    std::vector<GPUInfo> gpus;
+    CPUInfo cpu;
+    MemoryInfo memory;
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;
+    SeriesStore series;                // 时间戳为汇总服务的 steady_clock（按节点时间换算，单调）
+
+    // 解码状态只属于当前连接：同名的新连接会取代旧连接，旧连接之后的数据不再写入
+    bool hasInventory = false;         // 本次连接已收到清单，之后的样本才能解码
+    uint32_t encoding = 0;             // 本次连接的数据编码（kFleetEncoding*）
+    SnapshotDeltaDecoder decoder;      // 差分编码的解码状态（每次连接重置）
+    uint64_t connection = 0;           // 当前连接的编号（见 FleetStore::Connect），离线时为 0
+    uint64_t samples = 0;
+    uint64_t receivedBytes = 0;        // 累计收到的数据字节数（不含握手）
+    uint64_t decodeErrors = 0;
+    int64_t lastTimestampMs = 0;       // 最近一个样本的节点墙上时间
+    std::chrono::steady_clock::time_point lastSeen;
+
+    // 节点墙上时间到本地 steady_clock 的换算（每次连接时重新对齐）
+    bool hasTimeBase = false;
+    std::chrono::steady_clock::duration timeOffset{};
+};
+
+// 按节点分片的时序存储：节点名称哈希到固定数量的分片，每个分片一把锁。
+// 不同节点的写入大多落在不同分片上，事件循环线程之间很少竞争；
+// 每次读事件到达时，一个连接收到的所有完整记录在一次加锁内批量写入。
+class FleetStore {
+public:
+    static constexpr size_t kShardCount = 16;
+
+    FleetStore() = default;
+    FleetStore(const FleetStore&) = delete;
+    FleetStore& operator=(const FleetStore&) = delete;
+
+    // 节点连接建立（同名节点沿用之前的历史数据），返回该连接的编号；encoding 为该连接协商的数据编码。
+    // 同名节点已有活动连接时（节点重启后旧连接尚未超时，或两个节点配置了相同的名称），新连接取代旧连接
+    uint64_t Connect(const std::string& name, const std::string& address, uint32_t encoding);
+    // 连接断开；已被取代的连接不影响节点状态
+    void Disconnect(const std::string& name, uint64_t connection);
+
+    // 应用 data 中连续的若干条完整记录（按连接的编码：SessionFormat 记录或 SnapshotDelta 帧）。
+    // 连接已被同名的新连接取代时不写入任何数据并返回 false，调用方应断开该连接
+    bool Apply(const std::string& name, uint64_t connection, const uint8_t* data, size_t bytes);
+
+    // 逐个分片加锁遍历所有节点：fn(const FleetNode&)。回调中不能再访问 FleetStore
+    template <typename Fn>
+    void ForEachNode(Fn&& fn) const {
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& entry : shard.nodes) {
+                fn(*entry.second);
+            }
+        }
+    }
+
+    size_t GetNodeCount() const;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<FleetNode>> nodes;
+    };
+
+    Shard& ShardFor(const std::string& name);
+    // 调用方已持有分片锁
+    FleetNode& NodeLocked(Shard& shard, const std::string& name);
+    bool ApplyRecord(FleetNode& node, const SessionRecordHeader& header, const uint8_t* payload);
+    bool ApplyFrame(FleetNode& node, const uint8_t* frame, size_t bytes);
+    void AppendSample(FleetNode& node, int64_t timestampMs);
+
+    std::array<Shard, kShardCount> shards_;
+    std::atomic<uint64_t> nextConnection_{1};
+};
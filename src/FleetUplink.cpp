@@ -0,0 +1,167 @@
+#include "FleetUplink.h"
+#include "FleetProtocol.h"
+#include "SessionFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+FleetUplink::~FleetUplink() {
+    Stop();
+}
+
+bool FleetUplink::Start(const std::string& host, uint16_t port, const std::string& nodeName) {
+    if (IsRunning()) {
+        return true;
+    }
+    if (!InitializeSockets()) {
+        std::cerr << "警告: Winsock 初始化失败，节点上报不可用" << std::endl;
+        return false;
+    }
+
+    host_ = host;
+    port_ = port;
+    nodeName_ = nodeName.empty() ? LocalHostName() : nodeName;
+    if (nodeName_.size() > kFleetMaxNameLength) {
+        nodeName_.resize(kFleetMaxNameLength);
+    }
+    // 一条清单 + 一条样本
+    buffer_.resize(2 * SessionRecorder::kMaxRecordBytes);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&FleetUplink::UplinkLoop, this);
+    return true;
+}
+
+void FleetUplink::Stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel) && !thread_.joinable()) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    Disconnect();
+    ShutdownSockets();
+}
+
+void FleetUplink::UplinkLoop() {
+    using Clock = std::chrono::steady_clock;
+    int retryMs = kMinRetryMs;
+    Clock::time_point nextAttempt = Clock::now();
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (socket_ == kInvalidSocket && Clock::now() >= nextAttempt) {
+            if (Connect()) {
+                retryMs = kMinRetryMs;
+            } else {
+                nextAttempt = Clock::now() + std::chrono::milliseconds(retryMs);
+                retryMs = std::min(retryMs * 2, kMaxRetryMs);
+            }
+        }
+
+        // 断开期间也要取走快照，重连后从最新的样本开始
+        if (snapshots_.Acquire()) {
+            const HardwareSnapshot& snapshot = snapshots_.ReadBuffer();
+            if (socket_ != kInvalidSocket && snapshot.sequence != 0 && !SendSnapshot(snapshot)) {
+                std::cerr << "警告: 与汇总服务 " << host_ << ":" << port_ << " 的连接已断开，稍后重连" << std::endl;
+                Disconnect();
+                nextAttempt = Clock::now() + std::chrono::milliseconds(retryMs);
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+    }
+}
+
+bool FleetUplink::Connect() {
+    SocketHandle socket = ConnectTcp(host_, port_);
+    if (socket == kInvalidSocket) {
+        return false;
+    }
+    SetSocketTimeout(socket, 5000);
+
+    uint8_t hello[sizeof(FleetHello) + kFleetMaxNameLength];
+    FleetHello header{};
+    std::memcpy(header.magic, kFleetMagic, sizeof(header.magic));
+    header.version = kFleetVersion;
+    header.nameLength = static_cast<uint32_t>(nodeName_.size());
+    header.encodings = kFleetEncodingRecords | kFleetEncodingDelta;
+    header.schemaId = SampleSchemaId();
+    std::memcpy(hello, &header, sizeof(header));
+    std::memcpy(hello + sizeof(header), nodeName_.data(), nodeName_.size());
+    if (!SendAll(socket, hello, sizeof(header) + nodeName_.size())) {
+        CloseSocket(socket);
+        return false;
+    }
+
+    // 等待汇总服务选定编码
+    FleetAccept accept{};
+    size_t received = 0;
+    while (received < sizeof(accept)) {
+        ptrdiff_t bytes = ReceiveSome(socket, reinterpret_cast<uint8_t*>(&accept) + received, sizeof(accept) - received);
+        if (bytes <= 0) {
+            CloseSocket(socket);
+            return false;
+        }
+        received += static_cast<size_t>(bytes);
+    }
+    if (accept.version != kFleetVersion ||
+        (accept.encoding != kFleetEncodingRecords && accept.encoding != kFleetEncodingDelta)) {
+        std::cerr << "警告: 汇总服务 " << host_ << ":" << port_ << " 拒绝了节点上报（协议版本不兼容）" << std::endl;
+        CloseSocket(socket);
+        return false;
+    }
+
+    socket_ = socket;
+    sentInventoryVersion_ = 0;
+    encoder_.Reset();
+    encoding_.store(accept.encoding, std::memory_order_release);
+    connected_.store(true, std::memory_order_release);
+    std::cerr << "已连接汇总服务 " << host_ << ":" << port_ << "（节点 " << nodeName_
+              << (accept.encoding == kFleetEncodingDelta ? "，差分编码" : "，完整记录") << "）" << std::endl;
+    return true;
+}
+
+void FleetUplink::Disconnect() {
+    if (socket_ != kInvalidSocket) {
+        CloseSocket(socket_);
+        socket_ = kInvalidSocket;
+    }
+    encoding_.store(0, std::memory_order_release);
+    connected_.store(false, std::memory_order_release);
+}
+
+bool FleetUplink::SendSnapshot(const HardwareSnapshot& snapshot) {
+    SessionView state(snapshot);
+
+    int64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    bool delta = encoding_.load(std::memory_order_relaxed) == kFleetEncodingDelta;
+    size_t bytes = 0;
+    bool sendInventory = sentInventoryVersion_ != snapshot.inventoryVersion;
+    if (sendInventory) {
+        bytes = delta ? encoder_.EncodeInventory(state, timestampMs, buffer_.data(), SessionRecorder::kMaxRecordBytes)
+                      : EncodeSessionRecord(SessionRecordType::Inventory, timestampMs, state,
+                                            buffer_.data(), SessionRecorder::kMaxRecordBytes);
+        if (bytes == 0) {
+            return true;   // 清单超出记录容量，无法上报（不是连接问题）
+        }
+    }
+    uint8_t* sample = buffer_.data() + bytes;
+    size_t sampleBytes = delta ? encoder_.EncodeSample(state, timestampMs, sample, SessionRecorder::kMaxRecordBytes)
+                               : EncodeSessionRecord(SessionRecordType::Sample, timestampMs, state,
+                                                     sample, SessionRecorder::kMaxRecordBytes);
+    if (sampleBytes == 0) {
+        return true;
+    }
+    bytes += sampleBytes;
+
+    if (!SendAll(socket_, buffer_.data(), bytes)) {
+        return false;
+    }
+    if (sendInventory) {
+        sentInventoryVersion_ = snapshot.inventoryVersion;
+    }
+    sentBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HardwareMonitor.h"
+#include "NetSocket.h"
+#include "SnapshotDelta.h"
+
+// 节点上报：把本机的快照流通过 TCP 发送给汇总服务（FleetAggregator，协议见 FleetProtocol.h）
+//
+// 汇总服务支持时使用差分编码（每个样本只发送变化的数值），否则退回完整记录。
+// 数据来自 HardwareMonitor 的额外快照读端（AddSnapshotReader(&uplink.GetSnapshotBuffer())），
+// 发送在独立线程中进行，汇总服务变慢或断开都不会影响采样线程。断开后按 1s、2s、4s... 最长 30s 的间隔重连，
+// 重连后先补发设备清单；断开期间的样本直接丢弃（本地录制文件才是完整记录）。
+class FleetUplink {
+public:
+    FleetUplink() = default;
+    ~FleetUplink();
+    FleetUplink(const FleetUplink&) = delete;
+    FleetUplink& operator=(const FleetUplink&) = delete;
+
+    // 启动上报线程；nodeName 为空时使用主机名
+    bool Start(const std::string& host, uint16_t port, const std::string& nodeName);
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+    bool IsConnected() const { return connected_.load(std::memory_order_acquire); }
+    const std::string& GetNodeName() const { return nodeName_; }
+
+    // 快照输入：注册到 HardwareMonitor::AddSnapshotReader
+    TripleBuffer<HardwareSnapshot>& GetSnapshotBuffer() { return snapshots_; }
+
+    uint64_t GetSentBytes() const { return sentBytes_.load(std::memory_order_relaxed); }
+    // 当前连接使用的编码（kFleetEncoding*），未连接时为 0
+    uint32_t GetEncoding() const { return encoding_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr int kPollMs = 20;               // 检查新快照的间隔
+    static constexpr int kMinRetryMs = 1000;
+    static constexpr int kMaxRetryMs = 30000;
+
+    void UplinkLoop();
+    bool Connect();
+    void Disconnect();
+    bool SendSnapshot(const HardwareSnapshot& snapshot);
+
+    TripleBuffer<HardwareSnapshot> snapshots_;
+
+    std::string host_;
+    uint16_t port_ = 0;
+    std::string nodeName_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> sentBytes_{0};
+    std::atomic<uint32_t> encoding_{0};
+
+    // 以下只由上报线程访问
+    SocketHandle socket_ = kInvalidSocket;
+    uint32_t sentInventoryVersion_ = 0;  // 本次连接中最近一次发送的清单版本，0 表示尚未发送
+    SnapshotDeltaEncoder encoder_;
+    std::vector<uint8_t> buffer_;
+};
@@ -1,26 +1,16 @@
 #include "HardwareMonitor.h"
-#include <pdh.h>
-#include <psapi.h>
+#include "DerivedMetrics.h"
+#include "HostCollector.h"
+#include "SessionFormat.h"
+#include "SessionReplay.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <cerrno>
 #include <nvml.h>
-#include <comdef.h>
-#include <Wbemidl.h>
 #include <sstream>
 
-#pragma comment(lib, "pdh.lib")
-#pragma comment(lib, "psapi.lib")
-#pragma comment(lib, "wbemuuid.lib")
-#pragma comment(lib, "ole32.lib")
-#pragma comment(lib, "oleaut32.lib")
-
-HardwareMonitor::HardwareMonitor() {
-    GetSystemInfo(&sysInfo_);
-    numProcessors_ = sysInfo_.dwNumberOfProcessors;
-    self_ = GetCurrentProcess();
-}
+HardwareMonitor::HardwareMonitor() = default;
 
 HardwareMonitor::~HardwareMonitor() {
     Shutdown();
@@ -32,23 +22,282 @@ bool HardwareMonitor::Initialize() {
         std::cerr << "警告: NVML初始化失败，GPU监控可能不可用" << std::endl;
     }
 
-    // 初始化CPU性能计数器
-    PdhOpenQuery(NULL, NULL, &cpuQuery_);
-    PdhAddCounter(cpuQuery_, "\\Processor(_Total)\\% Processor Time", NULL, &cpuCounter_);
-    PdhCollectQueryData(cpuQuery_);
-
-    // 初始化CPU时间
-    FILETIME ftime, fsys, fuser;
-    GetSystemTimeAsFileTime(&ftime);
-    memcpy(&lastCPU_, &ftime, sizeof(FILETIME));
+    // 初始化CPU/内存/磁盘采集后端
+    host_ = CreateHostCollector(hostRoot_, pressureCgroup_);
+    if (!host_) {
+        std::cerr << "警告: 当前平台没有CPU/内存/磁盘采集后端，只监控GPU" << std::endl;
+    } else if (!host_->Initialize()) {
+        std::cerr << "警告: " << host_->Name() << " 采集后端初始化失败，只监控GPU" << std::endl;
+        host_.reset();
+    }
 
-    GetProcessTimes(self_, &ftime, &ftime, &fsys, &fuser);
-    memcpy(&lastSysCPU_, &fsys, sizeof(FILETIME));
-    memcpy(&lastUserCPU_, &fuser, sizeof(FILETIME));
+    RegisterCollectors();
+    return true;
+}
 
+bool HardwareMonitor::InitializeReplay(const std::string& path, double speed) {
+    // 不初始化 NVML/PDH，也不注册采集器：设备清单和数值全部来自录制文件
+    std::unique_ptr<SessionReplay> replay(new SessionReplay());
+    if (!replay->Open(path, speed)) {
+        return false;
+    }
+    replay_ = std::move(replay);
+    replayFinished_ = false;
     return true;
 }
 
+bool HardwareMonitor::InitializeAttach(const std::string& name) {
+    // 与回放模式相同：不初始化采集接口，设备清单和数值全部来自总线
+    return bus_.Attach(name);
+}
+
+// ===== 派生指标定义 =====
+// 新增派生指标只需在表中加一项（并在 GPUInfo 中加输出字段和指标编号），计算、历史和快照都会自动带上
+
+static constexpr float kTransferWaitReferenceMs = 10.0f;   // 等待占比 100% 对应的等待时间
+static constexpr float kThrottleBusyPercent = 80.0f;       // 利用率达到此值的逻辑 CPU 才参与降频判断
+static constexpr double kThrottleFrequencyPercent = 70.0;  // 负载高的核心平均频率低于最大频率的此比例视为降频
+
+static const DerivedMetrics<GPUInfo>::Definition kGpuDerivedMetrics[] = {
+    {"pcie_throughput", "MB/s", {&GPUInfo::pcieRxThroughput, &GPUInfo::pcieTxThroughput, nullptr}, true,
+     [](const GPUInfo& g) { return g.pcieRxThroughput + g.pcieTxThroughput; },
+     &GPUInfo::pcieThroughput, &GPUInfo::pcieThroughputSeries},
+    {"pcie_utilization", "%", {&GPUInfo::pcieThroughput, &GPUInfo::pcieBandwidth, nullptr}, false,
+     [](const GPUInfo& g) {
+         return g.pcieBandwidth > 0.0f ? std::min(100.0f, g.pcieThroughput / 1024.0f / g.pcieBandwidth * 100.0f) : 0.0f;
+     },
+     &GPUInfo::pcieUtilization, &GPUInfo::pcieUtilizationSeries},
+    {"memory_used_gb", "GB", {&GPUInfo::memoryUsed, nullptr, nullptr}, false,
+     [](const GPUInfo& g) { return g.memoryUsed / 1024.0f; },
+     &GPUInfo::memoryUsedGB, &GPUInfo::memoryUsedGBSeries},
+    {"transfer_wait_percent", "%", {&GPUInfo::dataTransferWaitTime, nullptr, nullptr}, false,
+     [](const GPUInfo& g) {
+         return std::min(100.0f, std::max(0.0f, g.dataTransferWaitTime) / kTransferWaitReferenceMs * 100.0f);
+     },
+     &GPUInfo::transferWaitPercent, &GPUInfo::transferWaitPercentSeries},
+};
+
+static const DerivedMetrics<GPUInfo>& GpuDerivedMetrics() {
+    static const DerivedMetrics<GPUInfo> metrics(kGpuDerivedMetrics);
+    return metrics;
+}
+
+void HardwareMonitor::UpdateDerived(const SessionState& state) {
+    GpuDerivedMetrics().Update(*state.gpus);
+
+    CPUInfo& cpu = *state.cpu;
+    cpu.maxCoreUtilization = 0.0f;
+    for (float utilization : cpu.coreUtilization) {
+        cpu.maxCoreUtilization = std::max(cpu.maxCoreUtilization, utilization);
+    }
+
+    // 频率百分比按每个逻辑 CPU 自己的最大频率计算（大小核的最大频率不同）；
+    // 空闲核心本来就会降频，判断降频只看负载高的核心
+    double frequencyPercent = 0.0;
+    double busyFrequencyPercent = 0.0;
+    size_t frequencyCount = 0;
+    size_t busyCount = 0;
+    size_t count = std::min({cpu.logicalCpus.size(), cpu.coreFrequency.size(), cpu.coreUtilization.size()});
+    for (size_t i = 0; i < count; i++) {
+        float maxFrequency = cpu.logicalCpus[i].maxFrequency;
+        if (maxFrequency <= 0.0f || cpu.coreFrequency[i] <= 0.0f) {
+            continue;
+        }
+        double percent = cpu.coreFrequency[i] / maxFrequency * 100.0;
+        frequencyPercent += percent;
+        frequencyCount++;
+        if (cpu.coreUtilization[i] >= kThrottleBusyPercent) {
+            busyFrequencyPercent += percent;
+            busyCount++;
+        }
+    }
+    cpu.frequencyPercent = frequencyCount > 0 ? static_cast<float>(frequencyPercent / frequencyCount) : 0.0f;
+    cpu.throttled = cpu.throttleRate > 0.0f ||
+        (busyCount > 0 && busyFrequencyPercent / busyCount < kThrottleFrequencyPercent);
+}
+
+void HardwareMonitor::RegisterSeries(SeriesStore& series, const SessionState& state) {
+    // 指标名称即稳定编号的来源：按注册顺序分配，运行期间不变
+    // 利用率、功耗、PCIe 吞吐和磁盘带宽额外维护分位数草图（诊断和图表的 p50/p95/p99）
+    for (size_t i = 0; i < state.gpus->size(); i++) {
+        GPUInfo& gpu = (*state.gpus)[i];
+        std::string prefix = "gpu" + std::to_string(i) + ".";
+        gpu.utilizationSeries = series.Register(prefix + "utilization", "%", true);
+        gpu.memorySeries = series.Register(prefix + "memory_percent", "%");
+        gpu.temperatureSeries = series.Register(prefix + "temperature", "°C");
+        gpu.pcieRxSeries = series.Register(prefix + "pcie_rx", "MB/s");
+        gpu.pcieTxSeries = series.Register(prefix + "pcie_tx", "MB/s");
+        gpu.transferWaitSeries = series.Register(prefix + "transfer_wait", "ms");
+        gpu.powerSeries = series.Register(prefix + "power", "W", true);
+        gpu.powerPercentSeries = series.Register(prefix + "power_percent", "%");
+        GpuDerivedMetrics().Register(series, gpu, prefix);
+    }
+
+    state.cpu->utilizationSeries = series.Register("cpu.utilization", "%", true);
+    // 每个逻辑 CPU 只保留当前值（热力图），历史只记录最忙的一个，避免几百个核心各占一条历史
+    state.cpu->maxCoreUtilizationSeries = series.Register("cpu.max_core_utilization", "%", true);
+    state.cpu->frequencySeries = series.Register("cpu.frequency", "MHz");
+    state.cpu->frequencyPercentSeries = series.Register("cpu.frequency_percent", "%");
+    state.cpu->temperatureSeries = series.Register("cpu.temperature", "°C");
+    state.cpu->maxCoreTemperatureSeries = series.Register("cpu.max_core_temperature", "°C");
+    state.cpu->throttleRateSeries = series.Register("cpu.throttle_rate", "1/s");
+    // 0/1 序列：窗口平均值即降频时间占比，诊断按行与 GPU 利用率对齐
+    state.cpu->throttledSeries = series.Register("cpu.throttled", "");
+    state.memory->percentSeries = series.Register("memory.percent", "%");
+    state.memory->pageInSeries = series.Register("memory.page_in", "MB/s");
+    state.memory->pageOutSeries = series.Register("memory.page_out", "MB/s");
+    state.memory->swapInSeries = series.Register("memory.swap_in", "MB/s");
+    state.memory->swapOutSeries = series.Register("memory.swap_out", "MB/s");
+    state.memory->majorFaultSeries = series.Register("memory.major_faults", "1/s");
+    state.memory->dirtySeries = series.Register("memory.dirty", "MB");
+    state.memory->writebackSeries = series.Register("memory.writeback", "MB");
+
+    state.bandwidth->totalBandwidthSeries = series.Register("bandwidth.total", "GB/s");
+    state.bandwidth->cpuBandwidthSeries = series.Register("bandwidth.cpu", "GB/s");
+    state.bandwidth->memoryBandwidthSeries = series.Register("bandwidth.memory", "GB/s");
+    state.bandwidth->pcieBandwidthSeries = series.Register("bandwidth.pcie", "GB/s");
+    state.bandwidth->storageBandwidthSeries = series.Register("bandwidth.storage", "GB/s");
+    state.bandwidth->vramBandwidthSeries = series.Register("bandwidth.vram", "GB/s");
+
+    for (size_t i = 0; i < state.memory->modules.size(); i++) {
+        state.memory->modules[i].bandwidthSeries = series.Register(
+            "memory.module" + std::to_string(i) + ".bandwidth", "GB/s");
+    }
+
+    for (DiskInfo& disk : *state.disks) {
+        std::string prefix = "disk." + disk.name.substr(0, disk.name.find(':')) + ".";
+        disk.readBandwidthSeries = series.Register(prefix + "read", "GB/s", true);
+        disk.writeBandwidthSeries = series.Register(prefix + "write", "GB/s", true);
+    }
+
+    // cgroup 路径可能很长且带 '/'，指标名只区分系统和 cgroup
+    for (PressureInfo& pressure : *state.pressures) {
+        std::string scope = pressure.scope == "system" ? "pressure.system." : "pressure.cgroup.";
+        for (const PressureResource& resource : kPressureResources) {
+            PressureStat& stat = pressure.*resource.stat;
+            std::string prefix = scope + resource.name + ".";
+            stat.someAvg10Series = series.Register(prefix + "some_avg10", "%");
+            stat.fullAvg10Series = series.Register(prefix + "full_avg10", "%");
+            stat.someStallSeries = series.Register(prefix + "some_stall", "%");
+            stat.fullStallSeries = series.Register(prefix + "full_stall", "%");
+        }
+    }
+}
+
+void HardwareMonitor::StoreSeries(SeriesStore& series, const SessionState& state) {
+    for (const GPUInfo& gpu : *state.gpus) {
+        series.Set(gpu.utilizationSeries, gpu.utilization);
+        series.Set(gpu.memorySeries, gpu.memoryPercent);
+        series.Set(gpu.temperatureSeries, gpu.temperature);
+        series.Set(gpu.pcieRxSeries, gpu.pcieRxThroughput);
+        series.Set(gpu.pcieTxSeries, gpu.pcieTxThroughput);
+        series.Set(gpu.transferWaitSeries, gpu.dataTransferWaitTime);
+        if (gpu.powerUsage > 0) {
+            series.Set(gpu.powerSeries, static_cast<float>(gpu.powerUsage));
+            series.Set(gpu.powerPercentSeries, gpu.powerPercent);
+        }
+        GpuDerivedMetrics().Store(series, gpu);
+    }
+
+    series.Set(state.cpu->utilizationSeries, state.cpu->utilization);
+    if (!state.cpu->coreUtilization.empty()) {
+        series.Set(state.cpu->maxCoreUtilizationSeries, state.cpu->maxCoreUtilization);
+    }
+    series.Set(state.cpu->frequencySeries, state.cpu->frequency);
+    series.Set(state.cpu->frequencyPercentSeries, state.cpu->frequencyPercent);
+    series.Set(state.cpu->temperatureSeries, state.cpu->temperature);
+    series.Set(state.cpu->maxCoreTemperatureSeries, state.cpu->maxCoreTemperature);
+    series.Set(state.cpu->throttleRateSeries, state.cpu->throttleRate);
+    series.Set(state.cpu->throttledSeries, state.cpu->throttled ? 1.0f : 0.0f);
+    series.Set(state.memory->percentSeries, state.memory->percent);
+    series.Set(state.memory->pageInSeries, state.memory->pageInRate);
+    series.Set(state.memory->pageOutSeries, state.memory->pageOutRate);
+    series.Set(state.memory->swapInSeries, state.memory->swapInRate);
+    series.Set(state.memory->swapOutSeries, state.memory->swapOutRate);
+    series.Set(state.memory->majorFaultSeries, state.memory->majorFaultRate);
+    series.Set(state.memory->dirtySeries, state.memory->dirty);
+    series.Set(state.memory->writebackSeries, state.memory->writeback);
+    for (const MemoryModuleInfo& module : state.memory->modules) {
+        series.Set(module.bandwidthSeries, module.realTimeBandwidth);
+    }
+    for (const DiskInfo& disk : *state.disks) {
+        series.Set(disk.readBandwidthSeries, disk.realTimeReadBandwidth);
+        series.Set(disk.writeBandwidthSeries, disk.realTimeWriteBandwidth);
+    }
+    for (const PressureInfo& pressure : *state.pressures) {
+        for (const PressureResource& resource : kPressureResources) {
+            const PressureStat& stat = pressure.*resource.stat;
+            series.Set(stat.someAvg10Series, stat.someAvg10);
+            series.Set(stat.fullAvg10Series, stat.fullAvg10);
+            series.Set(stat.someStallSeries, stat.someStall);
+            series.Set(stat.fullStallSeries, stat.fullStall);
+        }
+    }
+
+    series.Set(state.bandwidth->totalBandwidthSeries, state.bandwidth->totalSystemBandwidth);
+    series.Set(state.bandwidth->cpuBandwidthSeries, state.bandwidth->cpuBandwidth);
+    series.Set(state.bandwidth->memoryBandwidthSeries, state.bandwidth->memoryMaxBandwidth);
+    series.Set(state.bandwidth->pcieBandwidthSeries, state.bandwidth->pcieRealTimeBandwidth);
+    series.Set(state.bandwidth->storageBandwidthSeries, state.bandwidth->storageRealTimeBandwidth);
+    series.Set(state.bandwidth->vramBandwidthSeries, state.bandwidth->vramRealTimeBandwidth);
+}
+
+void HardwareMonitor::AppendRow(std::chrono::steady_clock::time_point time) {
+    // 派生指标与历史无关，快照、录制、导出都要用到
+    SessionState state{&gpuInfos_, &cpuInfo_, &memoryInfo_, &systemBandwidthInfo_, &diskInfos_, &pressureInfos_};
+    UpdateDerived(state);
+    if (!historyEnabled_) {
+        return;
+    }
+    // 设备清单变化后先补注册新设备的指标，再写入本行
+    if (registeredInventoryVersion_ != inventoryVersion_) {
+        RegisterSeries(series_, state);
+        registeredInventoryVersion_ = inventoryVersion_;
+    }
+    StoreSeries(series_, state);
+    series_.Append(time);
+    archive_.AppendRow(time, series_);
+}
+
+void HardwareMonitor::RegisterCollectors() {
+    using std::chrono::milliseconds;
+    using std::chrono::microseconds;
+
+    // 同时到期的采集器按注册顺序运行：带宽汇总依赖GPU/CPU/内存的最新值，必须放在最后
+    scheduler_.Register("GPU", milliseconds(100), microseconds(20000), [this] { UpdateGPU(); });
+    if (host_) {
+        scheduler_.Register("CPUTopology", milliseconds(0), microseconds(50000), [this] {
+            if (host_->UpdateCPUTopology(cpuInfo_)) {
+                inventoryVersion_++;
+            }
+        });
+        scheduler_.Register("CPU", milliseconds(500), microseconds(5000), [this] { host_->UpdateCPU(cpuInfo_); });
+        scheduler_.Register("CPUThermal", milliseconds(1000), microseconds(5000), [this] {
+            host_->UpdateCPUThermal(cpuInfo_);
+        });
+        scheduler_.Register("MemoryModules", milliseconds(0), microseconds(500000), [this] {
+            if (host_->UpdateMemoryModules(memoryInfo_)) {
+                inventoryVersion_++;
+            }
+        });
+        scheduler_.Register("Memory", milliseconds(1000), microseconds(2000), [this] {
+            host_->UpdateMemory(memoryInfo_);
+            UpdateMemoryModuleBandwidth();
+        });
+        scheduler_.Register("Disks", milliseconds(1000), microseconds(10000), [this] {
+            if (host_->UpdateDisks(diskInfos_)) {
+                inventoryVersion_++;
+            }
+        });
+        scheduler_.Register("Pressure", milliseconds(1000), microseconds(2000), [this] {
+            if (host_->UpdatePressure(pressureInfos_)) {
+                inventoryVersion_++;
+            }
+        });
+    }
+    scheduler_.Register("SystemBandwidth", milliseconds(500), microseconds(1000), [this] { UpdateSystemBandwidth(); });
+}
+
 bool HardwareMonitor::InitializeNVML() {
     nvmlReturn_t result = nvmlInit();
     if (result != NVML_SUCCESS) {
@@ -63,31 +312,271 @@ bool HardwareMonitor::InitializeNVML() {
     }
 
     gpuInfos_.resize(deviceCount);
+    gpuDevices_.resize(deviceCount);
     for (unsigned int i = 0; i < deviceCount; i++) {
-        gpuInfos_[i].available = true;
-        gpuInfos_[i].utilizationHistory.reserve(GPUInfo::MAX_HISTORY);
-        gpuInfos_[i].memoryHistory.reserve(GPUInfo::MAX_HISTORY);
-        gpuInfos_[i].temperatureHistory.reserve(GPUInfo::MAX_HISTORY);
-        gpuInfos_[i].pcieRxHistory.reserve(GPUInfo::MAX_HISTORY);
-        gpuInfos_[i].pcieTxHistory.reserve(GPUInfo::MAX_HISTORY);
-        gpuInfos_[i].transferWaitHistory.reserve(GPUInfo::MAX_HISTORY);
+        GPUInfo& gpu = gpuInfos_[i];
+        GPUDevice& device = gpuDevices_[i];
+
+        // 缓存设备句柄和静态属性，采样热路径只查询会变化的数值
+        if (nvmlDeviceGetHandleByIndex(i, &device.handle) != NVML_SUCCESS) {
+            device.handle = nullptr;
+            gpu.available = false;
+            continue;
+        }
+        gpu.available = true;
+
+        char name[NVML_DEVICE_NAME_BUFFER_SIZE];
+        if (nvmlDeviceGetName(device.handle, name, NVML_DEVICE_NAME_BUFFER_SIZE) == NVML_SUCCESS) {
+            gpu.name = name;
+        }
+
+        char uuid[NVML_DEVICE_UUID_BUFFER_SIZE];
+        if (nvmlDeviceGetUUID(device.handle, uuid, NVML_DEVICE_UUID_BUFFER_SIZE) == NVML_SUCCESS) {
+            gpu.uuid = uuid;
+        }
+
+        if (nvmlDeviceGetPowerManagementLimitConstraints(device.handle, &device.minPowerLimit,
+                                                         &device.maxPowerLimit) == NVML_SUCCESS) {
+            device.hasPowerLimit = true;
+        }
+
+        unsigned int value = 0;
+        if (nvmlDeviceGetMaxClockInfo(device.handle, NVML_CLOCK_GRAPHICS, &value) == NVML_SUCCESS) {
+            gpu.maxGpuClock = value;
+        }
+        if (nvmlDeviceGetMaxClockInfo(device.handle, NVML_CLOCK_MEM, &value) == NVML_SUCCESS) {
+            gpu.maxMemoryClock = value;
+        }
+        if (nvmlDeviceGetMaxPcieLinkGeneration(device.handle, &value) == NVML_SUCCESS) {
+            gpu.pcieMaxLinkGeneration = value;
+        }
+        if (nvmlDeviceGetMaxPcieLinkWidth(device.handle, &value) == NVML_SUCCESS) {
+            gpu.pcieMaxLinkWidth = value;
+        }
+        if (nvmlDeviceGetMemoryBusWidth(device.handle, &value) == NVML_SUCCESS) {
+            gpu.memoryBusWidth = value;
+        }
     }
-    
-    // 初始化系统带宽信息历史数据
-    systemBandwidthInfo_.totalBandwidthHistory.reserve(SystemBandwidthInfo::MAX_HISTORY);
-    systemBandwidthInfo_.cpuBandwidthHistory.reserve(SystemBandwidthInfo::MAX_HISTORY);
-    systemBandwidthInfo_.memoryBandwidthHistory.reserve(SystemBandwidthInfo::MAX_HISTORY);
 
     return true;
 }
 
 void HardwareMonitor::Update() {
-    UpdateGPU();
-    UpdateCPU();
-    UpdateMemory();
-    UpdateMemoryModules();
-    UpdateDisks();
-    UpdateSystemBandwidth();
+    if (replay_) {
+        UpdateReplay();
+        return;
+    }
+    if (IsAttached()) {
+        UpdateAttached();
+        return;
+    }
+
+    if (scheduler_.RunDue(std::chrono::steady_clock::now())) {
+        // 本轮所有采集器更新后的值作为同一行追加，各指标共用这一时间戳
+        AppendRow(std::chrono::steady_clock::now());
+        PublishSnapshot();
+        if (recorder_.IsOpen()) {
+            RecordSnapshot();
+        }
+    }
+}
+
+void HardwareMonitor::UpdateReplay() {
+    // 每轮最多回放这么多条记录，尽快播放时也能定期发布快照并及时响应 Stop
+    constexpr int kReplayBatch = 256;
+
+    SessionState state{&gpuInfos_, &cpuInfo_, &memoryInfo_, &systemBandwidthInfo_, &diskInfos_, &pressureInfos_};
+    SessionRecordHeader header;
+    const uint8_t* payload = nullptr;
+    bool updated = false;
+
+    auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < kReplayBatch && replay_->Next(now, header, payload); i++) {
+        if (!DecodeSessionRecord(header, payload, state)) {
+            std::cerr << "警告: 回放记录解码失败，已跳过" << std::endl;
+            continue;
+        }
+        if (header.type == static_cast<uint32_t>(SessionRecordType::Inventory)) {
+            inventoryVersion_++;
+            continue;
+        }
+        // 历史数据按录制时的时间间隔排列，与播放倍速无关
+        AppendRow(replay_->RecordTime(header.timestampMs));
+        updated = true;
+    }
+
+    if (updated) {
+        PublishSnapshot();
+    }
+    if (replay_->Finished() && !replayFinished_) {
+        std::cerr << "回放结束: 共 " << replay_->GetRecordCount() << " 条记录";
+        if (replay_->GetCorruptBlockCount() > 0) {
+            std::cerr << "，跳过 " << replay_->GetCorruptBlockCount() << " 个损坏的块";
+        }
+        std::cerr << std::endl;
+        replayFinished_ = true;
+    }
+}
+
+void HardwareMonitor::UpdateAttached() {
+    SessionState state{&gpuInfos_, &cpuInfo_, &memoryInfo_, &systemBandwidthInfo_, &diskInfos_, &pressureInfos_};
+    bool inventoryChanged = false;
+    if (!bus_.ReadLatest(state, inventoryChanged)) {
+        return;
+    }
+    if (inventoryChanged) {
+        inventoryVersion_++;
+    }
+    AppendRow(std::chrono::steady_clock::now());
+    PublishSnapshot();
+}
+
+bool HardwareMonitor::StartSnapshotBus(const std::string& name) {
+    busInventoryVersion_ = 0;
+    return bus_.Create(name);
+}
+
+void HardwareMonitor::PublishToBus() {
+    int64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    SessionState state{&gpuInfos_, &cpuInfo_, &memoryInfo_, &systemBandwidthInfo_, &diskInfos_, &pressureInfos_};
+    if (busInventoryVersion_ != inventoryVersion_ && bus_.PublishInventory(state, timestampMs)) {
+        busInventoryVersion_ = inventoryVersion_;
+    }
+    bus_.PublishSample(state, timestampMs);
+}
+
+bool HardwareMonitor::StartRecording(const std::string& path) {
+    recordedInventoryVersion_ = 0;
+    return recorder_.Open(path);
+}
+
+void HardwareMonitor::StopRecording() {
+    recorder_.Close();
+}
+
+void HardwareMonitor::RecordSnapshot() {
+    // 只编码到录制队列的预分配缓冲区，不分配内存、不等待写入线程；队列满时丢弃本次记录
+    int64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    SessionState state{&gpuInfos_, &cpuInfo_, &memoryInfo_, &systemBandwidthInfo_, &diskInfos_, &pressureInfos_};
+
+    // 设备清单变化后先写一条 Inventory，之后的 Sample 才能被解码
+    if (recordedInventoryVersion_ != inventoryVersion_) {
+        uint8_t* buffer = recorder_.BeginRecord();
+        if (buffer == nullptr) {
+            return;
+        }
+        size_t bytes = EncodeSessionRecord(SessionRecordType::Inventory, timestampMs, state,
+                                           buffer, SessionRecorder::kMaxRecordBytes);
+        recorder_.CommitRecord(bytes);
+        if (bytes == 0) {
+            return;
+        }
+        recordedInventoryVersion_ = inventoryVersion_;
+    }
+
+    uint8_t* buffer = recorder_.BeginRecord();
+    if (buffer != nullptr) {
+        recorder_.CommitRecord(EncodeSessionRecord(SessionRecordType::Sample, timestampMs, state,
+                                                   buffer, SessionRecorder::kMaxRecordBytes));
+    }
+}
+
+void HardwareMonitor::PublishSnapshot() {
+    // 写入采样线程独占的缓冲区（复制赋值会复用已有容量，稳定后不再分配内存）
+    snapshotSequence_++;
+    HardwareSnapshot& snapshot = snapshots_.WriteBuffer();
+    FillSnapshot(snapshot);
+    if (historyEnabled_) {
+        // 缓冲区中的历史是几次发布之前的副本，只补上之后追加的行，不整体复制
+        snapshot.series.SyncFrom(series_);
+    }
+    snapshots_.Publish();
+
+    // 其他读端只需要当前数值，不复制历史数据
+    for (TripleBuffer<HardwareSnapshot>* reader : snapshotReaders_) {
+        FillSnapshot(reader->WriteBuffer());
+        reader->Publish();
+    }
+    if (bus_.IsWriter()) {
+        PublishToBus();
+    }
+    if (snapshotListener_) {
+        snapshotListener_();
+    }
+}
+
+void HardwareMonitor::FillSnapshot(HardwareSnapshot& snapshot) {
+    snapshot.sequence = snapshotSequence_;
+    snapshot.inventoryVersion = inventoryVersion_;
+    snapshot.timestamp = std::chrono::steady_clock::now();
+    snapshot.gpus = gpuInfos_;
+    snapshot.cpu = cpuInfo_;
+    snapshot.memory = memoryInfo_;
+    snapshot.bandwidth = systemBandwidthInfo_;
+    snapshot.disks = diskInfos_;
+    snapshot.pressures = pressureInfos_;
+    snapshot.collectors = scheduler_.GetStats();
+}
+
+void HardwareMonitor::AddSnapshotReader(TripleBuffer<HardwareSnapshot>* buffer) {
+    if (buffer != nullptr && !IsRunning()) {
+        snapshotReaders_.push_back(buffer);
+    }
+}
+
+const HardwareSnapshot& HardwareMonitor::AcquireSnapshot(bool* updated) {
+    bool acquired = snapshots_.Acquire();
+    if (updated) {
+        *updated = acquired;
+    }
+    return snapshots_.ReadBuffer();
+}
+
+bool HardwareMonitor::Start() {
+    if (samplerRunning_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    samplerRunning_.store(true, std::memory_order_release);
+    try {
+        samplerThread_ = std::thread(&HardwareMonitor::SamplerLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "采样线程启动失败: " << e.what() << std::endl;
+        samplerRunning_.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void HardwareMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(samplerMutex_);
+        samplerRunning_.store(false, std::memory_order_release);
+    }
+    samplerCv_.notify_all();
+    if (samplerThread_.joinable()) {
+        samplerThread_.join();
+    }
+}
+
+void HardwareMonitor::SamplerLoop() {
+    while (samplerRunning_.load(std::memory_order_acquire)) {
+        Update();
+
+        // 睡眠到下一个采集器到期或下一条回放记录的播放时间（没有待办时也定期醒来检查退出标志）；
+        // 挂载模式没有到期时间，按固定间隔检查总线（只读内存，不需要系统调用）
+        auto now = std::chrono::steady_clock::now();
+        auto due = replay_ ? replay_->NextDeadline()
+                 : IsAttached() ? now + std::chrono::milliseconds(kAttachPollMs)
+                 : scheduler_.NextDeadline();
+        auto nextDeadline = std::min(due, now + std::chrono::seconds(1));
+
+        std::unique_lock<std::mutex> lock(samplerMutex_);
+        samplerCv_.wait_until(lock, nextDeadline, [this] {
+            return !samplerRunning_.load(std::memory_order_acquire);
+        });
+    }
 }
 
 void HardwareMonitor::UpdateGPU() {
@@ -97,25 +586,18 @@ void HardwareMonitor::UpdateGPU() {
 
     for (size_t i = 0; i < gpuInfos_.size(); i++) {
         GPUInfo& gpu = gpuInfos_[i];
-        nvmlDevice_t device;
-        
-        if (nvmlDeviceGetHandleByIndex(i, &device) != NVML_SUCCESS) {
-            gpu.available = false;
+        const GPUDevice& cached = gpuDevices_[i];
+        if (cached.handle == nullptr) {
             continue;
         }
+        nvmlDevice_t device = cached.handle;
 
-        gpu.available = true;
-
-        // 获取GPU名称
-        char name[NVML_DEVICE_NAME_BUFFER_SIZE];
-        if (nvmlDeviceGetName(device, name, NVML_DEVICE_NAME_BUFFER_SIZE) == NVML_SUCCESS) {
-            gpu.name = name;
-        }
-
-        // 获取利用率
+        // 获取利用率（GPU利用率和显存控制器负载来自同一次调用）
         nvmlUtilization_t utilization;
         if (nvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS) {
             gpu.utilization = static_cast<float>(utilization.gpu);
+            // 显存控制器负载（使用显存利用率作为近似值）
+            gpu.memoryControllerLoad = static_cast<float>(utilization.memory);
         }
 
         // 获取显存信息
@@ -123,7 +605,8 @@ void HardwareMonitor::UpdateGPU() {
         if (nvmlDeviceGetMemoryInfo(device, &memory) == NVML_SUCCESS) {
             gpu.memoryTotal = static_cast<float>(memory.total) / (1024.0f * 1024.0f);  // MB
             gpu.memoryUsed = static_cast<float>(memory.used) / (1024.0f * 1024.0f);    // MB
-            gpu.memoryPercent = (gpu.memoryUsed / gpu.memoryTotal) * 100.0f;
+            // 部分虚拟化/MIG 配置下 NVML 报告的总量为 0
+            gpu.memoryPercent = gpu.memoryTotal > 0.0f ? (gpu.memoryUsed / gpu.memoryTotal) * 100.0f : 0.0f;
         }
 
         // 获取温度
@@ -157,10 +640,14 @@ void HardwareMonitor::UpdateGPU() {
             gpu.powerUsage = power / 1000; // 转换为瓦特（NVML返回的是毫瓦）
         }
         
-        // 显存控制器负载（使用显存利用率作为近似值）
-        //nvmlUtilization_t utilization;
-        if (nvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS) {
-            gpu.memoryControllerLoad = static_cast<float>(utilization.memory);
+        // 功耗百分比（最大功耗限制已在初始化时缓存），供界面和诊断直接使用
+        if (cached.hasPowerLimit && cached.maxPowerLimit > 0) {
+            gpu.powerLimit = static_cast<float>(cached.maxPowerLimit) / 1000.0f; // 转换为瓦特
+            gpu.powerPercent = (static_cast<float>(gpu.powerUsage) / gpu.powerLimit) * 100.0f;
+            gpu.powerPercent = std::min(100.0f, std::max(0.0f, gpu.powerPercent));
+        } else {
+            gpu.powerLimit = 0.0f;
+            gpu.powerPercent = 0.0f;
         }
         
         // 视频引擎负载（编码器利用率）
@@ -175,14 +662,9 @@ void HardwareMonitor::UpdateGPU() {
         // 电压与功耗的关系：P = V^2 / R，因此 V ≈ sqrt(P * R)
         // 这里使用简化的线性关系进行估算
         
-        // 获取功耗限制（用于估算最大电压）
-        unsigned int minPowerLimit = 0;
-        unsigned int maxPowerLimit = 0;
-        bool hasPowerLimit = false;
-        
-        if (nvmlDeviceGetPowerManagementLimitConstraints(device, &minPowerLimit, &maxPowerLimit) == NVML_SUCCESS) {
-            hasPowerLimit = true;
-        }
+        // 功耗限制（用于估算最大电压，已在初始化时缓存）
+        unsigned int maxPowerLimit = cached.maxPowerLimit;
+        bool hasPowerLimit = cached.hasPowerLimit;
         
         // 估算最大电压（单位：V）
         // 大多数现代GPU的最大电压在1.0-1.2V之间
@@ -204,10 +686,8 @@ void HardwareMonitor::UpdateGPU() {
             // 假设：功耗与电压的平方成正比（P = V^2 / R）
             // 简化：V ≈ V_max * sqrt(P / P_max)
             float powerPercent = 0.0f;
-            if (hasPowerLimit && maxPowerLimit > 0) {
-                float maxPowerW = static_cast<float>(maxPowerLimit) / 1000.0f;
-                powerPercent = (static_cast<float>(gpu.powerUsage) / maxPowerW) * 100.0f;
-                powerPercent = std::min(100.0f, std::max(0.0f, powerPercent));
+            if (gpu.powerLimit > 0.0f) {
+                powerPercent = gpu.powerPercent;
             } else {
                 // 如果没有功耗限制，使用简化的线性关系
                 // 假设：功耗在0-100%时，电压在0.8-1.0V
@@ -355,250 +835,10 @@ void HardwareMonitor::UpdateGPU() {
             }
         }
 
-        // 更新历史数据
-        gpu.utilizationHistory.push_back(gpu.utilization);
-        gpu.memoryHistory.push_back(gpu.memoryPercent);
-        gpu.temperatureHistory.push_back(gpu.temperature);
-        gpu.pcieRxHistory.push_back(gpu.pcieRxThroughput);
-        gpu.pcieTxHistory.push_back(gpu.pcieTxThroughput);
-        gpu.transferWaitHistory.push_back(gpu.dataTransferWaitTime);
-
-        if (gpu.utilizationHistory.size() > GPUInfo::MAX_HISTORY) {
-            gpu.utilizationHistory.erase(gpu.utilizationHistory.begin());
-            gpu.memoryHistory.erase(gpu.memoryHistory.begin());
-            gpu.temperatureHistory.erase(gpu.temperatureHistory.begin());
-            gpu.pcieRxHistory.erase(gpu.pcieRxHistory.begin());
-            gpu.pcieTxHistory.erase(gpu.pcieTxHistory.begin());
-            gpu.transferWaitHistory.erase(gpu.transferWaitHistory.begin());
-        }
     }
 }
 
-void HardwareMonitor::UpdateCPU() {
-    // 使用PDH获取CPU利用率
-    PDH_FMT_COUNTERVALUE counterVal;
-    PdhCollectQueryData(cpuQuery_);
-    
-    if (PdhGetFormattedCounterValue(cpuCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
-        cpuInfo_.utilization = static_cast<float>(counterVal.doubleValue);
-    }
-
-    // 更新历史数据
-    cpuInfo_.utilizationHistory.push_back(cpuInfo_.utilization);
-    if (cpuInfo_.utilizationHistory.size() > CPUInfo::MAX_HISTORY) {
-        cpuInfo_.utilizationHistory.erase(cpuInfo_.utilizationHistory.begin());
-    }
-}
-
-void HardwareMonitor::UpdateMemory() {
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    GlobalMemoryStatusEx(&memInfo);
-
-    memoryInfo_.total = static_cast<float>(memInfo.ullTotalPhys) / (1024.0f * 1024.0f * 1024.0f);  // GB
-    memoryInfo_.available = static_cast<float>(memInfo.ullAvailPhys) / (1024.0f * 1024.0f * 1024.0f);  // GB
-    memoryInfo_.used = memoryInfo_.total - memoryInfo_.available;
-    memoryInfo_.percent = static_cast<float>(memInfo.dwMemoryLoad);
-
-    // 更新历史数据
-    memoryInfo_.percentHistory.push_back(memoryInfo_.percent);
-    if (memoryInfo_.percentHistory.size() > MemoryInfo::MAX_HISTORY) {
-        memoryInfo_.percentHistory.erase(memoryInfo_.percentHistory.begin());
-    }
-}
-
-void HardwareMonitor::UpdateMemoryModules() {
-    // 使用WMI获取真实的内存条信息
-    static bool wmiInitialized = false;
-    static bool wmiAvailable = false;
-    
-    if (!wmiInitialized) {
-        // 尝试初始化WMI（只初始化一次）
-        HRESULT hres = CoInitializeEx(0, COINIT_MULTITHREADED);
-        if (SUCCEEDED(hres) || hres == RPC_E_CHANGED_MODE) {
-            hres = CoInitializeSecurity(NULL, -1, NULL, NULL,
-                RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
-                NULL, EOAC_NONE, NULL);
-            wmiAvailable = (SUCCEEDED(hres) || hres == RPC_E_TOO_LATE);
-        }
-        wmiInitialized = true;
-    }
-    
-    bool modulesUpdated = false;
-    
-    if (wmiAvailable) {
-        // 使用WMI获取内存条信息
-        IWbemLocator* pLoc = nullptr;
-        HRESULT hres = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
-            IID_IWbemLocator, (LPVOID*)&pLoc);
-        
-        if (SUCCEEDED(hres)) {
-            IWbemServices* pSvc = nullptr;
-            hres = pLoc->ConnectServer(_bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &pSvc);
-            
-            if (SUCCEEDED(hres)) {
-                hres = CoSetProxyBlanket(pSvc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
-                    RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
-                
-                if (SUCCEEDED(hres)) {
-                    IEnumWbemClassObject* pEnumerator = nullptr;
-                    hres = pSvc->ExecQuery(bstr_t("WQL"),
-                        bstr_t("SELECT Capacity, Speed, MemoryType, DeviceLocator FROM Win32_PhysicalMemory"),
-                        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL, &pEnumerator);
-                    
-                    if (SUCCEEDED(hres)) {
-                        memoryInfo_.modules.clear();
-                        IWbemClassObject* pclsObj = nullptr;
-                        ULONG uReturn = 0;
-                        size_t moduleIndex = 0;
-                        
-                        while (pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn) == WBEM_S_NO_ERROR && uReturn > 0) {
-                            MemoryModuleInfo module;
-                            
-                            // 获取容量
-                            VARIANT vtProp;
-                            if (SUCCEEDED(pclsObj->Get(L"Capacity", 0, &vtProp, 0, 0))) {
-                                if (vtProp.vt == VT_BSTR) {
-                                    unsigned long long capacity = _wtoi64(vtProp.bstrVal);
-                                    module.capacity = static_cast<float>(capacity) / (1024.0f * 1024.0f * 1024.0f); // GB
-                                } else if (vtProp.vt == VT_I8 || vtProp.vt == VT_UI8) {
-                                    module.capacity = static_cast<float>(vtProp.ullVal) / (1024.0f * 1024.0f * 1024.0f); // GB
-                                }
-                                VariantClear(&vtProp);
-                            }
-                            
-                            // 获取速度
-                            if (SUCCEEDED(pclsObj->Get(L"Speed", 0, &vtProp, 0, 0))) {
-                                if (vtProp.vt == VT_UI4) {
-                                    module.speed = vtProp.ulVal;
-                                } else if (vtProp.vt == VT_UI2) {
-                                    module.speed = vtProp.uiVal;
-                                }
-                                VariantClear(&vtProp);
-                            }
-                            
-                            // 获取内存类型
-                            if (SUCCEEDED(pclsObj->Get(L"MemoryType", 0, &vtProp, 0, 0))) {
-                                unsigned int memType = 0;
-                                if (vtProp.vt == VT_UI2) {
-                                    memType = vtProp.uiVal;
-                                } else if (vtProp.vt == VT_UI4) {
-                                    memType = vtProp.ulVal;
-                                }
-                                
-                                // 转换内存类型代码为字符串
-                                switch (memType) {
-                                case 20: module.type = "DDR"; break;
-                                case 21: module.type = "DDR2"; break;
-                                case 24: module.type = "DDR3"; break;
-                                case 26: module.type = "DDR4"; break;
-                                case 34: case 35: module.type = "DDR5"; break;
-                                default: module.type = "Unknown"; break;
-                                }
-                                VariantClear(&vtProp);
-                            }
-                            
-                            // 获取设备位置
-                            if (SUCCEEDED(pclsObj->Get(L"DeviceLocator", 0, &vtProp, 0, 0))) {
-                                if (vtProp.vt == VT_BSTR && vtProp.bstrVal) {
-                                    _bstr_t bstrLocator(vtProp.bstrVal);
-                                    char* pLocator = bstrLocator;
-                                    if (pLocator) {
-                                        module.name = std::string(pLocator);
-                                    } else {
-                                        module.name = "内存条 " + std::to_string(moduleIndex + 1);
-                                    }
-                                } else {
-                                    module.name = "内存条 " + std::to_string(moduleIndex + 1);
-                                }
-                                VariantClear(&vtProp);
-                            } else {
-                                module.name = "内存条 " + std::to_string(moduleIndex + 1);
-                            }
-                            
-                            // 估算通道（基于索引，假设双通道）
-                            module.channel = static_cast<unsigned int>(moduleIndex % 2);
-                            
-                            // 如果没有获取到速度，使用默认值
-                            if (module.speed == 0) {
-                                if (module.type == "DDR5") {
-                                    module.speed = 4800;
-                                } else if (module.type == "DDR4") {
-                                    module.speed = 3200;
-                                } else if (module.type == "DDR3") {
-                                    module.speed = 1600;
-                                } else {
-                                    module.speed = 2400;
-                                }
-                            }
-                            
-                            // 计算单条内存的最大带宽
-                            // 单通道带宽 = 速度(MHz) * 64bit / 8 / 1000
-                            module.maxBandwidth = (static_cast<float>(module.speed) * 64.0f) / 8.0f / 1000.0f; // GB/s
-                            
-                            memoryInfo_.modules.push_back(module);
-                            moduleIndex++;
-                            
-                            pclsObj->Release();
-                        }
-                        
-                        pEnumerator->Release();
-                        modulesUpdated = true;
-                    }
-                    
-                    pSvc->Release();
-                }
-                
-                pLoc->Release();
-            }
-        }
-    }
-    
-    // 如果WMI失败或未初始化，使用估算方法
-    if (!modulesUpdated) {
-        MEMORYSTATUSEX memInfo;
-        memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-        GlobalMemoryStatusEx(&memInfo);
-        
-        float totalMemGB = static_cast<float>(memInfo.ullTotalPhys) / (1024.0f * 1024.0f * 1024.0f);
-        
-        // 估算内存条数量（假设每个内存条8GB或16GB）
-        size_t estimatedModuleCount = 0;
-        if (totalMemGB >= 64.0f) {
-            estimatedModuleCount = static_cast<size_t>(totalMemGB / 16.0f + 0.5f);
-        } else if (totalMemGB >= 32.0f) {
-            estimatedModuleCount = static_cast<size_t>(totalMemGB / 8.0f + 0.5f);
-        } else {
-            estimatedModuleCount = static_cast<size_t>(totalMemGB / 4.0f + 0.5f);
-        }
-        
-        estimatedModuleCount = std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(8), estimatedModuleCount));
-        
-        // 只在数量变化时重新初始化
-        if (memoryInfo_.modules.size() != estimatedModuleCount) {
-            memoryInfo_.modules.resize(estimatedModuleCount);
-            for (size_t i = 0; i < estimatedModuleCount; i++) {
-                MemoryModuleInfo& module = memoryInfo_.modules[i];
-                module.name = "内存条 " + std::to_string(i + 1);
-                module.capacity = totalMemGB / static_cast<float>(estimatedModuleCount);
-                module.channel = static_cast<unsigned int>(i % 2);
-                
-                if (totalMemGB >= 64.0f) {
-                    module.speed = 4800;
-                    module.type = "DDR5";
-                } else if (totalMemGB >= 32.0f) {
-                    module.speed = 3200;
-                    module.type = "DDR4";
-                } else {
-                    module.speed = 2400;
-                    module.type = "DDR4";
-                }
-                
-                module.maxBandwidth = (static_cast<float>(module.speed) * 64.0f) / 8.0f / 1000.0f;
-            }
-        }
-    }
-    
+void HardwareMonitor::UpdateMemoryModuleBandwidth() {
     // 更新每个内存条的实时带宽和利用率
     float memPercent = memoryInfo_.percent;
     float cpuUtil = cpuInfo_.utilization;
@@ -624,137 +864,6 @@ void HardwareMonitor::UpdateMemoryModules() {
         
         module.realTimeBandwidth = module.maxBandwidth * activityFactor;
         module.utilization = activityFactor * 100.0f;
-        
-        // 更新历史数据
-        module.bandwidthHistory.push_back(module.realTimeBandwidth);
-        if (module.bandwidthHistory.size() > MemoryModuleInfo::MAX_HISTORY) {
-            module.bandwidthHistory.erase(module.bandwidthHistory.begin());
-        }
-    }
-}
-
-void HardwareMonitor::UpdateDisks() {
-    // 初始化磁盘查询（如果尚未初始化）
-    if (diskQuery_ == nullptr) {
-        PdhOpenQuery(nullptr, NULL, &diskQuery_);
-        
-        // 枚举所有逻辑磁盘
-        DWORD bufferSize = 0;
-        GetLogicalDriveStrings(bufferSize, nullptr);
-        bufferSize += 1;
-        std::vector<char> driveBuffer(bufferSize);
-        GetLogicalDriveStrings(bufferSize, driveBuffer.data());
-        
-        diskInfos_.clear();
-        diskCounters_.clear();
-        
-        for (char* drive = driveBuffer.data(); *drive; drive += strlen(drive) + 1) {
-            UINT driveType = GetDriveTypeA(drive);
-            if (driveType == DRIVE_FIXED) { // 只监控固定磁盘
-                DiskInfo disk;
-                disk.name = std::string(1, drive[0]) + ":";
-                
-                // 获取磁盘容量
-                ULARGE_INTEGER freeBytes, totalBytes;
-                if (GetDiskFreeSpaceExA(drive, nullptr, &totalBytes, &freeBytes)) {
-                    disk.totalSize = static_cast<float>(totalBytes.QuadPart) / (1024.0f * 1024.0f * 1024.0f); // GB
-                }
-                
-                // 估算磁盘类型和最大带宽
-                if (disk.totalSize > 1000.0f) {
-                    // 大容量，可能是HDD
-                    disk.type = "HDD";
-                    disk.model = "机械硬盘";
-                    disk.maxReadBandwidth = 0.2f;  // GB/s
-                    disk.maxWriteBandwidth = 0.15f; // GB/s
-                } else {
-                    // 较小容量，可能是SSD
-                    disk.type = "SSD";
-                    disk.model = "固态硬盘";
-                    disk.maxReadBandwidth = 3.5f;  // GB/s (NVMe PCIe 3.0估算)
-                    disk.maxWriteBandwidth = 2.5f; // GB/s
-                }
-                
-                diskInfos_.push_back(disk);
-                
-                // 创建PDH计数器 - 使用正确的路径格式
-                DiskCounter counter;
-                counter.diskName = disk.name;
-                
-                // PDH路径格式: \PhysicalDisk(0 C:)\Disk Read Bytes/sec
-                char driveLetter = drive[0];
-                std::string readPath = "\\PhysicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Read Bytes/sec";
-                std::string writePath = "\\PhysicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Write Bytes/sec";
-                
-                // 尝试添加计数器，如果失败则跳过
-                PDH_STATUS status1 = PdhAddCounterA(diskQuery_, readPath.c_str(), NULL, &counter.readCounter);
-                PDH_STATUS status2 = PdhAddCounterA(diskQuery_, writePath.c_str(), NULL, &counter.writeCounter);
-                
-                if (status1 == ERROR_SUCCESS && status2 == ERROR_SUCCESS) {
-                    diskCounters_.push_back(counter);
-                } else {
-                    // 如果PDH路径失败，尝试使用逻辑磁盘路径
-                    readPath = "\\LogicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Read Bytes/sec";
-                    writePath = "\\LogicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Write Bytes/sec";
-                    
-                    counter.readCounter = nullptr;
-                    counter.writeCounter = nullptr;
-                    status1 = PdhAddCounterA(diskQuery_, readPath.c_str(), NULL, &counter.readCounter);
-                    status2 = PdhAddCounterA(diskQuery_, writePath.c_str(), NULL, &counter.writeCounter);
-                    
-                    if (status1 == ERROR_SUCCESS && status2 == ERROR_SUCCESS) {
-                        diskCounters_.push_back(counter);
-                    }
-                }
-            }
-        }
-        
-        if (diskQuery_ != nullptr && !diskCounters_.empty()) {
-            PdhCollectQueryData(diskQuery_);
-        }
-    }
-    
-    // 更新磁盘IO数据
-    if (diskQuery_ != nullptr && !diskCounters_.empty()) {
-        PdhCollectQueryData(diskQuery_);
-        
-        for (size_t i = 0; i < diskInfos_.size() && i < diskCounters_.size(); i++) {
-            DiskInfo& disk = diskInfos_[i];
-            DiskCounter& counter = diskCounters_[i];
-            
-            // 读取读取速度
-            if (counter.readCounter != nullptr) {
-                PDH_FMT_COUNTERVALUE readValue;
-                if (PdhGetFormattedCounterValue(counter.readCounter, PDH_FMT_DOUBLE, NULL, &readValue) == ERROR_SUCCESS) {
-                    // 转换为GB/s
-                    disk.realTimeReadBandwidth = static_cast<float>(readValue.doubleValue) / (1024.0f * 1024.0f * 1024.0f);
-                    disk.readUtilization = (disk.maxReadBandwidth > 0.0f) ? 
-                        (disk.realTimeReadBandwidth / disk.maxReadBandwidth * 100.0f) : 0.0f;
-                }
-            }
-            
-            // 读取写入速度
-            if (counter.writeCounter != nullptr) {
-                PDH_FMT_COUNTERVALUE writeValue;
-                if (PdhGetFormattedCounterValue(counter.writeCounter, PDH_FMT_DOUBLE, NULL, &writeValue) == ERROR_SUCCESS) {
-                    // 转换为GB/s
-                    disk.realTimeWriteBandwidth = static_cast<float>(writeValue.doubleValue) / (1024.0f * 1024.0f * 1024.0f);
-                    disk.writeUtilization = (disk.maxWriteBandwidth > 0.0f) ? 
-                        (disk.realTimeWriteBandwidth / disk.maxWriteBandwidth * 100.0f) : 0.0f;
-                }
-            }
-            
-            // 更新历史数据
-            disk.readBandwidthHistory.push_back(disk.realTimeReadBandwidth);
-            disk.writeBandwidthHistory.push_back(disk.realTimeWriteBandwidth);
-            
-            if (disk.readBandwidthHistory.size() > DiskInfo::MAX_HISTORY) {
-                disk.readBandwidthHistory.erase(disk.readBandwidthHistory.begin());
-            }
-            if (disk.writeBandwidthHistory.size() > DiskInfo::MAX_HISTORY) {
-                disk.writeBandwidthHistory.erase(disk.writeBandwidthHistory.begin());
-            }
-        }
     }
 }
 
@@ -781,11 +890,7 @@ void HardwareMonitor::UpdateSystemBandwidth() {
     systemBandwidthInfo_.pcieTotalBandwidth = totalPcieMaxBandwidth;
 
     // ========== 2. 内存带宽（CPU 与 RAM 的桥梁）==========
-    MEMORYSTATUSEX memInfo;
-    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
-    GlobalMemoryStatusEx(&memInfo);
-    
-    float totalMemGB = static_cast<float>(memInfo.ullTotalPhys) / (1024.0f * 1024.0f * 1024.0f);
+    float totalMemGB = memoryInfo_.total;   // 已在 Memory 采集器中更新
     
     // 估算最大内存带宽（基于内存类型和速度）
     // DDR4-3200 双通道 ≈ 51.2 GB/s, DDR5-4800 双通道 ≈ 76.8 GB/s
@@ -823,28 +928,17 @@ void HardwareMonitor::UpdateSystemBandwidth() {
     systemBandwidthInfo_.cpuBandwidth = memoryMaxBW * 1.2f; // CPU带宽估算
 
     // ========== 3. 存储/IO 带宽（硬盘与内存的桥梁）==========
-    // 估算存储最大带宽（基于常见存储接口）
-    // SATA3 ≈ 0.6 GB/s, NVMe PCIe 3.0 x4 ≈ 3.5 GB/s, NVMe PCIe 4.0 x4 ≈ 7.0 GB/s
-    // 这里使用保守估算，假设是NVMe PCIe 3.0
-    systemBandwidthInfo_.storageMaxBandwidth = 3.5f; // GB/s (保守估算)
-    
-    // 估算实时存储带宽（基于内存活动）
-    // 存储带宽利用率与内存使用率相关（内存不足时会频繁读写磁盘）
-      memPercent = memoryInfo_.percent; // 已在UpdateMemory中更新
-    float storageActivityFactor = 0.0f;
-    if (memPercent > 90.0f) {
-        // 内存接近满载，可能有频繁的Swap操作
-        storageActivityFactor = 0.3f + (memPercent - 90.0f) / 10.0f * 0.4f; // 30%-70%
-    } else if (memPercent > 80.0f) {
-        // 内存使用较高，可能有少量IO
-        storageActivityFactor = 0.1f + (memPercent - 80.0f) / 10.0f * 0.2f; // 10%-30%
-    } else {
-        // 内存充足，IO活动较少
-        storageActivityFactor = memPercent / 80.0f * 0.1f; // 0%-10%
+    // 最大带宽为各磁盘按接口类型估算的带宽之和
+    float storageMaxBW = 0.0f;
+    for (const auto& disk : diskInfos_) {
+        storageMaxBW += std::max(disk.maxReadBandwidth, disk.maxWriteBandwidth);
     }
-    
-    systemBandwidthInfo_.storageRealTimeBandwidth = systemBandwidthInfo_.storageMaxBandwidth * storageActivityFactor;
-    systemBandwidthInfo_.storageUtilization = storageActivityFactor * 100.0f;
+    systemBandwidthInfo_.storageMaxBandwidth = storageMaxBW;
+
+    // 实时带宽为实测的换页读写量（页缓存读入、脏页写回、换入换出），已在 Memory 采集器中更新
+    systemBandwidthInfo_.storageRealTimeBandwidth = (memoryInfo_.pageInRate + memoryInfo_.pageOutRate) / 1024.0f; // 转换为GB/s
+    systemBandwidthInfo_.storageUtilization = (storageMaxBW > 0.0f) ?
+        std::min(100.0f, systemBandwidthInfo_.storageRealTimeBandwidth / storageMaxBW * 100.0f) : 0.0f;
 
     // ========== 4. 显存带宽（GPU 内部带宽 - 极重要）==========
     float totalVramMaxBandwidth = 0.0f;
@@ -854,9 +948,8 @@ void HardwareMonitor::UpdateSystemBandwidth() {
         if (gpu.available && gpu.memoryClock > 0) {
             // 显存带宽计算公式：带宽(GB/s) = 显存时钟(MHz) * 位宽(bits) / 8 / 1000
             // 常见GPU显存位宽：128bit, 192bit, 256bit, 320bit, 384bit
-            // 这里使用估算值，基于显存时钟频率
-            // 假设位宽为256bit（常见的中高端GPU）
-            unsigned int memoryBusWidth = 256; // bits (估算值)
+            // 优先使用 NVML 报告的位宽，不可用时假设为256bit（常见的中高端GPU）
+            unsigned int memoryBusWidth = gpu.memoryBusWidth > 0 ? gpu.memoryBusWidth : 256; // bits
             float vramMaxBW = (static_cast<float>(gpu.memoryClock) * memoryBusWidth) / 8.0f / 1000.0f; // GB/s
             
             totalVramMaxBandwidth += vramMaxBW;
@@ -879,75 +972,37 @@ void HardwareMonitor::UpdateSystemBandwidth() {
         systemBandwidthInfo_.memoryMaxBandwidth + 
         systemBandwidthInfo_.storageMaxBandwidth + 
         systemBandwidthInfo_.vramMaxBandwidth;
-
-    // ========== 更新历史数据 ==========
-    systemBandwidthInfo_.totalBandwidthHistory.push_back(systemBandwidthInfo_.totalSystemBandwidth);
-    systemBandwidthInfo_.cpuBandwidthHistory.push_back(systemBandwidthInfo_.cpuBandwidth);
-    systemBandwidthInfo_.memoryBandwidthHistory.push_back(systemBandwidthInfo_.memoryMaxBandwidth);
-    systemBandwidthInfo_.pcieBandwidthHistory.push_back(systemBandwidthInfo_.pcieRealTimeBandwidth);
-    systemBandwidthInfo_.storageBandwidthHistory.push_back(systemBandwidthInfo_.storageRealTimeBandwidth);
-    systemBandwidthInfo_.vramBandwidthHistory.push_back(systemBandwidthInfo_.vramRealTimeBandwidth);
-    
-    // 限制历史数据大小
-    if (systemBandwidthInfo_.totalBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.totalBandwidthHistory.erase(systemBandwidthInfo_.totalBandwidthHistory.begin());
-    }
-    if (systemBandwidthInfo_.cpuBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.cpuBandwidthHistory.erase(systemBandwidthInfo_.cpuBandwidthHistory.begin());
-    }
-    if (systemBandwidthInfo_.memoryBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.memoryBandwidthHistory.erase(systemBandwidthInfo_.memoryBandwidthHistory.begin());
-    }
-    if (systemBandwidthInfo_.pcieBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.pcieBandwidthHistory.erase(systemBandwidthInfo_.pcieBandwidthHistory.begin());
-    }
-    if (systemBandwidthInfo_.storageBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.storageBandwidthHistory.erase(systemBandwidthInfo_.storageBandwidthHistory.begin());
-    }
-    if (systemBandwidthInfo_.vramBandwidthHistory.size() > SystemBandwidthInfo::MAX_HISTORY) {
-        systemBandwidthInfo_.vramBandwidthHistory.erase(systemBandwidthInfo_.vramBandwidthHistory.begin());
-    }
 }
 
 void HardwareMonitor::Shutdown() {
+    // 先停止采样线程，再释放采集资源
+    Stop();
+    recorder_.Close();
+    bus_.Close();
+
     if (nvmlInitialized_) {
         nvmlShutdown();
         nvmlInitialized_ = false;
     }
 
-    if (cpuQuery_) {
-        PdhCloseQuery(cpuQuery_);
-        cpuQuery_ = nullptr;
-    }
-    
-    if (diskQuery_) {
-        // 关闭所有磁盘计数器
-        for (auto& counter : diskCounters_) {
-            if (counter.readCounter) {
-                PdhRemoveCounter(counter.readCounter);
-            }
-            if (counter.writeCounter) {
-                PdhRemoveCounter(counter.writeCounter);
-            }
-        }
-        diskCounters_.clear();
-        PdhCloseQuery(diskQuery_);
-        diskQuery_ = nullptr;
+    if (host_) {
+        host_->Shutdown();
+        host_.reset();
     }
 }
 
-const GPUInfo& HardwareMonitor::GetGPUInfo(int index) const {
-    static GPUInfo empty;
-    if (index >= 0 && index < static_cast<int>(gpuInfos_.size())) {
-        return gpuInfos_[index];
+const GPUInfo& HardwareSnapshot::GetGPUInfo(int index) const {
+    static const GPUInfo empty;
+    if (index >= 0 && index < static_cast<int>(gpus.size())) {
+        return gpus[index];
     }
     return empty;
 }
 
-const DiskInfo& HardwareMonitor::GetDiskInfo(size_t index) const {
-    static DiskInfo empty;
-    if (index < diskInfos_.size()) {
-        return diskInfos_[index];
+const DiskInfo& HardwareSnapshot::GetDiskInfo(size_t index) const {
+    static const DiskInfo empty;
+    if (index < disks.size()) {
+        return disks[index];
     }
     return empty;
 }
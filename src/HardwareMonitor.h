@@ -1,10 +1,15 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
-#include <windows.h>
-#include <pdh.h>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,6 +19,17 @@ extern "C" {
 }
 #endif
 
+#include "TripleBuffer.h"
+#include "SamplingScheduler.h"
+#include "SeriesStore.h"
+#include "HistoryArchive.h"
+#include "SessionRecorder.h"
+#include "SnapshotBus.h"
+
+class HostCollector;
+class SessionReplay;
+struct SessionState;
+
 struct GPUInfo {
     float utilization = 0.0f;          // GPU利用率 (%)
     float memoryUsed = 0.0f;           // 显存使用 (MB)
@@ -21,13 +37,23 @@ struct GPUInfo {
     float memoryPercent = 0.0f;        // 显存使用百分比
     float temperature = 0.0f;          // 温度 (°C)
     std::string name = "Unknown";      // GPU名称
+    std::string uuid;                  // GPU UUID
     bool available = false;
     
+    // 静态规格（初始化时读取一次）
+    unsigned int maxGpuClock = 0;          // 最大GPU时钟频率 (MHz)
+    unsigned int maxMemoryClock = 0;       // 最大显存时钟频率 (MHz)
+    unsigned int pcieMaxLinkGeneration = 0; // 最大PCIe代数
+    unsigned int pcieMaxLinkWidth = 0;     // 最大PCIe链路宽度 (lanes)
+    unsigned int memoryBusWidth = 0;       // 显存位宽 (bits)，0 表示未知
+    
     // GPU-Z Sessions 风格的数据
     unsigned int gpuClock = 0;         // GPU时钟频率 (MHz)
     unsigned int memoryClock = 0;      // 显存时钟频率 (MHz)
     unsigned int fanSpeed = 0;         // 风扇转速 (%)
     unsigned int powerUsage = 0;       // 功耗 (W) - 如果可用
+    float powerLimit = 0.0f;           // 最大功耗限制 (W)，0 表示不可用
+    float powerPercent = 0.0f;         // 功耗占最大功耗限制的百分比 (%)
     float memoryControllerLoad = 0.0f; // 显存控制器负载 (%)
     float videoEngineLoad = 0.0f;     // 视频引擎负载 (%) - 如果可用
     
@@ -46,24 +72,61 @@ struct GPUInfo {
     // 数据传输等待时间（毫秒）
     float dataTransferWaitTime = 0.0f; // CPU到GPU数据传输等待时间
     
-    // 历史数据用于绘制图表
-    std::vector<float> utilizationHistory;
-    std::vector<float> memoryHistory;
-    std::vector<float> temperatureHistory;
-    std::vector<float> pcieRxHistory;
-    std::vector<float> pcieTxHistory;
-    std::vector<float> transferWaitHistory;
-    static constexpr size_t MAX_HISTORY = 120;  // 保存2分钟的数据（1秒更新）
+    // 派生指标（每个新样本落地后由 HardwareMonitor::UpdateDerived 计算一次，见 HardwareMonitor.cpp 中的定义表）
+    float pcieThroughput = 0.0f;       // PCIe 接收+发送合计 (MB/s)
+    float pcieUtilization = 0.0f;      // PCIe 吞吐量占链路带宽的百分比 (%)
+    float memoryUsedGB = 0.0f;         // 显存使用 (GB)
+    float transferWaitPercent = 0.0f;  // 传输等待时间相对 10ms 参考值的百分比 (%)，越低越好
+    
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId utilizationSeries = kInvalidMetric;
+    MetricId memorySeries = kInvalidMetric;
+    MetricId temperatureSeries = kInvalidMetric;
+    MetricId pcieRxSeries = kInvalidMetric;
+    MetricId pcieTxSeries = kInvalidMetric;
+    MetricId transferWaitSeries = kInvalidMetric;
+    MetricId powerSeries = kInvalidMetric;          // 功耗 (W)
+    MetricId powerPercentSeries = kInvalidMetric;
+    MetricId pcieThroughputSeries = kInvalidMetric; // 以下为派生指标
+    MetricId pcieUtilizationSeries = kInvalidMetric;
+    MetricId memoryUsedGBSeries = kInvalidMetric;
+    MetricId transferWaitPercentSeries = kInvalidMetric;
+};
+
+// 逻辑 CPU 的拓扑位置（静态清单）
+struct LogicalCpuInfo {
+    unsigned int id = 0;               // 逻辑 CPU 编号（Linux 的 cpuN，Windows 的处理器编号）
+    unsigned int socket = 0;           // 物理插槽
+    unsigned int core = 0;             // 插槽内的物理核心编号
+    unsigned int thread = 0;           // 同一物理核心内的超线程序号（0 为第一个）
+    float maxFrequency = 0.0f;         // 最大频率 (MHz)，0 表示未知
 };
 
 struct CPUInfo {
     float utilization = 0.0f;          // CPU利用率 (%)
-    std::vector<float> coreUtilization; // 每个核心的利用率
-    float temperature = 0.0f;          // CPU温度（如果可获取）
+    // 逻辑 CPU 按 (插槽, 物理核心, 超线程) 排序，同一物理核心的超线程相邻
+    std::vector<LogicalCpuInfo> logicalCpus;
+    std::vector<float> coreUtilization; // 每个逻辑 CPU 的利用率 (%)，与 logicalCpus 一一对应
+    float maxCoreUtilization = 0.0f;   // 最忙的逻辑 CPU 的利用率 (%)，单线程瓶颈在总利用率中看不出来
+
+    // 频率、温度和降频（取不到时保持 0）
+    std::vector<float> coreFrequency;  // 每个逻辑 CPU 的当前频率 (MHz)，与 logicalCpus 一一对应
+    float frequency = 0.0f;            // 逻辑 CPU 的平均频率 (MHz)
+    float frequencyPercent = 0.0f;     // 平均频率占最大频率的百分比（派生）
+    float temperature = 0.0f;          // 插槽温度，多插槽时取最高 (°C)
+    float maxCoreTemperature = 0.0f;   // 最热的物理核心的温度 (°C)
+    float throttleRate = 0.0f;         // 温控降频事件速率 (次/秒)，核心和插槽计数合计
+    bool throttled = false;            // 本次采样是否处于降频状态（派生）：有降频事件，或负载高时频率明显低于最大频率
     
-    // 历史数据
-    std::vector<float> utilizationHistory;
-    static constexpr size_t MAX_HISTORY = 120;
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId utilizationSeries = kInvalidMetric;
+    MetricId maxCoreUtilizationSeries = kInvalidMetric;
+    MetricId frequencySeries = kInvalidMetric;
+    MetricId frequencyPercentSeries = kInvalidMetric;
+    MetricId temperatureSeries = kInvalidMetric;
+    MetricId maxCoreTemperatureSeries = kInvalidMetric;
+    MetricId throttleRateSeries = kInvalidMetric;
+    MetricId throttledSeries = kInvalidMetric;
 };
 
 struct MemoryModuleInfo {
@@ -78,9 +141,8 @@ struct MemoryModuleInfo {
     float realTimeBandwidth = 0.0f;    // 实时带宽 (GB/s)
     float utilization = 0.0f;          // 利用率 (%)
     
-    // 历史数据
-    std::vector<float> bandwidthHistory;
-    static constexpr size_t MAX_HISTORY = 120;
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId bandwidthSeries = kInvalidMetric;
 };
 
 struct MemoryInfo {
@@ -88,13 +150,28 @@ struct MemoryInfo {
     float total = 0.0f;                // 总内存 (GB)
     float percent = 0.0f;              // 使用百分比
     float available = 0.0f;            // 可用内存 (GB)
+
+    // 换页和页缓存活动（取不到时保持 0）：数据集缓存超出内存时先表现为主缺页和换入换出，而不是使用率
+    float pageInRate = 0.0f;           // 从磁盘读入内存 (MB/s)，包含页缓存读入和换入
+    float pageOutRate = 0.0f;          // 从内存写回磁盘 (MB/s)，包含脏页写回和换出
+    float swapInRate = 0.0f;           // 换入 (MB/s)
+    float swapOutRate = 0.0f;          // 换出 (MB/s)
+    float majorFaultRate = 0.0f;       // 需要读磁盘的缺页 (次/秒)
+    float dirty = 0.0f;                // 等待写回的脏页 (MB)
+    float writeback = 0.0f;            // 正在写回的页 (MB)
     
     // 多个内存条信息
     std::vector<MemoryModuleInfo> modules;
     
-    // 历史数据
-    std::vector<float> percentHistory;
-    static constexpr size_t MAX_HISTORY = 120;
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId percentSeries = kInvalidMetric;
+    MetricId pageInSeries = kInvalidMetric;
+    MetricId pageOutSeries = kInvalidMetric;
+    MetricId swapInSeries = kInvalidMetric;
+    MetricId swapOutSeries = kInvalidMetric;
+    MetricId majorFaultSeries = kInvalidMetric;
+    MetricId dirtySeries = kInvalidMetric;
+    MetricId writebackSeries = kInvalidMetric;
 };
 
 struct DiskInfo {
@@ -111,10 +188,9 @@ struct DiskInfo {
     float readUtilization = 0.0f;     // 读取利用率 (%)
     float writeUtilization = 0.0f;     // 写入利用率 (%)
     
-    // 历史数据
-    std::vector<float> readBandwidthHistory;
-    std::vector<float> writeBandwidthHistory;
-    static constexpr size_t MAX_HISTORY = 120;
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId readBandwidthSeries = kInvalidMetric;
+    MetricId writeBandwidthSeries = kInvalidMetric;
 };
 
 struct SystemBandwidthInfo {
@@ -131,8 +207,8 @@ struct SystemBandwidthInfo {
     float memoryUtilization = 0.0f;     // 内存利用率 (%)
     
     // 存储/IO 带宽（硬盘与内存的桥梁）
-    float storageMaxBandwidth = 0.0f;    // 存储最大带宽 (GB/s) - 估算值
-    float storageRealTimeBandwidth = 0.0f; // 存储实时带宽 (GB/s) - 估算值
+    float storageMaxBandwidth = 0.0f;    // 存储最大带宽 (GB/s) - 各磁盘按接口类型估算的最大带宽之和
+    float storageRealTimeBandwidth = 0.0f; // 存储实时带宽 (GB/s) - 实测的换页读写量
     float storageUtilization = 0.0f;    // 存储利用率 (%)
     
     // 显存带宽（GPU 内部带宽 - 极重要）
@@ -147,14 +223,73 @@ struct SystemBandwidthInfo {
     std::string memoryType = "Unknown"; // 内存类型
     unsigned int memorySpeed = 0;      // 内存速度 (MHz)
     
-    // 历史数据
-    std::vector<float> totalBandwidthHistory;
-    std::vector<float> cpuBandwidthHistory;
-    std::vector<float> memoryBandwidthHistory;
-    std::vector<float> pcieBandwidthHistory;
-    std::vector<float> storageBandwidthHistory;
-    std::vector<float> vramBandwidthHistory;
-    static constexpr size_t MAX_HISTORY = 120;
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId totalBandwidthSeries = kInvalidMetric;
+    MetricId cpuBandwidthSeries = kInvalidMetric;
+    MetricId memoryBandwidthSeries = kInvalidMetric;
+    MetricId pcieBandwidthSeries = kInvalidMetric;
+    MetricId storageBandwidthSeries = kInvalidMetric;
+    MetricId vramBandwidthSeries = kInvalidMetric;
+};
+
+// 一种资源的压力停顿信息（PSI，Linux 4.20+）：
+// some 为至少一个任务在等待该资源的时间占比，full 为所有非空闲任务同时在等待的时间占比
+struct PressureStat {
+    float someAvg10 = 0.0f;            // 内核统计的近 10 秒 some 占比 (%)
+    float fullAvg10 = 0.0f;            // 近 10 秒 full 占比 (%)
+    float someStall = 0.0f;            // 两次采样之间 some 停顿时间占墙钟时间的比例 (%)，由累计停顿时间 (µs) 的差值计算
+    float fullStall = 0.0f;            // 同上，full
+
+    // 历史数据在 SeriesStore 中的指标编号
+    MetricId someAvg10Series = kInvalidMetric;
+    MetricId fullAvg10Series = kInvalidMetric;
+    MetricId someStallSeries = kInvalidMetric;
+    MetricId fullStallSeries = kInvalidMetric;
+};
+
+// 一个范围（整个系统或一个 cgroup）的 CPU/内存/IO 压力停顿
+struct PressureInfo {
+    std::string scope;                 // "system"，或 cgroup 路径（如 "/system.slice/train.service"）
+    PressureStat cpu;                  // 可运行但在等待 CPU
+    PressureStat memory;               // 等待回收内存、换入或页缓存缺页
+    PressureStat io;                   // 等待块设备 IO
+};
+
+// PSI 的三种资源，按此顺序遍历 PressureInfo（名称同时用于 PSI 文件名、指标名和导出标签）
+struct PressureResource {
+    const char* name;
+    PressureStat PressureInfo::* stat;
+};
+constexpr PressureResource kPressureResources[] = {
+    {"cpu", &PressureInfo::cpu},
+    {"memory", &PressureInfo::memory},
+    {"io", &PressureInfo::io},
+};
+constexpr size_t kPressureResourceCount = sizeof(kPressureResources) / sizeof(kPressureResources[0]);
+
+// 某一时刻完整的硬件状态快照（由采样线程发布，UI线程只读）
+struct HardwareSnapshot {
+    uint64_t sequence = 0;                           // 发布序号，0 表示尚未采样
+    uint32_t inventoryVersion = 0;                   // 设备清单版本，GPU/内存条/磁盘列表变化时改变
+    std::chrono::steady_clock::time_point timestamp; // 采样完成时间
+
+    std::vector<GPUInfo> gpus;
+    CPUInfo cpu;
+    MemoryInfo memory;
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;             // 系统和 cgroup 的压力停顿（不支持 PSI 时为空）
+    std::vector<SamplingScheduler::CollectorStats> collectors; // 各采集器的运行统计
+    SeriesStore series;                              // 所有指标的历史数据（共用一条时间线）
+
+    const GPUInfo& GetGPUInfo(int index = 0) const;
+    const CPUInfo& GetCPUInfo() const { return cpu; }
+    const MemoryInfo& GetMemoryInfo() const { return memory; }
+    const SystemBandwidthInfo& GetSystemBandwidthInfo() const { return bandwidth; }
+    size_t GetGPUCount() const { return gpus.size(); }
+    size_t GetMemoryModuleCount() const { return memory.modules.size(); }
+    size_t GetDiskCount() const { return disks.size(); }
+    const DiskInfo& GetDiskInfo(size_t index) const;
 };
 
 class HardwareMonitor {
@@ -162,52 +297,122 @@ public:
     HardwareMonitor();
     ~HardwareMonitor();
 
+    // 主机侧采集后端读取 procfs/sysfs 的根目录（仅 Linux 后端使用，默认 "/"），可指向样例目录树，需在 Initialize 之前调用
+    void SetHostRoot(const std::string& root) { hostRoot_ = root; }
+    // 额外采集压力停顿的 cgroup（cgroup v2 路径，如 "/system.slice/train.service"），空表示采样进程自身所在的 cgroup，
+    // 需在 Initialize 之前调用
+    void SetPressureCgroup(const std::string& cgroup) { pressureCgroup_ = cgroup; }
     bool Initialize();
-    void Update();
+    // 回放模式：从录制文件读取数据代替 NVML/PDH 采集（与 Initialize 二选一）
+    // speed 为播放倍速，1 为实时，0 表示不等待、尽快播放
+    bool InitializeReplay(const std::string& path, double speed);
+    bool IsReplaying() const { return replay_ != nullptr; }
+    // 挂载模式：从共享内存快照总线读取另一个采样进程发布的数据（与 Initialize 二选一）
+    bool InitializeAttach(const std::string& name);
+    bool IsAttached() const { return bus_.IsOpen() && !bus_.IsWriter(); }
+    void Update();      // 运行所有到期的采集器，有新数据时发布快照（由采样线程调用）
     void Shutdown();
 
-    // 获取信息
-    const GPUInfo& GetGPUInfo(int index = 0) const;
-    const CPUInfo& GetCPUInfo() const { return cpuInfo_; }
-    const MemoryInfo& GetMemoryInfo() const { return memoryInfo_; }
-    const SystemBandwidthInfo& GetSystemBandwidthInfo() const { return systemBandwidthInfo_; }
-    size_t GetGPUCount() const { return gpuInfos_.size(); }
-    size_t GetMemoryModuleCount() const { return memoryInfo_.modules.size(); }
-    size_t GetDiskCount() const { return diskInfos_.size(); }
-    const DiskInfo& GetDiskInfo(size_t index) const;
+    // 后台采样线程：采样频率与渲染频率相互独立，各采集器按自己的周期运行
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return samplerRunning_.load(std::memory_order_acquire); }
+
+    // 获取最新的完整快照（无锁，只允许一个读线程调用）
+    // 返回的引用在下一次调用 AcquireSnapshot 之前保持有效；updated 非空时写入自上次调用以来是否有新快照
+    const HardwareSnapshot& AcquireSnapshot(bool* updated = nullptr);
+
+    // 每次发布快照后在采样线程中调用（如唤醒等待事件的界面线程），需在 Start 之前设置，回调应尽快返回
+    void SetSnapshotListener(std::function<void()> listener) { snapshotListener_ = std::move(listener); }
+
+    // 额外的快照读端（如指标导出线程）：每次发布时另外复制一份不含历史数据的快照到 buffer。
+    // buffer 由调用方持有，需在 Start 之前注册，且生命周期不短于采样线程
+    void AddSnapshotReader(TripleBuffer<HardwareSnapshot>* buffer);
+
+    // 全分辨率压缩历史（任意线程可读，内部加锁）
+    const HistoryArchive& GetArchive() const { return archive_; }
+
+    // 关闭后不再维护 SeriesStore/HistoryArchive，快照中也不带历史（无界面模式不需要图表，需在 Start 之前调用）
+    void SetHistoryEnabled(bool enabled) { historyEnabled_ = enabled; }
+
+    // 会话录制：之后每次发布快照都追加到录制文件（需在 Start 之前调用）
+    bool StartRecording(const std::string& path);
+    void StopRecording();
+    bool IsRecording() const { return recorder_.IsOpen(); }
+
+    // 共享内存快照总线：之后每次发布快照都写入总线，供本机其他进程只读挂载（需在 Start 之前调用）
+    bool StartSnapshotBus(const std::string& name);
+
+    // 按设备清单注册所有历史指标（已注册的名称保持原编号），编号写回清单中的 *Series 字段
+    static void RegisterSeries(SeriesStore& series, const SessionState& state);
+    // 把清单中的数值写入 series 的当前行（之后由调用方 Append）
+    static void StoreSeries(SeriesStore& series, const SessionState& state);
+    // 由原始字段计算派生指标并写回清单（每个新样本落地后调用一次，在 StoreSeries 之前）
+    static void UpdateDerived(const SessionState& state);
 
 private:
     bool InitializeNVML();
+    void RegisterCollectors();
+    // 新样本落地：计算派生指标，历史开启时追加一行
+    void AppendRow(std::chrono::steady_clock::time_point time);
+    void UpdateReplay();
+    void UpdateAttached();
+    void PublishToBus();
     void UpdateGPU();
-    void UpdateCPU();
-    void UpdateMemory();
     void UpdateSystemBandwidth();
-    void UpdateMemoryModules();
-    void UpdateDisks();
+    void UpdateMemoryModuleBandwidth(); // 内存条实时带宽估算
+    void PublishSnapshot();
+    void FillSnapshot(HardwareSnapshot& snapshot);   // 复制除历史数据外的工作状态
+    void RecordSnapshot();
+    void SamplerLoop();
+
+    static constexpr int kAttachPollMs = 10;  // 挂载模式检查总线的间隔
+
+    // GPU静态属性缓存（InitializeNVML 中读取一次，运行期间不会变化）
+    struct GPUDevice {
+        nvmlDevice_t handle = nullptr;   // 为空表示获取句柄失败
+        unsigned int minPowerLimit = 0;  // 功耗限制 (mW)
+        unsigned int maxPowerLimit = 0;  // 功耗限制 (mW)
+        bool hasPowerLimit = false;
+    };
+    std::vector<GPUDevice> gpuDevices_;
 
+    // 以下状态只由采样线程读写
     std::vector<GPUInfo> gpuInfos_;
     CPUInfo cpuInfo_;
     MemoryInfo memoryInfo_;
     SystemBandwidthInfo systemBandwidthInfo_;
     std::vector<DiskInfo> diskInfos_;
+    std::vector<PressureInfo> pressureInfos_;
+    SeriesStore series_;
+    HistoryArchive archive_;
+    SessionRecorder recorder_;
+    uint32_t inventoryVersion_ = 1;          // GPU/内存条/磁盘清单变化时递增
+    uint32_t recordedInventoryVersion_ = 0;  // 录制文件中最近一次写入的清单版本
+    uint32_t registeredInventoryVersion_ = 0; // 历史指标最近一次按哪个清单版本注册
+    std::unique_ptr<SessionReplay> replay_;   // 非空表示回放模式
+    bool replayFinished_ = false;
+    SnapshotBus bus_;
+    uint32_t busInventoryVersion_ = 0;        // 总线中最近一次写入的清单版本
+    bool historyEnabled_ = true;
+    uint64_t snapshotSequence_ = 0;
+
+    // 快照发布（采样线程写，UI线程读）
+    TripleBuffer<HardwareSnapshot> snapshots_;
+    std::vector<TripleBuffer<HardwareSnapshot>*> snapshotReaders_;
+    std::function<void()> snapshotListener_;
+
+    // 采样线程与采集器调度
+    SamplingScheduler scheduler_;
+    std::thread samplerThread_;
+    std::atomic<bool> samplerRunning_{false};
+    std::mutex samplerMutex_;
+    std::condition_variable samplerCv_;
 
     bool nvmlInitialized_ = false;
-    PDH_HQUERY cpuQuery_ = nullptr;
-    PDH_HCOUNTER cpuCounter_ = nullptr;
-    PDH_HQUERY diskQuery_ = nullptr;
-    SYSTEM_INFO sysInfo_;
-    
-    // CPU性能计数器
-    ULARGE_INTEGER lastCPU_, lastSysCPU_, lastUserCPU_;
-    int numProcessors_ = 0;
-    HANDLE self_ = nullptr;
-    
-    // 磁盘性能计数器
-    struct DiskCounter {
-        PDH_HCOUNTER readCounter = nullptr;
-        PDH_HCOUNTER writeCounter = nullptr;
-        std::string diskName;
-    };
-    std::vector<DiskCounter> diskCounters_;
-};
 
+    // CPU/内存/磁盘采集后端（平台相关，见 HostCollector.h），为空表示当前平台不支持
+    std::unique_ptr<HostCollector> host_;
+    std::string hostRoot_;
+    std::string pressureCgroup_;
+};
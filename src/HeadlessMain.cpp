@@ -0,0 +1,153 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "FleetUplink.h"
+#include "HardwareMonitor.h"
+#include "MetricsExporter.h"
+#include "NetSocket.h"
+
+// 无界面采集程序：不创建窗口、不初始化 GLFW/ImGui/OpenGL，只运行后台采样线程，
+// 数据输出到录制文件、Prometheus 指标导出、共享内存快照总线和/或多节点汇总服务，适合没有显示环境的训练节点。Ctrl+C 或 SIGTERM 时正常退出并写完录制文件。
+
+static std::atomic<bool> g_stopRequested{false};
+
+static void HandleStopSignal(int) {
+    g_stopRequested.store(true);
+}
+
+int main(int argc, char* argv[]) {
+    // 命令行参数：
+    //   --record <文件>        把每次采样追加到会话录制文件
+    //   --metrics-port <端口>  启动 Prometheus 指标导出（HTTP /metrics）
+    //   --metrics-address <地址> 指标导出监听地址，默认 127.0.0.1（供其他机器抓取时用 0.0.0.0）
+    //   --shm <名称>           把快照发布到共享内存快照总线，供本机其他进程只读挂载
+    //   --aggregator <主机:端口> 把快照上报到多节点汇总服务（DeepInsightBlackwellAggregator）
+    //   --node-name <名称>     上报时使用的节点名称，默认为主机名
+    //   --duration <秒>        运行指定时间后退出，默认一直运行
+    //   --host-root <目录>     Linux 下读取 proc/ 和 sys/ 的根目录，默认 /（如容器中挂载的宿主机 /host）
+    //   --cgroup <路径>        Linux 下额外采集压力停顿的 cgroup v2 路径（如训练任务的服务），默认为本进程所在的 cgroup
+    std::string recordPath;
+    std::string busName;
+    std::string aggregator;
+    std::string nodeName;
+    std::string hostRoot;
+    std::string cgroup;
+    int metricsPort = -1;
+    std::string metricsAddress = "127.0.0.1";
+    double durationSeconds = 0.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            busName = argv[++i];
+        } else if (arg == "--aggregator" && i + 1 < argc) {
+            aggregator = argv[++i];
+        } else if (arg == "--node-name" && i + 1 < argc) {
+            nodeName = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            metricsPort = std::atoi(argv[++i]);
+        } else if (arg == "--metrics-address" && i + 1 < argc) {
+            metricsAddress = argv[++i];
+        } else if (arg == "--duration" && i + 1 < argc) {
+            durationSeconds = std::atof(argv[++i]);
+        } else if (arg == "--host-root" && i + 1 < argc) {
+            hostRoot = argv[++i];
+        } else if (arg == "--cgroup" && i + 1 < argc) {
+            cgroup = argv[++i];
+        }
+    }
+
+    if (recordPath.empty() && metricsPort < 0 && busName.empty() && aggregator.empty()) {
+        std::cerr << "用法: " << argv[0]
+                  << " [--record <文件>] [--metrics-port <端口> [--metrics-address <地址>]] [--shm <名称>]"
+                  << " [--aggregator <主机:端口> [--node-name <名称>]] [--duration <秒>] [--host-root <目录>]"
+                  << " [--cgroup <路径>]"
+                  << std::endl << "至少需要一种输出" << std::endl;
+        return -1;
+    }
+
+    std::signal(SIGINT, HandleStopSignal);
+    std::signal(SIGTERM, HandleStopSignal);
+
+    std::string aggregatorHost;
+    uint16_t aggregatorPort = 0;
+    if (!aggregator.empty() && !ParseHostPort(aggregator, aggregatorHost, aggregatorPort)) {
+        std::cerr << "无效的汇总服务地址: " << aggregator << "（应为 主机:端口）" << std::endl;
+        return -1;
+    }
+
+    MetricsExporter exporter;
+    FleetUplink uplink;
+    HardwareMonitor monitor;
+    // 没有图表，不需要维护历史数据；录制文件中有完整的采样记录
+    monitor.SetHistoryEnabled(false);
+    monitor.SetHostRoot(hostRoot);
+    monitor.SetPressureCgroup(cgroup);
+    if (!monitor.Initialize()) {
+        std::cerr << "硬件监控初始化失败！" << std::endl;
+        return -1;
+    }
+
+    if (!recordPath.empty() && !monitor.StartRecording(recordPath)) {
+        std::cerr << "会话录制启动失败: " << recordPath << std::endl;
+        return -1;
+    }
+
+    if (!busName.empty() && !monitor.StartSnapshotBus(busName)) {
+        std::cerr << "共享内存快照总线创建失败: " << busName << std::endl;
+        return -1;
+    }
+
+    if (metricsPort >= 0) {
+        if (!exporter.Start(metricsAddress, static_cast<uint16_t>(metricsPort))) {
+            std::cerr << "指标导出启动失败: " << metricsAddress << ":" << metricsPort << std::endl;
+            return -1;
+        }
+        monitor.AddSnapshotReader(&exporter.GetSnapshotBuffer());
+    }
+
+    if (!aggregator.empty()) {
+        // 连接失败时在上报线程中自动重试，不影响采集启动
+        uplink.Start(aggregatorHost, aggregatorPort, nodeName);
+        monitor.AddSnapshotReader(&uplink.GetSnapshotBuffer());
+    }
+
+    if (!monitor.Start()) {
+        std::cerr << "采样线程启动失败！" << std::endl;
+        return -1;
+    }
+    std::cout << "无界面采集已启动";
+    if (!recordPath.empty()) {
+        std::cout << "，录制到 " << recordPath;
+    }
+    if (!busName.empty()) {
+        std::cout << "，快照总线 " << busName;
+    }
+    if (exporter.IsRunning()) {
+        std::cout << "，指标导出 http://" << metricsAddress << ":" << exporter.GetPort() << "/metrics";
+    }
+    if (uplink.IsRunning()) {
+        std::cout << "，上报到 " << aggregator << "（节点 " << uplink.GetNodeName() << "）";
+    }
+    std::cout << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!g_stopRequested.load()) {
+        if (durationSeconds > 0.0 &&
+            std::chrono::steady_clock::now() - start >= std::chrono::duration<double>(durationSeconds)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    monitor.Shutdown();
+    exporter.Stop();
+    uplink.Stop();
+    std::cout << "采集结束" << std::endl;
+    return 0;
+}
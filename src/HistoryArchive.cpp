@@ -0,0 +1,138 @@
+#include "HistoryArchive.h"
+#include <algorithm>
+
+HistoryArchive::HistoryArchive(size_t maxBytes)
+    : epoch_(Clock::now()), maxBytes_(maxBytes) {
+}
+
+void HistoryArchive::AppendRow(Clock::time_point timestamp, const SeriesStore& store) {
+    int64_t timestampMs = ToMilliseconds(timestamp);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (series_.size() < store.GetMetricCount()) {
+        series_.resize(store.GetMetricCount());
+    }
+    for (MetricId id = 0; id < store.GetMetricCount(); id++) {
+        if (store.Empty(id)) {
+            continue;
+        }
+        Series& series = series_[id];
+        float value = store.Latest(id);
+        if (series.open == nullptr) {
+            series.open = NewBlock();
+        }
+        if (!series.open->Append(timestampMs, value)) {
+            // 当前块已满，封存后换一个新块
+            series.sealed.push_back(std::move(series.open));
+            series.open = NewBlock();
+            series.open->Append(timestampMs, value);
+        }
+        sampleCount_++;
+    }
+}
+
+std::unique_ptr<CompressedBlock> HistoryArchive::NewBlock() {
+    if ((blockCount_ + 1) * sizeof(CompressedBlock) > maxBytes_) {
+        // 达到上限：在所有指标的封存块中找第一个样本最早的块淘汰（正在写入的块不参与）
+        // 换块时才会走到这里（每个块容纳上千个样本），线性扫描所有指标的代价可以忽略
+        Series* victim = nullptr;
+        for (Series& candidate : series_) {
+            if (!candidate.sealed.empty() && (victim == nullptr ||
+                candidate.sealed.front()->FirstTimestamp() < victim->sealed.front()->FirstTimestamp())) {
+                victim = &candidate;
+            }
+        }
+        // 没有封存块时（上限小于每个指标一个块）仍需分配才能继续写入
+        if (victim != nullptr) {
+            sampleCount_ -= victim->sealed.front()->Count();
+            victim->sealed.pop_front();
+            victim->evicted = true;
+            blockCount_--;
+        }
+    }
+    blockCount_++;
+    return std::unique_ptr<CompressedBlock>(new CompressedBlock());
+}
+
+// 解码整个块并只保留 [fromMs, toMs] 内的样本，追加到 out
+static void DecodeRange(const CompressedBlock& block, int64_t fromMs, int64_t toMs,
+                        std::vector<ArchiveSample>& out) {
+    size_t offset = out.size();
+    out.resize(offset + block.Count());
+    block.Decode(out.data() + offset);
+
+    auto first = std::lower_bound(out.begin() + offset, out.end(), fromMs,
+        [](const ArchiveSample& sample, int64_t t) { return sample.timestampMs < t; });
+    auto last = std::upper_bound(first, out.end(), toMs,
+        [](int64_t t, const ArchiveSample& sample) { return t < sample.timestampMs; });
+    out.erase(last, out.end());
+    out.erase(out.begin() + offset, first);
+}
+
+size_t HistoryArchive::Read(MetricId id, Clock::time_point from, Clock::time_point to,
+                            std::vector<ArchiveSample>& out) const {
+    int64_t fromMs = ToMilliseconds(from);
+    int64_t toMs = ToMilliseconds(to);
+
+    // 锁内只复制相交封存块的引用和正在写入的块（最多一个 4KB 块），解码在锁外进行
+    std::vector<std::shared_ptr<const CompressedBlock>> blocks;
+    std::unique_ptr<CompressedBlock> tail;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (id >= series_.size()) {
+            return 0;
+        }
+        const Series& series = series_[id];
+
+        // 块按时间顺序排列，二分查找第一个可能包含 fromMs 的块
+        auto it = std::lower_bound(series.sealed.begin(), series.sealed.end(), fromMs,
+            [](const std::shared_ptr<const CompressedBlock>& block, int64_t t) {
+                return block->LastTimestamp() < t;
+            });
+        for (; it != series.sealed.end() && (*it)->FirstTimestamp() <= toMs; ++it) {
+            blocks.push_back(*it);
+        }
+        const CompressedBlock* open = series.open.get();
+        if (open != nullptr && !open->Empty() && open->FirstTimestamp() <= toMs && open->LastTimestamp() >= fromMs) {
+            tail.reset(new CompressedBlock(*open));
+        }
+    }
+
+    size_t before = out.size();
+    for (const auto& block : blocks) {
+        DecodeRange(*block, fromMs, toMs, out);
+    }
+    if (tail != nullptr) {
+        DecodeRange(*tail, fromMs, toMs, out);
+    }
+    return out.size() - before;
+}
+
+bool HistoryArchive::Covers(MetricId id, Clock::time_point from) const {
+    int64_t fromMs = ToMilliseconds(from);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= series_.size() || series_[id].First() == nullptr || series_[id].First()->Empty()) {
+        return false;
+    }
+    const Series& series = series_[id];
+    return !series.evicted || series.First()->FirstTimestamp() <= fromMs;
+}
+
+int64_t HistoryArchive::ToMilliseconds(Clock::time_point t) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t - epoch_).count();
+}
+
+HistoryArchive::Clock::time_point HistoryArchive::ToTimePoint(int64_t timestampMs) const {
+    return epoch_ + std::chrono::milliseconds(timestampMs);
+}
+
+size_t HistoryArchive::GetMemoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blockCount_ * sizeof(CompressedBlock);
+}
+
+uint64_t HistoryArchive::GetSampleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampleCount_;
+}
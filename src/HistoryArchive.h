@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CompressedBlock.h"
+#include "SeriesStore.h"
+
+// 全分辨率压缩历史（整个训练任务期间的每一个样本）
+// 每个指标一串 CompressedBlock：只有最后一个块在写入，其余块封存后只读。
+// 10Hz 采样时保持不变的样本只占几个 bit，带噪声的样本约 2~4 字节。
+// 内存上限是硬上限：超出时淘汰所有指标中最旧的封存块，
+// 因此保留的时间跨度随数据的可压缩程度变化（Covers 判断某个时间范围是否仍完整保留）。
+// 采样线程写入，其他线程读取，内部加锁。封存块以 shared_ptr<const> 持有：读取时在锁内只复制相交块的引用
+// 和正在写入的块，解码在锁外进行，长时间窗口的读取不会阻塞采样；淘汰只释放归档的引用，读取方仍持有的块不受影响。
+class HistoryArchive {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kDefaultMaxBytes = 32u * 1024u * 1024u;
+
+    explicit HistoryArchive(size_t maxBytes = kDefaultMaxBytes);
+
+    // 把 SeriesStore 最新一行中已有值的指标追加到各自的压缩序列（采样线程调用）
+    void AppendRow(Clock::time_point timestamp, const SeriesStore& store);
+
+    // 读取指标在 [from, to] 内的样本，追加到 out，返回读取的样本数
+    // 只解码与时间范围相交的块，解码时不持有锁
+    size_t Read(MetricId id, Clock::time_point from, Clock::time_point to,
+                std::vector<ArchiveSample>& out) const;
+    // 指标从 from 开始的样本是否都还保留着（没有被淘汰），指标没有样本时返回 false
+    bool Covers(MetricId id, Clock::time_point from) const;
+
+    // 样本时间戳（毫秒）与 steady_clock 时间点之间的转换
+    int64_t ToMilliseconds(Clock::time_point t) const;
+    Clock::time_point ToTimePoint(int64_t timestampMs) const;
+
+    size_t GetMemoryBytes() const;
+    uint64_t GetSampleCount() const;
+
+private:
+    struct Series {
+        std::deque<std::shared_ptr<const CompressedBlock>> sealed;   // 封存块，按时间顺序
+        std::unique_ptr<CompressedBlock> open;                        // 正在写入的块
+        bool evicted = false;          // 是否淘汰过块（之后最旧的样本不再是该指标的第一个样本）
+
+        const CompressedBlock* First() const { return sealed.empty() ? open.get() : sealed.front().get(); }
+    };
+
+    // 分配一个空块：达到上限时先淘汰所有指标中最旧的封存块
+    std::unique_ptr<CompressedBlock> NewBlock();
+
+    mutable std::mutex mutex_;
+    Clock::time_point epoch_;
+    size_t maxBytes_;
+    size_t blockCount_ = 0;          // 归档持有的块数（读取方暂时持有的已淘汰块不计入）
+    uint64_t sampleCount_ = 0;
+    std::deque<Series> series_;      // 按 MetricId 索引（deque 扩容时不移动已有元素）
+};
@@ -0,0 +1,81 @@
+#include "HostCollector.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#include "WindowsHostCollector.h"
+#elif defined(__linux__)
+#include "LinuxHostCollector.h"
+#endif
+
+std::unique_ptr<HostCollector> CreateHostCollector(const std::string& root, const std::string& cgroup) {
+#if defined(_WIN32)
+    (void)root;
+    (void)cgroup;
+    return std::unique_ptr<HostCollector>(new WindowsHostCollector());
+#elif defined(__linux__)
+    return std::unique_ptr<HostCollector>(new LinuxHostCollector(root, cgroup));
+#else
+    (void)root;
+    (void)cgroup;
+    return nullptr;
+#endif
+}
+
+void SortLogicalCpus(CPUInfo& cpu) {
+    std::vector<LogicalCpuInfo>& cpus = cpu.logicalCpus;
+    std::sort(cpus.begin(), cpus.end(), [](const LogicalCpuInfo& a, const LogicalCpuInfo& b) {
+        if (a.socket != b.socket) {
+            return a.socket < b.socket;
+        }
+        if (a.core != b.core) {
+            return a.core < b.core;
+        }
+        return a.id < b.id;
+    });
+    for (size_t i = 0; i < cpus.size(); i++) {
+        bool sameCore = i > 0 && cpus[i - 1].socket == cpus[i].socket && cpus[i - 1].core == cpus[i].core;
+        cpus[i].thread = sameCore ? cpus[i - 1].thread + 1 : 0;
+    }
+    cpu.coreUtilization.assign(cpus.size(), 0.0f);
+    cpu.coreFrequency.assign(cpus.size(), 0.0f);
+}
+
+bool EstimateMemoryModules(MemoryInfo& memory, float totalGB) {
+    // 估算内存条数量（假设每个内存条8GB或16GB）
+    size_t estimatedModuleCount = 0;
+    if (totalGB >= 64.0f) {
+        estimatedModuleCount = static_cast<size_t>(totalGB / 16.0f + 0.5f);
+    } else if (totalGB >= 32.0f) {
+        estimatedModuleCount = static_cast<size_t>(totalGB / 8.0f + 0.5f);
+    } else {
+        estimatedModuleCount = static_cast<size_t>(totalGB / 4.0f + 0.5f);
+    }
+
+    estimatedModuleCount = std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(8), estimatedModuleCount));
+
+    // 只在数量变化时重新初始化
+    if (memory.modules.size() == estimatedModuleCount) {
+        return false;
+    }
+    memory.modules.resize(estimatedModuleCount);
+    for (size_t i = 0; i < estimatedModuleCount; i++) {
+        MemoryModuleInfo& module = memory.modules[i];
+        module.name = "内存条 " + std::to_string(i + 1);
+        module.capacity = totalGB / static_cast<float>(estimatedModuleCount);
+        module.channel = static_cast<unsigned int>(i % 2);
+
+        if (totalGB >= 64.0f) {
+            module.speed = 4800;
+            module.type = "DDR5";
+        } else if (totalGB >= 32.0f) {
+            module.speed = 3200;
+            module.type = "DDR4";
+        } else {
+            module.speed = 2400;
+            module.type = "DDR4";
+        }
+
+        module.maxBandwidth = (static_cast<float>(module.speed) * 64.0f) / 8.0f / 1000.0f;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "HardwareMonitor.h"
+
+// 主机侧（CPU/内存/磁盘）采集后端：HardwareMonitor 只依赖这个接口，平台相关的实现各自放在一个类中
+// （Windows 为 PDH/WMI，Linux 为 procfs/sysfs）。所有方法都在采样线程中调用，由 SamplingScheduler 按周期驱动。
+class HostCollector {
+public:
+    virtual ~HostCollector() = default;
+
+    virtual const char* Name() const = 0;
+    virtual bool Initialize() = 0;
+    virtual void Shutdown() = 0;
+
+    // 逻辑 CPU 拓扑（静态，只采集一次），同时按拓扑调整 coreUtilization/coreFrequency 的长度，清单变化时返回 true
+    virtual bool UpdateCPUTopology(CPUInfo& cpu) = 0;
+    // 总利用率和每个逻辑 CPU 的利用率
+    virtual void UpdateCPU(CPUInfo& cpu) = 0;
+    // 每个逻辑 CPU 的频率、插槽/核心温度和温控降频事件速率，后端取不到的字段保持不变
+    virtual void UpdateCPUThermal(CPUInfo& cpu) = 0;
+    // 内存使用以及换页/页缓存活动（速率按两次采样之间的计数差计算）
+    virtual void UpdateMemory(MemoryInfo& memory) = 0;
+    // 内存条清单（静态，只采集一次），清单变化时返回 true
+    virtual bool UpdateMemoryModules(MemoryInfo& memory) = 0;
+    // 磁盘清单和实时读写带宽，清单变化时返回 true
+    virtual bool UpdateDisks(std::vector<DiskInfo>& disks) = 0;
+    // 系统和 cgroup 的压力停顿（不支持 PSI 的平台保持为空），范围清单变化时返回 true
+    virtual bool UpdatePressure(std::vector<PressureInfo>& pressures) = 0;
+};
+
+// 创建当前平台的采集后端，不支持的平台返回空（以下参数仅 Linux 后端使用）
+// root 为 procfs/sysfs 所在的根目录（空表示 "/"），可以指向测试用的样例目录树；
+// cgroup 为额外采集压力停顿的 cgroup v2 路径，空表示采样进程自身所在的 cgroup
+std::unique_ptr<HostCollector> CreateHostCollector(const std::string& root, const std::string& cgroup);
+
+// 按 (插槽, 物理核心, 编号) 排序并为同一物理核心的逻辑 CPU 编超线程序号（各后端共用），
+// 之后 coreUtilization 和 coreFrequency 的长度与 logicalCpus 一致
+void SortLogicalCpus(CPUInfo& cpu);
+
+// 无法读取内存条信息时按总容量估算内存条清单（各后端共用），清单变化时返回 true
+bool EstimateMemoryModules(MemoryInfo& memory, float totalGB);
@@ -1,9 +1,11 @@
 #include "ImGuiApp.h"
+#include "Downsample.h"
 #include <GLFW/glfw3.h>
 #define GL_SILENCE_DEPRECATION
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -11,6 +13,8 @@
 #include <cstdio>
 #include <functional>
 #include <cmath>
+#include <limits>
+#include <chrono>
 #ifdef _WIN32
 #include <io.h>
 #include <fcntl.h>
@@ -20,6 +24,11 @@
 #include <string>
 #endif
 
+// 字体文件是否存在且可读（各平台通用，不使用只有 MSVC 运行库提供的 fopen_s）
+static bool FontFileExists(const char* path) {
+    return std::ifstream(path, std::ios::binary).good();
+}
+
 ImGuiApp::ImGuiApp(const std::string& title, int width, int height)
     : title_(title), width_(width), height_(height), isMaximized_(false) {
 }
@@ -62,10 +71,17 @@ bool ImGuiApp::Initialize() {
     // 设置中文字体和emoji支持
     // 首先加载中文字体
     const char* fontPaths[] = {
+#ifdef _WIN32
         "C:/Windows/Fonts/msyh.ttc",           // 微软雅黑
         "C:/Windows/Fonts/simhei.ttf",          // 黑体
         "C:/Windows/Fonts/simsun.ttc",          // 宋体
         "C:/Windows/Fonts/msyhbd.ttc",          // 微软雅黑 Bold
+#else
+        "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc",       // Debian/Ubuntu fonts-noto-cjk
+        "/usr/share/fonts/google-noto-cjk/NotoSansCJK-Regular.ttc",     // Fedora/RHEL google-noto-sans-cjk-fonts
+        "/usr/share/fonts/noto-cjk/NotoSansCJK-Regular.ttc",            // Arch noto-fonts-cjk
+        "/usr/share/fonts/truetype/wqy/wqy-microhei.ttc",               // 文泉驿微米黑
+#endif
         nullptr
     };
     
@@ -76,9 +92,7 @@ bool ImGuiApp::Initialize() {
     
     for (int i = 0; fontPaths[i] != nullptr; i++) {
         // 检查文件是否存在（使用二进制模式）
-        FILE* testFile = nullptr;
-        if (fopen_s(&testFile, fontPaths[i], "rb") == 0 && testFile != nullptr) {
-            fclose(testFile);
+        if (FontFileExists(fontPaths[i])) {
             // 加载字体，包含中文字符范围
             // 使用更大的字体大小以确保清晰度
             font = io.Fonts->AddFontFromFileTTF(fontPaths[i], 18.0f, &fontConfig, 
@@ -151,9 +165,7 @@ bool ImGuiApp::Initialize() {
     // 方法1: 尝试直接加载emoji字体文件
     // 重要：MergeMode要求主字体已经加载并设置为默认字体
     for (int i = 0; emojiFontPaths[i] != nullptr; i++) {
-        FILE* testFile = nullptr;
-        if (fopen_s(&testFile, emojiFontPaths[i], "rb") == 0 && testFile != nullptr) {
-            fclose(testFile);
+        if (FontFileExists(emojiFontPaths[i])) {
             // 尝试加载，使用更大的字体大小（emoji通常需要更大的尺寸才能清晰显示）
             ImFont* emojiFont = io.Fonts->AddFontFromFileTTF(emojiFontPaths[i], 24.0f, &emojiConfig, emoji_ranges);
             if (emojiFont != nullptr) {
@@ -184,9 +196,7 @@ bool ImGuiApp::Initialize() {
             nullptr
         };
         for (int i = 0; fallbackFonts[i] != nullptr; i++) {
-            FILE* testFile = nullptr;
-            if (fopen_s(&testFile, fallbackFonts[i], "rb") == 0 && testFile != nullptr) {
-                fclose(testFile);
+            if (FontFileExists(fallbackFonts[i])) {
                 ImFont* fallbackFont = io.Fonts->AddFontFromFileTTF(fallbackFonts[i], 20.0f, &emojiConfig, emoji_ranges);
                 if (fallbackFont != nullptr) {
                     std::cout << "使用备用字体: " << fallbackFonts[i] << std::endl;
@@ -200,9 +210,7 @@ bool ImGuiApp::Initialize() {
     // 方法3: 如果还是失败，尝试不指定字符范围，让字体自己决定
     if (!emojiLoaded) {
         for (int i = 0; emojiFontPaths[i] != nullptr; i++) {
-            FILE* testFile = nullptr;
-            if (fopen_s(&testFile, emojiFontPaths[i], "rb") == 0 && testFile != nullptr) {
-                fclose(testFile);
+            if (FontFileExists(emojiFontPaths[i])) {
                 // 不指定字符范围，加载所有字符
                 ImFont* emojiFont = io.Fonts->AddFontFromFileTTF(emojiFontPaths[i], 20.0f, &emojiConfig, nullptr);
                 if (emojiFont != nullptr) {
@@ -227,9 +235,7 @@ bool ImGuiApp::Initialize() {
             nullptr
         };
         for (int i = 0; allSegoeFonts[i] != nullptr; i++) {
-            FILE* testFile = nullptr;
-            if (fopen_s(&testFile, allSegoeFonts[i], "rb") == 0 && testFile != nullptr) {
-                fclose(testFile);
+            if (FontFileExists(allSegoeFonts[i])) {
                 ImFont* segoeFont = io.Fonts->AddFontFromFileTTF(allSegoeFonts[i], 20.0f, &emojiConfig, emoji_ranges);
                 if (segoeFont != nullptr) {
                     std::cout << "成功加载Segoe字体: " << allSegoeFonts[i] << std::endl;
@@ -299,9 +305,65 @@ void ImGuiApp::Shutdown() {
     }
 }
 
-void ImGuiApp::BeginFrame() {
-    glfwPollEvents();
+void ImGuiApp::UpdateVisibility() {
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    glfwGetFramebufferSize(window_, &framebufferWidth, &framebufferHeight);
+    // GLFW 没有查询窗口是否被遮挡的接口：最小化、帧缓冲为 0 或不可见时视为隐藏，
+    // 失去焦点时可能被遮挡，新快照不再唤醒，只在空闲超时时刷新
+    hidden_ = glfwGetWindowAttrib(window_, GLFW_ICONIFIED) == GLFW_TRUE ||
+              glfwGetWindowAttrib(window_, GLFW_VISIBLE) == GLFW_FALSE ||
+              framebufferWidth <= 0 || framebufferHeight <= 0;
+    bool focused = glfwGetWindowAttrib(window_, GLFW_FOCUSED) == GLFW_TRUE;
+    suppressWake_.store(hidden_ || !focused, std::memory_order_relaxed);
+}
+
+void ImGuiApp::WaitEvents(bool block) {
+    inputWake_ = false;
+    idleTimeout_ = false;
+    UpdateVisibility();
+    if (!block || (pendingFrames_ > 0 && !hidden_)) {
+        glfwPollEvents();
+        return;
+    }
+    if (hidden_) {
+        // 隐藏时只等待事件（还原窗口、调整大小、关闭），采样线程不会唤醒
+        glfwWaitEvents();
+        inputWake_ = true;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    glfwWaitEventsTimeout(kIdleTimeoutSeconds);
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    idleTimeout_ = waited.count() >= kIdleTimeoutSeconds;
+    inputWake_ = !idleTimeout_;
+}
+
+bool ImGuiApp::NeedsFrame(bool newSnapshot) {
+    UpdateVisibility();
+    if (hidden_) {
+        return false;
+    }
+    // 提前被唤醒却没有新快照，说明是输入事件（或窗口大小、焦点变化）
+    if (inputWake_ && !newSnapshot) {
+        pendingFrames_ = std::max(pendingFrames_, kInputFrames);
+    }
+    if (pendingFrames_ > 0) {
+        pendingFrames_--;
+        return true;
+    }
+    return newSnapshot || idleTimeout_;
+}
+
+void ImGuiApp::Wake() {
+    if (suppressWake_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    glfwPostEmptyEvent();
+}
 
+void ImGuiApp::BeginFrame() {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -323,11 +385,11 @@ void ImGuiApp::EndFrame() {
     glfwSwapBuffers(window_);
 }
 
-void ImGuiApp::Render(const HardwareMonitor& monitor) {
-    RenderMainWindow(monitor);
+void ImGuiApp::Render(const HardwareSnapshot& snapshot) {
+    RenderMainWindow(snapshot);
 }
 
-void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
+void ImGuiApp::RenderMainWindow(const HardwareSnapshot& snapshot) {
     ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize, ImGuiCond_Always);
     
@@ -362,8 +424,17 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     ImGui::PopStyleColor();
     
     // 右侧：实时监控文字和窗口控制按钮
+    // 采样在后台线程进行，采集卡住时界面照常刷新，这里提示数据已过期
+    float snapshotAge = std::chrono::duration<float>(
+        std::chrono::steady_clock::now() - snapshot.timestamp).count();
     ImGui::SameLine(windowWidth - 200);
-    ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "实时监控");
+    if (snapshot.sequence == 0) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "等待数据...");
+    } else if (snapshotAge > kStaleSnapshotSeconds) {
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "数据延迟 %.0fs", snapshotAge);
+    } else {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "实时监控");
+    }
     
     // 窗口控制按钮（最小化、最大化/还原、关闭）
     ImGui::SameLine(windowWidth - 120);
@@ -402,11 +473,44 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     ImGui::BeginChild("MainContent", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
 
     // 获取数据
-    size_t gpuCount = monitor.GetGPUCount();
-    const GPUInfo& gpu = gpuCount > 0 ? monitor.GetGPUInfo(0) : GPUInfo();
-    const CPUInfo& cpu = monitor.GetCPUInfo();
-    const MemoryInfo& mem = monitor.GetMemoryInfo();
-    const SystemBandwidthInfo& bandwidth = monitor.GetSystemBandwidthInfo();
+    size_t gpuCount = snapshot.GetGPUCount();
+    if (selectedGpu_ >= static_cast<int>(gpuCount)) {
+        selectedGpu_ = 0;
+    }
+    // 多GPU时提供选择，下方所有GPU指标都来自所选GPU
+    if (gpuCount > 1) {
+        char preview[160];
+        snprintf(preview, sizeof(preview), "GPU %d: %s", selectedGpu_,
+                 snapshot.GetGPUInfo(selectedGpu_).name.c_str());
+        ImGui::SetNextItemWidth(320.0f);
+        if (ImGui::BeginCombo("##GPUSelect", preview)) {
+            for (size_t i = 0; i < gpuCount; i++) {
+                char item[160];
+                snprintf(item, sizeof(item), "GPU %zu: %s", i, snapshot.GetGPUInfo(static_cast<int>(i)).name.c_str());
+                if (ImGui::Selectable(item, selectedGpu_ == static_cast<int>(i))) {
+                    selectedGpu_ = static_cast<int>(i);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::Spacing();
+    }
+    // 历史图表的时间窗口（影响所有历史图表，长窗口自动切换到聚合数据）
+    ImGui::SetNextItemWidth(160.0f);
+    if (ImGui::BeginCombo("历史窗口", kHistoryWindows[historyWindow_].label)) {
+        for (int i = 0; i < kHistoryWindowCount; i++) {
+            if (ImGui::Selectable(kHistoryWindows[i].label, historyWindow_ == i)) {
+                historyWindow_ = i;
+            }
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::Spacing();
+
+    const GPUInfo& gpu = snapshot.GetGPUInfo(selectedGpu_);
+    const CPUInfo& cpu = snapshot.GetCPUInfo();
+    const MemoryInfo& mem = snapshot.GetMemoryInfo();
+    const SystemBandwidthInfo& bandwidth = snapshot.GetSystemBandwidthInfo();
     
     // 计算自适应网格大小（根据窗口宽度）
     // windowWidth 已在标题栏部分定义，这里直接使用
@@ -441,10 +545,8 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                            ImVec2(circleSize, circleSize),
                            GetStatusColor(gpu.memoryPercent, 80.0f, 95.0f, true), "%");
         // 显示实际显存使用量（居中）
-        float vramUsedGB = gpu.memoryUsed / 1024.0f;
-        float vramTotalGB = gpu.memoryTotal / 1024.0f;
         char vramText[32];
-        snprintf(vramText, sizeof(vramText), "实际: %.2f GB", vramUsedGB);
+        snprintf(vramText, sizeof(vramText), "实际: %.2f GB", gpu.memoryUsedGB);
         float vramTextWidth = ImGui::CalcTextSize(vramText).x;
         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (windowWidth / 5.0f - vramTextWidth) * 0.5f);
         ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%s", vramText);
@@ -475,12 +577,9 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
         ImGui::NextColumn();
         
         // CPU同步到GPU等待时长 - 圆形显示
-        // 将等待时长转换为百分比显示（反向：等待时间越短越好）
-        // 0ms = 0%（最佳），10ms = 100%（最差）
-        float maxWaitTime = 10.0f; // 最大参考值10ms
+        // 百分比由采样线程计算（0ms = 0% 最佳，10ms = 100% 最差）
         float waitTime = std::max(0.0f, gpu.dataTransferWaitTime); // 确保非负
-        float waitPercent = (waitTime / maxWaitTime) * 100.0f;
-        waitPercent = std::min(100.0f, waitPercent);
+        float waitPercent = gpu.transferWaitPercent;
         
         // 根据等待时长选择颜色（反向：等待时间越短越好）
         ImVec4 waitColor;
@@ -518,7 +617,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     }
 
     // 主机带宽模块 - 直接渲染内容，不使用子窗口避免占满剩余高度
-    RenderSystemBandwidthInfo(bandwidth, monitor);
+    RenderSystemBandwidthInfo(bandwidth, snapshot);
     ImGui::Spacing();
 
     // 详细信息 - 使用表格布局，美观大气
@@ -547,11 +646,8 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TextColored(GetStatusColor(gpu.utilization, 85.0f, 100.0f), "%s", 
                                   GetStatusIcon(gpu.utilization, 85.0f, 100.0f));
                 ImGui::TableNextColumn();
-                if (!gpu.utilizationHistory.empty()) {
-                    float maxUtil = *std::max_element(gpu.utilizationHistory.begin(), gpu.utilizationHistory.end());
-                    ImGui::PlotLines("##gpu_util_hist", gpu.utilizationHistory.data(), 
-                                   static_cast<int>(gpu.utilizationHistory.size()),
-                                   0, nullptr, 0.0f, 100.0f, ImVec2(-1, 30));
+                if (!snapshot.series.Empty(gpu.utilizationSeries)) {
+                    PlotSeries("##gpu_util_hist", snapshot.series, gpu.utilizationSeries, 0.0f, 100.0f, ImVec2(-1, 30));
                 }
                 
                 // 显存行
@@ -564,10 +660,8 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TableNextColumn();
                 ImGui::TextColored(GetStatusColor(gpu.memoryPercent, 80.0f, 95.0f, true), "%.1f%%", gpu.memoryPercent);
                 ImGui::TableNextColumn();
-                if (!gpu.memoryHistory.empty()) {
-                    ImGui::PlotLines("##gpu_mem_hist", gpu.memoryHistory.data(),
-                                   static_cast<int>(gpu.memoryHistory.size()),
-                                   0, nullptr, 0.0f, 100.0f, ImVec2(-1, 30));
+                if (!snapshot.series.Empty(gpu.memorySeries)) {
+                    PlotSeries("##gpu_mem_hist", snapshot.series, gpu.memorySeries, 0.0f, 100.0f, ImVec2(-1, 30));
                 }
                 
                 // 温度行
@@ -582,11 +676,9 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TableNextColumn();
                 if (gpu.temperature > 80.0f) ImGui::TextColored(tempColor, "🔥");
                 ImGui::TableNextColumn();
-                if (!gpu.temperatureHistory.empty()) {
-                    float maxTemp = *std::max_element(gpu.temperatureHistory.begin(), gpu.temperatureHistory.end());
-                    ImGui::PlotLines("##gpu_temp_hist", gpu.temperatureHistory.data(),
-                                   static_cast<int>(gpu.temperatureHistory.size()),
-                                   0, nullptr, 0.0f, maxTemp * 1.2f, ImVec2(-1, 30));
+                if (!snapshot.series.Empty(gpu.temperatureSeries)) {
+                    float maxTemp = HistoryMax(snapshot.series, gpu.temperatureSeries);
+                    PlotSeries("##gpu_temp_hist", snapshot.series, gpu.temperatureSeries, 0.0f, maxTemp * 1.2f, ImVec2(-1, 30));
                 }
                 
                 // PCIe带宽行
@@ -594,12 +686,9 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TableNextColumn();
                 ImGui::Text("PCIe带宽");
                 ImGui::TableNextColumn();
-                // 计算实时带宽大小（GB/s）
-                float realTimeBandwidth = (gpu.pcieRxThroughput + gpu.pcieTxThroughput) / 1024.0f; // 转换为GB/s
-                float pcieUtil = 0.0f;
-                if (gpu.pcieBandwidth > 0.0f) {
-                    pcieUtil = (realTimeBandwidth / gpu.pcieBandwidth) * 100.0f;
-                }
+                // 实时带宽（GB/s）和利用率由采样线程计算
+                float realTimeBandwidth = gpu.pcieThroughput / 1024.0f;
+                float pcieUtil = gpu.pcieUtilization;
                 // 显示：理论带宽 | 实时带宽 | 利用率
                 ImGui::Text("理论: %.2f GB/s | 实时: %.2f GB/s", gpu.pcieBandwidth, realTimeBandwidth);
                 ImGui::SameLine();
@@ -607,19 +696,9 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TableNextColumn();
                 ImGui::TextColored(GetStatusColor(pcieUtil, 0.0f, 80.0f, true), "%.1f%%", pcieUtil);
                 ImGui::TableNextColumn();
-                if (!gpu.pcieRxHistory.empty() && !gpu.pcieTxHistory.empty()) {
-                    std::vector<float> combined;
-                    size_t maxSize = std::max(gpu.pcieRxHistory.size(), gpu.pcieTxHistory.size());
-                    for (size_t i = 0; i < maxSize; i++) {
-                        float rx = (i < gpu.pcieRxHistory.size()) ? gpu.pcieRxHistory[i] : 0.0f;
-                        float tx = (i < gpu.pcieTxHistory.size()) ? gpu.pcieTxHistory[i] : 0.0f;
-                        combined.push_back(rx + tx);
-                    }
-                    if (!combined.empty()) {
-                        float maxThroughput = *std::max_element(combined.begin(), combined.end());
-                        ImGui::PlotLines("##pcie_hist", combined.data(), static_cast<int>(combined.size()),
-                                       0, nullptr, 0.0f, maxThroughput * 1.2f, ImVec2(-1, 30));
-                    }
+                if (!snapshot.series.Empty(gpu.pcieThroughputSeries)) {
+                    float maxThroughput = HistoryMax(snapshot.series, gpu.pcieThroughputSeries);
+                    PlotSeries("##pcie_hist", snapshot.series, gpu.pcieThroughputSeries, 0.0f, maxThroughput * 1.2f, ImVec2(-1, 30));
                 }
                 
                 // 功率行（显示功率信息，单位：W）
@@ -628,62 +707,38 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::Text("功率");
                 ImGui::TableNextColumn();
                 if (gpu.powerUsage > 0) {
-                    // 获取最大功耗限制
-                    unsigned int maxPowerLimit = 0;
-                    nvmlDevice_t device;
-                    if (nvmlDeviceGetHandleByIndex(0, &device) == NVML_SUCCESS) {
-                        unsigned int minPowerLimit = 0;
-                        if (nvmlDeviceGetPowerManagementLimitConstraints(device, &minPowerLimit, &maxPowerLimit) != NVML_SUCCESS) {
-                            maxPowerLimit = 0;
-                        }
-                    }
-                    
-                    float powerPercent = 0.0f;
-                    if (maxPowerLimit > 0) {
-                        float maxPowerW = static_cast<float>(maxPowerLimit) / 1000.0f; // 转换为瓦特
-                        powerPercent = (static_cast<float>(gpu.powerUsage) / maxPowerW) * 100.0f;
-                        powerPercent = std::min(100.0f, std::max(0.0f, powerPercent));
+                    // 最大功耗限制和百分比由采样线程按各自GPU计算，这里只读快照
+                    if (gpu.powerLimit > 0.0f) {
                         // 显示：最大功率 | 实时功率 | 百分比（单位：W）
-                        ImGui::Text("最大: %.0f W | 实时: %u W", maxPowerW, gpu.powerUsage);
+                        ImGui::Text("最大: %.0f W | 实时: %u W", gpu.powerLimit, gpu.powerUsage);
                     } else {
                         // 如果没有最大功耗限制，只显示实时功率
                         ImGui::Text("实时: %u W", gpu.powerUsage);
                     }
                     ImGui::SameLine();
-                    if (powerPercent > 0.0f) {
-                        ImVec4 powerColor = GetStatusColor(powerPercent, 0.0f, 90.0f, true);
-                        ImGui::TextColored(powerColor, "(%.1f%%)", powerPercent);
+                    if (gpu.powerPercent > 0.0f) {
+                        ImVec4 powerColor = GetStatusColor(gpu.powerPercent, 0.0f, 90.0f, true);
+                        ImGui::TextColored(powerColor, "(%.1f%%)", gpu.powerPercent);
                     }
                 } else {
                     ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "不可用");
                 }
                 ImGui::TableNextColumn();
-                if (gpu.powerUsage > 0) {
-                    // 计算功率百分比
-                    unsigned int maxPowerLimit = 0;
-                    nvmlDevice_t device;
-                    float powerPercent = 0.0f;
-                    if (nvmlDeviceGetHandleByIndex(0, &device) == NVML_SUCCESS) {
-                        unsigned int minPowerLimit = 0;
-                        if (nvmlDeviceGetPowerManagementLimitConstraints(device, &minPowerLimit, &maxPowerLimit) == NVML_SUCCESS && maxPowerLimit > 0) {
-                            float maxPowerW = static_cast<float>(maxPowerLimit) / 1000.0f;
-                            powerPercent = (static_cast<float>(gpu.powerUsage) / maxPowerW) * 100.0f;
-                            powerPercent = std::min(100.0f, std::max(0.0f, powerPercent));
-                        }
-                    }
-                    if (powerPercent > 0.0f) {
-                        ImVec4 powerColor = GetStatusColor(powerPercent, 0.0f, 90.0f, true);
-                        ImGui::TextColored(powerColor, "%.1f%%", powerPercent);
-                    } else {
-                        ImGui::Text("-");
-                    }
+                if (gpu.powerUsage > 0 && gpu.powerPercent > 0.0f) {
+                    ImVec4 powerColor = GetStatusColor(gpu.powerPercent, 0.0f, 90.0f, true);
+                    ImGui::TextColored(powerColor, "%.1f%%", gpu.powerPercent);
                 } else {
                     ImGui::Text("-");
                 }
                 ImGui::TableNextColumn();
-                // 功率历史图表（如果有历史数据的话，可以添加）
-                ImGui::Text("-");
-                
+                if (!snapshot.series.Empty(gpu.powerSeries)) {
+                    float maxPower = gpu.powerLimit > 0.0f ? gpu.powerLimit
+                                   : HistoryMax(snapshot.series, gpu.powerSeries) * 1.2f;
+                    PlotSeries("##gpu_power_hist", snapshot.series, gpu.powerSeries, 0.0f, maxPower, ImVec2(-1, 30));
+                } else {
+                    ImGui::Text("-");
+                }
+
                 ImGui::EndTable();
             }
             
@@ -693,40 +748,37 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
             ImGui::Spacing();
             
             // GPU利用率历史图表
-            if (!gpu.utilizationHistory.empty()) {
-                DrawHistoryChart("GPU利用率历史", gpu.utilizationHistory, 0.0f, 100.0f, "%");
+            if (!snapshot.series.Empty(gpu.utilizationSeries)) {
+                DrawHistoryChart("GPU利用率历史", snapshot.series, gpu.utilizationSeries, 0.0f, 100.0f, "%");
                 ImGui::Spacing();
             }
             
             // 显存使用历史图表
-            if (!gpu.memoryHistory.empty()) {
-                DrawHistoryChart("显存使用历史", gpu.memoryHistory, 0.0f, 100.0f, "%");
+            if (!snapshot.series.Empty(gpu.memorySeries)) {
+                DrawHistoryChart("显存使用历史", snapshot.series, gpu.memorySeries, 0.0f, 100.0f, "%");
                 ImGui::Spacing();
             }
             
             // PCIe 吞吐量历史图表
-            if (!gpu.pcieRxHistory.empty() || !gpu.pcieTxHistory.empty()) {
-                // 合并显示接收和发送
-                std::vector<float> combinedThroughput;
-                size_t maxSize = std::max(gpu.pcieRxHistory.size(), gpu.pcieTxHistory.size());
-                combinedThroughput.reserve(maxSize);
-                for (size_t i = 0; i < maxSize; i++) {
-                    float rx = (i < gpu.pcieRxHistory.size()) ? gpu.pcieRxHistory[i] : 0.0f;
-                    float tx = (i < gpu.pcieTxHistory.size()) ? gpu.pcieTxHistory[i] : 0.0f;
-                    combinedThroughput.push_back(rx + tx);
-                }
-                if (!combinedThroughput.empty()) {
-                    float maxThroughput = *std::max_element(combinedThroughput.begin(), combinedThroughput.end());
-                    DrawHistoryChart("PCIe吞吐量历史", combinedThroughput, 0.0f, 
-                                   maxThroughput > 0 ? maxThroughput * 1.2f : 1000.0f, "MB/s");
-                    ImGui::Spacing();
-                }
+            // 接收和发送合计由采样线程写入 pcieThroughputSeries
+            if (!snapshot.series.Empty(gpu.pcieThroughputSeries)) {
+                float maxThroughput = HistoryMax(snapshot.series, gpu.pcieThroughputSeries);
+                DrawHistoryChart("PCIe吞吐量历史", snapshot.series, gpu.pcieThroughputSeries, 0.0f, 
+                               maxThroughput > 0 ? maxThroughput * 1.2f : 1000.0f, "MB/s");
+                ImGui::Spacing();
+            }
+            
+            // 功耗历史图表
+            if (!snapshot.series.Empty(gpu.powerSeries)) {
+                DrawHistoryChart("功耗历史", snapshot.series, gpu.powerSeries, 0.0f,
+                               gpu.powerLimit > 0.0f ? gpu.powerLimit : HistoryMax(snapshot.series, gpu.powerSeries) * 1.2f, " W");
+                ImGui::Spacing();
             }
             
             // 温度历史图表
-            if (!gpu.temperatureHistory.empty()) {
-                float maxTemp = *std::max_element(gpu.temperatureHistory.begin(), gpu.temperatureHistory.end());
-                DrawHistoryChart("GPU温度历史", gpu.temperatureHistory, 0.0f, 
+            if (!snapshot.series.Empty(gpu.temperatureSeries)) {
+                float maxTemp = HistoryMax(snapshot.series, gpu.temperatureSeries);
+                DrawHistoryChart("GPU温度历史", snapshot.series, gpu.temperatureSeries, 0.0f, 
                                maxTemp > 0 ? maxTemp * 1.2f : 100.0f, "°C");
             }
         }
@@ -737,7 +789,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     }
 
     // ========== 显示每个内存条的详细信息 ==========
-    const MemoryInfo& memory = monitor.GetMemoryInfo();
+    const MemoryInfo& memory = snapshot.GetMemoryInfo();
     if (!memory.modules.empty()) {
         ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.12f, 0.12f, 0.15f, 0.5f));
         ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 6.0f);
@@ -789,7 +841,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     }
     
     // ========== 显示每个硬盘的详细信息 ==========
-    size_t diskCount = monitor.GetDiskCount();
+    size_t diskCount = snapshot.GetDiskCount();
     if (diskCount > 0) {
         ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.12f, 0.12f, 0.15f, 0.5f));
         ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 6.0f);
@@ -808,7 +860,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                 ImGui::TableHeadersRow();
                 
                 for (size_t i = 0; i < diskCount; i++) {
-                    const DiskInfo& disk = monitor.GetDiskInfo(i);
+                    const DiskInfo& disk = snapshot.GetDiskInfo(i);
                     ImGui::TableNextRow();
                     
                     ImGui::TableNextColumn();
@@ -824,10 +876,18 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
                     ImGui::TableNextColumn();
                     ImGui::Text("最大: %.2f GB/s", disk.maxReadBandwidth);
                     ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "实时: %.3f GB/s", disk.realTimeReadBandwidth);
+                    Percentiles readPercentiles;
+                    if (SelectPercentiles(snapshot.series, disk.readBandwidthSeries, HistoryWindow(), readPercentiles)) {
+                        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "p95: %.3f GB/s", readPercentiles.p95);
+                    }
                     
                     ImGui::TableNextColumn();
                     ImGui::Text("最大: %.2f GB/s", disk.maxWriteBandwidth);
                     ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "实时: %.3f GB/s", disk.realTimeWriteBandwidth);
+                    Percentiles writePercentiles;
+                    if (SelectPercentiles(snapshot.series, disk.writeBandwidthSeries, HistoryWindow(), writePercentiles)) {
+                        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "p95: %.3f GB/s", writePercentiles.p95);
+                    }
                     
                     ImGui::TableNextColumn();
                     ImVec4 readColor = GetStatusColor(disk.readUtilization, 0.0f, 80.0f, true);
@@ -847,6 +907,19 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
         ImGui::Spacing();
     }
 
+    // ========== 压力停顿（PSI）：任务实际等待 CPU/内存/IO 的时间 ==========
+    if (!snapshot.pressures.empty()) {
+        ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.12f, 0.12f, 0.15f, 0.5f));
+        ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 6.0f);
+        if (ImGui::BeginChild("Pressure", ImVec2(0, 0), true)) {
+            RenderPressureInfo(snapshot);
+        }
+        ImGui::EndChild();
+        ImGui::PopStyleVar();
+        ImGui::PopStyleColor();
+        ImGui::Spacing();
+    }
+
     // CPU和内存详细信息 - 并排显示
     ImGui::Columns(2, "CPUMem", false);
     
@@ -875,10 +948,57 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
             ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "💡 提示: CPU 使用率较低");
         }
         
+        // 逻辑 CPU 热力图：总利用率看不出的单核瓶颈（如单线程的数据加载进程）
+        if (!cpu.coreUtilization.empty()) {
+            ImGui::Spacing();
+            ImGui::Text("逻辑 CPU (%zu 个)，最忙: ", cpu.coreUtilization.size());
+            ImGui::SameLine();
+            ImGui::TextColored(GetStatusColor(cpu.maxCoreUtilization, 0.0f, 90.0f, true), "%.0f%%",
+                               cpu.maxCoreUtilization);
+            DrawCoreHeatmap(cpu);
+        }
+
+        // 频率和温度：降频时核心数和利用率不变，但同样的工作要更久
+        if (cpu.frequency > 0.0f || cpu.temperature > 0.0f) {
+            ImGui::Spacing();
+            if (cpu.frequency > 0.0f) {
+                ImGui::Text("平均频率: %.0f MHz", cpu.frequency);
+                if (cpu.frequencyPercent > 0.0f) {
+                    ImGui::SameLine();
+                    ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "(最大频率的 %.0f%%)", cpu.frequencyPercent);
+                }
+            }
+            if (cpu.temperature > 0.0f) {
+                ImGui::Text("温度: 插槽 ");
+                ImGui::SameLine();
+                ImGui::TextColored(GetStatusColor(cpu.temperature, 0.0f, 85.0f, true), "%.0f°C", cpu.temperature);
+                if (cpu.maxCoreTemperature > 0.0f) {
+                    ImGui::SameLine();
+                    ImGui::Text(" 最热核心 ");
+                    ImGui::SameLine();
+                    ImGui::TextColored(GetStatusColor(cpu.maxCoreTemperature, 0.0f, 90.0f, true), "%.0f°C",
+                                       cpu.maxCoreTemperature);
+                }
+            }
+            if (cpu.throttled) {
+                ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "⚠️ CPU 正在降频（降频事件 %.1f 次/秒）",
+                                   cpu.throttleRate);
+            }
+        }
+
         // CPU利用率历史图表
         ImGui::Spacing();
-        if (!cpu.utilizationHistory.empty()) {
-            DrawHistoryChart("CPU利用率历史", cpu.utilizationHistory, 0.0f, 100.0f, "%");
+        if (!snapshot.series.Empty(cpu.utilizationSeries)) {
+            DrawHistoryChart("CPU利用率历史", snapshot.series, cpu.utilizationSeries, 0.0f, 100.0f, "%");
+        }
+        if (!snapshot.series.Empty(cpu.maxCoreUtilizationSeries)) {
+            DrawHistoryChart("最忙逻辑CPU利用率历史", snapshot.series, cpu.maxCoreUtilizationSeries, 0.0f, 100.0f, "%");
+        }
+        if (cpu.frequencyPercent > 0.0f && !snapshot.series.Empty(cpu.frequencyPercentSeries)) {
+            DrawHistoryChart("CPU频率历史 (占最大频率)", snapshot.series, cpu.frequencyPercentSeries, 0.0f, 120.0f, "%");
+        }
+        if (cpu.temperature > 0.0f && !snapshot.series.Empty(cpu.temperatureSeries)) {
+            DrawHistoryChart("CPU温度历史", snapshot.series, cpu.temperatureSeries, 0.0f, 110.0f, "°C");
         }
     }
     ImGui::EndChild();
@@ -904,9 +1024,24 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
         ImGui::Spacing();
         ImGui::Text("💾 可用内存: %.2f GB", mem.available);
         
+        // 换页活动：页缓存读入/写回是正常的文件 IO，换入换出和大量主缺页说明内存已经不够用
+        ImGui::Spacing();
+        ImGui::Text("页缓存: 读入 %.1f MB/s  写回 %.1f MB/s  脏页 %.0f MB", mem.pageInRate, mem.pageOutRate, mem.dirty);
+        float swapRate = mem.swapInRate + mem.swapOutRate;
+        ImGui::Text("换页: ");
+        ImGui::SameLine();
+        ImGui::TextColored(GetStatusColor(swapRate, 0.0f, 1.0f, true), "换入 %.1f MB/s  换出 %.1f MB/s",
+                           mem.swapInRate, mem.swapOutRate);
+        ImGui::SameLine();
+        ImGui::TextColored(GetStatusColor(mem.majorFaultRate, 0.0f, 100.0f, true), "  主缺页 %.0f 次/秒",
+                           mem.majorFaultRate);
+
         // 状态提示
         ImGui::Spacing();
-        if (mem.percent > 95.0f) {
+        if (swapRate > 1.0f) {
+            ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), 
+                              "🚨 警告: 正在换页（%.1f MB/s），性能会断崖式下跌！", swapRate);
+        } else if (mem.percent > 95.0f) {
             ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), 
                               "🚨 警告: 内存使用过高，可能出现 Swap，导致性能断崖式下跌！");
         } else if (mem.percent > 80.0f) {
@@ -917,8 +1052,12 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
         
         // 内存使用历史图表
         ImGui::Spacing();
-        if (!mem.percentHistory.empty()) {
-            DrawHistoryChart("内存使用历史", mem.percentHistory, 0.0f, 100.0f, "%");
+        if (!snapshot.series.Empty(mem.percentSeries)) {
+            DrawHistoryChart("内存使用历史", snapshot.series, mem.percentSeries, 0.0f, 100.0f, "%");
+        }
+        if (!snapshot.series.Empty(mem.majorFaultSeries)) {
+            DrawHistoryChart("主缺页历史", snapshot.series, mem.majorFaultSeries, 0.0f,
+                             std::max(100.0f, HistoryMax(snapshot.series, mem.majorFaultSeries)), "次/秒");
         }
     }
     ImGui::EndChild();
@@ -932,7 +1071,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.12f, 0.12f, 0.15f, 0.5f));
     ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 6.0f);
     if (ImGui::BeginChild("Diagnosis", ImVec2(0, 0), true)) {
-        RenderDiagnosis(monitor);
+        RenderDiagnosis(snapshot);
     }
     ImGui::EndChild();
     ImGui::PopStyleVar();
@@ -945,7 +1084,7 @@ void ImGuiApp::RenderMainWindow(const HardwareMonitor& monitor) {
     ImGui::End();
 }
 
-void ImGuiApp::RenderGPUInfo(const GPUInfo& gpu, int index) {
+void ImGuiApp::RenderGPUInfo(const GPUInfo& gpu, int index, const SeriesStore& series) {
     if (!gpu.available) {
         ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "❌ GPU %d: 不可用", index);
         return;
@@ -1018,7 +1157,7 @@ void ImGuiApp::RenderGPUInfo(const GPUInfo& gpu, int index) {
     
     // PCIe 吞吐量利用率
     if (gpu.pcieBandwidth > 0.0f) {
-        float pcieUtilPercent = ((gpu.pcieRxThroughput + gpu.pcieTxThroughput) / 1024.0f) / gpu.pcieBandwidth * 100.0f;
+        float pcieUtilPercent = gpu.pcieUtilization;
         ImGui::Text("  PCIe 利用率: %.1f%%", pcieUtilPercent);
         DrawProgressBar("##pcie_util", pcieUtilPercent, 0.0f, 100.0f, "%",
                        pcieUtilPercent > 80.0f ? IM_COL32(255, 0, 0, 255) :
@@ -1038,36 +1177,26 @@ void ImGuiApp::RenderGPUInfo(const GPUInfo& gpu, int index) {
     }
 
     // PCIe 吞吐量历史图表
-    if (!gpu.pcieRxHistory.empty() || !gpu.pcieTxHistory.empty()) {
+    if (!series.Empty(gpu.pcieThroughputSeries)) {
         ImGui::Text("PCIe 吞吐量历史:");
-        // 合并显示接收和发送
-        std::vector<float> combinedThroughput;
-        size_t maxSize = std::max(gpu.pcieRxHistory.size(), gpu.pcieTxHistory.size());
-        combinedThroughput.reserve(maxSize);
-        for (size_t i = 0; i < maxSize; i++) {
-            float rx = (i < gpu.pcieRxHistory.size()) ? gpu.pcieRxHistory[i] : 0.0f;
-            float tx = (i < gpu.pcieTxHistory.size()) ? gpu.pcieTxHistory[i] : 0.0f;
-            combinedThroughput.push_back(rx + tx);
-        }
-        if (!combinedThroughput.empty()) {
-            float maxThroughput = *std::max_element(combinedThroughput.begin(), combinedThroughput.end());
-            DrawHistoryChart("PCIe吞吐量", combinedThroughput, 0.0f, 
-                           maxThroughput > 0 ? maxThroughput * 1.2f : 1000.0f, "MB/s");
-        }
+        // 接收和发送合计
+        float maxThroughput = HistoryMax(series, gpu.pcieThroughputSeries);
+        DrawHistoryChart("PCIe吞吐量", series, gpu.pcieThroughputSeries, 0.0f, 
+                       maxThroughput > 0 ? maxThroughput * 1.2f : 1000.0f, "MB/s");
     }
 
     // 利用率历史图表
-    if (!gpu.utilizationHistory.empty()) {
-        DrawHistoryChart("GPU利用率历史", gpu.utilizationHistory, 0.0f, 100.0f, "%");
+    if (!series.Empty(gpu.utilizationSeries)) {
+        DrawHistoryChart("GPU利用率历史", series, gpu.utilizationSeries, 0.0f, 100.0f, "%");
     }
 
     // 显存使用历史图表
-    if (!gpu.memoryHistory.empty()) {
-        DrawHistoryChart("显存使用历史", gpu.memoryHistory, 0.0f, 100.0f, "%");
+    if (!series.Empty(gpu.memorySeries)) {
+        DrawHistoryChart("显存使用历史", series, gpu.memorySeries, 0.0f, 100.0f, "%");
     }
 }
 
-void ImGuiApp::RenderCPUInfo(const CPUInfo& cpu) {
+void ImGuiApp::RenderCPUInfo(const CPUInfo& cpu, const SeriesStore& series) {
     ImGui::Text("CPU 利用率: %.1f%%", cpu.utilization);
     DrawProgressBar("##cpu_util", cpu.utilization, 0.0f, 100.0f, "%",
                    cpu.utilization > 90.0f ? IM_COL32(255, 0, 0, 255) :
@@ -1085,12 +1214,12 @@ void ImGuiApp::RenderCPUInfo(const CPUInfo& cpu) {
     }
 
     // CPU利用率历史图表
-    if (!cpu.utilizationHistory.empty()) {
-        DrawHistoryChart("CPU利用率历史", cpu.utilizationHistory, 0.0f, 100.0f, "%");
+    if (!series.Empty(cpu.utilizationSeries)) {
+        DrawHistoryChart("CPU利用率历史", series, cpu.utilizationSeries, 0.0f, 100.0f, "%");
     }
 }
 
-void ImGuiApp::RenderMemoryInfo(const MemoryInfo& memory) {
+void ImGuiApp::RenderMemoryInfo(const MemoryInfo& memory, const SeriesStore& series) {
     // 内存使用 - 美化显示
     ImVec4 memColor = GetStatusColor(memory.percent, 0.0f, 80.0f, true);
     ImGui::Text("使用情况: ");
@@ -1117,12 +1246,12 @@ void ImGuiApp::RenderMemoryInfo(const MemoryInfo& memory) {
     }
 
     // 内存使用历史图表
-    if (!memory.percentHistory.empty()) {
-        DrawHistoryChart("内存使用历史", memory.percentHistory, 0.0f, 100.0f, "%");
+    if (!series.Empty(memory.percentSeries)) {
+        DrawHistoryChart("内存使用历史", series, memory.percentSeries, 0.0f, 100.0f, "%");
     }
 }
 
-void ImGuiApp::RenderSystemBandwidthInfo(const SystemBandwidthInfo& bandwidth, const HardwareMonitor& monitor) {
+void ImGuiApp::RenderSystemBandwidthInfo(const SystemBandwidthInfo& bandwidth, const HardwareSnapshot& snapshot) {
     ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "🌐 主机带宽模块");
     ImGui::Separator();
     
@@ -1197,43 +1326,218 @@ void ImGuiApp::RenderSystemBandwidthInfo(const SystemBandwidthInfo& bandwidth, c
     }
 }
 
-void ImGuiApp::RenderDiagnosis(const HardwareMonitor& monitor) {
-    size_t gpuCount = monitor.GetGPUCount();
+void ImGuiApp::RenderPressureInfo(const HardwareSnapshot& snapshot) {
+    ImGui::TextColored(ImVec4(0.9f, 0.5f, 0.5f, 1.0f), "⏳ 压力停顿 (PSI)");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "some: 至少一个任务在等待  full: 所有任务同时在等待");
+    ImGui::Separator();
+
+    if (ImGui::BeginTable("PressureTable", 6, ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("范围", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("资源", ImGuiTableColumnFlags_WidthFixed, 60);
+        ImGui::TableSetupColumn("some 停顿", ImGuiTableColumnFlags_WidthFixed, 100);
+        ImGui::TableSetupColumn("full 停顿", ImGuiTableColumnFlags_WidthFixed, 100);
+        ImGui::TableSetupColumn("some avg10", ImGuiTableColumnFlags_WidthFixed, 100);
+        ImGui::TableSetupColumn("full avg10", ImGuiTableColumnFlags_WidthFixed, 100);
+        ImGui::TableHeadersRow();
+
+        for (const PressureInfo& pressure : snapshot.pressures) {
+            for (const PressureResource& resource : kPressureResources) {
+                const PressureStat& stat = pressure.*resource.stat;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", pressure.scope == "system" ? "系统" : pressure.scope.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", resource.name);
+                ImGui::TableNextColumn();
+                ImGui::TextColored(GetStatusColor(stat.someStall, 0.0f, 10.0f, true), "%.1f%%", stat.someStall);
+                ImGui::TableNextColumn();
+                ImGui::TextColored(GetStatusColor(stat.fullStall, 0.0f, 5.0f, true), "%.1f%%", stat.fullStall);
+                ImGui::TableNextColumn();
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%.2f%%", stat.someAvg10);
+                ImGui::TableNextColumn();
+                ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "%.2f%%", stat.fullAvg10);
+            }
+        }
+        ImGui::EndTable();
+    }
+}
+
+// 降频期间与其余时间的 GPU 利用率对比
+struct ThrottleImpact {
+    float throttledFraction = 0.0f;   // 降频行占窗口的比例
+    float throttledGpu = 0.0f;        // 降频期间的 GPU 平均利用率 (%)
+    float normalGpu = 0.0f;           // 其余时间的 GPU 平均利用率 (%)
+};
+
+// 所有指标共用原始行的时间轴，按行把最近 window 内的降频标记与 GPU 利用率对齐；
+// 没有历史数据、或降频/未降频的行太少无法比较时返回 false
+static bool SelectThrottleImpact(const SeriesStore& series, MetricId throttled, MetricId gpu,
+                                 std::chrono::steady_clock::duration window, ThrottleImpact& impact) {
+    constexpr size_t kMinRows = 10;
+    if (series.Empty(throttled) || series.Empty(gpu)) {
+        return false;
+    }
+    size_t first = series.LowerBound(series.TimeAt(series.Size() - 1) - window);
+    double sums[2] = {};
+    size_t counts[2] = {};
+    for (size_t row = first; row < series.Size(); row++) {
+        int index = series.ValueAt(throttled, row) > 0.5f ? 1 : 0;
+        sums[index] += series.ValueAt(gpu, row);
+        counts[index]++;
+    }
+    if (counts[0] < kMinRows || counts[1] < kMinRows) {
+        return false;
+    }
+    impact.throttledFraction = static_cast<float>(counts[1]) / static_cast<float>(counts[0] + counts[1]);
+    impact.throttledGpu = static_cast<float>(sums[1] / counts[1]);
+    impact.normalGpu = static_cast<float>(sums[0] / counts[0]);
+    return true;
+}
+
+// 最近 window 内的平均停顿占比（实测的累计停顿时间差值），没有历史数据时退回瞬时值
+static float PressureStallMean(const SeriesStore& series, MetricId metric,
+                               std::chrono::steady_clock::duration window, float current) {
+    HistoryBucket summary;
+    return series.Summarize(metric, window, summary) ? summary.mean : current;
+}
+
+void ImGuiApp::RenderDiagnosis(const HardwareSnapshot& snapshot) {
+    size_t gpuCount = snapshot.GetGPUCount();
     bool hasIssue = false;
 
+    // 利用率取最近 kDiagnosisWindowSeconds 秒的中位数，避免单个采样的抖动触发或掩盖诊断；
+    // 没有历史数据（或未开启历史）时退回瞬时值
+    const std::chrono::seconds window(kDiagnosisWindowSeconds);
+    const CPUInfo& cpu = snapshot.GetCPUInfo();
+    Percentiles cpuPercentiles;
+    float cpuUtilization = SelectPercentiles(snapshot.series, cpu.utilizationSeries, window, cpuPercentiles)
+                               ? cpuPercentiles.p50 : cpu.utilization;
+    Percentiles corePercentiles;
+    float maxCoreUtilization = SelectPercentiles(snapshot.series, cpu.maxCoreUtilizationSeries, window, corePercentiles)
+                                   ? corePercentiles.p50 : cpu.maxCoreUtilization;
+
+    // 有压力停顿数据时按实测停顿时间判断资源不足，优先看 cgroup（训练任务所在范围），否则看整个系统
+    const PressureInfo* pressure = snapshot.pressures.empty() ? nullptr : &snapshot.pressures.back();
+    const char* pressureScope = pressure != nullptr && pressure->scope != "system" ? pressure->scope.c_str() : "系统";
+    float cpuStall = 0.0f;
+    float memoryStall = 0.0f;
+    float ioStall = 0.0f;
+    float ioFullStall = 0.0f;
+    if (pressure != nullptr) {
+        cpuStall = PressureStallMean(snapshot.series, pressure->cpu.someStallSeries, window, pressure->cpu.someStall);
+        memoryStall = PressureStallMean(snapshot.series, pressure->memory.someStallSeries, window,
+                                        pressure->memory.someStall);
+        ioStall = PressureStallMean(snapshot.series, pressure->io.someStallSeries, window, pressure->io.someStall);
+        ioFullStall = PressureStallMean(snapshot.series, pressure->io.fullStallSeries, window, pressure->io.fullStall);
+    }
+    bool cpuStarved = pressure != nullptr ? cpuStall >= 20.0f : cpuUtilization > 90.0f;
+
     if (gpuCount > 0) {
         for (size_t i = 0; i < gpuCount; i++) {
-            const GPUInfo& gpu = monitor.GetGPUInfo(i);
+            const GPUInfo& gpu = snapshot.GetGPUInfo(i);
             if (!gpu.available) continue;
 
-            const CPUInfo& cpu = monitor.GetCPUInfo();
+            Percentiles gpuPercentiles;
+            bool hasPercentiles = SelectPercentiles(snapshot.series, gpu.utilizationSeries, window, gpuPercentiles);
+            float gpuUtilization = hasPercentiles ? gpuPercentiles.p50 : gpu.utilization;
+            bool flagged = false;
+            ThrottleImpact throttle;
 
             // 诊断逻辑
-            if (gpu.utilization < 70.0f && cpu.utilization > 90.0f) {
+            // CPU 降频放在最前：它是 CPU 瓶颈的根因，且降频往往是间歇的，GPU 利用率中位数不一定低于 70%
+            if (SelectThrottleImpact(snapshot.series, cpu.throttledSeries, gpu.utilizationSeries, window, throttle) &&
+                throttle.throttledFraction >= 0.1f && throttle.normalGpu - throttle.throttledGpu >= 15.0f) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f),
+                                  "【GPU %zu】检测到 CPU 降频拖慢 GPU:", i);
+                ImGui::Text("  近 %d 秒内 CPU 有 %.0f%% 的时间处于降频状态，期间 GPU 利用率 %.0f%%，其余时间 %.0f%%。",
+                            kDiagnosisWindowSeconds, throttle.throttledFraction * 100.0f,
+                            throttle.throttledGpu, throttle.normalGpu);
+                ImGui::Text("  请检查 CPU 散热（风扇、散热器、机箱风道）和功耗墙设置，当前插槽温度 %.0f°C。",
+                            cpu.temperature);
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && cpuStarved) {
                 ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), 
-                                  "【GPU %d】检测到 CPU 瓶颈:", i);
+                                  "【GPU %zu】检测到 CPU 瓶颈:", i);
+                if (pressure != nullptr) {
+                    ImGui::Text("  近 %d 秒内%s的任务有 %.0f%% 的墙钟时间在排队等待 CPU。",
+                                kDiagnosisWindowSeconds, pressureScope, cpuStall);
+                }
                 ImGui::Text("  GPU 在等数据，请增加 DataLoader 的 num_workers 或优化数据增强代码。");
-                hasIssue = true;
-            } else if (gpu.utilization < 70.0f && gpu.memoryPercent < 50.0f) {
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && maxCoreUtilization > 95.0f && cpu.coreUtilization.size() > 1) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f),
+                                  "【GPU %zu】检测到单核瓶颈:", i);
+                ImGui::Text("  有逻辑 CPU 持续满载而总利用率只有 %.0f%%，可能是单线程的数据加载或预处理（如 num_workers=0）。",
+                            cpuUtilization);
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && ioStall >= 10.0f) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f),
+                                  "【GPU %zu】检测到 IO 停顿:", i);
+                ImGui::Text("  近 %d 秒内%s的数据加载有 %.0f%% 的墙钟时间停顿在 IO 上（所有任务同时停顿 %.0f%%）。",
+                            kDiagnosisWindowSeconds, pressureScope, ioStall, ioFullStall);
+                ImGui::Text("  请把数据集放到更快的存储、增大 prefetch_factor，或先把数据集缓存到内存。");
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && memoryStall >= 10.0f) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f),
+                                  "【GPU %zu】检测到内存停顿:", i);
+                ImGui::Text("  近 %d 秒内%s的任务有 %.0f%% 的墙钟时间在等待内存回收或换入。",
+                            kDiagnosisWindowSeconds, pressureScope, memoryStall);
+                ImGui::Text("  请减少 num_workers 或数据缓存的大小，避免内存回收和换页。");
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && gpu.memoryPercent < 50.0f) {
                 ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), 
-                                  "【GPU %d】检测到计算未饱和:", i);
+                                  "【GPU %zu】检测到计算未饱和:", i);
                 ImGui::Text("  请尝试增大 batch_size 以提升并行度。");
-                hasIssue = true;
-            } else if (gpu.utilization < 70.0f && gpu.memoryPercent > 90.0f) {
+                flagged = true;
+            } else if (gpuUtilization < 70.0f && gpu.memoryPercent > 90.0f) {
                 ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), 
-                                  "【GPU %d】显存已满但利用率低:", i);
+                                  "【GPU %zu】显存已满但利用率低:", i);
                 ImGui::Text("  可能是复杂的循环计算、频繁的数据拷贝或小尺寸数据的频繁计算。");
+                flagged = true;
+            }
+            if (flagged) {
+                if (hasPercentiles) {
+                    ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+                                       "  近 %d 秒 GPU 利用率 p50 %.0f%% / p95 %.0f%% / p99 %.0f%%，CPU 利用率 p50 %.0f%%",
+                                       kDiagnosisWindowSeconds, gpuPercentiles.p50, gpuPercentiles.p95,
+                                       gpuPercentiles.p99, cpuUtilization);
+                }
                 hasIssue = true;
             }
         }
     }
 
+    // 内存颠簸：按实测的换入换出和主缺页判断，而不是按内存使用率猜测
+    const MemoryInfo& memory = snapshot.GetMemoryInfo();
+    HistoryBucket swapIn;
+    HistoryBucket swapOut;
+    HistoryBucket majorFaults;
+    float swapRate = memory.swapInRate + memory.swapOutRate;
+    float majorFaultRate = memory.majorFaultRate;
+    if (snapshot.series.Summarize(memory.swapInSeries, window, swapIn) &&
+        snapshot.series.Summarize(memory.swapOutSeries, window, swapOut) &&
+        snapshot.series.Summarize(memory.majorFaultSeries, window, majorFaults)) {
+        swapRate = swapIn.mean + swapOut.mean;
+        majorFaultRate = majorFaults.mean;
+    }
+    if (swapRate > 1.0f || majorFaultRate > 500.0f) {
+        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "检测到内存颠簸:");
+        ImGui::Text("  近 %d 秒平均换页 %.1f MB/s、主缺页 %.0f 次/秒，数据集缓存或 DataLoader 进程已超出物理内存。",
+                    kDiagnosisWindowSeconds, swapRate, majorFaultRate);
+        ImGui::Text("  请减少 num_workers 或预取数量、改用内存映射读取数据集，或限制数据缓存的大小。");
+        hasIssue = true;
+    }
+
     if (!hasIssue && gpuCount > 0) {
-        const GPUInfo& gpu = monitor.GetGPUInfo(0);
-        if (gpu.available && gpu.utilization > 85.0f && 
+        const GPUInfo& gpu = snapshot.GetGPUInfo(0);
+        Percentiles gpuPercentiles;
+        float gpuUtilization = SelectPercentiles(snapshot.series, gpu.utilizationSeries, window, gpuPercentiles)
+                                   ? gpuPercentiles.p50 : gpu.utilization;
+        if (gpu.available && gpuUtilization > 85.0f && 
             gpu.memoryPercent > 80.0f && gpu.memoryPercent < 95.0f &&
-            monitor.GetCPUInfo().utilization > 30.0f && 
-            monitor.GetCPUInfo().utilization < 70.0f) {
+            cpuUtilization > 30.0f && 
+            cpuUtilization < 70.0f) {
             ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "✓ 硬件资源使用状态良好！");
         }
     }
@@ -1343,32 +1647,195 @@ void ImGuiApp::DrawCircularProgress(const char* label, float value, float min, f
     ImGui::SetCursorScreenPos(ImVec2(canvas_pos.x, canvas_pos.y + size.y + ImGui::GetStyle().ItemSpacing.y));
 }
 
-void ImGuiApp::DrawHistoryChart(const char* label, const std::vector<float>& history, 
+// 利用率对应的热力图颜色：0% 为深蓝灰，经绿、黄到 100% 的红色
+static ImU32 HeatmapColor(float percent) {
+    float t = std::max(0.0f, std::min(1.0f, percent / 100.0f));
+    if (t < 0.02f) {
+        return IM_COL32(40, 45, 60, 255);
+    }
+    int red = t < 0.5f ? static_cast<int>(t * 2.0f * 255.0f) : 255;
+    int green = t < 0.5f ? 200 : static_cast<int>((1.0f - t) * 2.0f * 200.0f);
+    return IM_COL32(red, green, 40, 255);
+}
+
+void ImGuiApp::DrawCoreHeatmap(const CPUInfo& cpu) {
+    const float cell = 9.0f;         // 方块边长
+    const float gap = 1.0f;          // 方块间距
+    const float bandGap = 4.0f;      // 换行后两排之间的间距
+    const size_t count = std::min(cpu.logicalCpus.size(), cpu.coreUtilization.size());
+    const float width = std::max(cell, ImGui::GetContentRegionAvail().x);
+    const size_t columnsPerRow = std::max<size_t>(1, static_cast<size_t>((width + gap) / (cell + gap)));
+    const ImVec2 mouse = ImGui::GetMousePos();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    size_t hovered = count;
+
+    // 逻辑 CPU 已按 (插槽, 物理核心, 超线程) 排好序：每个插槽一段，段内每个物理核心一列，超线程从上到下
+    for (size_t begin = 0; begin < count;) {
+        unsigned int socket = cpu.logicalCpus[begin].socket;
+        size_t end = begin;
+        size_t cores = 0;
+        unsigned int threads = 1;
+        while (end < count && cpu.logicalCpus[end].socket == socket) {
+            if (cpu.logicalCpus[end].thread == 0) {
+                cores++;
+            }
+            threads = std::max(threads, cpu.logicalCpus[end].thread + 1);
+            end++;
+        }
+        if (begin > 0 || end < count) {
+            ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "插槽 %u", socket);
+        }
+
+        size_t bands = (cores + columnsPerRow - 1) / columnsPerRow;
+        float bandHeight = threads * (cell + gap) - gap;
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        size_t column = 0;
+        for (size_t i = begin; i < end; i++) {
+            const LogicalCpuInfo& logical = cpu.logicalCpus[i];
+            if (logical.thread == 0 && i > begin) {
+                column++;
+            }
+            float x = origin.x + (column % columnsPerRow) * (cell + gap);
+            float y = origin.y + (column / columnsPerRow) * (bandHeight + bandGap) + logical.thread * (cell + gap);
+            ImVec2 minCorner(x, y);
+            ImVec2 maxCorner(x + cell, y + cell);
+            drawList->AddRectFilled(minCorner, maxCorner, HeatmapColor(cpu.coreUtilization[i]));
+            if (mouse.x >= minCorner.x && mouse.x < maxCorner.x + gap && mouse.y >= minCorner.y && mouse.y < maxCorner.y + gap) {
+                hovered = i;
+            }
+        }
+        float usedWidth = std::min(cores, columnsPerRow) * (cell + gap);
+        ImGui::Dummy(ImVec2(usedWidth, bands * (bandHeight + bandGap)));
+        begin = end;
+    }
+
+    if (hovered < count && ImGui::IsWindowHovered()) {
+        const LogicalCpuInfo& logical = cpu.logicalCpus[hovered];
+        ImGui::SetTooltip("CPU %u（插槽 %u / 核心 %u / 超线程 %u）: %.1f%%", logical.id, logical.socket,
+                          logical.core, logical.thread, cpu.coreUtilization[hovered]);
+    }
+}
+
+void ImGuiApp::DrawHistoryChart(const char* label, const SeriesStore& series, MetricId metric,
                                 float scaleMin, float scaleMax, const char* unit) {
-    if (history.empty()) return;
+    if (series.Empty(metric)) return;
+
+    // 按当前时间窗口选择分辨率：短窗口用原始样本，长窗口用压缩历史的全部样本，
+    // 压缩历史已淘汰了窗口开头的数据时用 10秒/1分钟/10分钟 聚合桶的均值
+    SeriesStore::View view = series.Select(metric, HistoryWindow());
+    static const char* kTierNames[] = {"10秒", "1分钟", "10分钟"};
+    const char* resolution = view.Tier() < 0 ? "原始"
+                           : UseArchive(series, metric) ? "全分辨率"
+                           : kTierNames[view.Tier()];
 
     ImGui::Text("%s", label);
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "(%s, %s)", kHistoryWindows[historyWindow_].label, resolution);
     
     // 使用 label 作为 PlotLines 的 ID，确保每个图表都有唯一的 ID
     // ImGui 要求每个控件都必须有唯一的 ID，不能使用空字符串
     std::string plotId = std::string(label) + "##Plot";
-    ImGui::PlotLines(plotId.c_str(), history.data(), static_cast<int>(history.size()), 
-                     0, nullptr, scaleMin, scaleMax, 
-                     ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+    PlotSeries(plotId.c_str(), series, metric, scaleMin, scaleMax,
+               ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
     
-    // 显示当前值
-    float current = history.back();
-    ImGui::Text("当前: %.1f%s  最小: %.1f%s  最大: %.1f%s", 
+    // 显示当前值；最小/最大/平均值由采样线程按窗口增量维护，不受聚合平均的影响，也不需要逐帧扫描
+    float current = series.Latest(metric);
+    HistoryBucket summary;
+    series.Summarize(metric, HistoryWindow(), summary);
+    ImGui::Text("当前: %.1f%s  最小: %.1f%s  最大: %.1f%s  平均: %.1f%s", 
                 current, unit,
-                *std::min_element(history.begin(), history.end()), unit,
-                *std::max_element(history.begin(), history.end()), unit);
+                summary.minValue, unit,
+                summary.maxValue, unit,
+                summary.mean, unit);
+
+    // 有分位数草图的指标再显示窗口内的分布，悬停时显示整个会话的分布
+    Percentiles percentiles;
+    if (SelectPercentiles(series, metric, HistoryWindow(), percentiles)) {
+        ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "p50: %.1f%s  p95: %.1f%s  p99: %.1f%s",
+                           percentiles.p50, unit, percentiles.p95, unit, percentiles.p99, unit);
+        if (ImGui::IsItemHovered() && series.SessionQuantiles(metric, quantileScratch_)) {
+            ImGui::SetTooltip("整个会话 (%llu 个样本)\np50: %.1f%s  p95: %.1f%s  p99: %.1f%s",
+                              static_cast<unsigned long long>(quantileScratch_.Count()),
+                              quantileScratch_.Quantile(0.50), unit,
+                              quantileScratch_.Quantile(0.95), unit,
+                              quantileScratch_.Quantile(0.99), unit);
+        }
+    }
+}
+
+bool ImGuiApp::SelectPercentiles(const SeriesStore& series, MetricId metric,
+                                 std::chrono::steady_clock::duration window, Percentiles& result) {
+    if (!series.SelectQuantiles(metric, window, quantileScratch_)) {
+        return false;
+    }
+    result.p50 = quantileScratch_.Quantile(0.50);
+    result.p95 = quantileScratch_.Quantile(0.95);
+    result.p99 = quantileScratch_.Quantile(0.99);
+    return true;
+}
+
+std::chrono::steady_clock::duration ImGuiApp::HistoryWindow() const {
+    return std::chrono::seconds(kHistoryWindows[historyWindow_].seconds);
+}
+
+void ImGuiApp::PlotSeries(const char* id, const SeriesStore& series, MetricId metric,
+                          float scaleMin, float scaleMax, const ImVec2& size) {
+    // 与 PlotLines 相同的宽度规则：负数表示相对可用宽度，0 表示默认控件宽度
+    float width = size.x > 0.0f ? size.x
+                : size.x < 0.0f ? ImGui::GetContentRegionAvail().x + size.x
+                : ImGui::CalcItemWidth();
+    int pixels = std::max(3, static_cast<int>(width));
+
+    PlotCache& cache = plotCache_[ImGui::GetID(id)];
+    bool archived = UseArchive(series, metric);
+    std::chrono::steady_clock::time_point end = series.TimeAt(series.Size() - 1);
+    bool stale = cache.revision != series.Revision();
+    if (archived && cache.archived) {
+        // 一个像素对应 window / pixels 的时长，不足一个像素的新样本在曲线上看不出来
+        stale = end - cache.end >= HistoryWindow() / pixels;
+    }
+    if (cache.metric != metric || cache.window != historyWindow_ || cache.width != pixels ||
+        cache.archived != archived || stale) {
+        if (archived) {
+            archiveScratch_.clear();
+            archive_->Read(metric, end - HistoryWindow(), end, archiveScratch_);
+            plotScratch_.resize(archiveScratch_.size());
+            for (size_t i = 0; i < plotScratch_.size(); i++) {
+                plotScratch_[i] = archiveScratch_[i].value;
+            }
+        } else {
+            // 空桶（采样停顿、挂起）记为 NaN：PlotLines 不连接 NaN 两侧的点，时间轴上留出空白
+            SeriesStore::View view = series.Select(metric, HistoryWindow());
+            plotScratch_.resize(static_cast<size_t>(view.Count()));
+            for (size_t i = 0; i < plotScratch_.size(); i++) {
+                plotScratch_[i] = view.Gap(i) ? std::numeric_limits<float>::quiet_NaN() : view.Mean(i);
+            }
+        }
+        DownsampleLttb(plotScratch_.data(), plotScratch_.size(), static_cast<size_t>(pixels), cache.points);
+        cache.metric = metric;
+        cache.revision = series.Revision();
+        cache.window = historyWindow_;
+        cache.width = pixels;
+        cache.archived = archived;
+        cache.end = end;
+    }
+
+    ImGui::PlotLines(id, cache.points.data(), static_cast<int>(cache.points.size()),
+                     0, nullptr, scaleMin, scaleMax, size);
+}
+
+bool ImGuiApp::UseArchive(const SeriesStore& series, MetricId metric) const {
+    if (archive_ == nullptr || series.Empty(metric) || series.Select(metric, HistoryWindow()).Tier() < 0) {
+        return false;
+    }
+    return archive_->Covers(metric, series.TimeAt(series.Size() - 1) - HistoryWindow());
 }
 
-bool ImGuiApp::ShouldClose() const {
-    return window_ ? glfwWindowShouldClose(window_) : true;
+float ImGuiApp::HistoryMax(const SeriesStore& series, MetricId metric) const {
+    HistoryBucket summary;
+    return series.Summarize(metric, HistoryWindow(), summary) ? summary.maxValue : 0.0f;
 }
 
-// 绘制卡片容器（使用函数指针而不是 std::function 以避免头文件依赖）
 void ImGuiApp::DrawCard(const char* title, const ImVec4& color, std::function<void()> content) {
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(color.x * 0.15f, color.y * 0.15f, color.z * 0.15f, 0.3f));
     ImGui::PushStyleColor(ImGuiCol_Border, color);
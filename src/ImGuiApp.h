@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "HardwareMonitor.h"
 #include <functional>
 #include "imgui.h"
@@ -17,30 +21,90 @@ public:
     bool Initialize();
     void Shutdown();
     
+    // 事件驱动的主循环：WaitEvents 等待输入事件、新快照（Wake）或空闲超时，NeedsFrame 判断本轮是否渲染。
+    // 没有新数据也没有操作时界面不重绘；最小化、帧缓冲为 0 或不可见时完全不渲染，
+    // 失去焦点（可能被其他窗口遮挡）时新快照不唤醒，只按空闲超时每秒刷新一次。
+    // block 为 false 时只处理已有事件、不等待（基准测试不限帧率）
+    void WaitEvents(bool block);
+    bool NeedsFrame(bool newSnapshot);
+    // 唤醒 WaitEvents（任意线程可调用，如采样线程发布新快照后）；窗口隐藏或失去焦点时不唤醒
+    void Wake();
+
     void BeginFrame();
     void EndFrame();
-    void Render(const HardwareMonitor& monitor);
+    void Render(const HardwareSnapshot& snapshot);
+    // 全分辨率压缩历史：窗口超出原始数据的覆盖范围时，图表从这里读取而不是用聚合桶（为空时只用 SeriesStore）
+    void SetArchive(const HistoryArchive* archive) { archive_ = archive; }
     
     bool ShouldClose() const;
 
 private:
-    void RenderMainWindow(const HardwareMonitor& monitor);
-    void RenderGPUInfo(const GPUInfo& gpu, int index);
-    void RenderCPUInfo(const CPUInfo& cpu);
-    void RenderMemoryInfo(const MemoryInfo& memory);
-    void RenderSystemBandwidthInfo(const SystemBandwidthInfo& bandwidth, const HardwareMonitor& monitor);
-    void RenderDiagnosis(const HardwareMonitor& monitor);
+    // 快照超过该时长未更新时，标题栏提示数据延迟
+    static constexpr float kStaleSnapshotSeconds = 3.0f;
+    // 没有新快照和输入时的最长等待时间（到时重绘一帧，刷新数据延迟提示）
+    static constexpr double kIdleTimeoutSeconds = 1.0;
+    // 输入事件之后连续渲染的帧数（ImGui 的点击、悬停等状态需要后续几帧才能完成）
+    static constexpr int kInputFrames = 3;
+
+    // 历史图表可选的时间窗口，与 SeriesStore::kWindowSeconds 一一对应（采样线程预先维护滑动统计）
+    struct HistoryWindowOption {
+        const char* label;
+        int seconds;
+    };
+    static constexpr int kHistoryWindowCount = 6;
+    static constexpr HistoryWindowOption kHistoryWindows[kHistoryWindowCount] = {
+        {"1 分钟", SeriesStore::kWindowSeconds[0]},
+        {"10 分钟", SeriesStore::kWindowSeconds[1]},
+        {"1 小时", SeriesStore::kWindowSeconds[2]},
+        {"6 小时", SeriesStore::kWindowSeconds[3]},
+        {"24 小时", SeriesStore::kWindowSeconds[4]},
+        {"60 小时", SeriesStore::kWindowSeconds[5]},
+    };
+    static_assert(kHistoryWindowCount == static_cast<int>(SeriesStore::kWindowCount),
+                  "history windows must match SeriesStore::kWindowSeconds");
+
+    // 诊断使用的统计窗口：看最近一段时间的分布，而不是单个瞬时值
+    static constexpr int kDiagnosisWindowSeconds = 60;
+
+    struct Percentiles {
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+    };
+
+    void RenderMainWindow(const HardwareSnapshot& snapshot);
+    void RenderGPUInfo(const GPUInfo& gpu, int index, const SeriesStore& series);
+    void RenderCPUInfo(const CPUInfo& cpu, const SeriesStore& series);
+    void RenderMemoryInfo(const MemoryInfo& memory, const SeriesStore& series);
+    void RenderSystemBandwidthInfo(const SystemBandwidthInfo& bandwidth, const HardwareSnapshot& snapshot);
+    void RenderPressureInfo(const HardwareSnapshot& snapshot);
+    void RenderDiagnosis(const HardwareSnapshot& snapshot);
     void DrawProgressBar(const char* label, float value, float min, float max, 
                         const char* suffix = "%", unsigned int  color = 0);
     void DrawCircularProgress(const char* label, float value, float min, float max, 
                              const ImVec2& size, const ImVec4& color, const char* unit = "%");
-    void DrawHistoryChart(const char* label, const std::vector<float>& history, 
+    // 逻辑 CPU 利用率热力图：每个逻辑 CPU 一个小方块，同一物理核心的超线程上下相邻，按插槽分组，宽度不够时换行
+    void DrawCoreHeatmap(const CPUInfo& cpu);
+    void DrawHistoryChart(const char* label, const SeriesStore& series, MetricId metric,
                          float scaleMin, float scaleMax, const char* unit = "%");
+    std::chrono::steady_clock::duration HistoryWindow() const;
+    // 当前历史窗口是否从压缩历史读取：窗口超出原始数据，且压缩历史完整保留了整个窗口
+    bool UseArchive(const SeriesStore& series, MetricId metric) const;
+    // 绘制指标在当前历史窗口内的曲线：点数超过图表像素宽度时用 LTTB 降采样，结果按图表缓存
+    void PlotSeries(const char* id, const SeriesStore& series, MetricId metric,
+                    float scaleMin, float scaleMax, const ImVec2& size);
+    // 当前历史窗口内的最大值（图表纵轴范围），没有数据时返回 0
+    float HistoryMax(const SeriesStore& series, MetricId metric) const;
+    // 指标最近 window 时长的 p50/p95/p99，指标没有分位数草图或没有数据时返回 false
+    bool SelectPercentiles(const SeriesStore& series, MetricId metric,
+                           std::chrono::steady_clock::duration window, Percentiles& result);
     void DrawCard(const char* title, const ImVec4& color, std::function<void()> content);
     void DrawMetricCard(const char* icon, const char* label, float value, const char* unit, 
                        const ImVec4& color, float minVal = 0.0f, float maxVal = 100.0f);
     void DrawCompactMetric(const char* icon, const char* label, float value, const char* unit,
                           const ImVec4& color, float minVal = 0.0f, float maxVal = 100.0f);
+    // 在主线程上读取窗口状态，更新 hidden_ 和 suppressWake_
+    void UpdateVisibility();
     ImVec4 GetStatusColor(float value, float goodMin, float goodMax, bool reverse = false);
     const char* GetStatusIcon(float value, float goodMin, float goodMax);
 
@@ -49,5 +113,29 @@ private:
     int height_;
     GLFWwindow* window_ = nullptr;
     bool isMaximized_ = false;
+    int selectedGpu_ = 0;   // 主界面当前显示的GPU
+    int historyWindow_ = 0; // kHistoryWindows 中当前选中的时间窗口
+    int pendingFrames_ = 1; // 还需连续渲染的帧数（启动时先画一帧）
+    bool inputWake_ = false; // 最近一次 WaitEvents 在超时之前被唤醒
+    bool idleTimeout_ = false; // 最近一次 WaitEvents 等到了超时
+    bool hidden_ = false;      // 最小化、帧缓冲为 0 或不可见：不渲染
+    std::atomic<bool> suppressWake_{false}; // 隐藏或失去焦点：Wake 不发送空事件（采样线程读取）
+    QuantileSketch quantileScratch_; // 分位数查询的临时草图（复用容量，避免每帧分配）
+
+    // 曲线降采样缓存（按 ImGui 控件 ID），只在有新样本、切换指标/时间窗口或图表宽度变化时重新计算；
+    // 从压缩历史读取的曲线需要解码整个窗口，新样本累计满一个像素的时长才重新计算
+    struct PlotCache {
+        MetricId metric = kInvalidMetric;
+        uint64_t revision = 0;
+        int window = -1;
+        int width = 0;
+        bool archived = false;
+        std::chrono::steady_clock::time_point end;   // 计算时最新样本的时间
+        std::vector<float> points;
+    };
+    std::unordered_map<ImGuiID, PlotCache> plotCache_;
+    std::vector<float> plotScratch_;   // 降采样前的完整曲线（复用容量）
+    const HistoryArchive* archive_ = nullptr;
+    std::vector<ArchiveSample> archiveScratch_;   // 从压缩历史解码的样本（复用容量）
 };
 
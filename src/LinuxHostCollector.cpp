@@ -0,0 +1,687 @@
+#include "LinuxHostCollector.h"
+
+#ifdef __linux__
+#include <algorithm>
+#include <iostream>
+#include <dirent.h>
+#include <unistd.h>
+
+// 去掉 sysfs 属性首尾的空白（如 model 末尾的空格和换行）
+static std::string TrimAttribute(const char* text) {
+    std::string value(text);
+    size_t begin = value.find_first_not_of(" \t\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = value.find_last_not_of(" \t\n");
+    return value.substr(begin, end - begin + 1);
+}
+
+// 重新读取只含一个无符号整数的 sysfs 属性（频率、温度、计数器），未打开或解析失败返回 false
+static bool ReadUintAttribute(ProcFile& file, uint64_t& value) {
+    return file.IsOpen() && file.Read() && TextCursor(file.Text()).ParseUint(value);
+}
+
+// 累计计数的差值换算为每秒速率，计数回绕时按 0 计
+static float CounterRate(uint64_t current, uint64_t last, double scale, double elapsed) {
+    return current >= last ? static_cast<float>(static_cast<double>(current - last) * scale / elapsed) : 0.0f;
+}
+
+// 解析 PSI 文件中 "some"/"full" 之后的部分："avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+static bool ParsePressureLine(TextCursor& cursor, double& avg10, uint64_t& total) {
+    double avg60 = 0.0;
+    double avg300 = 0.0;
+    return cursor.Match("avg10=") && cursor.ParseDouble(avg10) &&
+           cursor.Match("avg60=") && cursor.ParseDouble(avg60) &&
+           cursor.Match("avg300=") && cursor.ParseDouble(avg300) &&
+           cursor.Match("total=") && cursor.ParseUint(total);
+}
+
+LinuxHostCollector::LinuxHostCollector(const std::string& root, const std::string& cgroup)
+    : root_(root), cgroup_(cgroup) {
+    // 统一去掉末尾的 '/'，之后拼接的相对路径都以 '/' 开头
+    while (!root_.empty() && root_.back() == '/') {
+        root_.pop_back();
+    }
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        pageSize_ = static_cast<uint64_t>(pageSize);
+    }
+}
+
+bool LinuxHostCollector::Initialize() {
+    if (!stat_.Open(Path("/proc/stat"))) {
+        std::cerr << "警告: 无法打开 " << Path("/proc/stat") << std::endl;
+        return false;
+    }
+    if (!meminfo_.Open(Path("/proc/meminfo"))) {
+        std::cerr << "警告: 无法打开 " << Path("/proc/meminfo") << std::endl;
+        return false;
+    }
+    if (!vmstat_.Open(Path("/proc/vmstat"))) {
+        std::cerr << "警告: 无法打开 " << Path("/proc/vmstat") << "，换页速率不可用" << std::endl;
+    }
+    if (!diskstats_.Open(Path("/proc/diskstats"))) {
+        std::cerr << "警告: 无法打开 " << Path("/proc/diskstats") << "，磁盘带宽不可用" << std::endl;
+    }
+    return true;
+}
+
+void LinuxHostCollector::Shutdown() {
+    stat_.Close();
+    meminfo_.Close();
+    vmstat_.Close();
+    diskstats_.Close();
+    coreFrequencies_.clear();
+    throttleCounters_.clear();
+    temperatures_.clear();
+    pressureSources_.clear();
+}
+
+bool LinuxHostCollector::ParseCpuTimes(TextCursor& cursor, CpuTimes& times) {
+    // user nice system idle iowait irq softirq steal guest guest_nice
+    // guest 已计入 user，不重复累加；idle 和 iowait 算作空闲
+    uint64_t fields[8] = {};
+    for (uint64_t& field : fields) {
+        if (!cursor.ParseUint(field)) {
+            return false;
+        }
+    }
+    times.total = 0;
+    for (uint64_t field : fields) {
+        times.total += field;
+    }
+    times.busy = times.total - fields[3] - fields[4];
+    return true;
+}
+
+float LinuxHostCollector::Utilization(const CpuTimes& current, const CpuTimes& last) {
+    if (current.total <= last.total || current.busy < last.busy) {
+        return 0.0f;
+    }
+    double busy = static_cast<double>(current.busy - last.busy);
+    double total = static_cast<double>(current.total - last.total);
+    return static_cast<float>(std::min(1.0, busy / total) * 100.0);
+}
+
+bool LinuxHostCollector::UpdateCPUTopology(CPUInfo& cpu) {
+    // 每个在线的逻辑 CPU 有 topology/physical_package_id 和 topology/core_id（离线的 CPU 没有 topology 目录）
+    cpu.logicalCpus.clear();
+    std::string cpuPath = Path("/sys/devices/system/cpu");
+    DIR* dir = opendir(cpuPath.c_str());
+    if (dir != nullptr) {
+        ProcFile attribute;
+        while (dirent* entry = readdir(dir)) {
+            TextCursor name(entry->d_name);
+            uint64_t id = 0;
+            if (!name.Match("cpu") || !name.ParseUint(id) || !name.AtEnd()) {
+                continue;
+            }
+            std::string topologyPath = cpuPath + "/" + entry->d_name + "/topology/";
+            uint64_t core = 0;
+            if (!ProcFile::ReadOnce(topologyPath + "core_id", attribute) ||
+                !TextCursor(attribute.Text()).ParseUint(core)) {
+                continue;
+            }
+            // 部分虚拟机中 physical_package_id 为 -1，按插槽 0 处理
+            uint64_t socket = 0;
+            if (ProcFile::ReadOnce(topologyPath + "physical_package_id", attribute)) {
+                TextCursor(attribute.Text()).ParseUint(socket);
+            }
+            LogicalCpuInfo logical;
+            logical.id = static_cast<unsigned int>(id);
+            logical.socket = static_cast<unsigned int>(socket);
+            logical.core = static_cast<unsigned int>(core);
+            // cpuinfo_max_freq 单位为 kHz，没有 cpufreq 驱动（如部分虚拟机）时不存在
+            uint64_t maxFrequency = 0;
+            if (ProcFile::ReadOnce(cpuPath + "/" + entry->d_name + "/cpufreq/cpuinfo_max_freq", attribute) &&
+                TextCursor(attribute.Text()).ParseUint(maxFrequency)) {
+                logical.maxFrequency = static_cast<float>(maxFrequency) / 1000.0f;
+            }
+            cpu.logicalCpus.push_back(logical);
+        }
+        closedir(dir);
+    }
+
+    // sysfs 不可用时按 /proc/stat 中的 cpuN 行生成平铺拓扑（每个逻辑 CPU 视为一个物理核心）
+    if (cpu.logicalCpus.empty() && stat_.Read()) {
+        TextCursor cursor(stat_.Text());
+        for (cursor.NextLine(); cursor.Match("cpu"); cursor.NextLine()) {
+            uint64_t id = 0;
+            if (cursor.ParseUint(id)) {
+                LogicalCpuInfo logical;
+                logical.id = static_cast<unsigned int>(id);
+                logical.core = static_cast<unsigned int>(id);
+                cpu.logicalCpus.push_back(logical);
+            }
+        }
+    }
+
+    SortLogicalCpus(cpu);
+    unsigned int maxId = 0;
+    for (const LogicalCpuInfo& logical : cpu.logicalCpus) {
+        maxId = std::max(maxId, logical.id);
+    }
+    cpuIndex_.assign(cpu.logicalCpus.empty() ? 0 : maxId + 1, -1);
+    for (size_t i = 0; i < cpu.logicalCpus.size(); i++) {
+        cpuIndex_[cpu.logicalCpus[i].id] = static_cast<int>(i);
+    }
+    lastCores_.assign(cpu.logicalCpus.size(), CpuTimes());
+    OpenThermalFiles(cpu);
+    return true;
+}
+
+void LinuxHostCollector::UpdateCPU(CPUInfo& cpu) {
+    if (!stat_.Read()) {
+        return;
+    }
+
+    // 第一行为所有 CPU 的合计，之后每个在线的逻辑 CPU 一行（cpuN），一次读取得到全部
+    TextCursor cursor(stat_.Text());
+    CpuTimes times;
+    if (!cursor.Match("cpu ") || !ParseCpuTimes(cursor, times)) {
+        return;
+    }
+    if (cpuSampled_) {
+        cpu.utilization = Utilization(times, lastCpu_);
+    }
+    lastCpu_ = times;
+    cpuSampled_ = true;
+
+    bool sizesMatch = cpu.coreUtilization.size() == lastCores_.size();
+    for (cursor.NextLine(); sizesMatch && cursor.Match("cpu"); cursor.NextLine()) {
+        uint64_t id = 0;
+        if (!cursor.ParseUint(id) || !ParseCpuTimes(cursor, times)) {
+            continue;
+        }
+        // 采集开始后上线的 CPU 不在清单中，忽略
+        if (id >= cpuIndex_.size() || cpuIndex_[id] < 0) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(cpuIndex_[id]);
+        if (lastCores_[index].total > 0) {
+            cpu.coreUtilization[index] = Utilization(times, lastCores_[index]);
+        }
+        lastCores_[index] = times;
+    }
+}
+
+void LinuxHostCollector::OpenThermalFiles(const CPUInfo& cpu) {
+    std::string cpuPath = Path("/sys/devices/system/cpu/cpu");
+    coreFrequencies_.clear();
+    coreFrequencies_.resize(cpu.logicalCpus.size());
+    throttleCounters_.clear();
+    lastThrottleCount_ = 0;
+    throttleSampled_ = false;
+
+    for (size_t i = 0; i < cpu.logicalCpus.size(); i++) {
+        const LogicalCpuInfo& logical = cpu.logicalCpus[i];
+        std::string path = cpuPath + std::to_string(logical.id);
+        coreFrequencies_[i].Open(path + "/cpufreq/scaling_cur_freq");
+
+        // 同一物理核心的超线程共用核心计数，同一插槽的逻辑 CPU 共用插槽计数，各只读一份
+        ProcFile counter;
+        if (logical.thread == 0 && counter.Open(path + "/thermal_throttle/core_throttle_count")) {
+            throttleCounters_.push_back(std::move(counter));
+        }
+        bool firstInSocket = i == 0 || cpu.logicalCpus[i - 1].socket != logical.socket;
+        if (firstInSocket && counter.Open(path + "/thermal_throttle/package_throttle_count")) {
+            throttleCounters_.push_back(std::move(counter));
+        }
+    }
+    ScanTemperatureSensors();
+}
+
+void LinuxHostCollector::ScanTemperatureSensors() {
+    temperatures_.clear();
+    ProcFile attribute;
+
+    // coretemp（Intel）的标签为 "Package id N"/"Core N"，k10temp/zenpower（AMD）为 "Tctl"/"Tdie"/"TccdN"
+    std::string hwmonPath = Path("/sys/class/hwmon");
+    if (DIR* dir = opendir(hwmonPath.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string devicePath = hwmonPath + "/" + entry->d_name + "/";
+            if (entry->d_name[0] == '.' || !ProcFile::ReadOnce(devicePath + "name", attribute)) {
+                continue;
+            }
+            std::string driver = TrimAttribute(attribute.Text());
+            if (driver != "coretemp" && driver != "k10temp" && driver != "zenpower") {
+                continue;
+            }
+            DIR* device = opendir(devicePath.c_str());
+            if (device == nullptr) {
+                continue;
+            }
+            while (dirent* input = readdir(device)) {
+                TextCursor name(input->d_name);
+                uint64_t index = 0;
+                if (!name.Match("temp") || !name.ParseUint(index) || !name.Match("_input") || !name.AtEnd()) {
+                    continue;
+                }
+                TemperatureSensor sensor;
+                if (!sensor.file.Open(devicePath + input->d_name)) {
+                    continue;
+                }
+                // 没有标签的输入（旧版 k10temp 只有 Tctl）按插槽温度处理
+                if (ProcFile::ReadOnce(devicePath + "temp" + std::to_string(index) + "_label", attribute)) {
+                    TextCursor label(attribute.Text());
+                    sensor.package = !label.Match("Core") && !label.Match("Tccd");
+                }
+                temperatures_.push_back(std::move(sensor));
+            }
+            closedir(device);
+        }
+        closedir(dir);
+    }
+    if (!temperatures_.empty()) {
+        return;
+    }
+
+    // 没有 hwmon 驱动时使用温区：x86_pkg_temp 为 Intel 插槽温度，ARM 平台的 CPU 温区名称中带 cpu
+    std::string thermalPath = Path("/sys/class/thermal");
+    if (DIR* dir = opendir(thermalPath.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string zonePath = thermalPath + "/" + entry->d_name + "/";
+            if (std::string(entry->d_name).compare(0, 12, "thermal_zone") != 0 ||
+                !ProcFile::ReadOnce(zonePath + "type", attribute)) {
+                continue;
+            }
+            std::string type = TrimAttribute(attribute.Text());
+            if (type != "x86_pkg_temp" && type.find("cpu") == std::string::npos) {
+                continue;
+            }
+            TemperatureSensor sensor;
+            if (sensor.file.Open(zonePath + "temp")) {
+                temperatures_.push_back(std::move(sensor));
+            }
+        }
+        closedir(dir);
+    }
+}
+
+void LinuxHostCollector::UpdateCPUThermal(CPUInfo& cpu) {
+    // scaling_cur_freq 单位为 kHz；平均频率只统计能读到频率的逻辑 CPU
+    if (cpu.coreFrequency.size() == coreFrequencies_.size()) {
+        double sum = 0.0;
+        size_t count = 0;
+        for (size_t i = 0; i < coreFrequencies_.size(); i++) {
+            uint64_t frequency = 0;
+            if (ReadUintAttribute(coreFrequencies_[i], frequency)) {
+                cpu.coreFrequency[i] = static_cast<float>(frequency) / 1000.0f;
+                sum += cpu.coreFrequency[i];
+                count++;
+            }
+        }
+        if (count > 0) {
+            cpu.frequency = static_cast<float>(sum / static_cast<double>(count));
+        }
+    }
+
+    // 温度单位为毫摄氏度，多插槽/多核心各取最高值
+    uint64_t packageTemperature = 0;
+    uint64_t coreTemperature = 0;
+    bool hasPackage = false;
+    bool hasCore = false;
+    for (TemperatureSensor& sensor : temperatures_) {
+        uint64_t temperature = 0;
+        if (!ReadUintAttribute(sensor.file, temperature)) {
+            continue;
+        }
+        if (sensor.package) {
+            packageTemperature = std::max(packageTemperature, temperature);
+            hasPackage = true;
+        } else {
+            coreTemperature = std::max(coreTemperature, temperature);
+            hasCore = true;
+        }
+    }
+    if (hasPackage) {
+        cpu.temperature = static_cast<float>(packageTemperature) / 1000.0f;
+    }
+    if (hasCore) {
+        cpu.maxCoreTemperature = static_cast<float>(coreTemperature) / 1000.0f;
+    }
+
+    // 降频计数只增不减，换算为两次采样之间的事件速率
+    if (throttleCounters_.empty()) {
+        return;
+    }
+    uint64_t total = 0;
+    for (ProcFile& counter : throttleCounters_) {
+        uint64_t count = 0;
+        if (ReadUintAttribute(counter, count)) {
+            total += count;
+        }
+    }
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastThrottleSample_).count();
+    if (throttleSampled_ && elapsed > 0.0) {
+        cpu.throttleRate = CounterRate(total, lastThrottleCount_, 1.0, elapsed);
+    }
+    lastThrottleCount_ = total;
+    lastThrottleSample_ = now;
+    throttleSampled_ = true;
+}
+
+bool LinuxHostCollector::ReadMemInfo(MemInfoFields& fields) {
+    if (!meminfo_.Read()) {
+        return false;
+    }
+    // Dirty/Writeback 在 MemAvailable 之后，读到 Writeback 即可停止
+    bool hasTotal = false;
+    bool hasAvailable = false;
+    bool hasWriteback = false;
+    for (TextCursor cursor(meminfo_.Text()); !cursor.AtEnd() && !hasWriteback; cursor.NextLine()) {
+        if (cursor.Match("MemTotal:")) {
+            hasTotal = cursor.ParseUint(fields.totalKb);
+        } else if (cursor.Match("MemAvailable:")) {
+            hasAvailable = cursor.ParseUint(fields.availableKb);
+        } else if (cursor.Match("Dirty:")) {
+            cursor.ParseUint(fields.dirtyKb);
+        } else if (cursor.Match("Writeback:")) {
+            hasWriteback = cursor.ParseUint(fields.writebackKb);
+        }
+    }
+    return hasTotal && hasAvailable;
+}
+
+bool LinuxHostCollector::ReadVmStat(VmCounters& counters) {
+    if (!vmstat_.IsOpen() || !vmstat_.Read()) {
+        return false;
+    }
+    // 每行 "名称 值"，名称带上空格匹配，避免 pgpgin 匹配到同前缀的其他计数
+    int found = 0;
+    for (TextCursor cursor(vmstat_.Text()); !cursor.AtEnd() && found < 5; cursor.NextLine()) {
+        uint64_t* counter = cursor.Match("pgpgin ") ? &counters.pageIn
+                          : cursor.Match("pgpgout ") ? &counters.pageOut
+                          : cursor.Match("pswpin ") ? &counters.swapIn
+                          : cursor.Match("pswpout ") ? &counters.swapOut
+                          : cursor.Match("pgmajfault ") ? &counters.majorFaults
+                          : nullptr;
+        if (counter != nullptr && cursor.ParseUint(*counter)) {
+            found++;
+        }
+    }
+    return found == 5;
+}
+
+void LinuxHostCollector::UpdateMemory(MemoryInfo& memory) {
+    MemInfoFields fields;
+    if (!ReadMemInfo(fields) || fields.totalKb == 0) {
+        return;
+    }
+    memory.total = static_cast<float>(fields.totalKb) / (1024.0f * 1024.0f);  // GB
+    memory.available = static_cast<float>(fields.availableKb) / (1024.0f * 1024.0f);  // GB
+    memory.used = memory.total - memory.available;
+    memory.percent = static_cast<float>(fields.totalKb - fields.availableKb) / static_cast<float>(fields.totalKb) * 100.0f;
+    memory.dirty = static_cast<float>(fields.dirtyKb) / 1024.0f;  // MB
+    memory.writeback = static_cast<float>(fields.writebackKb) / 1024.0f;  // MB
+
+    VmCounters counters;
+    if (!ReadVmStat(counters)) {
+        return;
+    }
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastVmSample_).count();
+    if (vmSampled_ && elapsed > 0.0) {
+        const double kbToMb = 1.0 / 1024.0;
+        const double pagesToMb = static_cast<double>(pageSize_) / (1024.0 * 1024.0);
+        memory.pageInRate = CounterRate(counters.pageIn, lastVm_.pageIn, kbToMb, elapsed);
+        memory.pageOutRate = CounterRate(counters.pageOut, lastVm_.pageOut, kbToMb, elapsed);
+        memory.swapInRate = CounterRate(counters.swapIn, lastVm_.swapIn, pagesToMb, elapsed);
+        memory.swapOutRate = CounterRate(counters.swapOut, lastVm_.swapOut, pagesToMb, elapsed);
+        memory.majorFaultRate = CounterRate(counters.majorFaults, lastVm_.majorFaults, 1.0, elapsed);
+    }
+    lastVm_ = counters;
+    lastVmSample_ = now;
+    vmSampled_ = true;
+}
+
+bool LinuxHostCollector::UpdateMemoryModules(MemoryInfo& memory) {
+    // 内存条型号和速度只能从 DMI 表读取（需要 root 权限），这里按总容量估算
+    MemInfoFields fields;
+    if (!ReadMemInfo(fields)) {
+        return false;
+    }
+    return EstimateMemoryModules(memory, static_cast<float>(fields.totalKb) / (1024.0f * 1024.0f));
+}
+
+void LinuxHostCollector::ScanDisks(std::vector<DiskInfo>& disks) {
+    disks.clear();
+    diskDevices_.clear();
+
+    // /sys/block 下有 device 链接的才是物理磁盘（排除 loop、ram、dm-* 等虚拟设备）
+    std::vector<std::string> names;
+    std::string blockPath = Path("/sys/block");
+    DIR* dir = opendir(blockPath.c_str());
+    if (dir == nullptr) {
+        std::cerr << "警告: 无法读取 " << blockPath << "，磁盘带宽不可用" << std::endl;
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::string devicePath = blockPath + "/" + entry->d_name + "/device";
+        if (access(devicePath.c_str(), F_OK) == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    ProcFile attribute;
+    for (const std::string& name : names) {
+        std::string devicePath = blockPath + "/" + name;
+        DiskInfo disk;
+        disk.name = name;
+
+        uint64_t sectors = 0;
+        if (ProcFile::ReadOnce(devicePath + "/size", attribute)) {
+            TextCursor cursor(attribute.Text());
+            if (cursor.ParseUint(sectors)) {
+                disk.totalSize = static_cast<float>(sectors * kSectorBytes) / (1024.0f * 1024.0f * 1024.0f); // GB
+            }
+        }
+
+        bool rotational = false;
+        if (ProcFile::ReadOnce(devicePath + "/queue/rotational", attribute)) {
+            rotational = attribute.Text()[0] == '1';
+        }
+
+        // 按接口类型估算最大带宽
+        if (name.compare(0, 4, "nvme") == 0) {
+            disk.type = "NVMe";
+            disk.model = "NVMe 固态硬盘";
+            disk.maxReadBandwidth = 3.5f;  // GB/s (NVMe PCIe 3.0估算)
+            disk.maxWriteBandwidth = 2.5f; // GB/s
+        } else if (rotational) {
+            disk.type = "HDD";
+            disk.model = "机械硬盘";
+            disk.maxReadBandwidth = 0.2f;  // GB/s
+            disk.maxWriteBandwidth = 0.15f; // GB/s
+        } else {
+            disk.type = "SSD";
+            disk.model = "固态硬盘";
+            disk.maxReadBandwidth = 0.55f; // GB/s (SATA3估算)
+            disk.maxWriteBandwidth = 0.5f; // GB/s
+        }
+        if (ProcFile::ReadOnce(devicePath + "/device/model", attribute)) {
+            std::string model = TrimAttribute(attribute.Text());
+            if (!model.empty()) {
+                disk.model = model;
+            }
+        }
+
+        disks.push_back(disk);
+        DiskDevice device;
+        device.name = name;
+        diskDevices_.push_back(device);
+    }
+}
+
+bool LinuxHostCollector::UpdateDisks(std::vector<DiskInfo>& disks) {
+    bool inventoryChanged = false;
+    if (!disksScanned_) {
+        ScanDisks(disks);
+        disksScanned_ = true;
+        inventoryChanged = true;
+    }
+    if (diskDevices_.empty() || !diskstats_.Read()) {
+        return inventoryChanged;
+    }
+
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastDiskSample_).count();
+    lastDiskSample_ = now;
+
+    // 每行：major minor name reads merged sectors_read ms_read writes merged sectors_written ...
+    for (TextCursor cursor(diskstats_.Text()); !cursor.AtEnd(); cursor.NextLine()) {
+        uint64_t major = 0;
+        uint64_t minor = 0;
+        if (!cursor.ParseUint(major) || !cursor.ParseUint(minor)) {
+            continue;
+        }
+        size_t length = 0;
+        const char* name = cursor.Token(length);
+        size_t index = 0;
+        while (index < diskDevices_.size() && !TokenEquals(name, length, diskDevices_[index].name)) {
+            index++;
+        }
+        if (index == diskDevices_.size()) {
+            continue;
+        }
+
+        uint64_t fields[7] = {};
+        bool complete = true;
+        for (uint64_t& field : fields) {
+            complete = complete && cursor.ParseUint(field);
+        }
+        if (!complete) {
+            continue;
+        }
+        uint64_t sectorsRead = fields[2];
+        uint64_t sectorsWritten = fields[6];
+
+        DiskDevice& device = diskDevices_[index];
+        DiskInfo& disk = disks[index];
+        if (device.sampled && elapsed > 0.0) {
+            // 计数器在设备重置时可能回绕，差值为负时本次按 0 计
+            double readBytes = sectorsRead >= device.sectorsRead
+                ? static_cast<double>((sectorsRead - device.sectorsRead) * kSectorBytes) : 0.0;
+            double writeBytes = sectorsWritten >= device.sectorsWritten
+                ? static_cast<double>((sectorsWritten - device.sectorsWritten) * kSectorBytes) : 0.0;
+            // 转换为GB/s
+            disk.realTimeReadBandwidth = static_cast<float>(readBytes / elapsed / (1024.0 * 1024.0 * 1024.0));
+            disk.realTimeWriteBandwidth = static_cast<float>(writeBytes / elapsed / (1024.0 * 1024.0 * 1024.0));
+            disk.readUtilization = (disk.maxReadBandwidth > 0.0f) ?
+                (disk.realTimeReadBandwidth / disk.maxReadBandwidth * 100.0f) : 0.0f;
+            disk.writeUtilization = (disk.maxWriteBandwidth > 0.0f) ?
+                (disk.realTimeWriteBandwidth / disk.maxWriteBandwidth * 100.0f) : 0.0f;
+        }
+        device.sectorsRead = sectorsRead;
+        device.sectorsWritten = sectorsWritten;
+        device.sampled = true;
+    }
+    return inventoryChanged;
+}
+std::string LinuxHostCollector::CurrentCgroup() {
+    ProcFile file;
+    if (!ProcFile::ReadOnce(Path("/proc/self/cgroup"), file)) {
+        return std::string();
+    }
+    // cgroup v2 只有一行 "0::/路径"；混合模式下 v1 的各行在前
+    for (TextCursor cursor(file.Text()); !cursor.AtEnd(); cursor.NextLine()) {
+        if (cursor.Match("0::")) {
+            size_t length = 0;
+            const char* path = cursor.Token(length);
+            return std::string(path, length);
+        }
+    }
+    return std::string();
+}
+
+bool LinuxHostCollector::AddPressureScope(const std::string& scope, const std::string& directory,
+                                          const char* suffix, std::vector<PressureInfo>& pressures) {
+    PressureSource source;
+    bool opened = false;
+    for (size_t i = 0; i < kPressureResourceCount; i++) {
+        opened = source.files[i].Open(directory + kPressureResources[i].name + suffix) || opened;
+    }
+    if (!opened) {
+        return false;
+    }
+    PressureInfo pressure;
+    pressure.scope = scope;
+    pressures.push_back(pressure);
+    pressureSources_.push_back(std::move(source));
+    return true;
+}
+
+void LinuxHostCollector::ScanPressure(std::vector<PressureInfo>& pressures) {
+    pressures.clear();
+    pressureSources_.clear();
+
+    if (!AddPressureScope("system", Path("/proc/pressure/"), "", pressures)) {
+        std::cerr << "警告: 无法读取 " << Path("/proc/pressure") << "（内核未启用 PSI），系统压力停顿不可用" << std::endl;
+    }
+
+    // 未指定 cgroup 时使用采样进程自身所在的 cgroup（与训练任务同一个容器或服务时即为任务的 cgroup），根 cgroup 与系统相同
+    std::string cgroup = cgroup_.empty() ? CurrentCgroup() : cgroup_;
+    if (!cgroup.empty() && cgroup[0] != '/') {
+        cgroup.insert(0, "/");
+    }
+    if (cgroup.empty() || cgroup == "/") {
+        return;
+    }
+    if (!AddPressureScope(cgroup, Path("/sys/fs/cgroup") + cgroup + "/", ".pressure", pressures) && !cgroup_.empty()) {
+        std::cerr << "警告: 无法读取 cgroup " << cgroup << " 的压力停顿（需要 cgroup v2）" << std::endl;
+    }
+}
+
+bool LinuxHostCollector::UpdatePressure(std::vector<PressureInfo>& pressures) {
+    bool inventoryChanged = false;
+    if (!pressureScanned_) {
+        ScanPressure(pressures);
+        pressureScanned_ = true;
+        inventoryChanged = true;
+    }
+
+    // 每个文件两行 "some ..." 和 "full ..."（5.13 之前的内核 cpu 只有 some）；
+    // 停顿占比由累计停顿时间 total (µs) 的差值除以墙钟时间得到，比内核的指数平均 avg10 更贴合采样间隔
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < pressureSources_.size() && i < pressures.size(); i++) {
+        PressureSource& source = pressureSources_[i];
+        double elapsedUs = std::chrono::duration<double, std::micro>(now - source.lastSample).count();
+        for (size_t r = 0; r < kPressureResourceCount; r++) {
+            if (!source.files[r].Read()) {
+                continue;
+            }
+            double someAvg10 = 0.0;
+            double fullAvg10 = 0.0;
+            uint64_t someTotal = source.someTotal[r];
+            uint64_t fullTotal = source.fullTotal[r];
+            for (TextCursor cursor(source.files[r].Text()); !cursor.AtEnd(); cursor.NextLine()) {
+                if (cursor.Match("some")) {
+                    ParsePressureLine(cursor, someAvg10, someTotal);
+                } else if (cursor.Match("full")) {
+                    ParsePressureLine(cursor, fullAvg10, fullTotal);
+                }
+            }
+
+            PressureStat& stat = pressures[i].*kPressureResources[r].stat;
+            stat.someAvg10 = static_cast<float>(someAvg10);
+            stat.fullAvg10 = static_cast<float>(fullAvg10);
+            if (source.sampled && elapsedUs > 0.0) {
+                stat.someStall = std::min(100.0f, CounterRate(someTotal, source.someTotal[r], 100.0, elapsedUs));
+                stat.fullStall = std::min(100.0f, CounterRate(fullTotal, source.fullTotal[r], 100.0, elapsedUs));
+            }
+            source.someTotal[r] = someTotal;
+            source.fullTotal[r] = fullTotal;
+        }
+        source.sampled = true;
+        source.lastSample = now;
+    }
+    return inventoryChanged;
+}
+#endif
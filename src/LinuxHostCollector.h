@@ -0,0 +1,131 @@
+#pragma once
+
+#ifdef __linux__
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "HostCollector.h"
+#include "ProcFile.h"
+
+// Linux 采集后端：读取 procfs/sysfs
+//   /proc/stat       CPU 时间 → 总利用率和每个逻辑 CPU 的利用率（一次读取）
+//   /sys/devices/system/cpu  逻辑 CPU 的插槽/物理核心拓扑，cpufreq 当前/最大频率，thermal_throttle 降频计数
+//   /sys/class/hwmon  coretemp/k10temp 的插槽和核心温度（没有时退回 /sys/class/thermal 中的 CPU 温区）
+//   /proc/meminfo    MemTotal/MemAvailable → 内存使用，Dirty/Writeback → 待写回的页
+//   /proc/vmstat     pgpgin/pgpgout、pswpin/pswpout、pgmajfault → 换页速率和主缺页速率
+//   /proc/diskstats  扇区计数 → 每块物理磁盘的读写带宽（磁盘清单来自 /sys/block）
+//   /proc/pressure/{cpu,memory,io}  系统的压力停顿；/sys/fs/cgroup/<cgroup>/{cpu,memory,io}.pressure 为 cgroup 的
+// 每个文件在 Initialize 时打开一次，采样时用 pread 重读并就地解析，稳态采样不分配内存。
+// 所有路径都以 root 为前缀，root 可以指向带有 proc/ 和 sys/ 子目录的样例目录树。
+class LinuxHostCollector : public HostCollector {
+public:
+    LinuxHostCollector(const std::string& root, const std::string& cgroup);
+
+    const char* Name() const override { return "Linux procfs"; }
+    bool Initialize() override;
+    void Shutdown() override;
+
+    bool UpdateCPUTopology(CPUInfo& cpu) override;
+    void UpdateCPU(CPUInfo& cpu) override;
+    void UpdateCPUThermal(CPUInfo& cpu) override;
+    void UpdateMemory(MemoryInfo& memory) override;
+    bool UpdateMemoryModules(MemoryInfo& memory) override;
+    bool UpdateDisks(std::vector<DiskInfo>& disks) override;
+    bool UpdatePressure(std::vector<PressureInfo>& pressures) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint64_t kSectorBytes = 512;   // diskstats 的扇区固定为 512 字节
+
+    // CPU 时间（单位为 USER_HZ，只用差值）
+    struct CpuTimes {
+        uint64_t busy = 0;
+        uint64_t total = 0;
+    };
+    // /proc/meminfo 中用到的字段 (KB)
+    struct MemInfoFields {
+        uint64_t totalKb = 0;
+        uint64_t availableKb = 0;
+        uint64_t dirtyKb = 0;
+        uint64_t writebackKb = 0;
+    };
+    // /proc/vmstat 中的累计计数：pgpgin/pgpgout 单位为 KB，pswpin/pswpout 单位为页
+    struct VmCounters {
+        uint64_t pageIn = 0;
+        uint64_t pageOut = 0;
+        uint64_t swapIn = 0;
+        uint64_t swapOut = 0;
+        uint64_t majorFaults = 0;
+    };
+    struct DiskDevice {
+        std::string name;              // 块设备名（如 nvme0n1、sda）
+        uint64_t sectorsRead = 0;
+        uint64_t sectorsWritten = 0;
+        bool sampled = false;          // 是否已有上一次的计数
+    };
+    // 温度传感器（hwmon 的 tempN_input 或温区的 temp，单位为毫摄氏度）
+    struct TemperatureSensor {
+        ProcFile file;
+        bool package = true;           // true 为插槽温度，false 为物理核心温度
+    };
+
+    // 一个范围的 PSI 文件，下标与 kPressureResources 对应；不存在的文件不打开
+    struct PressureSource {
+        ProcFile files[kPressureResourceCount];
+        uint64_t someTotal[kPressureResourceCount] = {};   // 上一次的累计停顿时间 (µs)
+        uint64_t fullTotal[kPressureResourceCount] = {};
+        bool sampled = false;
+        Clock::time_point lastSample;
+    };
+
+    std::string Path(const char* relative) const { return root_ + relative; }
+    // 解析 /proc/stat 一行中 "cpu"/"cpuN" 之后的时间字段
+    static bool ParseCpuTimes(TextCursor& cursor, CpuTimes& times);
+    static float Utilization(const CpuTimes& current, const CpuTimes& last);
+    // 按拓扑打开每个逻辑 CPU 的频率文件和降频计数器，并扫描温度传感器
+    void OpenThermalFiles(const CPUInfo& cpu);
+    void ScanTemperatureSensors();
+    bool ReadMemInfo(MemInfoFields& fields);
+    bool ReadVmStat(VmCounters& counters);
+    void ScanDisks(std::vector<DiskInfo>& disks);
+    // 采样进程所在的 cgroup v2 路径（/proc/self/cgroup 中的 "0::" 行），取不到时返回空
+    std::string CurrentCgroup();
+    // 打开 directory 下名为 <资源><suffix> 的 PSI 文件，至少有一个时加入清单
+    bool AddPressureScope(const std::string& scope, const std::string& directory, const char* suffix,
+                          std::vector<PressureInfo>& pressures);
+    void ScanPressure(std::vector<PressureInfo>& pressures);
+
+    std::string root_;
+    std::string cgroup_;
+    ProcFile stat_;
+    ProcFile meminfo_;
+    ProcFile vmstat_;
+    ProcFile diskstats_;
+
+    CpuTimes lastCpu_;
+    bool cpuSampled_ = false;
+    std::vector<CpuTimes> lastCores_;   // 与 CPUInfo::logicalCpus 一一对应，total 为 0 表示尚未采样
+    std::vector<int> cpuIndex_;         // 逻辑 CPU 编号 → logicalCpus 中的下标，-1 表示不在清单中
+
+    std::vector<ProcFile> coreFrequencies_;   // 与 logicalCpus 一一对应，没有 cpufreq 的 CPU 不打开
+    std::vector<ProcFile> throttleCounters_;  // 每个物理核心的 core_throttle_count 和每个插槽的 package_throttle_count
+    std::vector<TemperatureSensor> temperatures_;
+    uint64_t lastThrottleCount_ = 0;
+    bool throttleSampled_ = false;
+    Clock::time_point lastThrottleSample_;
+
+    uint64_t pageSize_ = 4096;
+    VmCounters lastVm_;
+    bool vmSampled_ = false;
+    Clock::time_point lastVmSample_;
+
+    std::vector<DiskDevice> diskDevices_;   // 与 DiskInfo 清单一一对应
+    bool disksScanned_ = false;
+    Clock::time_point lastDiskSample_;
+
+    std::vector<PressureSource> pressureSources_;   // 与 PressureInfo 清单一一对应
+    bool pressureScanned_ = false;
+};
+#endif
@@ -0,0 +1,577 @@
+#include "MetricsExporter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+using PollFd = WSAPOLLFD;
+static int PollSockets(PollFd* fds, size_t count, int timeoutMs) {
+    return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+}
+#else
+#include <poll.h>
+using PollFd = pollfd;
+static int PollSockets(PollFd* fds, size_t count, int timeoutMs) {
+    return poll(fds, static_cast<nfds_t>(count), timeoutMs);
+}
+#endif
+
+static const char kTextContentType[] = "text/plain; version=0.0.4; charset=utf-8";
+
+// ===== 指标清单 =====
+// 每个字段一个指标族（全部为 gauge），名称带单位后缀；同一族内按设备标签区分
+
+template <typename T>
+struct GaugeField {
+    const char* name;
+    const char* help;
+    double (*read)(const T&);
+};
+
+static const GaugeField<GPUInfo> kGPUFields[] = {
+    {"gpu_available", "GPU 是否可用（1 可用）", [](const GPUInfo& g) -> double { return g.available ? 1.0 : 0.0; }},
+    {"gpu_utilization_percent", "GPU 利用率", [](const GPUInfo& g) -> double { return g.utilization; }},
+    {"gpu_memory_used_megabytes", "显存使用量", [](const GPUInfo& g) -> double { return g.memoryUsed; }},
+    {"gpu_memory_total_megabytes", "显存总量", [](const GPUInfo& g) -> double { return g.memoryTotal; }},
+    {"gpu_memory_used_percent", "显存使用百分比", [](const GPUInfo& g) -> double { return g.memoryPercent; }},
+    {"gpu_temperature_celsius", "GPU 温度", [](const GPUInfo& g) -> double { return g.temperature; }},
+    {"gpu_max_clock_mhz", "最大 GPU 时钟频率", [](const GPUInfo& g) -> double { return g.maxGpuClock; }},
+    {"gpu_max_memory_clock_mhz", "最大显存时钟频率", [](const GPUInfo& g) -> double { return g.maxMemoryClock; }},
+    {"gpu_pcie_max_link_generation", "最大 PCIe 代数", [](const GPUInfo& g) -> double { return g.pcieMaxLinkGeneration; }},
+    {"gpu_pcie_max_link_width", "最大 PCIe 链路宽度 (lanes)", [](const GPUInfo& g) -> double { return g.pcieMaxLinkWidth; }},
+    {"gpu_memory_bus_width_bits", "显存位宽，0 表示未知", [](const GPUInfo& g) -> double { return g.memoryBusWidth; }},
+    {"gpu_clock_mhz", "GPU 时钟频率", [](const GPUInfo& g) -> double { return g.gpuClock; }},
+    {"gpu_memory_clock_mhz", "显存时钟频率", [](const GPUInfo& g) -> double { return g.memoryClock; }},
+    {"gpu_fan_speed_percent", "风扇转速", [](const GPUInfo& g) -> double { return g.fanSpeed; }},
+    {"gpu_power_usage_watts", "功耗", [](const GPUInfo& g) -> double { return g.powerUsage; }},
+    {"gpu_power_limit_watts", "最大功耗限制，0 表示不可用", [](const GPUInfo& g) -> double { return g.powerLimit; }},
+    {"gpu_power_percent", "功耗占最大功耗限制的百分比", [](const GPUInfo& g) -> double { return g.powerPercent; }},
+    {"gpu_memory_controller_load_percent", "显存控制器负载", [](const GPUInfo& g) -> double { return g.memoryControllerLoad; }},
+    {"gpu_video_engine_load_percent", "视频引擎负载", [](const GPUInfo& g) -> double { return g.videoEngineLoad; }},
+    {"gpu_voltage_volts", "实时电压", [](const GPUInfo& g) -> double { return g.currentVoltage; }},
+    {"gpu_max_voltage_volts", "最大电压", [](const GPUInfo& g) -> double { return g.maxVoltage; }},
+    {"gpu_voltage_percent", "电压百分比", [](const GPUInfo& g) -> double { return g.voltagePercent; }},
+    {"gpu_pcie_link_width", "PCIe 链路宽度 (lanes)", [](const GPUInfo& g) -> double { return g.pcieLinkWidth; }},
+    {"gpu_pcie_link_speed_gts", "PCIe 链路速度 (GT/s)", [](const GPUInfo& g) -> double { return g.pcieLinkSpeed; }},
+    {"gpu_pcie_bandwidth_gigabytes_per_second", "PCIe 带宽", [](const GPUInfo& g) -> double { return g.pcieBandwidth; }},
+    {"gpu_pcie_rx_megabytes_per_second", "PCIe 接收吞吐量", [](const GPUInfo& g) -> double { return g.pcieRxThroughput; }},
+    {"gpu_pcie_tx_megabytes_per_second", "PCIe 发送吞吐量", [](const GPUInfo& g) -> double { return g.pcieTxThroughput; }},
+    {"gpu_transfer_wait_milliseconds", "CPU 到 GPU 数据传输等待时间", [](const GPUInfo& g) -> double { return g.dataTransferWaitTime; }},
+    {"gpu_pcie_throughput_megabytes_per_second", "PCIe 接收+发送合计吞吐量", [](const GPUInfo& g) -> double { return g.pcieThroughput; }},
+    {"gpu_pcie_utilization_percent", "PCIe 吞吐量占链路带宽的百分比", [](const GPUInfo& g) -> double { return g.pcieUtilization; }},
+    {"gpu_transfer_wait_percent", "传输等待时间相对 10ms 参考值的百分比", [](const GPUInfo& g) -> double { return g.transferWaitPercent; }},
+};
+
+static const GaugeField<CPUInfo> kCPUFields[] = {
+    {"cpu_utilization_percent", "CPU 利用率", [](const CPUInfo& c) -> double { return c.utilization; }},
+    {"cpu_temperature_celsius", "CPU 插槽温度（如果可获取）", [](const CPUInfo& c) -> double { return c.temperature; }},
+    {"cpu_max_core_utilization_percent", "最忙的逻辑 CPU 的利用率", [](const CPUInfo& c) -> double { return c.maxCoreUtilization; }},
+    {"cpu_max_core_temperature_celsius", "最热的物理核心的温度（如果可获取）", [](const CPUInfo& c) -> double { return c.maxCoreTemperature; }},
+    {"cpu_frequency_megahertz", "逻辑 CPU 的平均频率", [](const CPUInfo& c) -> double { return c.frequency; }},
+    {"cpu_frequency_percent", "平均频率占最大频率的百分比", [](const CPUInfo& c) -> double { return c.frequencyPercent; }},
+    {"cpu_throttle_events_per_second", "温控降频事件速率", [](const CPUInfo& c) -> double { return c.throttleRate; }},
+    {"cpu_throttled", "是否处于降频状态（0 或 1）", [](const CPUInfo& c) -> double { return c.throttled ? 1.0 : 0.0; }},
+};
+
+static const GaugeField<MemoryInfo> kMemoryFields[] = {
+    {"memory_used_gigabytes", "已使用内存", [](const MemoryInfo& m) -> double { return m.used; }},
+    {"memory_total_gigabytes", "总内存", [](const MemoryInfo& m) -> double { return m.total; }},
+    {"memory_used_percent", "内存使用百分比", [](const MemoryInfo& m) -> double { return m.percent; }},
+    {"memory_available_gigabytes", "可用内存", [](const MemoryInfo& m) -> double { return m.available; }},
+    {"memory_page_in_megabytes_per_second", "从磁盘读入内存的速率（含页缓存读入和换入）", [](const MemoryInfo& m) -> double { return m.pageInRate; }},
+    {"memory_page_out_megabytes_per_second", "从内存写回磁盘的速率（含脏页写回和换出）", [](const MemoryInfo& m) -> double { return m.pageOutRate; }},
+    {"memory_swap_in_megabytes_per_second", "换入速率", [](const MemoryInfo& m) -> double { return m.swapInRate; }},
+    {"memory_swap_out_megabytes_per_second", "换出速率", [](const MemoryInfo& m) -> double { return m.swapOutRate; }},
+    {"memory_major_faults_per_second", "需要读磁盘的缺页速率", [](const MemoryInfo& m) -> double { return m.majorFaultRate; }},
+    {"memory_dirty_megabytes", "等待写回的脏页", [](const MemoryInfo& m) -> double { return m.dirty; }},
+    {"memory_writeback_megabytes", "正在写回的页", [](const MemoryInfo& m) -> double { return m.writeback; }},
+};
+
+static const GaugeField<MemoryModuleInfo> kModuleFields[] = {
+    {"memory_module_capacity_gigabytes", "内存条容量", [](const MemoryModuleInfo& m) -> double { return m.capacity; }},
+    {"memory_module_speed_mhz", "内存条速度", [](const MemoryModuleInfo& m) -> double { return m.speed; }},
+    {"memory_module_channel", "内存通道编号", [](const MemoryModuleInfo& m) -> double { return m.channel; }},
+    {"memory_module_max_bandwidth_gigabytes_per_second", "内存条最大带宽", [](const MemoryModuleInfo& m) -> double { return m.maxBandwidth; }},
+    {"memory_module_bandwidth_gigabytes_per_second", "内存条实时带宽（估算）", [](const MemoryModuleInfo& m) -> double { return m.realTimeBandwidth; }},
+    {"memory_module_utilization_percent", "内存条带宽利用率（估算）", [](const MemoryModuleInfo& m) -> double { return m.utilization; }},
+};
+
+static const GaugeField<DiskInfo> kDiskFields[] = {
+    {"disk_total_size_gigabytes", "磁盘总容量", [](const DiskInfo& d) -> double { return d.totalSize; }},
+    {"disk_max_read_bandwidth_gigabytes_per_second", "最大读取带宽（估算）", [](const DiskInfo& d) -> double { return d.maxReadBandwidth; }},
+    {"disk_max_write_bandwidth_gigabytes_per_second", "最大写入带宽（估算）", [](const DiskInfo& d) -> double { return d.maxWriteBandwidth; }},
+    {"disk_read_bandwidth_gigabytes_per_second", "实时读取带宽", [](const DiskInfo& d) -> double { return d.realTimeReadBandwidth; }},
+    {"disk_write_bandwidth_gigabytes_per_second", "实时写入带宽", [](const DiskInfo& d) -> double { return d.realTimeWriteBandwidth; }},
+    {"disk_read_utilization_percent", "读取利用率", [](const DiskInfo& d) -> double { return d.readUtilization; }},
+    {"disk_write_utilization_percent", "写入利用率", [](const DiskInfo& d) -> double { return d.writeUtilization; }},
+};
+
+static const GaugeField<SystemBandwidthInfo> kBandwidthFields[] = {
+    {"system_bandwidth_gigabytes_per_second", "总系统带宽", [](const SystemBandwidthInfo& b) -> double { return b.totalSystemBandwidth; }},
+    {"pcie_max_bandwidth_gigabytes_per_second", "PCIe 最大带宽", [](const SystemBandwidthInfo& b) -> double { return b.pcieMaxBandwidth; }},
+    {"pcie_bandwidth_gigabytes_per_second", "PCIe 实时带宽", [](const SystemBandwidthInfo& b) -> double { return b.pcieRealTimeBandwidth; }},
+    {"pcie_utilization_percent", "PCIe 利用率", [](const SystemBandwidthInfo& b) -> double { return b.pcieUtilization; }},
+    {"memory_max_bandwidth_gigabytes_per_second", "内存最大带宽", [](const SystemBandwidthInfo& b) -> double { return b.memoryMaxBandwidth; }},
+    {"memory_bandwidth_gigabytes_per_second", "内存实时带宽", [](const SystemBandwidthInfo& b) -> double { return b.memoryRealTimeBandwidth; }},
+    {"memory_bandwidth_utilization_percent", "内存带宽利用率", [](const SystemBandwidthInfo& b) -> double { return b.memoryUtilization; }},
+    {"storage_max_bandwidth_gigabytes_per_second", "存储最大带宽（估算）", [](const SystemBandwidthInfo& b) -> double { return b.storageMaxBandwidth; }},
+    {"storage_bandwidth_gigabytes_per_second", "存储实时带宽（实测换页读写量）", [](const SystemBandwidthInfo& b) -> double { return b.storageRealTimeBandwidth; }},
+    {"storage_utilization_percent", "存储利用率", [](const SystemBandwidthInfo& b) -> double { return b.storageUtilization; }},
+    {"vram_max_bandwidth_gigabytes_per_second", "显存最大带宽", [](const SystemBandwidthInfo& b) -> double { return b.vramMaxBandwidth; }},
+    {"vram_bandwidth_gigabytes_per_second", "显存实时带宽", [](const SystemBandwidthInfo& b) -> double { return b.vramRealTimeBandwidth; }},
+    {"vram_utilization_percent", "显存带宽利用率", [](const SystemBandwidthInfo& b) -> double { return b.vramUtilization; }},
+    {"cpu_bandwidth_gigabytes_per_second", "CPU 带宽（兼容字段）", [](const SystemBandwidthInfo& b) -> double { return b.cpuBandwidth; }},
+    {"memory_bandwidth_compat_gigabytes_per_second", "内存带宽（兼容字段）", [](const SystemBandwidthInfo& b) -> double { return b.memoryBandwidth; }},
+    {"pcie_total_bandwidth_gigabytes_per_second", "PCIe 总带宽（兼容字段）", [](const SystemBandwidthInfo& b) -> double { return b.pcieTotalBandwidth; }},
+    {"memory_speed_mhz", "内存速度", [](const SystemBandwidthInfo& b) -> double { return b.memorySpeed; }},
+};
+
+// 压力停顿按 (scope, resource) 两个标签展开，见 Render
+static const GaugeField<PressureStat> kPressureFields[] = {
+    {"pressure_some_avg10_percent", "近 10 秒至少一个任务因等待资源而停顿的时间占比（内核统计）", [](const PressureStat& p) -> double { return p.someAvg10; }},
+    {"pressure_full_avg10_percent", "近 10 秒所有非空闲任务同时停顿的时间占比（内核统计）", [](const PressureStat& p) -> double { return p.fullAvg10; }},
+    {"pressure_some_stall_percent", "两次采样之间至少一个任务停顿的时间占比（由累计停顿时间计算）", [](const PressureStat& p) -> double { return p.someStall; }},
+    {"pressure_full_stall_percent", "两次采样之间所有非空闲任务同时停顿的时间占比（由累计停顿时间计算）", [](const PressureStat& p) -> double { return p.fullStall; }},
+};
+
+// 向复用缓冲区追加文本，容量不足时才扩展（稳定后不再分配内存）
+class MetricsWriter {
+public:
+    MetricsWriter(std::vector<char>& buffer, size_t& size) : buffer_(buffer), size_(size) {}
+
+    void Append(const char* text, size_t length) {
+        if (size_ + length > buffer_.size()) {
+            buffer_.resize(std::max(buffer_.size() * 2, size_ + length));
+        }
+        std::memcpy(buffer_.data() + size_, text, length);
+        size_ += length;
+    }
+    void Append(const char* text) { Append(text, std::strlen(text)); }
+
+    void Number(double value) {
+        char text[32];
+        int length;
+        if (std::isnan(value)) {
+            length = std::snprintf(text, sizeof(text), "NaN");
+        } else if (std::isinf(value)) {
+            length = std::snprintf(text, sizeof(text), value > 0 ? "+Inf" : "-Inf");
+        } else {
+            length = std::snprintf(text, sizeof(text), "%.9g", value);
+        }
+        Append(text, static_cast<size_t>(length));
+    }
+    void Integer(uint64_t value) {
+        char text[24];
+        int length = std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        Append(text, static_cast<size_t>(length));
+    }
+
+    void Family(const char* name, const char* help, const char* type) {
+        Append("# HELP deepinsight_");
+        Append(name);
+        Append(" ");
+        Append(help);
+        Append("\n# TYPE deepinsight_");
+        Append(name);
+        Append(" ");
+        Append(type);
+        Append("\n");
+    }
+
+    // 样本行：BeginSample，若干 Label，EndSample
+    void BeginSample(const char* name) {
+        Append("deepinsight_");
+        Append(name);
+        labels_ = 0;
+    }
+    void Label(const char* name, const std::string& value) {
+        Append(labels_++ == 0 ? "{" : ",");
+        Append(name);
+        Append("=\"");
+        // 标签值转义：反斜杠、双引号、换行
+        for (char c : value) {
+            if (c == '\\') {
+                Append("\\\\", 2);
+            } else if (c == '"') {
+                Append("\\\"", 2);
+            } else if (c == '\n') {
+                Append("\\n", 2);
+            } else {
+                Append(&c, 1);
+            }
+        }
+        Append("\"");
+    }
+    void Label(const char* name, size_t index) {
+        char text[24];
+        int length = std::snprintf(text, sizeof(text), "%zu", index);
+        Append(labels_++ == 0 ? "{" : ",");
+        Append(name);
+        Append("=\"");
+        Append(text, static_cast<size_t>(length));
+        Append("\"");
+    }
+    void EndSample(double value) {
+        if (labels_ > 0) {
+            Append("}");
+        }
+        Append(" ");
+        Number(value);
+        Append("\n");
+    }
+
+private:
+    std::vector<char>& buffer_;
+    size_t& size_;
+    int labels_ = 0;
+};
+
+// 一组设备共用一份字段清单：每个字段一个指标族，族内每个设备一行
+template <typename T, size_t N, typename LabelFn>
+static void RenderItems(MetricsWriter& out, const GaugeField<T> (&fields)[N],
+                        const std::vector<T>& items, LabelFn&& labels) {
+    for (const GaugeField<T>& field : fields) {
+        out.Family(field.name, field.help, "gauge");
+        for (size_t i = 0; i < items.size(); i++) {
+            out.BeginSample(field.name);
+            labels(out, i, items[i]);
+            out.EndSample(field.read(items[i]));
+        }
+    }
+}
+
+template <typename T, size_t N>
+static void RenderScalars(MetricsWriter& out, const GaugeField<T> (&fields)[N], const T& item) {
+    for (const GaugeField<T>& field : fields) {
+        out.Family(field.name, field.help, "gauge");
+        out.BeginSample(field.name);
+        out.EndSample(field.read(item));
+    }
+}
+
+// 每个逻辑 CPU 一个样本，values 与 logicalCpus 一一对应
+static void RenderCoreValues(MetricsWriter& out, const char* name, const char* help,
+                             const CPUInfo& cpu, const std::vector<float>& values) {
+    out.Family(name, help, "gauge");
+    for (size_t i = 0; i < values.size() && i < cpu.logicalCpus.size(); i++) {
+        const LogicalCpuInfo& logical = cpu.logicalCpus[i];
+        out.BeginSample(name);
+        out.Label("cpu", logical.id);
+        out.Label("socket", logical.socket);
+        out.Label("core", logical.core);
+        out.EndSample(values[i]);
+    }
+}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+bool MetricsExporter::Start(const std::string& address, uint16_t port) {
+    if (IsRunning()) {
+        return true;
+    }
+
+    if (!InitializeSockets()) {
+        std::cerr << "警告: Winsock 初始化失败，指标导出不可用" << std::endl;
+        return false;
+    }
+    listener_ = ListenTcp(address, port, static_cast<int>(kMaxConnections), &port_);
+    if (listener_ == kInvalidSocket) {
+        std::cerr << "警告: 指标导出无法监听 " << address << ":" << port << std::endl;
+        ShutdownSockets();
+        return false;
+    }
+
+    // 预留渲染缓冲区，常见规模下一次即可容纳全部指标
+    body_.resize(64 * 1024);
+    bodySize_ = 0;
+    renderedSequence_ = 0;
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&MetricsExporter::ServerLoop, this);
+    return true;
+}
+
+void MetricsExporter::Stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (Connection& connection : connections_) {
+        CloseConnection(connection);
+    }
+    if (listener_ != kInvalidSocket) {
+        CloseSocket(listener_);
+        listener_ = kInvalidSocket;
+        ShutdownSockets();
+    }
+}
+
+void MetricsExporter::ServerLoop() {
+    std::array<PollFd, kMaxConnections + 1> fds;
+    std::array<Connection*, kMaxConnections + 1> owners;
+
+    while (running_.load(std::memory_order_acquire)) {
+        // 连接已满时暂不接受新连接，留在监听队列中
+        size_t count = 0;
+        bool hasFreeSlot = false;
+        for (Connection& connection : connections_) {
+            if (connection.socket == kInvalidSocket) {
+                hasFreeSlot = true;
+                continue;
+            }
+            fds[count] = PollFd{};
+            fds[count].fd = connection.socket;
+            fds[count].events = connection.writing ? POLLOUT : POLLIN;
+            owners[count] = &connection;
+            count++;
+        }
+        if (hasFreeSlot) {
+            fds[count] = PollFd{};
+            fds[count].fd = listener_;
+            fds[count].events = POLLIN;
+            owners[count] = nullptr;
+            count++;
+        }
+
+        // 超时用于检查退出标志和空闲连接
+        int ready = PollSockets(fds.data(), count, 100);
+        if (ready > 0) {
+            for (size_t i = 0; i < count; i++) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                if (owners[i] == nullptr) {
+                    AcceptConnections();
+                } else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                    CloseConnection(*owners[i]);
+                } else if (owners[i]->writing) {
+                    WriteResponse(*owners[i]);
+                } else {
+                    ReadRequest(*owners[i]);
+                }
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (Connection& connection : connections_) {
+            if (connection.socket != kInvalidSocket &&
+                now - connection.lastActivity > std::chrono::milliseconds(kIdleTimeoutMs)) {
+                CloseConnection(connection);
+            }
+        }
+    }
+}
+
+void MetricsExporter::AcceptConnections() {
+    for (Connection& connection : connections_) {
+        if (connection.socket != kInvalidSocket) {
+            continue;
+        }
+        SocketHandle client = AcceptTcp(listener_, nullptr);
+        if (client == kInvalidSocket) {
+            return;
+        }
+        connection.socket = client;
+        connection.requestBytes = 0;
+        connection.writing = false;
+        connection.lastActivity = std::chrono::steady_clock::now();
+    }
+}
+
+void MetricsExporter::ReadRequest(Connection& connection) {
+    size_t space = kRequestBytes - 1 - connection.requestBytes;
+    if (space == 0) {
+        Respond(connection, "431 Request Header Fields Too Large", "text/plain; charset=utf-8", "", 0);
+        return;
+    }
+    ptrdiff_t received = ReceiveSome(connection.socket, connection.request + connection.requestBytes, space);
+    if (received < 0 && SocketWouldBlock()) {
+        return;
+    }
+    if (received <= 0) {
+        CloseConnection(connection);
+        return;
+    }
+    connection.requestBytes += static_cast<size_t>(received);
+    connection.request[connection.requestBytes] = '\0';
+    connection.lastActivity = std::chrono::steady_clock::now();
+
+    // 请求头完整后处理（忽略请求体）
+    if (std::strstr(connection.request, "\r\n\r\n") != nullptr) {
+        HandleRequest(connection);
+    }
+}
+
+void MetricsExporter::HandleRequest(Connection& connection) {
+    static const char kIndex[] = "DeepInsight Blackwell metrics: /metrics\n";
+    static const char kNotFound[] = "Not Found\n";
+    static const char kNoData[] = "No snapshot yet\n";
+
+    const char* request = connection.request;
+    if (std::strncmp(request, "GET ", 4) != 0) {
+        Respond(connection, "405 Method Not Allowed", "text/plain; charset=utf-8", "", 0);
+        return;
+    }
+    const char* path = request + 4;
+    size_t pathLength = std::strcspn(path, " ?\r\n");
+
+    if (pathLength == 1 && path[0] == '/') {
+        Respond(connection, "200 OK", "text/plain; charset=utf-8", kIndex, sizeof(kIndex) - 1);
+        return;
+    }
+    if (pathLength != 8 || std::strncmp(path, "/metrics", 8) != 0) {
+        Respond(connection, "404 Not Found", "text/plain; charset=utf-8", kNotFound, sizeof(kNotFound) - 1);
+        return;
+    }
+
+    // 只在有新快照时重新渲染；其他连接还在发送上一次的结果时先沿用旧结果
+    snapshots_.Acquire();
+    const HardwareSnapshot& snapshot = snapshots_.ReadBuffer();
+    if (snapshot.sequence == 0 && renderedSequence_ == 0) {
+        Respond(connection, "503 Service Unavailable", "text/plain; charset=utf-8", kNoData, sizeof(kNoData) - 1);
+        return;
+    }
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    if (snapshot.sequence != renderedSequence_ && !AnyWriting()) {
+        Render(snapshot);
+    }
+    Respond(connection, "200 OK", kTextContentType, body_.data(), bodySize_);
+}
+
+void MetricsExporter::Respond(Connection& connection, const char* status, const char* contentType,
+                              const char* body, size_t bodyBytes) {
+    int length = std::snprintf(connection.header, sizeof(connection.header),
+                               "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                               status, contentType, bodyBytes);
+    connection.headerBytes = length > 0 ? static_cast<size_t>(length) : 0;
+    connection.body = body;
+    connection.bodyBytes = bodyBytes;
+    connection.sent = 0;
+    connection.writing = true;
+    WriteResponse(connection);
+}
+
+void MetricsExporter::WriteResponse(Connection& connection) {
+    while (connection.sent < connection.headerBytes + connection.bodyBytes) {
+        const char* data;
+        size_t remaining;
+        if (connection.sent < connection.headerBytes) {
+            data = connection.header + connection.sent;
+            remaining = connection.headerBytes - connection.sent;
+        } else {
+            data = connection.body + (connection.sent - connection.headerBytes);
+            remaining = connection.headerBytes + connection.bodyBytes - connection.sent;
+        }
+        ptrdiff_t sent = SendSome(connection.socket, data, remaining);
+        if (sent < 0 && SocketWouldBlock()) {
+            return;
+        }
+        if (sent <= 0) {
+            CloseConnection(connection);
+            return;
+        }
+        connection.sent += static_cast<size_t>(sent);
+        connection.lastActivity = std::chrono::steady_clock::now();
+    }
+    CloseConnection(connection);
+}
+
+void MetricsExporter::CloseConnection(Connection& connection) {
+    if (connection.socket != kInvalidSocket) {
+        CloseSocket(connection.socket);
+        connection.socket = kInvalidSocket;
+    }
+    connection.requestBytes = 0;
+    connection.writing = false;
+}
+
+bool MetricsExporter::AnyWriting() const {
+    for (const Connection& connection : connections_) {
+        if (connection.socket != kInvalidSocket && connection.writing) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MetricsExporter::Render(const HardwareSnapshot& snapshot) {
+    bodySize_ = 0;
+    MetricsWriter out(body_, bodySize_);
+
+    RenderItems(out, kGPUFields, snapshot.gpus, [](MetricsWriter& w, size_t i, const GPUInfo& gpu) {
+        w.Label("gpu", i);
+        w.Label("name", gpu.name);
+        w.Label("uuid", gpu.uuid);
+    });
+
+    RenderScalars(out, kCPUFields, snapshot.cpu);
+    RenderCoreValues(out, "cpu_core_utilization_percent", "每个逻辑 CPU 的利用率",
+                     snapshot.cpu, snapshot.cpu.coreUtilization);
+    RenderCoreValues(out, "cpu_core_frequency_megahertz", "每个逻辑 CPU 的当前频率",
+                     snapshot.cpu, snapshot.cpu.coreFrequency);
+
+    RenderScalars(out, kMemoryFields, snapshot.memory);
+    RenderItems(out, kModuleFields, snapshot.memory.modules,
+                [](MetricsWriter& w, size_t i, const MemoryModuleInfo& module) {
+        w.Label("module", i);
+        w.Label("name", module.name);
+        w.Label("type", module.type);
+    });
+
+    RenderItems(out, kDiskFields, snapshot.disks, [](MetricsWriter& w, size_t, const DiskInfo& disk) {
+        w.Label("disk", disk.name);
+        w.Label("model", disk.model);
+        w.Label("type", disk.type);
+    });
+
+    RenderScalars(out, kBandwidthFields, snapshot.bandwidth);
+    out.Family("memory_info", "内存类型", "gauge");
+    out.BeginSample("memory_info");
+    out.Label("type", snapshot.bandwidth.memoryType);
+    out.EndSample(1.0);
+
+    for (const GaugeField<PressureStat>& field : kPressureFields) {
+        out.Family(field.name, field.help, "gauge");
+        for (const PressureInfo& pressure : snapshot.pressures) {
+            for (const PressureResource& resource : kPressureResources) {
+                out.BeginSample(field.name);
+                out.Label("scope", pressure.scope);
+                out.Label("resource", resource.name);
+                out.EndSample(field.read(pressure.*resource.stat));
+            }
+        }
+    }
+
+    // 采集器运行统计
+    out.Family("collector_last_cost_seconds", "采集器最近一次运行耗时", "gauge");
+    for (const SamplingScheduler::CollectorStats& stats : snapshot.collectors) {
+        out.BeginSample("collector_last_cost_seconds");
+        out.Label("collector", stats.name);
+        out.EndSample(static_cast<double>(stats.lastCost.count()) / 1e6);
+    }
+    out.Family("collector_runs_total", "采集器运行次数", "counter");
+    for (const SamplingScheduler::CollectorStats& stats : snapshot.collectors) {
+        out.BeginSample("collector_runs_total");
+        out.Label("collector", stats.name);
+        out.EndSample(static_cast<double>(stats.runCount));
+    }
+    out.Family("collector_over_budget_total", "采集器超出耗时预算的次数", "counter");
+    for (const SamplingScheduler::CollectorStats& stats : snapshot.collectors) {
+        out.BeginSample("collector_over_budget_total");
+        out.Label("collector", stats.name);
+        out.EndSample(static_cast<double>(stats.overBudgetCount));
+    }
+
+    out.Family("snapshot_sequence", "快照发布序号", "gauge");
+    out.BeginSample("snapshot_sequence");
+    out.Append(" ");
+    out.Integer(snapshot.sequence);
+    out.Append("\n");
+
+    renderedSequence_ = snapshot.sequence;
+}
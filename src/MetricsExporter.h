@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HardwareMonitor.h"
+#include "NetSocket.h"
+
+// Prometheus 指标导出（HTTP，文本格式 0.0.4）
+//
+// 单线程、非阻塞：一个导出线程用 poll 同时处理监听套接字和所有连接，不会因为某个抓取方卡住而阻塞。
+// 数据来自 HardwareMonitor 的额外快照读端（AddSnapshotReader(&exporter.GetSnapshotBuffer())），
+// 只在有新快照时重新渲染到复用的文本缓冲区，抓取本身不触发采集，稳定后也不再分配内存。
+//
+//   GET /metrics   所有 GPU/CPU/内存/磁盘/系统带宽字段，GPU 和磁盘等按标签区分
+class MetricsExporter {
+public:
+    static constexpr size_t kMaxConnections = 16;
+    static constexpr size_t kRequestBytes = 2048;
+    static constexpr int kIdleTimeoutMs = 5000;
+
+    MetricsExporter() = default;
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // 监听 address:port 并启动导出线程；port 为 0 时由系统分配（见 GetPort）
+    bool Start(const std::string& address, uint16_t port);
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+    uint16_t GetPort() const { return port_; }
+
+    // 快照输入：注册到 HardwareMonitor::AddSnapshotReader
+    TripleBuffer<HardwareSnapshot>& GetSnapshotBuffer() { return snapshots_; }
+
+    uint64_t GetScrapeCount() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        SocketHandle socket = kInvalidSocket;
+        char request[kRequestBytes];
+        size_t requestBytes = 0;
+        char header[256];
+        size_t headerBytes = 0;
+        const char* body = nullptr;
+        size_t bodyBytes = 0;
+        size_t sent = 0;             // 已发送的字节数（先头部后正文）
+        bool writing = false;
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    void ServerLoop();
+    void AcceptConnections();
+    void ReadRequest(Connection& connection);
+    void HandleRequest(Connection& connection);
+    void WriteResponse(Connection& connection);
+    void Respond(Connection& connection, const char* status, const char* contentType,
+                 const char* body, size_t bodyBytes);
+    void CloseConnection(Connection& connection);
+    bool AnyWriting() const;
+    void Render(const HardwareSnapshot& snapshot);
+
+    TripleBuffer<HardwareSnapshot> snapshots_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> scrapes_{0};
+    SocketHandle listener_ = kInvalidSocket;
+    uint16_t port_ = 0;
+    std::array<Connection, kMaxConnections> connections_;
+
+    // 渲染结果（只由导出线程访问）；有连接正在发送时不重新渲染
+    std::vector<char> body_;
+    size_t bodySize_ = 0;
+    uint64_t renderedSequence_ = 0;
+};
@@ -0,0 +1,236 @@
+#include "NetSocket.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static std::atomic<int> g_socketUsers{0};
+#endif
+
+bool InitializeSockets() {
+#ifdef _WIN32
+    if (g_socketUsers.fetch_add(1) == 0) {
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            g_socketUsers.fetch_sub(1);
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+void ShutdownSockets() {
+#ifdef _WIN32
+    if (g_socketUsers.fetch_sub(1) == 1) {
+        WSACleanup();
+    }
+#endif
+}
+
+void CloseSocket(SocketHandle socket) {
+    if (socket == kInvalidSocket) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(socket));
+#else
+    ::close(socket);
+#endif
+}
+
+bool SetNonBlocking(SocketHandle socket) {
+#ifdef _WIN32
+    u_long enabled = 1;
+    return ioctlsocket(static_cast<SOCKET>(socket), FIONBIO, &enabled) == 0;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool SetSocketTimeout(SocketHandle socket, int timeoutMs) {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(timeoutMs);
+#else
+    timeval timeout{};
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+#endif
+    const char* value = reinterpret_cast<const char*>(&timeout);
+    return setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, value, sizeof(timeout)) == 0 &&
+           setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, value, sizeof(timeout)) == 0;
+}
+
+bool SetKeepAlive(SocketHandle socket, int idleSeconds, int intervalSeconds, int probes) {
+    int enabled = 1;
+    if (setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<const char*>(&enabled), sizeof(enabled)) != 0) {
+        return false;
+    }
+#if defined(TCP_KEEPIDLE) && defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPIDLE, reinterpret_cast<const char*>(&idleSeconds), sizeof(idleSeconds));
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPINTVL, reinterpret_cast<const char*>(&intervalSeconds),
+               sizeof(intervalSeconds));
+    setsockopt(socket, IPPROTO_TCP, TCP_KEEPCNT, reinterpret_cast<const char*>(&probes), sizeof(probes));
+#else
+    (void)idleSeconds;
+    (void)intervalSeconds;
+    (void)probes;
+#endif
+    return true;
+}
+
+bool SocketWouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+SocketHandle ListenTcp(const std::string& address, uint16_t port, int backlog, uint16_t* boundPort) {
+    sockaddr_in bindAddress{};
+    bindAddress.sin_family = AF_INET;
+    bindAddress.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &bindAddress.sin_addr) != 1) {
+        return kInvalidSocket;
+    }
+
+    SocketHandle listener = static_cast<SocketHandle>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (listener == kInvalidSocket) {
+        return kInvalidSocket;
+    }
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    socklen_t addressLength = sizeof(bindAddress);
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&bindAddress), sizeof(bindAddress)) != 0 ||
+        listen(listener, backlog) != 0 || !SetNonBlocking(listener) ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&bindAddress), &addressLength) != 0) {
+        CloseSocket(listener);
+        return kInvalidSocket;
+    }
+    if (boundPort != nullptr) {
+        *boundPort = ntohs(bindAddress.sin_port);
+    }
+    return listener;
+}
+
+SocketHandle AcceptTcp(SocketHandle listener, std::string* remoteAddress) {
+    sockaddr_in address{};
+    socklen_t addressLength = sizeof(address);
+    SocketHandle client = static_cast<SocketHandle>(
+        accept(listener, reinterpret_cast<sockaddr*>(&address), &addressLength));
+    if (client == kInvalidSocket) {
+        return kInvalidSocket;
+    }
+    if (!SetNonBlocking(client)) {
+        CloseSocket(client);
+        return kInvalidSocket;
+    }
+    if (remoteAddress != nullptr) {
+        char text[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &address.sin_addr, text, sizeof(text));
+        *remoteAddress = text;
+    }
+    return client;
+}
+
+SocketHandle ConnectTcp(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || result == nullptr) {
+        return kInvalidSocket;
+    }
+
+    SocketHandle connection = kInvalidSocket;
+    for (addrinfo* entry = result; entry != nullptr; entry = entry->ai_next) {
+        connection = static_cast<SocketHandle>(socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol));
+        if (connection == kInvalidSocket) {
+            continue;
+        }
+        if (connect(connection, entry->ai_addr, static_cast<int>(entry->ai_addrlen)) == 0) {
+            break;
+        }
+        CloseSocket(connection);
+        connection = kInvalidSocket;
+    }
+    freeaddrinfo(result);
+
+    if (connection != kInvalidSocket) {
+        // 每个样本都很小，关闭 Nagle 避免攒包带来的延迟
+        int noDelay = 1;
+        setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    }
+    return connection;
+}
+
+ptrdiff_t SendSome(SocketHandle socket, const void* data, size_t size) {
+#ifdef _WIN32
+    return send(static_cast<SOCKET>(socket), static_cast<const char*>(data), static_cast<int>(size), 0);
+#else
+    // 对端已关闭时返回错误而不是触发 SIGPIPE
+    return send(socket, data, size, MSG_NOSIGNAL);
+#endif
+}
+
+ptrdiff_t ReceiveSome(SocketHandle socket, void* data, size_t size) {
+#ifdef _WIN32
+    return recv(static_cast<SOCKET>(socket), static_cast<char*>(data), static_cast<int>(size), 0);
+#else
+    return recv(socket, data, size, 0);
+#endif
+}
+
+bool SendAll(SocketHandle socket, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ptrdiff_t sent = SendSome(socket, bytes, size);
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool ParseHostPort(const std::string& text, std::string& host, uint16_t& port) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 >= text.size()) {
+        return false;
+    }
+    int value = std::atoi(text.c_str() + colon + 1);
+    if (value <= 0 || value > 65535) {
+        return false;
+    }
+    host = text.substr(0, colon);
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+std::string LocalHostName() {
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0 || name[0] == '\0') {
+        return "unknown";
+    }
+    return name;
+}
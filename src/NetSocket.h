@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 最小的跨平台 TCP 套接字封装（Winsock / BSD socket），供指标导出、节点上报和汇总服务共用
+
+#ifdef _WIN32
+using SocketHandle = uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+constexpr SocketHandle kInvalidSocket = static_cast<SocketHandle>(-1);
+
+// Windows 下初始化/释放 Winsock（按引用计数，可重复调用）；其他平台为空操作
+bool InitializeSockets();
+void ShutdownSockets();
+
+void CloseSocket(SocketHandle socket);
+bool SetNonBlocking(SocketHandle socket);
+// 阻塞收发的超时（毫秒），对端长时间无响应时返回错误而不是一直等待
+bool SetSocketTimeout(SocketHandle socket, int timeoutMs);
+// 开启 TCP keepalive：连接空闲 idleSeconds 秒后开始探测，每 intervalSeconds 秒一次，连续 probes 次无响应由内核断开
+// （对端掉电或网络分区时不会发送 FIN，没有 keepalive 的空闲连接永远不会报错）。
+// 平台不支持调整探测参数时只开启 keepalive，使用系统默认参数
+bool SetKeepAlive(SocketHandle socket, int idleSeconds, int intervalSeconds, int probes);
+// 最近一次非阻塞操作失败是否只是暂时没有数据/空间
+bool SocketWouldBlock();
+
+// 监听 address:port（非阻塞），boundPort 返回实际端口（port 为 0 时由系统分配）
+SocketHandle ListenTcp(const std::string& address, uint16_t port, int backlog, uint16_t* boundPort);
+// 非阻塞接受连接，没有待接受的连接时返回 kInvalidSocket；remoteAddress 可为空
+SocketHandle AcceptTcp(SocketHandle listener, std::string* remoteAddress);
+// 阻塞连接 host:port（host 可以是主机名），失败返回 kInvalidSocket
+SocketHandle ConnectTcp(const std::string& host, uint16_t port);
+
+// 单次收发，返回字节数；出错返回 -1（配合 SocketWouldBlock 区分），对端关闭时 Receive 返回 0
+ptrdiff_t SendSome(SocketHandle socket, const void* data, size_t size);
+ptrdiff_t ReceiveSome(SocketHandle socket, void* data, size_t size);
+// 阻塞发送全部数据
+bool SendAll(SocketHandle socket, const void* data, size_t size);
+
+// 解析 "host:port"
+bool ParseHostPort(const std::string& text, std::string& host, uint16_t& port);
+// 本机主机名，获取失败时返回 "unknown"
+std::string LocalHostName();
@@ -0,0 +1,169 @@
+#include "ProcFile.h"
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcFile::~ProcFile() {
+    Close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : fd_(other.fd_), buffer_(std::move(other.buffer_)), size_(other.size_) {
+    other.fd_ = -1;
+    other.buffer_.assign(1, '\0');
+    other.size_ = 0;
+}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        fd_ = other.fd_;
+        buffer_ = std::move(other.buffer_);
+        size_ = other.size_;
+        other.fd_ = -1;
+        other.buffer_.assign(1, '\0');
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool ProcFile::Open(const std::string& path) {
+    Close();
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    if (buffer_.size() < kInitialBufferSize) {
+        buffer_.resize(kInitialBufferSize);
+    }
+    return true;
+}
+
+void ProcFile::Close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    buffer_[0] = '\0';
+    size_ = 0;
+}
+
+bool ProcFile::Read() {
+    if (fd_ < 0) {
+        return false;
+    }
+    size_t total = 0;
+    while (true) {
+        // 预留结尾的 '\0'；缓冲区读满说明内容可能更长，加倍后从当前偏移继续读
+        if (total + 1 >= buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+        }
+        ssize_t count = ::pread(fd_, buffer_.data() + total, buffer_.size() - 1 - total, static_cast<off_t>(total));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            buffer_[0] = '\0';
+            size_ = 0;
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+        total += static_cast<size_t>(count);
+    }
+    buffer_[total] = '\0';
+    size_ = total;
+    return true;
+}
+
+bool ProcFile::ReadOnce(const std::string& path, ProcFile& file) {
+    bool ok = file.Open(path) && file.Read();
+    if (file.IsOpen()) {
+        ::close(file.fd_);   // 保留已读内容，只释放文件描述符
+        file.fd_ = -1;
+    }
+    return ok;
+}
+#endif
+
+void TextCursor::SkipSpaces() {
+    while (*pos_ == ' ' || *pos_ == '\t') {
+        pos_++;
+    }
+}
+
+void TextCursor::NextLine() {
+    while (*pos_ != '\0' && *pos_ != '\n') {
+        pos_++;
+    }
+    if (*pos_ == '\n') {
+        pos_++;
+    }
+}
+
+bool TextCursor::Match(const char* literal) {
+    SkipSpaces();
+    size_t length = std::strlen(literal);
+    if (std::strncmp(pos_, literal, length) != 0) {
+        return false;
+    }
+    pos_ += length;
+    return true;
+}
+
+bool TextCursor::ParseUint(uint64_t& value) {
+    SkipSpaces();
+    if (*pos_ < '0' || *pos_ > '9') {
+        return false;
+    }
+    value = 0;
+    while (*pos_ >= '0' && *pos_ <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*pos_ - '0');
+        pos_++;
+    }
+    return true;
+}
+
+bool TextCursor::ParseDouble(double& value) {
+    SkipSpaces();
+    bool negative = *pos_ == '-';
+    if (negative) {
+        pos_++;
+    }
+    uint64_t integer = 0;
+    if (!ParseUint(integer)) {
+        return false;
+    }
+    value = static_cast<double>(integer);
+    if (*pos_ == '.') {
+        pos_++;
+        double scale = 0.1;
+        while (*pos_ >= '0' && *pos_ <= '9') {
+            value += static_cast<double>(*pos_ - '0') * scale;
+            scale *= 0.1;
+            pos_++;
+        }
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+const char* TextCursor::Token(size_t& length) {
+    SkipSpaces();
+    const char* start = pos_;
+    while (*pos_ != '\0' && *pos_ != ' ' && *pos_ != '\t' && *pos_ != '\n') {
+        pos_++;
+    }
+    length = static_cast<size_t>(pos_ - start);
+    return start;
+}
+
+bool TokenEquals(const char* token, size_t length, const std::string& name) {
+    return length == name.size() && std::memcmp(token, name.data(), length) == 0;
+}
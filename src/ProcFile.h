@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 常开的 procfs/sysfs 文本文件（Linux 采集后端使用）
+// 打开一次，每次采样用 pread 从偏移 0 重新读取：procfs 每次读取都会重新生成内容，不需要重新打开。
+// 缓冲区只在内容比以往都长时增长，稳态采样既不打开文件也不分配内存。
+class ProcFile {
+public:
+    ProcFile() = default;
+    ~ProcFile();
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return fd_ >= 0; }
+
+    // 重新读取整个文件，成功后 Text() 为以 '\0' 结尾的完整内容
+    bool Read();
+    const char* Text() const { return buffer_.data(); }
+    size_t Size() const { return size_; }
+
+    // 打开、读取一次并关闭（用于只在清单扫描时读取的 sysfs 属性），失败返回 false
+    static bool ReadOnce(const std::string& path, ProcFile& file);
+
+private:
+    static constexpr size_t kInitialBufferSize = 4096;
+
+    int fd_ = -1;
+    std::vector<char> buffer_ = std::vector<char>(1, '\0');
+    size_t size_ = 0;
+};
+
+// 在 ProcFile 内容上前进的只读游标：解析数字和名称都不复制、不分配
+class TextCursor {
+public:
+    explicit TextCursor(const char* text) : pos_(text) {}
+
+    bool AtEnd() const { return *pos_ == '\0'; }
+    const char* Position() const { return pos_; }
+
+    // 跳过空格和制表符（不跨行）
+    void SkipSpaces();
+    // 前进到下一行的开头
+    void NextLine();
+    // 跳过空格后内容以 literal 开头时前进并返回 true
+    bool Match(const char* literal);
+    // 跳过空格后解析一个十进制无符号整数
+    bool ParseUint(uint64_t& value);
+    // 跳过空格后解析一个十进制小数（如 PSI 的 "12.34"，不支持指数形式）
+    bool ParseDouble(double& value);
+    // 跳过空格后返回下一个以空白结束的名称，length 写入长度
+    const char* Token(size_t& length);
+
+private:
+    const char* pos_;
+};
+
+// 名称（不以 '\0' 结尾）是否与字符串相等
+bool TokenEquals(const char* token, size_t length, const std::string& name);
@@ -0,0 +1,163 @@
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+
+static double ScaleK(double q) {
+    return QuantileSketch::kCompression / (2.0 * 3.14159265358979323846) * std::asin(2.0 * q - 1.0);
+}
+
+void QuantileSketch::AddWeighted(float mean, float weight) {
+    if (count_ == 0) {
+        min_ = mean;
+        max_ = mean;
+    }
+    min_ = std::min(min_, mean);
+    max_ = std::max(max_, mean);
+    buffer_.push_back(Centroid{mean, weight});
+    count_ += static_cast<uint64_t>(weight);
+    if (buffer_.size() >= kBufferSize) {
+        Flush();
+    }
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    float otherMin = other.min_;
+    float otherMax = other.max_;
+    for (const Centroid& centroid : other.centroids_) {
+        AddWeighted(centroid.mean, centroid.weight);
+    }
+    for (const Centroid& centroid : other.buffer_) {
+        AddWeighted(centroid.mean, centroid.weight);
+    }
+    // 质心的均值落在极值之内，极值本身要单独合并
+    min_ = std::min(min_, otherMin);
+    max_ = std::max(max_, otherMax);
+}
+
+void QuantileSketch::Clear() {
+    centroids_.clear();
+    buffer_.clear();
+    count_ = 0;
+    min_ = 0.0f;
+    max_ = 0.0f;
+}
+
+void QuantileSketch::Compact() {
+    Flush();
+    buffer_.shrink_to_fit();
+}
+
+void QuantileSketch::Flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+    std::sort(buffer_.begin(), buffer_.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    double total = 0.0;
+    for (const Centroid& centroid : buffer_) {
+        total += centroid.weight;
+    }
+
+    // 刻度函数 k(q) = δ/(2π)·asin(2q-1)：每个质心覆盖的 k 跨度不超过 1，
+    // 两端 k 变化最快（质心最小），因此质心总数不超过 δ+1，尾部分位数最精确
+    centroids_.clear();
+    Centroid current = buffer_[0];
+    double before = 0.0;   // current 之前所有质心的权重
+    double kLeft = ScaleK(0.0);
+    for (size_t i = 1; i < buffer_.size(); i++) {
+        const Centroid& next = buffer_[i];
+        double proposed = static_cast<double>(current.weight) + next.weight;
+        if (ScaleK((before + proposed) / total) - kLeft <= 1.0) {
+            current.mean += static_cast<float>((next.mean - current.mean) * next.weight / proposed);
+            current.weight = static_cast<float>(proposed);
+        } else {
+            before += current.weight;
+            kLeft = ScaleK(before / total);
+            centroids_.push_back(current);
+            current = next;
+        }
+    }
+    centroids_.push_back(current);
+    buffer_.clear();
+}
+
+float QuantileSketch::Quantile(double q) {
+    Flush();
+    if (centroids_.empty()) {
+        return 0.0f;
+    }
+    if (centroids_.size() == 1 || q <= 0.0) {
+        return q <= 0.0 ? min_ : centroids_[0].mean;
+    }
+    if (q >= 1.0) {
+        return max_;
+    }
+
+    // 每个质心代表以其均值为中心、宽度为其权重的一段累计分布，相邻中心之间线性插值
+    double target = q * static_cast<double>(count_);
+    double cumulative = 0.0;
+    double previousCenter = 0.0;
+    float previousMean = min_;
+    for (const Centroid& centroid : centroids_) {
+        double center = cumulative + centroid.weight / 2.0;
+        if (target < center) {
+            double span = center - previousCenter;
+            double t = span > 0.0 ? (target - previousCenter) / span : 0.0;
+            return previousMean + static_cast<float>((centroid.mean - previousMean) * t);
+        }
+        cumulative += centroid.weight;
+        previousCenter = center;
+        previousMean = centroid.mean;
+    }
+    double span = cumulative - previousCenter;
+    double t = span > 0.0 ? (target - previousCenter) / span : 1.0;
+    return previousMean + static_cast<float>((max_ - previousMean) * std::min(1.0, t));
+}
+
+void QuantileHistory::Add(Clock::time_point timestamp, float value) {
+    int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp.time_since_epoch()).count();
+    latestSeconds_ = seconds;
+    for (size_t tier = 0; tier < kTierCount; tier++) {
+        int64_t index = seconds / kTierSeconds[tier];
+        Slot& slot = tiers_[tier][static_cast<size_t>(index % static_cast<int64_t>(kSlotCount))];
+        if (slot.index != index) {
+            // 该位置原来是 kSlotCount 个时间段之前的数据，直接覆盖
+            slot.sketch.Clear();
+            slot.index = index;
+            // 上一个时间段已经结束，压缩后不再需要缓冲区
+            Slot& previous = tiers_[tier][static_cast<size_t>((index + kSlotCount - 1) % kSlotCount)];
+            if (previous.index == index - 1) {
+                previous.sketch.Compact();
+            }
+        }
+        slot.sketch.Add(value);
+    }
+    session_.Add(value);
+}
+
+void QuantileHistory::Select(Clock::duration window, QuantileSketch& out) const {
+    out.Clear();
+    int64_t windowSeconds = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::seconds>(window).count());
+
+    // 选择能覆盖窗口的最细一档；当前时间段尚未结束，再多取一个时间段补足窗口开头
+    for (size_t tier = 0; tier < kTierCount; tier++) {
+        int64_t resolution = kTierSeconds[tier];
+        int64_t slots = (windowSeconds + resolution - 1) / resolution + 1;
+        if (slots > static_cast<int64_t>(kSlotCount)) {
+            continue;
+        }
+        int64_t latest = latestSeconds_ / resolution;
+        for (const Slot& slot : tiers_[tier]) {
+            if (slot.index >= 0 && slot.index > latest - slots && slot.index <= latest) {
+                out.Merge(slot.sketch);
+            }
+        }
+        return;
+    }
+    out.Merge(session_);
+}
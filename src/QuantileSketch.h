@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 流式分位数估计（合并式 t-digest）
+// 样本先进入缓冲区，缓冲区满时与已有的质心一起排序并按分位数位置压缩：
+// 两端（p1/p99 附近）的质心很小，中间的质心可以很大，因此尾部分位数的误差远小于中位数附近。
+// 质心数不超过 kCompression + 1，内存占用与样本数无关；两个草图可以直接合并（如多个时间段、多个节点）。
+class QuantileSketch {
+public:
+    static constexpr double kCompression = 100.0;
+    static constexpr size_t kBufferSize = 128;
+
+    void Add(float value) { AddWeighted(value, 1.0f); }
+    void Merge(const QuantileSketch& other);
+    void Clear();
+
+    // 分位数 q ∈ [0, 1]，没有样本时返回 0
+    float Quantile(double q);
+    uint64_t Count() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+    float Min() const { return min_; }
+    float Max() const { return max_; }
+
+    // 把缓冲区压缩进质心并释放缓冲区（不再追加数据的草图，如已结束的时间段）
+    void Compact();
+
+private:
+    struct Centroid {
+        float mean;
+        float weight;
+    };
+
+    void AddWeighted(float mean, float weight);
+    void Flush();
+
+    std::vector<Centroid> centroids_;   // 按均值排序
+    std::vector<Centroid> buffer_;      // 尚未压缩的样本/其他草图的质心
+    uint64_t count_ = 0;
+    float min_ = 0.0f;
+    float max_ = 0.0f;
+};
+
+// 单个指标分时间段的分位数草图：最近 60 分钟每分钟一个、最近 60 小时每小时一个，外加整个会话一个
+// 任意时间窗口的分位数由覆盖该窗口的时间段合并得到（窗口按时间段粒度向上取整）
+class QuantileHistory {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kSlotCount = 60;
+    static constexpr size_t kTierCount = 2;
+    static constexpr std::array<int, kTierCount> kTierSeconds = {60, 3600};
+
+    // 累加一个样本（时间戳需单调不减）
+    void Add(Clock::time_point timestamp, float value);
+
+    // 把截至最新样本、长度为 window 的窗口合并到 out（先清空）；窗口超过 60 小时时返回整个会话
+    void Select(Clock::duration window, QuantileSketch& out) const;
+    const QuantileSketch& Session() const { return session_; }
+
+private:
+    struct Slot {
+        int64_t index = -1;      // 时间段序号（时间戳 / 分辨率），-1 表示空
+        QuantileSketch sketch;
+    };
+
+    std::array<std::array<Slot, kSlotCount>, kTierCount> tiers_;
+    QuantileSketch session_;
+    int64_t latestSeconds_ = 0;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// 固定容量的环形序列（用于所有指标历史数据）
+// - Push 为 O(1)，写满后覆盖最旧的数据，不会移动内存
+// - 数据存放在内联数组中，复制快照时就是一次连续内存拷贝
+// - 可以直接交给 ImGui::PlotLines：PlotLines(label, Data(), PlotCount(), PlotOffset(), ...)
+//   PlotLines 按 (i + values_offset) % values_count 取值，正好从最旧的数据开始线性读取
+template <typename T, size_t N>
+class RingSeries {
+    static_assert(N > 0, "RingSeries capacity must be positive");
+
+public:
+    static constexpr size_t kCapacity = N;
+
+    // 一段连续的只读数据
+    struct Span {
+        const T* data = nullptr;
+        size_t size = 0;
+    };
+
+    void Push(const T& value) {
+        data_[head_] = value;
+        head_ = (head_ + 1 == N) ? 0 : head_ + 1;
+        if (size_ < N) {
+            size_++;
+        }
+    }
+
+    void Clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    bool Full() const { return size_ == N; }
+    static constexpr size_t Capacity() { return N; }
+
+    // 按时间顺序访问：0 为最旧的数据，Size()-1 为最新的数据
+    const T& operator[](size_t index) const {
+        size_t physical = Start() + index;
+        return data_[physical >= N ? physical - N : physical];
+    }
+    const T& Front() const { return (*this)[0]; }
+    const T& Back() const { return data_[head_ == 0 ? N - 1 : head_ - 1]; }
+
+    // 两段连续视图：first 为较旧的一段，second 为较新的一段（未写满时 second 为空）
+    Span First() const {
+        if (size_ < N) {
+            return Span{data_.data(), size_};
+        }
+        return Span{data_.data() + head_, N - head_};
+    }
+    Span Second() const {
+        if (size_ < N) {
+            return Span{data_.data() + size_, 0};
+        }
+        return Span{data_.data(), head_};
+    }
+
+    // 供 ImGui::PlotLines 使用的线性读取参数
+    const T* Data() const { return data_.data(); }
+    int PlotCount() const { return static_cast<int>(size_); }
+    int PlotOffset() const { return size_ < N ? 0 : static_cast<int>(head_); }
+
+    // 按时间顺序遍历（两段连续内存，无取模运算）
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        Span first = First();
+        for (size_t i = 0; i < first.size; i++) {
+            fn(first.data[i]);
+        }
+        Span second = Second();
+        for (size_t i = 0; i < second.size; i++) {
+            fn(second.data[i]);
+        }
+    }
+
+    // 最小值/最大值（需要序列非空；O(N) 扫描）
+    T Min() const {
+        T result = Back();
+        ForEach([&](const T& value) { if (value < result) result = value; });
+        return result;
+    }
+    T Max() const {
+        T result = Back();
+        ForEach([&](const T& value) { if (result < value) result = value; });
+        return result;
+    }
+
+    // 线性拷贝到外部缓冲区（按时间顺序），返回拷贝的数量
+    size_t CopyTo(T* out, size_t maxCount) const {
+        size_t copied = 0;
+        ForEach([&](const T& value) {
+            if (copied < maxCount) {
+                out[copied++] = value;
+            }
+        });
+        return copied;
+    }
+
+private:
+    size_t Start() const { return size_ < N ? 0 : head_; }
+
+    std::array<T, N> data_{};
+    size_t head_ = 0;   // 下一次写入的位置
+    size_t size_ = 0;
+};
@@ -0,0 +1,71 @@
+#include "SamplingScheduler.h"
+#include <algorithm>
+#include <iostream>
+
+size_t SamplingScheduler::Register(const std::string& name, std::chrono::milliseconds period,
+                                   std::chrono::microseconds costBudget, std::function<void()> collect) {
+    size_t index = collectors_.size();
+    collectors_.push_back(std::move(collect));
+
+    CollectorStats stats;
+    stats.name = name;
+    stats.period = period;
+    stats.costBudget = costBudget;
+    stats_.push_back(stats);
+
+    // 新注册的采集器立即到期，保证第一次快照包含所有数据
+    queue_.push(Pending{Clock::time_point::min(), index});
+    return index;
+}
+
+bool SamplingScheduler::RunDue(Clock::time_point now) {
+    bool ran = false;
+    while (!queue_.empty() && queue_.top().due <= now) {
+        Pending pending = queue_.top();
+        queue_.pop();
+
+        CollectorStats& stats = stats_[pending.index];
+        auto start = Clock::now();
+        collectors_[pending.index]();
+        auto finish = Clock::now();
+
+        stats.lastCost = std::chrono::duration_cast<std::chrono::microseconds>(finish - start);
+        stats.runCount++;
+        ran = true;
+
+        // 静态采集器只运行一次
+        if (stats.period.count() == 0) {
+            continue;
+        }
+
+        // 超出耗时预算：按 实际耗时/预算 的比例拉长下一次的间隔，限制采集器的CPU占用比例
+        Clock::duration delay = stats.period;
+        if (stats.costBudget.count() > 0 && stats.lastCost > stats.costBudget) {
+            if (stats.overBudgetCount++ == 0) {
+                std::cerr << "警告: 采集器 " << stats.name << " 耗时 "
+                          << stats.lastCost.count() << "us，超出预算 "
+                          << stats.costBudget.count() << "us，将降低其采样频率" << std::endl;
+            }
+            double factor = static_cast<double>(stats.lastCost.count()) /
+                            static_cast<double>(stats.costBudget.count());
+            factor = std::min(static_cast<double>(kMaxBackoffFactor), factor);
+            delay = std::chrono::duration_cast<Clock::duration>(stats.period * factor);
+        }
+
+        // 按节拍对齐避免漂移；如果已经错过了节拍，则从完成时刻重新计时，不补采
+        Clock::time_point base = (pending.due == Clock::time_point::min()) ? start : pending.due;
+        Clock::time_point next = base + delay;
+        if (next <= finish) {
+            next = finish + delay;
+        }
+        queue_.push(Pending{next, pending.index});
+    }
+    return ran;
+}
+
+SamplingScheduler::Clock::time_point SamplingScheduler::NextDeadline() const {
+    if (queue_.empty()) {
+        return Clock::time_point::max();
+    }
+    return queue_.top().due;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+// 采集器调度器（优先队列实现）
+// 每个采集器声明自己的采样周期和单次耗时预算：
+//   - 廉价的采集器（如GPU利用率）高频运行
+//   - 昂贵的采集器低频运行；实际耗时超出预算时自动按比例拉长周期
+//   - 周期为0的静态采集器（如内存条清单）只运行一次
+class SamplingScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct CollectorStats {
+        std::string name;
+        std::chrono::milliseconds period{0};
+        std::chrono::microseconds costBudget{0};
+        std::chrono::microseconds lastCost{0};  // 最近一次运行耗时
+        uint64_t runCount = 0;
+        uint64_t overBudgetCount = 0;           // 超出预算的次数
+    };
+
+    // 注册采集器，返回其编号；period 为 0 表示只运行一次
+    size_t Register(const std::string& name, std::chrono::milliseconds period,
+                    std::chrono::microseconds costBudget, std::function<void()> collect);
+
+    // 运行所有到期的采集器（同时到期时按注册顺序运行），返回是否有采集器运行
+    bool RunDue(Clock::time_point now);
+
+    // 下一个采集器的到期时间；没有待运行的采集器时返回 time_point::max()
+    Clock::time_point NextDeadline() const;
+
+    const std::vector<CollectorStats>& GetStats() const { return stats_; }
+
+private:
+    // 超出预算时周期最多拉长的倍数
+    static constexpr int kMaxBackoffFactor = 10;
+
+    struct Pending {
+        Clock::time_point due;
+        size_t index;
+        bool operator>(const Pending& other) const {
+            return due != other.due ? due > other.due : index > other.index;
+        }
+    };
+
+    std::vector<std::function<void()>> collectors_;
+    std::vector<CollectorStats> stats_;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> queue_;
+};
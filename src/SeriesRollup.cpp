@@ -0,0 +1,55 @@
+#include "SeriesRollup.h"
+#include <algorithm>
+
+void SeriesRollup::Add(Clock::time_point timestamp, float value) {
+    int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp.time_since_epoch()).count();
+    for (size_t tier = 0; tier < kTierCount; tier++) {
+        Accumulator& acc = pending_[tier];
+        int64_t bucket = seconds / kTierSeconds[tier];
+        if (bucket != acc.bucket) {
+            // 当前桶的时间段已结束，写入聚合层后开始新桶；中间没有样本的时间段补空桶，超过一整档的部分会被覆盖，不必写入
+            if (acc.count > 0) {
+                tiers_[tier].Push(Close(acc));
+                int64_t skipped = std::min<int64_t>(bucket - acc.bucket - 1, static_cast<int64_t>(kTierCapacity));
+                for (int64_t i = 0; i < skipped; i++) {
+                    tiers_[tier].Push(HistoryBucket{});
+                }
+            }
+            acc = Accumulator{};
+            acc.bucket = bucket;
+            acc.minValue = value;
+            acc.maxValue = value;
+        }
+        acc.minValue = std::min(acc.minValue, value);
+        acc.maxValue = std::max(acc.maxValue, value);
+        acc.sum += value;
+        acc.count++;
+    }
+}
+
+void SeriesRollup::Clear() {
+    for (size_t tier = 0; tier < kTierCount; tier++) {
+        tiers_[tier].Clear();
+        pending_[tier] = Accumulator{};
+    }
+}
+
+size_t SeriesRollup::Size(size_t tier) const {
+    return tiers_[tier].Size() + (pending_[tier].count > 0 ? 1 : 0);
+}
+
+HistoryBucket SeriesRollup::At(size_t tier, size_t index) const {
+    if (index < tiers_[tier].Size()) {
+        return tiers_[tier][index];
+    }
+    return Close(pending_[tier]);
+}
+
+HistoryBucket SeriesRollup::Close(const Accumulator& acc) {
+    HistoryBucket bucket;
+    bucket.minValue = acc.minValue;
+    bucket.maxValue = acc.maxValue;
+    bucket.mean = acc.count > 0 ? static_cast<float>(acc.sum / acc.count) : 0.0f;
+    bucket.count = acc.count;
+    return bucket;
+}
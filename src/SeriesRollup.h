@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "RingSeries.h"
+
+// 一个聚合桶：覆盖一个固定时间段内所有原始样本的最小值/最大值/均值
+// count 为 0 的是空桶：该时间段内没有样本（采样线程停顿、系统挂起或录制中断），只用来占住时间轴上的位置
+struct HistoryBucket {
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+    float mean = 0.0f;
+    uint32_t count = 0;
+};
+
+// 单个指标的多分辨率聚合（用于长时间训练任务的监控）
+// 10秒 / 1分钟 / 10分钟 三档，每档 kTierCapacity 个桶，分别覆盖 1 小时 / 6 小时 / 60 小时。
+// 每个样本同时累加到三档的当前桶，桶的时间段结束时写入对应的环形序列。
+// 样本之间跳过了若干个时间段时，每个跳过的时间段写入一个空桶（最多一整档），各档的桶序号始终与时间对齐。
+// 所有存储都是内联的定长数组，单个指标的内存占用在编译期确定（约 13KB）。
+class SeriesRollup {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kTierCapacity = 360;
+    static constexpr size_t kTierCount = 3;
+    // 各档的分辨率（秒）
+    static constexpr std::array<int, kTierCount> kTierSeconds = {10, 60, 600};
+
+    // 累加一个样本（时间戳需单调不减）
+    void Add(Clock::time_point timestamp, float value);
+    void Clear();
+
+    // 第 tier 档含尚未结束的当前桶在内的点数；index 0 为最旧的桶
+    size_t Size(size_t tier) const;
+    HistoryBucket At(size_t tier, size_t index) const;
+    // 第 tier 档的环形序列是否已写满（写满后只覆盖 kTierCapacity 个桶的时长）
+    bool Full(size_t tier) const { return tiers_[tier].Full(); }
+
+private:
+    struct Accumulator {
+        int64_t bucket = -1;   // 当前桶的序号（时间戳 / 分辨率），-1 表示尚无数据
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        double sum = 0.0;
+        uint32_t count = 0;
+    };
+
+    static HistoryBucket Close(const Accumulator& acc);
+
+    std::array<RingSeries<HistoryBucket, kTierCapacity>, kTierCount> tiers_;
+    std::array<Accumulator, kTierCount> pending_;
+};
@@ -0,0 +1,245 @@
+#include "SeriesStore.h"
+#include <algorithm>
+
+MetricId SeriesStore::Register(const std::string& name, const std::string& unit, bool quantiles) {
+    MetricId existing = Find(name);
+    if (existing != kInvalidMetric) {
+        return existing;
+    }
+
+    MetricId id = static_cast<MetricId>(metrics_.size());
+    Metric metric;
+    metric.name = name;
+    metric.unit = unit;
+    if (quantiles) {
+        metric.quantiles = quantiles_.size();
+        quantiles_.emplace_back();
+    }
+    metrics_.push_back(metric);
+    values_.resize(metrics_.size() * kCapacity, 0.0f);
+    rollups_.emplace_back();
+    windows_.emplace_back();
+    for (size_t i = 0; i < kWindowCount; i++) {
+        windows_.back()[i].Reset(std::chrono::seconds(kWindowSeconds[i]));
+    }
+    return id;
+}
+
+MetricId SeriesStore::Find(const std::string& name) const {
+    for (size_t i = 0; i < metrics_.size(); i++) {
+        if (metrics_[i].name == name) {
+            return static_cast<MetricId>(i);
+        }
+    }
+    return kInvalidMetric;
+}
+
+void SeriesStore::Set(MetricId id, float value) {
+    if (id >= metrics_.size()) {
+        return;
+    }
+    Metric& metric = metrics_[id];
+    if (!metric.hasValue) {
+        metric.hasValue = true;
+        metric.firstRow = appended_;
+    }
+    metric.current = value;
+}
+
+void SeriesStore::Append(Clock::time_point timestamp) {
+    times_[head_] = timestamp;
+    for (size_t id = 0; id < metrics_.size(); id++) {
+        const Metric& metric = metrics_[id];
+        values_[id * kCapacity + head_] = metric.current;
+        if (metric.hasValue) {
+            rollups_[id].Add(timestamp, metric.current);
+            for (SlidingWindow& window : windows_[id]) {
+                window.Add(timestamp, metric.current);
+            }
+            if (metric.quantiles != kNoQuantiles) {
+                quantiles_[metric.quantiles].Add(timestamp, metric.current);
+            }
+        }
+    }
+    head_ = (head_ + 1 == kCapacity) ? 0 : head_ + 1;
+    if (size_ < kCapacity) {
+        size_++;
+    }
+    appended_++;
+}
+
+void SeriesStore::SyncFrom(const SeriesStore& source) {
+    if (metrics_.size() > source.metrics_.size() || appended_ > source.appended_ ||
+        source.appended_ - appended_ > source.size_) {
+        *this = source;
+        return;
+    }
+    for (size_t id = metrics_.size(); id < source.metrics_.size(); id++) {
+        const Metric& metric = source.metrics_[id];
+        Register(metric.name, metric.unit, metric.quantiles != kNoQuantiles);
+    }
+    // 每行只重放在 source 中已有值的指标，firstRow 与 source 一致
+    for (uint64_t row = appended_; row < source.appended_; row++) {
+        size_t sourceRow = source.size_ - static_cast<size_t>(source.appended_ - row);
+        for (size_t id = 0; id < metrics_.size(); id++) {
+            const Metric& metric = source.metrics_[id];
+            if (metric.hasValue && row >= metric.firstRow) {
+                Set(static_cast<MetricId>(id), source.ValueAt(static_cast<MetricId>(id), sourceRow));
+            }
+        }
+        Append(source.TimeAt(sourceRow));
+    }
+}
+
+size_t SeriesStore::ValidRows(MetricId id) const {
+    const Metric& metric = metrics_[id];
+    if (!metric.hasValue || appended_ <= metric.firstRow) {
+        return 0;
+    }
+    return static_cast<size_t>(std::min<uint64_t>(size_, appended_ - metric.firstRow));
+}
+
+size_t SeriesStore::LowerBound(Clock::time_point t) const {
+    size_t lo = 0;
+    size_t hi = size_;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (TimeAt(mid) < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+SeriesStore::View SeriesStore::Select(MetricId id, Clock::duration window) const {
+    View view;
+    view.store_ = this;
+    view.metric_ = id;
+    if (Empty(id)) {
+        return view;
+    }
+
+    // 原始数据未写满时包含全部历史；写满后只覆盖最早与最新一行之间的时长
+    size_t validRows = ValidRows(id);
+    size_t firstValid = size_ - validRows;
+    if (size_ < kCapacity || TimeAt(size_ - 1) - TimeAt(firstValid) >= window) {
+        view.tier_ = -1;
+        view.start_ = std::max(firstValid, LowerBound(TimeAt(size_ - 1) - window));
+        view.count_ = size_ - view.start_;
+        return view;
+    }
+
+    // 选择能覆盖整个窗口的最细聚合档位；都覆盖不了时使用最粗的一档
+    const SeriesRollup& rollup = rollups_[id];
+    size_t tier = 0;
+    while (tier + 1 < SeriesRollup::kTierCount) {
+        auto coverage = std::chrono::seconds(SeriesRollup::kTierSeconds[tier]) *
+                        static_cast<int64_t>(SeriesRollup::kTierCapacity);
+        if (!rollup.Full(tier) || coverage >= window) {
+            break;
+        }
+        tier++;
+    }
+
+    size_t points = rollup.Size(tier);
+    auto resolution = std::chrono::seconds(SeriesRollup::kTierSeconds[tier]);
+    size_t wanted = static_cast<size_t>((window + resolution - Clock::duration(1)) / resolution) + 1;
+    view.tier_ = static_cast<int>(tier);
+    view.count_ = std::min(points, wanted);
+    view.start_ = points - view.count_;
+    return view;
+}
+
+bool SeriesStore::Summarize(MetricId id, Clock::duration window, HistoryBucket& out) const {
+    if (Empty(id)) {
+        return false;
+    }
+    for (size_t i = 0; i < kWindowCount; i++) {
+        if (window == std::chrono::seconds(kWindowSeconds[i])) {
+            out = windows_[id][i].Summary();
+            return true;
+        }
+    }
+
+    // 视图的最后一个点是有样本的当前桶，非空桶至少有一个
+    View view = Select(id, window);
+    out.minValue = view.Min();
+    out.maxValue = view.Max();
+    double sum = 0.0;
+    uint32_t buckets = 0;
+    for (int i = 0; i < view.Count(); i++) {
+        if (!view.Gap(static_cast<size_t>(i))) {
+            sum += view.Mean(static_cast<size_t>(i));
+            buckets++;
+        }
+    }
+    out.mean = static_cast<float>(sum / buckets);
+    out.count = buckets;
+    return true;
+}
+
+bool SeriesStore::SelectQuantiles(MetricId id, Clock::duration window, QuantileSketch& out) const {
+    out.Clear();
+    if (!HasQuantiles(id) || Empty(id)) {
+        return false;
+    }
+
+    // 与 Select 相同的判断：原始数据覆盖窗口时用原始样本，结果不受时间段边界影响
+    size_t validRows = ValidRows(id);
+    size_t firstValid = size_ - validRows;
+    if (size_ < kCapacity || TimeAt(size_ - 1) - TimeAt(firstValid) >= window) {
+        size_t start = std::max(firstValid, LowerBound(TimeAt(size_ - 1) - window));
+        Scan(id, start, [&out](Clock::time_point, float value) { out.Add(value); });
+        return !out.Empty();
+    }
+    quantiles_[metrics_[id].quantiles].Select(window, out);
+    return !out.Empty();
+}
+
+bool SeriesStore::SessionQuantiles(MetricId id, QuantileSketch& out) const {
+    out.Clear();
+    if (!HasQuantiles(id)) {
+        return false;
+    }
+    out.Merge(quantiles_[metrics_[id].quantiles].Session());
+    return !out.Empty();
+}
+
+HistoryBucket SeriesStore::View::At(size_t index) const {
+    size_t position = start_ + index;
+    if (tier_ < 0) {
+        float value = store_->ValueAt(metric_, position);
+        return HistoryBucket{value, value, value, 1};
+    }
+    return store_->rollups_[metric_].At(static_cast<size_t>(tier_), position);
+}
+
+float SeriesStore::View::Min() const {
+    float result = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count_; i++) {
+        HistoryBucket bucket = At(i);
+        if (bucket.count > 0) {
+            result = std::min(result, bucket.minValue);
+        }
+    }
+    return result;
+}
+
+float SeriesStore::View::Max() const {
+    float result = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < count_; i++) {
+        HistoryBucket bucket = At(i);
+        if (bucket.count > 0) {
+            result = std::max(result, bucket.maxValue);
+        }
+    }
+    return result;
+}
+
+float SeriesStore::View::PlotMean(void* data, int index) {
+    const View* view = static_cast<const View*>(data);
+    HistoryBucket bucket = view->At(static_cast<size_t>(index));
+    return bucket.count > 0 ? bucket.mean : std::numeric_limits<float>::quiet_NaN();
+}
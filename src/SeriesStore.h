@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "QuantileSketch.h"
+#include "SeriesRollup.h"
+#include "SlidingWindow.h"
+
+// 指标编号：按注册顺序分配，运行期间保持不变
+using MetricId = uint32_t;
+constexpr MetricId kInvalidMetric = std::numeric_limits<MetricId>::max();
+
+// 所有指标共用一条时间线的列式时序存储（结构数组）
+// - 一列单调递增的时间戳 + 每个指标一列 float，各列在内存中连续，按行号对齐
+// - 采集器通过 Set 暂存指标的最新值，采样线程每发布一次快照追加一行；
+//   本轮没有运行的采集器沿用上一次的值（采样保持），因此同一行的各列可以直接相互比较
+// - 漏掉的采样周期表现为时间戳之间的间隔，而不会压缩时间轴
+// - 原始数据保留最近 kCapacity 行；更长的时间窗口由每个指标的 SeriesRollup 提供
+// - 每个指标对 kWindowSeconds 中的几个标准窗口维护滑动统计（最小/最大/均值），图表读取时无需扫描
+// - 注册时要求分位数的指标另外维护 QuantileHistory，可查询任意窗口和整个会话的 p50/p95/p99
+class SeriesStore {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kCapacity = 1200;
+    // 预先维护滑动统计的窗口（秒），与界面可选的历史窗口一致
+    static constexpr size_t kWindowCount = 6;
+    static constexpr std::array<int, kWindowCount> kWindowSeconds = {60, 600, 3600, 6 * 3600, 24 * 3600, 60 * 3600};
+
+    // 某个指标最近一段时间的只读视图，供绘图和统计使用
+    // 原始数据的 Min/Max/Mean 都等于样本值；聚合数据的最后一个点是尚未结束的当前桶，
+    // 其中可能有没有样本的空桶（HistoryBucket::count 为 0），统计时跳过
+    class View {
+    public:
+        int Tier() const { return tier_; }   // -1 为原始数据，0..kTierCount-1 为聚合档位
+        int Count() const { return static_cast<int>(count_); }
+        bool Empty() const { return count_ == 0; }
+        HistoryBucket At(size_t index) const;
+        float Mean(size_t index) const { return At(index).mean; }
+        bool Gap(size_t index) const { return At(index).count == 0; }
+        float Min() const;   // 视图内非空桶的最小值（需要非空）
+        float Max() const;   // 视图内非空桶的最大值（需要非空）
+
+        // ImGui::PlotLines 的取值回调，data 为 const View*；空桶返回 NaN，曲线在此处断开
+        static float PlotMean(void* data, int index);
+
+    private:
+        friend class SeriesStore;
+        const SeriesStore* store_ = nullptr;
+        MetricId metric_ = kInvalidMetric;
+        int tier_ = -1;
+        size_t start_ = 0;   // 原始数据为行号，聚合数据为桶序号
+        size_t count_ = 0;
+    };
+
+    // 注册指标，名称相同时返回已有的编号（如 "gpu0.utilization"）
+    // quantiles 为 true 时维护分位数草图（每个指标约几十 KB，只用于需要看分布的指标）
+    MetricId Register(const std::string& name, const std::string& unit, bool quantiles = false);
+    MetricId Find(const std::string& name) const;
+    size_t GetMetricCount() const { return metrics_.size(); }
+    const std::string& GetName(MetricId id) const { return metrics_[id].name; }
+    const std::string& GetUnit(MetricId id) const { return metrics_[id].unit; }
+
+    // ===== 写端（采样线程） =====
+    // 暂存指标的最新值，下一次 Append 时写入
+    void Set(MetricId id, float value);
+    // 以 timestamp 追加一行（时间戳需单调不减）
+    void Append(Clock::time_point timestamp);
+    // 把本存储更新为与 source 相同（本存储需为空或是 source 较早时的副本，如快照缓冲区中的历史）：
+    // 补注册新指标，再用 source 保留的原始数据重放之后追加的行，聚合桶、滑动统计和分位数草图随之更新；
+    // 落后超过 source 保留的行数时整体复制
+    void SyncFrom(const SeriesStore& source);
+
+    // ===== 读端 =====
+    size_t Size() const { return size_; }   // 保留的行数
+    uint64_t Revision() const { return appended_; }   // 累计追加的行数，变化说明有新数据（用于缓存失效）
+    Clock::time_point TimeAt(size_t row) const { return times_[Physical(row)]; }   // row 0 为最旧的一行
+    float ValueAt(MetricId id, size_t row) const { return values_[id * kCapacity + Physical(row)]; }
+    bool Empty(MetricId id) const { return id >= metrics_.size() || ValidRows(id) == 0; }
+    float Latest(MetricId id) const { return metrics_[id].current; }
+    // 第一个时间戳不早于 t 的行号（二分查找）
+    size_t LowerBound(Clock::time_point t) const;
+
+    // 按时间顺序扫描 [fromRow, Size()) 行：fn(时间戳, 值)，内部是两段连续内存
+    template <typename Fn>
+    void Scan(MetricId id, size_t fromRow, Fn&& fn) const {
+        size_t start = (size_ < kCapacity) ? 0 : head_;
+        const float* column = values_.data() + id * kCapacity;
+        for (size_t row = fromRow; row < size_; ) {
+            size_t physical = start + row;
+            if (physical >= kCapacity) {
+                physical -= kCapacity;
+            }
+            size_t run = std::min(size_ - row, kCapacity - physical);
+            for (size_t i = 0; i < run; i++) {
+                fn(times_[physical + i], column[physical + i]);
+            }
+            row += run;
+        }
+    }
+
+    // 选择能覆盖 window 时长的最细分辨率，返回指标最近 window 时长的视图
+    View Select(MetricId id, Clock::duration window) const;
+
+    // 指标最近 window 时长的最小值/最大值/均值：标准窗口直接读取滑动统计，其他窗口扫描 Select 的视图；
+    // 指标没有数据时返回 false
+    bool Summarize(MetricId id, Clock::duration window, HistoryBucket& out) const;
+
+    // 指标最近 window 时长的分布，写入 out（先清空）：原始数据覆盖窗口时逐个样本累加，
+    // 否则合并覆盖窗口的分钟/小时草图；指标没有分位数或没有数据时返回 false
+    bool HasQuantiles(MetricId id) const { return id < metrics_.size() && metrics_[id].quantiles != kNoQuantiles; }
+    bool SelectQuantiles(MetricId id, Clock::duration window, QuantileSketch& out) const;
+    // 整个会话的分布
+    bool SessionQuantiles(MetricId id, QuantileSketch& out) const;
+
+private:
+    static constexpr size_t kNoQuantiles = std::numeric_limits<size_t>::max();
+
+    struct Metric {
+        std::string name;
+        std::string unit;
+        float current = 0.0f;      // 暂存的最新值
+        bool hasValue = false;
+        uint64_t firstRow = 0;     // 第一次有值的绝对行号，之前的行对该指标无效
+        size_t quantiles = kNoQuantiles;   // quantiles_ 中的位置
+    };
+
+    size_t Physical(size_t row) const {
+        size_t physical = ((size_ < kCapacity) ? 0 : head_) + row;
+        return physical >= kCapacity ? physical - kCapacity : physical;
+    }
+    // 该指标在保留的行中有效的行数（最新的若干行）
+    size_t ValidRows(MetricId id) const;
+
+    std::vector<Metric> metrics_;
+    std::vector<Clock::time_point> times_ = std::vector<Clock::time_point>(kCapacity);
+    std::vector<float> values_;            // 按列存放：values_[id * kCapacity + 物理位置]
+    std::vector<SeriesRollup> rollups_;    // 每个指标一个
+    std::vector<std::array<SlidingWindow, kWindowCount>> windows_;   // 每个指标一组
+    std::vector<QuantileHistory> quantiles_;   // 只有注册时要求分位数的指标才有
+    size_t head_ = 0;                      // 下一行写入的物理位置
+    size_t size_ = 0;
+    uint64_t appended_ = 0;                // 累计追加的行数
+};
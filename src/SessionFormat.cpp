@@ -0,0 +1,475 @@
+#include "SessionFormat.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+static std::array<uint32_t, 256> BuildCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+uint32_t SessionCrc32(const void* data, size_t size, uint32_t crc) {
+    static const std::array<uint32_t, 256> table = BuildCrcTable();
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// 解码时写回字段；编码时状态是只读的，什么也不做
+template <typename T, typename V>
+static void Assign(T& target, V value) {
+    if constexpr (!std::is_const<T>::value) {
+        target = static_cast<T>(value);
+    }
+}
+
+template <typename T>
+static void Resize(T& items, size_t count) {
+    if constexpr (!std::is_const<T>::value) {
+        items.resize(count);
+    }
+}
+
+// 顺序写入定长缓冲区，越界后只记录失败，不再写入
+class SessionEncoder {
+public:
+    SessionEncoder(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    template <typename T>
+    void operator()(const T& value) {
+        Bytes(&value, sizeof(T));
+    }
+    // 录制文件保存原始浮点数，不做量化
+    void operator()(const float& value, double) { (*this)(value); }
+    void operator()(const std::string& value) {
+        // 字符串最长 255 字节，超出部分截断
+        uint8_t length = static_cast<uint8_t>(value.size() > 255 ? 255 : value.size());
+        Bytes(&length, 1);
+        Bytes(value.data(), length);
+    }
+    void Bytes(const void* data, size_t size) {
+        if (pos_ + size > capacity_) {
+            ok_ = false;
+            return;
+        }
+        std::memcpy(out_ + pos_, data, size);
+        pos_ += size;
+    }
+    // 数组长度；编码时原样写出
+    void Count(const uint16_t& count) { (*this)(count); }
+
+    bool Ok() const { return ok_; }
+    size_t Position() const { return pos_; }
+
+private:
+    uint8_t* out_;
+    size_t capacity_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+// 与 SessionEncoder 对称的读取器
+class SessionDecoder {
+public:
+    SessionDecoder(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    void operator()(T& value) {
+        Bytes(&value, sizeof(T));
+    }
+    void operator()(float& value, double) { (*this)(value); }
+    void operator()(std::string& value) {
+        uint8_t length = 0;
+        Bytes(&length, 1);
+        if (!ok_ || pos_ + length > size_) {
+            ok_ = false;
+            return;
+        }
+        value.assign(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+    }
+    void Bytes(void* data, size_t size) {
+        if (pos_ + size > size_) {
+            ok_ = false;
+            std::memset(data, 0, size);
+            return;
+        }
+        std::memcpy(data, data_ + pos_, size);
+        pos_ += size;
+    }
+    void Count(uint16_t& count) { (*this)(count); }
+
+    bool Ok() const { return ok_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+// 差分编码时浮点字段的量化步长，与界面的显示精度一致：低于显示精度的传感器噪声不再让每一帧都产生差值。
+// 录制文件不受影响（仍保存原始浮点数）。修改步长会改变 SampleSchemaId，新旧两端自动退回完整记录。
+static constexpr double kStepPercent = 1.0;          // 利用率、负载、使用百分比 (%)
+static constexpr double kStepPressure = 0.1;         // PSI 停顿占比 (%)
+static constexpr double kStepPressureAvg = 0.01;     // PSI avg10 (%)，内核只保留两位小数，每 2 秒更新一次
+static constexpr double kStepTemperature = 0.1;      // °C
+static constexpr double kStepClock = 1.0;            // MHz
+static constexpr double kStepPower = 0.1;            // W
+static constexpr double kStepVoltage = 0.001;        // V
+static constexpr double kStepRate = 0.1;             // MB/s、次/秒
+static constexpr double kStepMegabytes = 1.0;        // MB
+static constexpr double kStepGigabytes = 0.01;       // GB
+static constexpr double kStepBandwidth = 0.001;      // GB/s（即 1 MB/s）
+static constexpr double kStepMilliseconds = 0.01;    // ms
+// 量化后的整数上限：±inf 截断到这里，NaN 记为 0（llround 对非有限值和超出 int64 范围的值是未定义行为）
+static constexpr double kSampleValueLimit = 1e15;
+
+// 把样本数值依次转换为整数写入 output，或从 input 写回（都为空时只计数，steps 非空时记录每个数值的量化步长）。
+// 浮点数按字段的量化步长取整，整数原样保留。不关心数组长度和字符串
+class SampleValueIo {
+public:
+    SampleValueIo(const int64_t* input, int64_t* output, std::vector<double>* steps = nullptr)
+        : input_(input), output_(output), steps_(steps) {}
+
+    // 整数字段（样本中的浮点字段都带量化步长，走下面的重载）
+    template <typename T>
+    void operator()(T& value) {
+        if (input_ != nullptr) {
+            Assign(value, input_[pos_]);
+        } else if (output_ != nullptr) {
+            output_[pos_] = static_cast<int64_t>(value);
+        } else if (steps_ != nullptr) {
+            steps_->push_back(0.0);
+        }
+        pos_++;
+    }
+    template <typename F>
+    void operator()(F& value, double step) {
+        static_assert(std::is_same<typename std::remove_const<F>::type, float>::value, "只有浮点字段带量化步长");
+        if (input_ != nullptr) {
+            Assign(value, static_cast<double>(input_[pos_]) * step);
+        } else if (output_ != nullptr) {
+            double steps = static_cast<double>(value) / step;
+            if (std::isnan(steps)) {
+                steps = 0.0;
+            }
+            output_[pos_] = std::llround(std::max(-kSampleValueLimit, std::min(kSampleValueLimit, steps)));
+        } else if (steps_ != nullptr) {
+            steps_->push_back(step);
+        }
+        pos_++;
+    }
+    void operator()(std::string&) {}
+    void operator()(const std::string&) {}
+    void Count(const uint16_t&) {}
+
+    bool Ok() const { return true; }
+    size_t Position() const { return pos_; }
+
+private:
+    const int64_t* input_;
+    int64_t* output_;
+    std::vector<double>* steps_;
+    size_t pos_ = 0;
+};
+
+// ===== 字段清单：编码和解码共用同一份，保证两边的顺序一致 =====
+// Info 是对应的 XxxInfo（解码、写回样本数值）或 const XxxInfo（编码、统计和展开样本数值）
+
+template <typename Io, typename Info>
+static void VisitGPUInventory(Io& io, Info& gpu) {
+    io(gpu.name);
+    io(gpu.uuid);
+    io(gpu.maxGpuClock);
+    io(gpu.maxMemoryClock);
+    io(gpu.pcieMaxLinkGeneration);
+    io(gpu.pcieMaxLinkWidth);
+    io(gpu.memoryBusWidth);
+}
+
+template <typename Io, typename Info>
+static void VisitGPUSample(Io& io, Info& gpu) {
+    uint8_t available = gpu.available ? 1 : 0;
+    io(available);
+    Assign(gpu.available, available != 0);
+    io(gpu.utilization, kStepPercent);
+    io(gpu.memoryUsed, kStepMegabytes);
+    io(gpu.memoryTotal, kStepMegabytes);
+    io(gpu.memoryPercent, kStepPercent);
+    io(gpu.temperature, kStepTemperature);
+    io(gpu.gpuClock);
+    io(gpu.memoryClock);
+    io(gpu.fanSpeed);
+    io(gpu.powerUsage);
+    io(gpu.powerLimit, kStepPower);
+    io(gpu.powerPercent, kStepPercent);
+    io(gpu.memoryControllerLoad, kStepPercent);
+    io(gpu.videoEngineLoad, kStepPercent);
+    io(gpu.currentVoltage, kStepVoltage);
+    io(gpu.maxVoltage, kStepVoltage);
+    io(gpu.voltagePercent, kStepPercent);
+    io(gpu.pcieLinkWidth);
+    io(gpu.pcieLinkSpeed);
+    io(gpu.pcieBandwidth, kStepBandwidth);
+    io(gpu.pcieRxThroughput, kStepRate);
+    io(gpu.pcieTxThroughput, kStepRate);
+    io(gpu.dataTransferWaitTime, kStepMilliseconds);
+}
+
+template <typename Io, typename Info>
+static void VisitModuleInventory(Io& io, Info& module) {
+    io(module.name);
+    io(module.type);
+    io(module.capacity);
+    io(module.speed);
+    io(module.channel);
+    io(module.maxBandwidth);
+}
+
+template <typename Io, typename Info>
+static void VisitModuleSample(Io& io, Info& module) {
+    io(module.realTimeBandwidth, kStepBandwidth);
+    io(module.utilization, kStepPercent);
+}
+
+template <typename Io, typename Info>
+static void VisitDiskInventory(Io& io, Info& disk) {
+    io(disk.name);
+    io(disk.model);
+    io(disk.type);
+    io(disk.totalSize);
+    io(disk.maxReadBandwidth);
+    io(disk.maxWriteBandwidth);
+}
+
+template <typename Io, typename Info>
+static void VisitDiskSample(Io& io, Info& disk) {
+    io(disk.realTimeReadBandwidth, kStepBandwidth);
+    io(disk.realTimeWriteBandwidth, kStepBandwidth);
+    io(disk.readUtilization, kStepPercent);
+    io(disk.writeUtilization, kStepPercent);
+}
+
+template <typename Io, typename Info>
+static void VisitLogicalCpuInventory(Io& io, Info& logical) {
+    io(logical.id);
+    io(logical.socket);
+    io(logical.core);
+    io(logical.thread);
+    io(logical.maxFrequency);
+}
+
+template <typename Io, typename Info>
+static void VisitPressureInventory(Io& io, Info& pressure) {
+    io(pressure.scope);
+}
+
+template <typename Io, typename Info>
+static void VisitPressureStat(Io& io, Info& stat) {
+    io(stat.someAvg10, kStepPressureAvg);
+    io(stat.fullAvg10, kStepPressureAvg);
+    io(stat.someStall, kStepPressure);
+    io(stat.fullStall, kStepPressure);
+}
+
+template <typename Io, typename Info>
+static void VisitPressureSample(Io& io, Info& pressure) {
+    VisitPressureStat(io, pressure.cpu);
+    VisitPressureStat(io, pressure.memory);
+    VisitPressureStat(io, pressure.io);
+}
+
+template <typename Io, typename Info>
+static void VisitCPUSample(Io& io, Info& cpu) {
+    io(cpu.utilization, kStepPercent);
+    io(cpu.temperature, kStepTemperature);
+    io(cpu.frequency, kStepClock);
+    io(cpu.maxCoreTemperature, kStepTemperature);
+    io(cpu.throttleRate, kStepRate);
+}
+
+template <typename Io, typename Info>
+static void VisitMemorySample(Io& io, Info& memory) {
+    io(memory.used, kStepGigabytes);
+    io(memory.total, kStepGigabytes);
+    io(memory.percent, kStepPercent);
+    io(memory.available, kStepGigabytes);
+    io(memory.pageInRate, kStepRate);
+    io(memory.pageOutRate, kStepRate);
+    io(memory.swapInRate, kStepRate);
+    io(memory.swapOutRate, kStepRate);
+    io(memory.majorFaultRate, kStepRate);
+    io(memory.dirty, kStepMegabytes);
+    io(memory.writeback, kStepMegabytes);
+}
+
+template <typename Io, typename Info>
+static void VisitBandwidthInventory(Io& io, Info& bandwidth) {
+    io(bandwidth.memoryType);
+    io(bandwidth.memorySpeed);
+}
+
+template <typename Io, typename Info>
+static void VisitBandwidthSample(Io& io, Info& bandwidth) {
+    io(bandwidth.totalSystemBandwidth, kStepBandwidth);
+    io(bandwidth.pcieMaxBandwidth, kStepBandwidth);
+    io(bandwidth.pcieRealTimeBandwidth, kStepBandwidth);
+    io(bandwidth.pcieUtilization, kStepPercent);
+    io(bandwidth.memoryMaxBandwidth, kStepBandwidth);
+    io(bandwidth.memoryRealTimeBandwidth, kStepBandwidth);
+    io(bandwidth.memoryUtilization, kStepPercent);
+    io(bandwidth.storageMaxBandwidth, kStepBandwidth);
+    io(bandwidth.storageRealTimeBandwidth, kStepBandwidth);
+    io(bandwidth.storageUtilization, kStepPercent);
+    io(bandwidth.vramMaxBandwidth, kStepBandwidth);
+    io(bandwidth.vramRealTimeBandwidth, kStepBandwidth);
+    io(bandwidth.vramUtilization, kStepPercent);
+    io(bandwidth.cpuBandwidth, kStepBandwidth);
+    io(bandwidth.memoryBandwidth, kStepBandwidth);
+    io(bandwidth.pcieTotalBandwidth, kStepBandwidth);
+}
+
+// 变长数组：编码时写出当前长度；解码 Inventory 时按长度重建，解码 Sample 时要求长度一致
+template <typename Io, typename Items, typename Fn>
+static bool VisitArray(Io& io, Items& items, bool resize, Fn&& visit) {
+    uint16_t count = static_cast<uint16_t>(items.size());
+    io.Count(count);
+    if (!io.Ok()) {
+        return false;
+    }
+    if (count != items.size()) {
+        if (!resize) {
+            return false;
+        }
+        Resize(items, count);
+    }
+    for (auto& item : items) {
+        visit(io, item);
+    }
+    return io.Ok();
+}
+
+// State 是 SessionState（解码）或 SessionView（编码）；resize 只在解码 Inventory 时为 true
+template <typename Io, typename State>
+static bool VisitRecord(Io& io, SessionRecordType type, const State& state, bool resize) {
+    if (type == SessionRecordType::Inventory) {
+        return VisitArray(io, *state.gpus, resize, [](Io& io, auto& gpu) { VisitGPUInventory(io, gpu); }) &&
+               VisitArray(io, state.memory->modules, resize,
+                          [](Io& io, auto& module) { VisitModuleInventory(io, module); }) &&
+               VisitArray(io, *state.disks, resize, [](Io& io, auto& disk) { VisitDiskInventory(io, disk); }) &&
+               (VisitBandwidthInventory(io, *state.bandwidth), io.Ok()) &&
+               VisitArray(io, state.cpu->logicalCpus, resize,
+                          [](Io& io, auto& logical) { VisitLogicalCpuInventory(io, logical); }) &&
+               (!resize || (Resize(state.cpu->coreUtilization, state.cpu->logicalCpus.size()),
+                            Resize(state.cpu->coreFrequency, state.cpu->logicalCpus.size()), true)) &&
+               VisitArray(io, *state.pressures, resize,
+                          [](Io& io, auto& pressure) { VisitPressureInventory(io, pressure); });
+    }
+
+    VisitCPUSample(io, *state.cpu);
+    VisitMemorySample(io, *state.memory);
+    VisitBandwidthSample(io, *state.bandwidth);
+    return VisitArray(io, state.cpu->coreUtilization, false, [](Io& io, auto& utilization) { io(utilization, kStepPercent); }) &&
+           VisitArray(io, state.cpu->coreFrequency, false, [](Io& io, auto& frequency) { io(frequency, kStepClock); }) &&
+           VisitArray(io, *state.gpus, false, [](Io& io, auto& gpu) { VisitGPUSample(io, gpu); }) &&
+           VisitArray(io, state.memory->modules, false,
+                      [](Io& io, auto& module) { VisitModuleSample(io, module); }) &&
+           VisitArray(io, *state.disks, false, [](Io& io, auto& disk) { VisitDiskSample(io, disk); }) &&
+           VisitArray(io, *state.pressures, false,
+                      [](Io& io, auto& pressure) { VisitPressureSample(io, pressure); });
+}
+
+size_t EncodeSessionRecord(SessionRecordType type, int64_t timestampMs,
+                           const SessionView& state, uint8_t* out, size_t capacity) {
+    if (capacity < sizeof(SessionRecordHeader)) {
+        return 0;
+    }
+    SessionEncoder encoder(out + sizeof(SessionRecordHeader), capacity - sizeof(SessionRecordHeader));
+    if (!VisitRecord(encoder, type, state, false)) {
+        return 0;
+    }
+
+    SessionRecordHeader header;
+    header.type = static_cast<uint32_t>(type);
+    header.size = static_cast<uint32_t>(sizeof(SessionRecordHeader) + encoder.Position());
+    header.timestampMs = timestampMs;
+    std::memcpy(out, &header, sizeof(header));
+    return header.size;
+}
+
+bool DecodeSessionRecord(const SessionRecordHeader& header, const uint8_t* payload,
+                         const SessionState& state) {
+    if (header.size < sizeof(SessionRecordHeader)) {
+        return false;
+    }
+    SessionDecoder decoder(payload, header.size - sizeof(SessionRecordHeader));
+    SessionRecordType type = static_cast<SessionRecordType>(header.type);
+    if (type != SessionRecordType::Inventory && type != SessionRecordType::Sample) {
+        return false;
+    }
+    return VisitRecord(decoder, type, state, type == SessionRecordType::Inventory);
+}
+
+size_t CountSampleValues(const SessionView& state) {
+    SampleValueIo counter(nullptr, nullptr);
+    VisitRecord(counter, SessionRecordType::Sample, state, false);
+    return counter.Position();
+}
+
+void ExtractSampleValues(const SessionView& state, int64_t* values) {
+    SampleValueIo extractor(nullptr, values);
+    VisitRecord(extractor, SessionRecordType::Sample, state, false);
+}
+
+void ApplySampleValues(const SessionState& state, const int64_t* values) {
+    SampleValueIo applier(values, nullptr);
+    VisitRecord(applier, SessionRecordType::Sample, state, false);
+}
+
+uint32_t SampleSchemaId() {
+    // 用只有一个设备的清单分别统计每类设备的字段数
+    std::vector<GPUInfo> gpus(1);
+    CPUInfo cpu;
+    MemoryInfo memory;
+    memory.modules.resize(1);
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks(1);
+    std::vector<PressureInfo> pressures(1);
+    cpu.coreUtilization.resize(1);
+    cpu.coreFrequency.resize(1);
+    SessionState state{&gpus, &cpu, &memory, &bandwidth, &disks, &pressures};
+    std::vector<double> steps;
+    SampleValueIo stepCollector(nullptr, nullptr, &steps);
+    VisitRecord(stepCollector, SessionRecordType::Sample, state, false);
+
+    uint32_t layout[8];
+    layout[0] = kSessionVersion;
+    layout[1] = SessionCrc32(steps.data(), steps.size() * sizeof(double));   // 每个字段的量化步长
+    layout[2] = static_cast<uint32_t>(CountSampleValues(state));
+    gpus.clear();
+    layout[3] = layout[2] - static_cast<uint32_t>(CountSampleValues(state));
+    memory.modules.clear();
+    layout[4] = layout[2] - layout[3] - static_cast<uint32_t>(CountSampleValues(state));
+    disks.clear();
+    layout[5] = layout[2] - layout[3] - layout[4] - static_cast<uint32_t>(CountSampleValues(state));
+    cpu.coreUtilization.clear();
+    cpu.coreFrequency.clear();
+    layout[6] = layout[2] - layout[3] - layout[4] - layout[5] - static_cast<uint32_t>(CountSampleValues(state));
+    pressures.clear();
+    layout[7] = layout[2] - layout[3] - layout[4] - layout[5] - layout[6] -
+                static_cast<uint32_t>(CountSampleValues(state));
+    return SessionCrc32(layout, sizeof(layout));
+}
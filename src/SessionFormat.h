@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "HardwareMonitor.h"
+
+// 会话录制文件格式（小端）
+//
+//   [文件头 kSessionHeaderSize 字节][块 0][块 1]...    每个块固定 kSessionBlockSize 字节
+//
+// 块 = SessionBlockHeader + 若干条完整的记录（记录不跨块）。
+// 块头中的 checksum 是 payload 前 payloadBytes 字节的 CRC32，每写入一条记录就更新一次，
+// 因此进程崩溃或被杀时最多丢失正在写入的那一条记录；掉电时最多丢失校验失败的那一个块。
+//
+// 记录 = SessionRecordHeader + 负载：
+//   - Inventory：GPU/内存条/磁盘的名称和静态规格、逻辑 CPU 拓扑、压力停顿的范围，设备列表变化时写入一次
+//   - Sample：一次快照中所有会变化的数值
+// 版本 2：增加逻辑 CPU 拓扑和每个逻辑 CPU 的利用率
+// 版本 3：增加逻辑 CPU 的最大频率和当前频率、核心温度、降频事件速率
+// 版本 4：增加换页/换入换出/主缺页速率和脏页、写回页
+// 版本 5：增加系统和 cgroup 的压力停顿（PSI）
+constexpr char kSessionMagic[8] = {'H', 'W', 'M', 'R', 'E', 'C', '0', '1'};
+constexpr uint32_t kSessionVersion = 5;
+constexpr uint32_t kSessionHeaderSize = 4096;
+constexpr uint32_t kSessionBlockSize = 64 * 1024;
+constexpr uint32_t kSessionBlockMagic = 0x4B4C4248;   // "HBLK"
+
+struct SessionFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t blockSize;
+    uint32_t checksum;          // 整个结构的 CRC32（计算时 checksum 字段为 0）
+    int64_t startUnixMs;        // 录制开始时间（墙上时间，毫秒）
+};
+
+struct SessionBlockHeader {
+    uint32_t magic;
+    uint32_t checksum;          // payload 前 payloadBytes 字节的 CRC32
+    uint64_t sequence;          // 块序号，从 0 开始
+    uint32_t payloadBytes;
+    uint32_t recordCount;
+    int64_t firstTimestampMs;
+    int64_t lastTimestampMs;
+};
+static_assert(sizeof(SessionBlockHeader) == 40, "SessionBlockHeader layout changed");
+
+constexpr uint32_t kSessionBlockPayload = kSessionBlockSize - sizeof(SessionBlockHeader);
+
+enum class SessionRecordType : uint32_t {
+    Inventory = 1,
+    Sample = 2,
+};
+
+struct SessionRecordHeader {
+    uint32_t type;              // SessionRecordType
+    uint32_t size;              // 含本记录头在内的总字节数
+    int64_t timestampMs;        // 墙上时间（毫秒）
+};
+static_assert(sizeof(SessionRecordHeader) == 16, "SessionRecordHeader layout changed");
+
+// CRC32（IEEE 802.3），crc 传入上一次的结果可以分段计算
+uint32_t SessionCrc32(const void* data, size_t size, uint32_t crc = 0);
+
+// 录制的设备清单和数值（与 HardwareMonitor 的工作状态对应）
+struct SessionState {
+    std::vector<GPUInfo>* gpus;
+    CPUInfo* cpu;
+    MemoryInfo* memory;
+    SystemBandwidthInfo* bandwidth;
+    std::vector<DiskInfo>* disks;
+    std::vector<PressureInfo>* pressures;
+};
+
+// 只读的设备清单和数值，编码时使用：可以直接指向已发布的快照，不必先复制成可写的 SessionState
+struct SessionView {
+    const std::vector<GPUInfo>* gpus;
+    const CPUInfo* cpu;
+    const MemoryInfo* memory;
+    const SystemBandwidthInfo* bandwidth;
+    const std::vector<DiskInfo>* disks;
+    const std::vector<PressureInfo>* pressures;
+
+    SessionView(const std::vector<GPUInfo>* gpus, const CPUInfo* cpu, const MemoryInfo* memory,
+                const SystemBandwidthInfo* bandwidth, const std::vector<DiskInfo>* disks,
+                const std::vector<PressureInfo>* pressures)
+        : gpus(gpus), cpu(cpu), memory(memory), bandwidth(bandwidth), disks(disks), pressures(pressures) {}
+    SessionView(const SessionState& state)
+        : SessionView(state.gpus, state.cpu, state.memory, state.bandwidth, state.disks, state.pressures) {}
+    explicit SessionView(const HardwareSnapshot& snapshot)
+        : SessionView(&snapshot.gpus, &snapshot.cpu, &snapshot.memory, &snapshot.bandwidth, &snapshot.disks,
+                      &snapshot.pressures) {}
+};
+
+// 编码一条完整记录（含记录头）到 out，空间不足时返回 0。不分配内存
+size_t EncodeSessionRecord(SessionRecordType type, int64_t timestampMs,
+                           const SessionView& state, uint8_t* out, size_t capacity);
+
+// 解码一条记录的负载。Inventory 会重建设备列表；Sample 要求设备数量与当前清单一致
+bool DecodeSessionRecord(const SessionRecordHeader& header, const uint8_t* payload,
+                         const SessionState& state);
+
+// ===== 样本数值的整数形式（供差分编码使用） =====
+// 按 Sample 记录的字段顺序把所有数值展开为整数：浮点数按字段的显示精度量化（如利用率 1%、功耗 0.1W、
+// 频率 1MHz、吞吐量 0.1MB/s，见 SessionFormat.cpp 中的 kStep*），整数原样保留；非有限值记为 0 或截断。
+// 数值个数只由清单（设备数量）决定，同一清单下第 i 个数值始终对应同一个字段。
+
+size_t CountSampleValues(const SessionView& state);
+// values 需要有 CountSampleValues 个元素
+void ExtractSampleValues(const SessionView& state, int64_t* values);
+void ApplySampleValues(const SessionState& state, const int64_t* values);
+// 样本字段布局的标识（记录版本、量化步长和每类设备字段数的校验值），两端一致才能使用差分编码
+uint32_t SampleSchemaId();
@@ -0,0 +1,298 @@
+#include "SessionRecorder.h"
+#include "SessionFormat.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+SessionRecorder::~SessionRecorder() {
+    Close();
+}
+
+bool SessionRecorder::Open(const std::string& path) {
+    if (IsOpen()) {
+        return false;
+    }
+
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        std::cerr << "警告: 无法创建录制文件 " << path << std::endl;
+        return false;
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "警告: 无法创建录制文件 " << path << std::endl;
+        return false;
+    }
+#endif
+
+    if (!MapFile(kSessionHeaderSize + kGrowBytes)) {
+        std::cerr << "警告: 录制文件映射失败 " << path << std::endl;
+        UnmapFile();
+#ifdef _WIN32
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        ::close(fd_);
+        fd_ = -1;
+#endif
+        return false;
+    }
+
+    // 文件头（校验和按 checksum 字段为 0 时计算）
+    SessionFileHeader header{};
+    std::memcpy(header.magic, kSessionMagic, sizeof(header.magic));
+    header.version = kSessionVersion;
+    header.headerSize = kSessionHeaderSize;
+    header.blockSize = kSessionBlockSize;
+    header.startUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.checksum = 0;
+    header.checksum = SessionCrc32(&header, sizeof(header));
+    std::memcpy(mapped_, &header, sizeof(header));
+
+    blockOffset_ = kSessionHeaderSize;
+    flushedOffset_ = 0;
+    blockStarted_ = false;
+    blockSequence_.store(0, std::memory_order_relaxed);
+    Flush(true);
+
+    // 队列在这里一次性分配，之后采样线程不再分配内存
+    slots_.reset(new Slot[kQueueSlots]);
+    writeIndex_.store(0, std::memory_order_relaxed);
+    readIndex_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+
+    stopping_.store(false, std::memory_order_release);
+    open_.store(true, std::memory_order_release);
+    writer_ = std::thread(&SessionRecorder::WriterLoop, this);
+    return true;
+}
+
+void SessionRecorder::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+    open_.store(false, std::memory_order_release);
+    stopping_.store(true, std::memory_order_release);
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    // 截掉预留但未使用的空间：保留到当前块末尾
+    uint64_t used = blockStarted_ ? blockOffset_ + kSessionBlockSize : kSessionHeaderSize;
+    UnmapFile();
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(used);
+    if (SetFilePointerEx(file_, size, nullptr, FILE_BEGIN)) {
+        SetEndOfFile(file_);
+    }
+    CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+#else
+    if (ftruncate(fd_, static_cast<off_t>(used)) != 0) {
+        std::cerr << "警告: 录制文件截断失败" << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+#endif
+
+    if (dropped_.load(std::memory_order_relaxed) > 0) {
+        std::cerr << "警告: 录制期间有 " << dropped_.load(std::memory_order_relaxed)
+                  << " 条记录因写入队列已满被丢弃" << std::endl;
+    }
+}
+
+uint8_t* SessionRecorder::BeginRecord() {
+    size_t write = writeIndex_.load(std::memory_order_relaxed);
+    size_t read = readIndex_.load(std::memory_order_acquire);
+    if (write - read >= kQueueSlots) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return slots_[write % kQueueSlots].data;
+}
+
+void SessionRecorder::CommitRecord(size_t bytes) {
+    size_t write = writeIndex_.load(std::memory_order_relaxed);
+    slots_[write % kQueueSlots].size = static_cast<uint32_t>(bytes);
+    writeIndex_.store(write + 1, std::memory_order_release);
+}
+
+void SessionRecorder::WriterLoop() {
+    auto lastFlush = std::chrono::steady_clock::now();
+    while (!stopping_.load(std::memory_order_acquire)) {
+        bool wrote = DrainQueue();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastFlush >= std::chrono::milliseconds(kFlushIntervalMs)) {
+            Flush(false);
+            lastFlush = now;
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    // 采样线程可能仍在提交最后几条记录，关闭前再写一次
+    DrainQueue();
+    Flush(true);
+}
+
+bool SessionRecorder::DrainQueue() {
+    bool wrote = false;
+    size_t read = readIndex_.load(std::memory_order_relaxed);
+    while (read != writeIndex_.load(std::memory_order_acquire)) {
+        const Slot& slot = slots_[read % kQueueSlots];
+        if (slot.size > 0) {
+            WriteRecord(slot.data, slot.size);
+            wrote = true;
+        }
+        read++;
+        readIndex_.store(read, std::memory_order_release);
+    }
+    return wrote;
+}
+
+void SessionRecorder::WriteRecord(const uint8_t* record, size_t size) {
+    if (size < sizeof(SessionRecordHeader) || size > kSessionBlockPayload || mapped_ == nullptr) {
+        return;
+    }
+    if (!blockStarted_) {
+        StartBlock();
+    }
+
+    SessionBlockHeader* block = reinterpret_cast<SessionBlockHeader*>(mapped_ + blockOffset_);
+    if (block->payloadBytes + size > kSessionBlockPayload) {
+        // 当前块已满：块头已经是完整的，异步刷盘后开始下一个块
+        Flush(false);
+        blockOffset_ += kSessionBlockSize;
+        StartBlock();
+        if (mapped_ == nullptr) {
+            return;
+        }
+        block = reinterpret_cast<SessionBlockHeader*>(mapped_ + blockOffset_);
+    }
+
+    SessionRecordHeader recordHeader;
+    std::memcpy(&recordHeader, record, sizeof(recordHeader));
+
+    uint8_t* payload = mapped_ + blockOffset_ + sizeof(SessionBlockHeader);
+    std::memcpy(payload + block->payloadBytes, record, size);
+
+    // 先写数据再更新块头；块头中的校验和覆盖到最后一条完整记录
+    if (block->recordCount == 0) {
+        block->firstTimestampMs = recordHeader.timestampMs;
+    }
+    block->lastTimestampMs = recordHeader.timestampMs;
+    block->recordCount++;
+    block->checksum = SessionCrc32(payload + block->payloadBytes, size, block->checksum);
+    block->payloadBytes += static_cast<uint32_t>(size);
+}
+
+void SessionRecorder::StartBlock() {
+    if (!Reserve(blockOffset_ + kSessionBlockSize)) {
+        std::cerr << "警告: 录制文件扩展失败，停止录制" << std::endl;
+        UnmapFile();
+        return;
+    }
+    SessionBlockHeader header{};
+    header.magic = kSessionBlockMagic;
+    header.sequence = blockSequence_.load(std::memory_order_relaxed);
+    std::memcpy(mapped_ + blockOffset_, &header, sizeof(header));
+    blockSequence_.fetch_add(1, std::memory_order_relaxed);
+    blockStarted_ = true;
+}
+
+bool SessionRecorder::Reserve(uint64_t end) {
+    if (end <= mappedSize_) {
+        return true;
+    }
+    uint64_t newSize = mappedSize_ + kGrowBytes;
+    while (newSize < end) {
+        newSize += kGrowBytes;
+    }
+    Flush(false);
+    UnmapFile();
+    return MapFile(newSize);
+}
+
+void SessionRecorder::Flush(bool wait) {
+    if (mapped_ == nullptr) {
+        return;
+    }
+    // 从上次刷盘的块开始，到当前块末尾（当前块还会继续写入，下次会再刷一次）
+    uint64_t begin = flushedOffset_ - flushedOffset_ % kSessionBlockSize;
+    uint64_t end = blockOffset_ + (blockStarted_ ? kSessionBlockSize : 0);
+    if (end > mappedSize_) {
+        end = mappedSize_;
+    }
+    if (end <= begin) {
+        end = begin + kSessionHeaderSize;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(mapped_ + begin, static_cast<SIZE_T>(end - begin));
+    if (wait) {
+        FlushFileBuffers(file_);
+    }
+#else
+    uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    begin -= begin % page;
+    msync(mapped_ + begin, static_cast<size_t>(end - begin), wait ? MS_SYNC : MS_ASYNC);
+#endif
+    flushedOffset_ = blockOffset_;
+}
+
+bool SessionRecorder::MapFile(uint64_t size) {
+#ifdef _WIN32
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    if (mapping_ == nullptr) {
+        return false;
+    }
+    mapped_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(size)));
+    if (mapped_ == nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+        return false;
+    }
+#else
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapped_ = static_cast<uint8_t*>(address);
+#endif
+    mappedSize_ = size;
+    return true;
+}
+
+void SessionRecorder::UnmapFile() {
+    if (mapped_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapped_);
+#else
+        munmap(mapped_, static_cast<size_t>(mappedSize_));
+#endif
+        mapped_ = nullptr;
+    }
+#ifdef _WIN32
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+#endif
+    mappedSize_ = 0;
+}
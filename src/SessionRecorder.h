@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 会话录制（内存映射、只追加的二进制文件，格式见 SessionFormat.h）
+//
+// 采样线程只把编码好的记录放进预分配的单写单读队列（BeginRecord/CommitRecord），
+// 不分配内存、不加锁、不做系统调用；队列满时丢弃该记录并计数。
+// 独立的写入线程把记录追加到映射区中的当前块，每条记录后更新块头校验和，
+// 定期（以及每个块写满时）异步刷盘；文件空间不足时按 kGrowBytes 扩展并重新映射。
+class SessionRecorder {
+public:
+    static constexpr size_t kMaxRecordBytes = 32 * 1024;
+    static constexpr size_t kQueueSlots = 64;
+    static constexpr uint64_t kGrowBytes = 64ull * 1024 * 1024;
+    static constexpr int kFlushIntervalMs = 1000;
+
+    SessionRecorder() = default;
+    ~SessionRecorder();
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // 创建录制文件并启动写入线程（已存在的文件会被覆盖）
+    bool Open(const std::string& path);
+    // 写完队列中剩余的记录，刷盘并关闭文件
+    void Close();
+    bool IsOpen() const { return open_.load(std::memory_order_acquire); }
+
+    // ===== 采样线程 =====
+    // 获取一个空闲记录缓冲区（kMaxRecordBytes 字节），队列已满时返回 nullptr
+    uint8_t* BeginRecord();
+    // 提交 BeginRecord 返回的缓冲区，bytes 为 0 表示放弃
+    void CommitRecord(size_t bytes);
+
+    uint64_t GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    // 队列中等待写入线程处理的记录数
+    size_t GetQueuedCount() const {
+        return writeIndex_.load(std::memory_order_relaxed) - readIndex_.load(std::memory_order_acquire);
+    }
+    uint64_t GetBlockCount() const { return blockSequence_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        uint32_t size = 0;
+        uint8_t data[kMaxRecordBytes];
+    };
+
+    void WriterLoop();
+    bool DrainQueue();
+    void WriteRecord(const uint8_t* record, size_t size);
+    void StartBlock();
+    bool Reserve(uint64_t end);     // 保证文件映射覆盖 [0, end)
+    void Flush(bool wait);
+    bool MapFile(uint64_t size);
+    void UnmapFile();
+
+    // 单写单读队列
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> writeIndex_{0};   // 采样线程推进
+    alignas(64) std::atomic<size_t> readIndex_{0};    // 写入线程推进
+    std::atomic<uint64_t> dropped_{0};
+
+    std::thread writer_;
+    std::atomic<bool> open_{false};
+    std::atomic<bool> stopping_{false};
+
+    // 以下只由写入线程访问（Open/Close 在线程启动前/结束后访问）
+    uint8_t* mapped_ = nullptr;
+    uint64_t mappedSize_ = 0;
+    uint64_t blockOffset_ = 0;        // 当前块在文件中的偏移
+    uint64_t flushedOffset_ = 0;      // 已经请求刷盘的位置
+    std::atomic<uint64_t> blockSequence_{0};
+    bool blockStarted_ = false;
+
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
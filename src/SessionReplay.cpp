@@ -0,0 +1,161 @@
+#include "SessionReplay.h"
+#include <cstring>
+#include <iostream>
+
+bool SessionReplay::Open(const std::string& path, double speed) {
+    Close();
+
+    file_.open(path, std::ios::binary);
+    if (!file_.is_open()) {
+        std::cerr << "警告: 无法打开录制文件 " << path << std::endl;
+        return false;
+    }
+
+    SessionFileHeader header{};
+    file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    uint32_t checksum = header.checksum;
+    header.checksum = 0;
+    if (!file_ || std::memcmp(header.magic, kSessionMagic, sizeof(header.magic)) != 0 ||
+        SessionCrc32(&header, sizeof(header)) != checksum) {
+        std::cerr << "警告: " << path << " 不是有效的录制文件" << std::endl;
+        Close();
+        return false;
+    }
+    if (header.version != kSessionVersion || header.blockSize != kSessionBlockSize ||
+        header.headerSize < sizeof(SessionFileHeader)) {
+        std::cerr << "警告: 不支持的录制文件版本 " << header.version << std::endl;
+        Close();
+        return false;
+    }
+
+    file_.seekg(header.headerSize, std::ios::beg);
+    block_.assign(kSessionBlockSize, 0);
+    blockHeader_ = SessionBlockHeader{};
+    recordOffset_ = 0;
+    pending_ = false;
+    finished_ = false;
+
+    speed_ = speed > 0.0 ? speed : 0.0;
+    startUnixMs_ = header.startUnixMs;
+    hasFirst_ = false;
+    playStart_ = Clock::now();
+    lastRecordTime_ = playStart_;
+    recordCount_ = 0;
+    corruptBlocks_ = 0;
+    return true;
+}
+
+void SessionReplay::Close() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    file_.clear();
+    pending_ = false;
+    finished_ = true;
+}
+
+bool SessionReplay::Next(Clock::time_point now, SessionRecordHeader& header, const uint8_t*& payload) {
+    if (!Peek()) {
+        return false;
+    }
+    if (speed_ > 0.0 && now < NextDeadline()) {
+        return false;
+    }
+
+    header = pendingHeader_;
+    payload = block_.data() + sizeof(SessionBlockHeader) + recordOffset_ + sizeof(SessionRecordHeader);
+    recordOffset_ += header.size;
+    pending_ = false;
+    recordCount_++;
+    return true;
+}
+
+SessionReplay::Clock::time_point SessionReplay::NextDeadline() {
+    if (!Peek()) {
+        return Clock::time_point::max();
+    }
+    if (speed_ <= 0.0) {
+        return playStart_;
+    }
+    // 录制时系统时间被往回调时，记录间隔可能为负，此时立即播放
+    double elapsedMs = static_cast<double>(pendingHeader_.timestampMs - firstTimestampMs_) / speed_;
+    if (elapsedMs <= 0.0) {
+        return playStart_;
+    }
+    return playStart_ + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(elapsedMs));
+}
+
+SessionReplay::Clock::time_point SessionReplay::RecordTime(int64_t timestampMs) {
+    Clock::time_point time = playStart_ + std::chrono::milliseconds(timestampMs - firstTimestampMs_);
+    if (time < lastRecordTime_) {
+        time = lastRecordTime_;
+    }
+    lastRecordTime_ = time;
+    return time;
+}
+
+bool SessionReplay::Peek() {
+    if (pending_) {
+        return true;
+    }
+    if (finished_) {
+        return false;
+    }
+
+    while (true) {
+        if (recordOffset_ + sizeof(SessionRecordHeader) <= blockHeader_.payloadBytes) {
+            const uint8_t* record = block_.data() + sizeof(SessionBlockHeader) + recordOffset_;
+            std::memcpy(&pendingHeader_, record, sizeof(pendingHeader_));
+            if (pendingHeader_.size >= sizeof(SessionRecordHeader) &&
+                recordOffset_ + pendingHeader_.size <= blockHeader_.payloadBytes) {
+                break;
+            }
+            // 记录长度异常：块校验已通过，说明是不兼容的写入方，跳过本块剩余部分
+            recordOffset_ = blockHeader_.payloadBytes;
+            continue;
+        }
+        if (!LoadBlock()) {
+            finished_ = true;
+            return false;
+        }
+    }
+
+    if (!hasFirst_) {
+        // 以第一条记录为回放起点，打开文件到开始播放之间的耗时不计入
+        firstTimestampMs_ = pendingHeader_.timestampMs;
+        playStart_ = Clock::now();
+        lastRecordTime_ = playStart_;
+        hasFirst_ = true;
+    }
+    pending_ = true;
+    return true;
+}
+
+bool SessionReplay::LoadBlock() {
+    while (true) {
+        file_.read(reinterpret_cast<char*>(block_.data()), kSessionBlockSize);
+        size_t bytes = static_cast<size_t>(file_.gcount());
+        if (bytes < sizeof(SessionBlockHeader)) {
+            return false;
+        }
+
+        std::memcpy(&blockHeader_, block_.data(), sizeof(blockHeader_));
+        recordOffset_ = 0;
+        if (blockHeader_.magic != kSessionBlockMagic) {
+            // 预留但从未写入的区域，录制到此为止
+            blockHeader_.payloadBytes = 0;
+            return false;
+        }
+        if (blockHeader_.payloadBytes > kSessionBlockPayload ||
+            sizeof(SessionBlockHeader) + blockHeader_.payloadBytes > bytes ||
+            SessionCrc32(block_.data() + sizeof(SessionBlockHeader), blockHeader_.payloadBytes) !=
+                blockHeader_.checksum) {
+            std::cerr << "警告: 录制文件第 " << blockHeader_.sequence << " 块校验失败，已跳过" << std::endl;
+            corruptBlocks_++;
+            blockHeader_.payloadBytes = 0;
+            continue;
+        }
+        return true;
+    }
+}
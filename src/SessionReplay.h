@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SessionFormat.h"
+
+// 会话回放：按录制时的时间间隔依次读出 SessionRecorder 写入的记录
+//
+// 文件按块顺序读取，每次只在内存中保留一个块（kSessionBlockSize 字节），录制文件再大也不会整个载入。
+// 块头校验和不匹配的块整块跳过（崩溃/掉电时最后一个块可能不完整），遇到未写入的区域（块头魔数不对）即结束。
+//
+// 播放速度：
+//   - 1      实时，记录间隔与录制时相同
+//   - N > 1  加速，例如 100 表示录制 100 秒的数据 1 秒播完
+//   - 0      不等待，尽快读出所有记录（用于基准测试）
+class SessionReplay {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    bool Open(const std::string& path, double speed);
+    void Close();
+    bool IsOpen() const { return file_.is_open(); }
+    bool Finished() const { return finished_; }
+
+    // 取下一条播放时间已到的记录，payload 在下一次调用 Next 之前有效。没有到期记录时返回 false
+    bool Next(Clock::time_point now, SessionRecordHeader& header, const uint8_t*& payload);
+    // 下一条记录的播放时间；已播放完时返回 Clock::time_point::max()
+    Clock::time_point NextDeadline();
+
+    // 记录在回放时间线上的时间：按录制时的真实间隔排列，与播放速度无关，保证单调递增
+    Clock::time_point RecordTime(int64_t timestampMs);
+
+    double GetSpeed() const { return speed_; }
+    int64_t GetStartUnixMs() const { return startUnixMs_; }
+    uint64_t GetRecordCount() const { return recordCount_; }
+    uint64_t GetCorruptBlockCount() const { return corruptBlocks_; }
+
+private:
+    bool Peek();            // 保证 pending_ 指向下一条完整记录，没有更多记录时返回 false
+    bool LoadBlock();       // 读入下一个校验通过的块
+
+    std::ifstream file_;
+    std::vector<uint8_t> block_;
+    SessionBlockHeader blockHeader_{};
+    size_t recordOffset_ = 0;        // 下一条记录在块负载中的偏移
+    SessionRecordHeader pendingHeader_{};
+    bool pending_ = false;
+    bool finished_ = true;
+
+    double speed_ = 1.0;
+    int64_t startUnixMs_ = 0;
+    int64_t firstTimestampMs_ = 0;   // 第一条记录的录制时间，回放时间的起点
+    bool hasFirst_ = false;
+    Clock::time_point playStart_;    // 开始播放时的本地时间
+    Clock::time_point lastRecordTime_;
+
+    uint64_t recordCount_ = 0;
+    uint64_t corruptBlocks_ = 0;
+};
@@ -0,0 +1,80 @@
+#include "SlidingWindow.h"
+#include <algorithm>
+
+void SlidingWindow::Reset(Clock::duration window) {
+    int64_t windowMs = std::chrono::duration_cast<std::chrono::milliseconds>(window).count();
+    resolutionMs_ = std::max<int64_t>(1, windowMs / static_cast<int64_t>(kSlots));
+    pending_ = Accumulator{};
+    minimums_.Clear();
+    maximums_.Clear();
+    totals_.Clear();
+    sum_ = 0.0;
+    count_ = 0;
+}
+
+void SlidingWindow::Add(Clock::time_point timestamp, float value) {
+    int64_t bucket = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count() /
+                     resolutionMs_;
+    if (bucket != pending_.bucket) {
+        if (pending_.count > 0) {
+            Close();
+        }
+        pending_ = Accumulator{};
+        pending_.bucket = bucket;
+        pending_.minValue = value;
+        pending_.maxValue = value;
+
+        // 移出不在 [bucket - kSlots + 1, bucket] 内的桶
+        int64_t oldest = bucket - static_cast<int64_t>(kSlots) + 1;
+        while (!minimums_.Empty() && minimums_.Front().bucket < oldest) {
+            minimums_.PopFront();
+        }
+        while (!maximums_.Empty() && maximums_.Front().bucket < oldest) {
+            maximums_.PopFront();
+        }
+        while (!totals_.Empty() && totals_.Front().bucket < oldest) {
+            sum_ -= totals_.Front().sum;
+            count_ -= totals_.Front().count;
+            totals_.PopFront();
+        }
+        if (totals_.Empty()) {
+            sum_ = 0.0;   // 清掉反复加减累积的舍入误差
+        }
+    }
+    pending_.minValue = std::min(pending_.minValue, value);
+    pending_.maxValue = std::max(pending_.maxValue, value);
+    pending_.sum += value;
+    pending_.count++;
+}
+
+void SlidingWindow::Close() {
+    // 新桶入队前，队尾不可能再成为最值的桶先出队
+    while (!minimums_.Empty() && minimums_.Back().value >= pending_.minValue) {
+        minimums_.PopBack();
+    }
+    minimums_.PushBack(Extreme{pending_.bucket, pending_.minValue});
+    while (!maximums_.Empty() && maximums_.Back().value <= pending_.maxValue) {
+        maximums_.PopBack();
+    }
+    maximums_.PushBack(Extreme{pending_.bucket, pending_.maxValue});
+
+    totals_.PushBack(Total{pending_.bucket, pending_.sum, pending_.count});
+    sum_ += pending_.sum;
+    count_ += pending_.count;
+}
+
+HistoryBucket SlidingWindow::Summary() const {
+    HistoryBucket result;
+    bool hasPending = pending_.count > 0;
+    if (!minimums_.Empty()) {
+        result.minValue = hasPending ? std::min(minimums_.Front().value, pending_.minValue) : minimums_.Front().value;
+        result.maxValue = hasPending ? std::max(maximums_.Front().value, pending_.maxValue) : maximums_.Front().value;
+    } else {
+        result.minValue = pending_.minValue;
+        result.maxValue = pending_.maxValue;
+    }
+    uint64_t count = count_ + pending_.count;
+    result.mean = count > 0 ? static_cast<float>((sum_ + pending_.sum) / static_cast<double>(count)) : 0.0f;
+    result.count = static_cast<uint32_t>(count);
+    return result;
+}
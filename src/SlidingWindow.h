@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "SeriesRollup.h"
+
+// 单个时间窗口的滑动统计（最小值/最大值/均值），供图表直接读取而不必每帧扫描历史
+// 窗口分成 kSlots 个等长的桶：样本先累加到当前桶，桶结束时进入单调队列（最小值、最大值）
+// 和总和队列，超出窗口的桶从队首移出。每个样本均摊 O(1)，查询 O(1)，内存固定。
+// 统计覆盖最近 kSlots 个桶（含尚未结束的当前桶），窗口起点的误差不超过一个桶（窗口的 1/kSlots）。
+class SlidingWindow {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kSlots = 60;
+
+    // 设置窗口长度并清空
+    void Reset(Clock::duration window);
+    // 累加一个样本（时间戳需单调不减）
+    void Add(Clock::time_point timestamp, float value);
+
+    bool Empty() const { return count_ == 0 && pending_.count == 0; }
+    // 窗口内的最小值/最大值/均值（需要非空）
+    HistoryBucket Summary() const;
+
+private:
+    struct Extreme {
+        int64_t bucket;
+        float value;
+    };
+    struct Total {
+        int64_t bucket;
+        double sum;
+        uint32_t count;
+    };
+    struct Accumulator {
+        int64_t bucket = -1;
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        double sum = 0.0;
+        uint32_t count = 0;
+    };
+
+    // 定长双端队列（单调队列只在两端操作）
+    template <typename T>
+    class Deque {
+    public:
+        static constexpr size_t kCapacity = kSlots + 1;
+
+        bool Empty() const { return size_ == 0; }
+        void Clear() { head_ = 0; size_ = 0; }
+        const T& Front() const { return data_[head_]; }
+        const T& Back() const { return data_[(head_ + size_ - 1) % kCapacity]; }
+        void PushBack(const T& value) { data_[(head_ + size_) % kCapacity] = value; size_++; }
+        void PopBack() { size_--; }
+        void PopFront() { head_ = (head_ + 1) % kCapacity; size_--; }
+
+    private:
+        std::array<T, kCapacity> data_{};
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+    void Close();
+
+    int64_t resolutionMs_ = 1000;
+    Accumulator pending_;
+    Deque<Extreme> minimums_;    // 桶序号递增、最小值递增
+    Deque<Extreme> maximums_;    // 桶序号递增、最大值递减
+    Deque<Total> totals_;        // 窗口内已结束的桶
+    double sum_ = 0.0;           // totals_ 的合计
+    uint64_t count_ = 0;
+};
@@ -0,0 +1,264 @@
+#include "SnapshotBus.h"
+#include "SessionFormat.h"
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// 跨进程共享的原子变量必须是无锁的，且布局不能随编译器变化
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "SnapshotBus requires lock-free 64-bit atomics");
+static_assert(sizeof(SnapshotBus::Header) <= kSnapshotBusHeaderSize, "SnapshotBus header too large");
+static_assert(sizeof(SnapshotBus::Slot) % 64 == 0, "SnapshotBus slot must be cache-line aligned");
+
+static size_t BusSize() {
+    return kSnapshotBusHeaderSize + SnapshotBus::kInventoryBytes +
+           sizeof(SnapshotBus::Slot) * SnapshotBus::kSlotCount;
+}
+
+SnapshotBus::~SnapshotBus() {
+    Close();
+}
+
+bool SnapshotBus::Create(const std::string& name) {
+    Close();
+    if (!Map(name, true)) {
+        std::cerr << "警告: 无法创建共享内存快照总线 " << name << std::endl;
+        Close();
+        return false;
+    }
+    writer_ = true;
+
+    std::memset(mapped_, 0, mappedSize_);
+    header_ = new (mapped_) Header();
+    std::memcpy(header_->magic, kSnapshotBusMagic, sizeof(header_->magic));
+    header_->version = kSnapshotBusVersion;
+    header_->recordVersion = kSessionVersion;
+    header_->headerSize = kSnapshotBusHeaderSize;
+    header_->slotCount = kSlotCount;
+    header_->slotBytes = kSlotBytes;
+    header_->inventoryBytes = kInventoryBytes;
+    for (uint32_t i = 0; i < kSlotCount; i++) {
+        new (SlotAt(i)) Slot();
+    }
+    return true;
+}
+
+bool SnapshotBus::Attach(const std::string& name) {
+    Close();
+    if (!Map(name, false)) {
+        std::cerr << "警告: 无法挂载共享内存快照总线 " << name << "（采样进程是否已启动？）" << std::endl;
+        Close();
+        return false;
+    }
+
+    header_ = reinterpret_cast<Header*>(mapped_);
+    if (std::memcmp(header_->magic, kSnapshotBusMagic, sizeof(header_->magic)) != 0 ||
+        header_->version != kSnapshotBusVersion || header_->recordVersion != kSessionVersion ||
+        header_->headerSize != kSnapshotBusHeaderSize || header_->slotCount != kSlotCount ||
+        header_->slotBytes != kSlotBytes || header_->inventoryBytes != kInventoryBytes) {
+        std::cerr << "警告: 共享内存快照总线 " << name << " 的版本或布局不兼容" << std::endl;
+        Close();
+        return false;
+    }
+    lastRead_ = 0;
+    inventoryGeneration_ = 0;
+    return true;
+}
+
+void SnapshotBus::Close() {
+    if (header_ != nullptr && writer_) {
+        header_->closed.store(1, std::memory_order_release);
+    }
+    header_ = nullptr;
+
+    if (mapped_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapped_);
+#else
+        munmap(mapped_, mappedSize_);
+#endif
+        mapped_ = nullptr;
+        mappedSize_ = 0;
+    }
+#ifdef _WIN32
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+#else
+    // 写端关闭时删除名称；已挂载的读端映射仍然有效，直到它们各自关闭
+    if (writer_ && !shmName_.empty()) {
+        shm_unlink(shmName_.c_str());
+    }
+#endif
+    writer_ = false;
+    shmName_.clear();
+}
+
+bool SnapshotBus::Map(const std::string& name, bool create) {
+    size_t size = BusSize();
+#ifdef _WIN32
+    shmName_ = "Local\\" + name;
+    if (create) {
+        mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      0, static_cast<DWORD>(size), shmName_.c_str());
+    } else {
+        mapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, shmName_.c_str());
+    }
+    if (mapping_ == nullptr) {
+        return false;
+    }
+    mapped_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+    if (mapped_ == nullptr) {
+        return false;
+    }
+#else
+    shmName_ = "/" + name;
+    int fd = create ? shm_open(shmName_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)
+                    : shm_open(shmName_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        shmName_.clear();
+        return false;
+    }
+    if (create && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        if (!create) {
+            shmName_.clear();
+        }
+        return false;
+    }
+    mapped_ = static_cast<uint8_t*>(address);
+    if (!create) {
+        // 读端不持有名称，关闭时不能删除
+        shmName_.clear();
+    }
+#endif
+    mappedSize_ = size;
+    return true;
+}
+
+SnapshotBus::Slot* SnapshotBus::SlotAt(uint64_t index) const {
+    uint8_t* slots = mapped_ + kSnapshotBusHeaderSize + kInventoryBytes;
+    return reinterpret_cast<Slot*>(slots + sizeof(Slot) * (index % kSlotCount));
+}
+
+uint8_t* SnapshotBus::InventoryData() const {
+    return mapped_ + kSnapshotBusHeaderSize;
+}
+
+bool SnapshotBus::PublishInventory(const SessionView& state, int64_t timestampMs) {
+    if (!writer_) {
+        return false;
+    }
+    uint64_t sequence = header_->inventorySequence.load(std::memory_order_relaxed);
+    header_->inventorySequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t bytes = EncodeSessionRecord(SessionRecordType::Inventory, timestampMs, state,
+                                       InventoryData(), kInventoryBytes);
+    header_->inventorySize = static_cast<uint32_t>(bytes);
+    header_->inventorySequence.store(sequence + 2, std::memory_order_release);
+    return bytes > 0;
+}
+
+bool SnapshotBus::PublishSample(const SessionView& state, int64_t timestampMs) {
+    if (!writer_) {
+        return false;
+    }
+    uint64_t index = header_->published.load(std::memory_order_relaxed);
+    Slot* slot = SlotAt(index);
+    slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t bytes = EncodeSessionRecord(SessionRecordType::Sample, timestampMs, state, slot->data, kSlotBytes);
+    slot->size = static_cast<uint32_t>(bytes);
+    slot->inventoryGeneration = header_->inventorySequence.load(std::memory_order_relaxed) / 2;
+    slot->sequence.store(2 * index + 2, std::memory_order_release);
+    header_->published.store(index + 1, std::memory_order_release);
+    return bytes > 0;
+}
+
+bool SnapshotBus::ReadLatest(const SessionState& state, bool& inventoryChanged) {
+    inventoryChanged = false;
+    if (header_ == nullptr || writer_) {
+        return false;
+    }
+
+    // 写端正好在改写同一个槽时重试；槽数足够多，连续失败说明读端被长时间挂起，下次再读
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint64_t published = header_->published.load(std::memory_order_acquire);
+        if (published == 0 || published == lastRead_) {
+            return false;
+        }
+        uint64_t index = published - 1;
+        const Slot* slot = SlotAt(index);
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2) {
+            continue;
+        }
+
+        if (slot->inventoryGeneration != inventoryGeneration_) {
+            if (!ReadInventory(state)) {
+                continue;
+            }
+            inventoryChanged = true;
+        }
+
+        SessionRecordHeader record;
+        std::memcpy(&record, slot->data, sizeof(record));
+        bool decoded = slot->size >= sizeof(record) && record.size == slot->size && record.size <= kSlotBytes &&
+                       DecodeSessionRecord(record, slot->data + sizeof(record), state);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        if (!decoded) {
+            // 完整但无法解码（清单与样本不一致），下次重新读取清单
+            inventoryGeneration_ = 0;
+            return false;
+        }
+        lastRead_ = published;
+        return true;
+    }
+    return false;
+}
+
+bool SnapshotBus::ReadInventory(const SessionState& state) {
+    uint64_t sequence = header_->inventorySequence.load(std::memory_order_acquire);
+    if (sequence == 0 || (sequence & 1) != 0) {
+        return false;
+    }
+
+    const uint8_t* data = InventoryData();
+    SessionRecordHeader record;
+    std::memcpy(&record, data, sizeof(record));
+    bool decoded = header_->inventorySize >= sizeof(record) && record.size == header_->inventorySize &&
+                   record.size <= kInventoryBytes &&
+                   DecodeSessionRecord(record, data + sizeof(record), state);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header_->inventorySequence.load(std::memory_order_relaxed) != sequence || !decoded) {
+        return false;
+    }
+    inventoryGeneration_ = sequence / 2;
+    return true;
+}
+
+bool SnapshotBus::IsWriterClosed() const {
+    return header_ != nullptr && header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t SnapshotBus::GetPublishedCount() const {
+    return header_ != nullptr ? header_->published.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct SessionState;
+struct SessionView;
+
+constexpr char kSnapshotBusMagic[8] = {'H', 'W', 'M', 'B', 'U', 'S', '0', '1'};
+constexpr uint32_t kSnapshotBusVersion = 1;
+constexpr uint32_t kSnapshotBusHeaderSize = 4096;
+
+// 共享内存快照总线：一个采样进程写，任意多个进程只读挂载
+//
+// 共享内存布局（固定，按 kSnapshotBusVersion 区分版本）：
+//   [Header kSnapshotBusHeaderSize][清单区 kInventoryBytes][槽 0][槽 1]...[槽 kSlotCount-1]
+// 清单和样本都使用会话录制的记录编码（SessionFormat.h），样本按发布序号轮流写入各个槽。
+// 清单区和每个槽都由顺序锁保护：写端写入前把 sequence 置为奇数，写完置为偶数；
+// 读端直接在映射区上解码，解码前后 sequence 相同且为偶数才算读到完整数据，否则重试。
+// 写端从不等待读端，读端也不需要任何系统调用，读端只拿最新的样本，跟不上时自然跳过中间的样本。
+class SnapshotBus {
+public:
+    static constexpr uint32_t kSlotCount = 16;
+    static constexpr uint32_t kSlotBytes = 32 * 1024;        // 每个槽的记录容量
+    static constexpr uint32_t kInventoryBytes = 32 * 1024;
+
+    // 共享内存头：Create 时写入一次的布局字段 + 写端维护的计数器
+    struct Header {
+        char magic[8];
+        uint32_t version;              // kSnapshotBusVersion
+        uint32_t recordVersion;        // 记录编码版本（kSessionVersion）
+        uint32_t headerSize;
+        uint32_t slotCount;
+        uint32_t slotBytes;
+        uint32_t inventoryBytes;
+        alignas(64) std::atomic<uint64_t> published;          // 已发布的样本数
+        alignas(64) std::atomic<uint64_t> inventorySequence;  // 清单区顺序锁，清单版本 = sequence / 2
+        uint32_t inventorySize;
+        std::atomic<uint32_t> closed;                          // 写端已关闭
+    };
+
+    struct Slot {
+        alignas(64) std::atomic<uint64_t> sequence;   // 写入中为奇数；写完为 2 * (发布序号 + 1)
+        uint64_t inventoryGeneration;                 // 写入样本时的清单版本
+        uint32_t size;                                // 记录字节数（含记录头）
+        uint8_t data[kSlotBytes];
+    };
+
+    SnapshotBus() = default;
+    ~SnapshotBus();
+    SnapshotBus(const SnapshotBus&) = delete;
+    SnapshotBus& operator=(const SnapshotBus&) = delete;
+
+    // 写端：创建（或覆盖同名的）共享内存
+    bool Create(const std::string& name);
+    // 读端：只读挂载已存在的共享内存
+    bool Attach(const std::string& name);
+    void Close();
+
+    bool IsOpen() const { return header_ != nullptr; }
+    bool IsWriter() const { return writer_; }
+
+    // ===== 写端（采样线程），不分配内存 =====
+    bool PublishInventory(const SessionView& state, int64_t timestampMs);
+    bool PublishSample(const SessionView& state, int64_t timestampMs);
+
+    // ===== 读端 =====
+    // 有新样本时解码到 state 并返回 true；清单变化时 inventoryChanged 置为 true（设备列表已重建）
+    bool ReadLatest(const SessionState& state, bool& inventoryChanged);
+    // 写端已正常关闭（之后不会再有新样本，需要重新挂载）
+    bool IsWriterClosed() const;
+    uint64_t GetPublishedCount() const;
+
+private:
+    bool Map(const std::string& name, bool create);
+    Slot* SlotAt(uint64_t index) const;
+    uint8_t* InventoryData() const;
+    bool ReadInventory(const SessionState& state);
+
+    Header* header_ = nullptr;
+    uint8_t* mapped_ = nullptr;
+    size_t mappedSize_ = 0;
+    bool writer_ = false;
+    std::string shmName_;
+
+    // 读端状态
+    uint64_t lastRead_ = 0;                  // 最近一次读到的发布序号
+    uint64_t inventoryGeneration_ = 0;       // 本地已解码的清单版本
+
+#ifdef _WIN32
+    HANDLE mapping_ = nullptr;
+#endif
+};
@@ -0,0 +1,260 @@
+#include "SnapshotDelta.h"
+#include <cstring>
+
+static uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// 顺序写入定长缓冲区，越界后只记录失败
+class VarintWriter {
+public:
+    VarintWriter(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    void Varint(uint64_t value) {
+        while (value >= 0x80) {
+            Byte(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        Byte(static_cast<uint8_t>(value));
+    }
+    void Signed(int64_t value) { Varint(ZigZag(value)); }
+    void Byte(uint8_t value) {
+        if (pos_ >= capacity_) {
+            ok_ = false;
+            return;
+        }
+        out_[pos_++] = value;
+    }
+
+    bool Ok() const { return ok_; }
+    size_t Position() const { return pos_; }
+
+private:
+    uint8_t* out_;
+    size_t capacity_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+class VarintReader {
+public:
+    VarintReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= size_) {
+                ok_ = false;
+                return 0;
+            }
+            uint8_t byte = data_[pos_++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+    int64_t Signed() { return UnZigZag(Varint()); }
+
+    bool Ok() const { return ok_; }
+    bool AtEnd() const { return pos_ == size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+// 在 out 开头写入帧头，负载已经写在 out + kDeltaFrameHeaderMax 处；返回整帧长度
+static size_t FinishFrame(DeltaFrameType type, uint8_t* out, size_t payloadBytes) {
+    VarintWriter header(out, kDeltaFrameHeaderMax);
+    header.Byte(static_cast<uint8_t>(type));
+    header.Varint(payloadBytes);
+    std::memmove(out + header.Position(), out + kDeltaFrameHeaderMax, payloadBytes);
+    return header.Position() + payloadBytes;
+}
+
+size_t DeltaFrameSize(const uint8_t* data, size_t bytes, size_t maxFrameBytes, bool& error) {
+    error = false;
+    if (bytes < 2) {
+        return 0;
+    }
+    if (data[0] < static_cast<uint8_t>(DeltaFrameType::Inventory) ||
+        data[0] > static_cast<uint8_t>(DeltaFrameType::Delta)) {
+        error = true;
+        return 0;
+    }
+    VarintReader reader(data + 1, bytes - 1 < 5 ? bytes - 1 : 5);
+    uint64_t payloadBytes = reader.Varint();
+    if (!reader.Ok()) {
+        // 5 个字节都有后续标记说明长度字段无效，否则只是还没收全
+        error = bytes - 1 >= 5;
+        return 0;
+    }
+    size_t headerBytes = bytes;   // 按读取位置计算帧头长度
+    for (size_t i = 1; i < bytes; i++) {
+        if ((data[i] & 0x80) == 0) {
+            headerBytes = i + 1;
+            break;
+        }
+    }
+    if (payloadBytes + headerBytes > maxFrameBytes) {
+        error = true;
+        return 0;
+    }
+    size_t frameBytes = headerBytes + static_cast<size_t>(payloadBytes);
+    return bytes >= frameBytes ? frameBytes : 0;
+}
+
+void SnapshotDeltaEncoder::Reset() {
+    needKeyframe_ = true;
+}
+
+size_t SnapshotDeltaEncoder::EncodeInventory(const SessionView& state, int64_t timestampMs,
+                                             uint8_t* out, size_t capacity) {
+    if (capacity <= kDeltaFrameHeaderMax) {
+        return 0;
+    }
+    size_t bytes = EncodeSessionRecord(SessionRecordType::Inventory, timestampMs, state,
+                                       out + kDeltaFrameHeaderMax, capacity - kDeltaFrameHeaderMax);
+    if (bytes == 0) {
+        return 0;
+    }
+    needKeyframe_ = true;
+    return FinishFrame(DeltaFrameType::Inventory, out, bytes);
+}
+
+size_t SnapshotDeltaEncoder::EncodeSample(const SessionView& state, int64_t timestampMs,
+                                          uint8_t* out, size_t capacity) {
+    if (capacity <= kDeltaFrameHeaderMax) {
+        return 0;
+    }
+    current_.resize(CountSampleValues(state));
+    ExtractSampleValues(state, current_.data());
+
+    bool keyframe = needKeyframe_ || sinceKeyframe_ >= kKeyframeInterval || current_.size() != previous_.size();
+    VarintWriter payload(out + kDeltaFrameHeaderMax, capacity - kDeltaFrameHeaderMax);
+    if (keyframe) {
+        payload.Signed(timestampMs);
+        payload.Varint(current_.size());
+        for (int64_t value : current_) {
+            payload.Signed(value);
+        }
+    } else {
+        size_t changed = 0;
+        for (size_t i = 0; i < current_.size(); i++) {
+            changed += current_[i] != previous_[i] ? 1 : 0;
+        }
+        payload.Signed(timestampMs - previousTimestampMs_);
+        payload.Varint(changed);
+        size_t next = 0;   // 下一个可能变化的位置，间隔相对于它计算
+        for (size_t i = 0; i < current_.size(); i++) {
+            if (current_[i] == previous_[i]) {
+                continue;
+            }
+            payload.Varint(i - next);
+            payload.Signed(current_[i] - previous_[i]);
+            next = i + 1;
+        }
+    }
+    if (!payload.Ok()) {
+        return 0;
+    }
+
+    previous_.swap(current_);
+    previousTimestampMs_ = timestampMs;
+    sinceKeyframe_ = keyframe ? 1 : sinceKeyframe_ + 1;
+    needKeyframe_ = false;
+    return FinishFrame(keyframe ? DeltaFrameType::Keyframe : DeltaFrameType::Delta, out, payload.Position());
+}
+
+void SnapshotDeltaDecoder::Reset() {
+    hasInventory_ = false;
+    synced_ = false;
+}
+
+bool SnapshotDeltaDecoder::Decode(const uint8_t* frame, size_t bytes, const SessionState& state,
+                                  DeltaFrameType& type, int64_t& timestampMs, bool& error) {
+    error = false;
+    bool sizeError = false;
+    if (DeltaFrameSize(frame, bytes, bytes, sizeError) != bytes) {
+        error = true;
+        return false;
+    }
+    type = static_cast<DeltaFrameType>(frame[0]);
+    size_t headerBytes = 1;
+    while ((frame[headerBytes] & 0x80) != 0) {
+        headerBytes++;
+    }
+    headerBytes++;
+    const uint8_t* payload = frame + headerBytes;
+    size_t payloadBytes = bytes - headerBytes;
+
+    if (type == DeltaFrameType::Inventory) {
+        SessionRecordHeader header;
+        if (payloadBytes < sizeof(header)) {
+            error = true;
+            return false;
+        }
+        std::memcpy(&header, payload, sizeof(header));
+        synced_ = false;
+        hasInventory_ = header.type == static_cast<uint32_t>(SessionRecordType::Inventory) &&
+                        header.size == payloadBytes &&
+                        DecodeSessionRecord(header, payload + sizeof(header), state);
+        error = !hasInventory_;
+        timestampMs = header.timestampMs;
+        return hasInventory_;
+    }
+
+    if (!hasInventory_ || (type == DeltaFrameType::Delta && !synced_)) {
+        return false;   // 等待清单和下一个 Keyframe
+    }
+
+    VarintReader reader(payload, payloadBytes);
+    if (type == DeltaFrameType::Keyframe) {
+        int64_t timestamp = reader.Signed();
+        uint64_t count = reader.Varint();
+        if (!reader.Ok() || count != CountSampleValues(state)) {
+            synced_ = false;
+            error = true;
+            return false;
+        }
+        values_.resize(static_cast<size_t>(count));
+        for (int64_t& value : values_) {
+            value = reader.Signed();
+        }
+        timestampMs_ = timestamp;
+    } else {
+        timestampMs_ += reader.Signed();
+        uint64_t changed = reader.Varint();
+        size_t next = 0;
+        for (uint64_t i = 0; i < changed && reader.Ok(); i++) {
+            uint64_t index = next + reader.Varint();
+            int64_t delta = reader.Signed();
+            if (index >= values_.size()) {
+                synced_ = false;
+                error = true;
+                return false;
+            }
+            values_[index] += delta;
+            next = static_cast<size_t>(index) + 1;
+        }
+    }
+    if (!reader.Ok() || !reader.AtEnd()) {
+        synced_ = false;
+        error = true;
+        return false;
+    }
+
+    synced_ = true;
+    ApplySampleValues(state, values_.data());
+    timestampMs = timestampMs_;
+    return true;
+}
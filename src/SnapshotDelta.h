@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SessionFormat.h"
+
+// 快照差分编码（节点上报的紧凑格式）
+//
+// 帧 = [类型 1 字节][负载长度 varint][负载]
+//   Inventory：负载为一条完整的 Inventory 记录（SessionFormat），静态字段只在清单变化时发送
+//   Keyframe： [时间戳 zigzag varint][数值个数 varint][每个数值 zigzag varint]
+//   Delta：    [与上一帧的时间差 zigzag varint][变化的数值个数 varint][(与上一个变化位置的间隔 varint, 差值 zigzag varint)...]
+//
+// 数值为 ExtractSampleValues 展开的整数，Delta 帧只包含与上一帧相比发生变化的数值。
+// 清单变化后、以及每隔 kKeyframeInterval 帧发送一次 Keyframe，解码端出错后可以从下一个 Keyframe 重新同步。
+enum class DeltaFrameType : uint8_t {
+    Inventory = 1,
+    Keyframe = 2,
+    Delta = 3,
+};
+
+constexpr size_t kDeltaFrameHeaderMax = 1 + 5;   // 类型 + 最长的 32 位 varint
+
+// data 开头一帧的总字节数；数据还不完整时返回 0，格式错误时返回 0 并把 error 置为 true
+size_t DeltaFrameSize(const uint8_t* data, size_t bytes, size_t maxFrameBytes, bool& error);
+
+class SnapshotDeltaEncoder {
+public:
+    static constexpr uint32_t kKeyframeInterval = 100;   // 10 Hz 采样时约 10 秒一次
+
+    // 下一个样本编码为 Keyframe（新连接时调用）
+    void Reset();
+
+    // 编码一帧，空间不足时返回 0。清单变化后先编码 Inventory，下一个样本自动成为 Keyframe
+    size_t EncodeInventory(const SessionView& state, int64_t timestampMs, uint8_t* out, size_t capacity);
+    size_t EncodeSample(const SessionView& state, int64_t timestampMs, uint8_t* out, size_t capacity);
+
+private:
+    std::vector<int64_t> previous_;
+    std::vector<int64_t> current_;
+    int64_t previousTimestampMs_ = 0;
+    uint32_t sinceKeyframe_ = 0;
+    bool needKeyframe_ = true;
+};
+
+class SnapshotDeltaDecoder {
+public:
+    // 丢弃已同步的状态，等待下一个 Inventory/Keyframe
+    void Reset();
+
+    // 解码完整的一帧（DeltaFrameSize 返回的长度）到 state。
+    // Inventory 重建设备列表；样本帧在尚未同步时返回 false（不算错误，error 保持为 false）
+    bool Decode(const uint8_t* frame, size_t bytes, const SessionState& state,
+                DeltaFrameType& type, int64_t& timestampMs, bool& error);
+
+private:
+    std::vector<int64_t> values_;
+    int64_t timestampMs_ = 0;
+    bool hasInventory_ = false;
+    bool synced_ = false;          // 已收到清单之后的 Keyframe
+};
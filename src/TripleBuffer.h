@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 单写单读的三缓冲区（无锁）
+// 写端（采样线程）始终写入自己独占的 back 缓冲区，完成后通过一次原子交换发布；
+// 读端（UI线程）在有新数据时把 middle 缓冲区交换到自己独占的 front 缓冲区。
+// 双方永远不会访问同一个缓冲区，也不会互相等待。
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ===== 写端 =====
+    // 获取可写缓冲区（内容是之前某一次发布的旧数据，写端需要完整覆盖）
+    T& WriteBuffer() { return slots_[back_]; }
+
+    // 发布写好的缓冲区，并取回一个空闲缓冲区用于下次写入
+    void Publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kDirtyBit),
+                                            std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+
+    // ===== 读端 =====
+    // 如果有新发布的数据，则切换到最新数据；返回是否发生了切换
+    bool Acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & kDirtyBit) == 0) {
+            return false;
+        }
+        uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+
+    // 获取读端当前持有的（完整的）数据
+    const T& ReadBuffer() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirtyBit = 0x4;
+
+    T slots_[3];
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t back_ = 0;   // 仅写端访问
+    alignas(64) uint8_t front_ = 2;  // 仅读端访问
+};
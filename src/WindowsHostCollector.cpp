@@ -0,0 +1,526 @@
+#include "WindowsHostCollector.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <comdef.h>
+#include <Wbemidl.h>
+
+#pragma comment(lib, "pdh.lib")
+#pragma comment(lib, "psapi.lib")
+#pragma comment(lib, "wbemuuid.lib")
+#pragma comment(lib, "ole32.lib")
+#pragma comment(lib, "oleaut32.lib")
+
+// 取回通配计数器所有实例的格式化值，buffer 只增长；失败返回空
+static const PDH_FMT_COUNTERVALUE_ITEM_A* GetCounterArray(PDH_HCOUNTER counter, std::vector<BYTE>& buffer,
+                                                          DWORD& itemCount) {
+    DWORD bufferSize = static_cast<DWORD>(buffer.size());
+    itemCount = 0;
+    PDH_STATUS status = PdhGetFormattedCounterArrayA(counter, PDH_FMT_DOUBLE, &bufferSize, &itemCount,
+        buffer.empty() ? nullptr : reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_A*>(buffer.data()));
+    if (status == PDH_MORE_DATA) {
+        buffer.resize(bufferSize);
+        status = PdhGetFormattedCounterArrayA(counter, PDH_FMT_DOUBLE, &bufferSize, &itemCount,
+            reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_A*>(buffer.data()));
+    }
+    if (status != ERROR_SUCCESS) {
+        return nullptr;
+    }
+    return reinterpret_cast<const PDH_FMT_COUNTERVALUE_ITEM_A*>(buffer.data());
+}
+
+bool WindowsHostCollector::Initialize() {
+    // 初始化CPU性能计数器
+    PdhOpenQuery(NULL, NULL, &cpuQuery_);
+    PdhAddCounter(cpuQuery_, "\\Processor(_Total)\\% Processor Time", NULL, &cpuCounter_);
+    PdhAddCounter(cpuQuery_, "\\Processor(*)\\% Processor Time", NULL, &coreCounter_);
+    // 频率：Processor Frequency 为标称频率 (MHz)，% Processor Performance 为实际频率占标称频率的比例（睿频时超过 100）
+    PdhAddCounter(cpuQuery_, "\\Processor Information(_Total)\\Processor Frequency", NULL, &baseFrequencyCounter_);
+    PdhAddCounter(cpuQuery_, "\\Processor Information(*)\\% Processor Performance", NULL, &performanceCounter_);
+    PdhCollectQueryData(cpuQuery_);
+
+    // 换页计数器
+    PdhOpenQuery(NULL, NULL, &memoryQuery_);
+    PdhAddCounter(memoryQuery_, "\\Memory\\Pages Input/sec", NULL, &pageInCounter_);
+    PdhAddCounter(memoryQuery_, "\\Memory\\Pages Output/sec", NULL, &pageOutCounter_);
+    PdhAddCounter(memoryQuery_, "\\Memory\\Page Reads/sec", NULL, &majorFaultCounter_);
+    PdhAddCounter(memoryQuery_, "\\Memory\\Modified Page List Bytes", NULL, &modifiedCounter_);
+    PdhCollectQueryData(memoryQuery_);
+    return true;
+}
+
+void WindowsHostCollector::Shutdown() {
+    if (cpuQuery_) {
+        PdhCloseQuery(cpuQuery_);
+        cpuQuery_ = nullptr;
+    }
+    if (memoryQuery_) {
+        PdhCloseQuery(memoryQuery_);
+        memoryQuery_ = nullptr;
+    }
+    
+    if (diskQuery_) {
+        // 关闭所有磁盘计数器
+        for (auto& counter : diskCounters_) {
+            if (counter.readCounter) {
+                PdhRemoveCounter(counter.readCounter);
+            }
+            if (counter.writeCounter) {
+                PdhRemoveCounter(counter.writeCounter);
+            }
+        }
+        diskCounters_.clear();
+        PdhCloseQuery(diskQuery_);
+        diskQuery_ = nullptr;
+    }
+}
+
+bool WindowsHostCollector::UpdateCPUTopology(CPUInfo& cpu) {
+    cpu.logicalCpus.clear();
+
+    // 每个 RelationProcessorCore 项是一个物理核心（掩码中的位是它的逻辑 CPU），RelationProcessorPackage 项是一个插槽
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformation(nullptr, &bufferSize);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> entries(bufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!entries.empty() && GetLogicalProcessorInformation(entries.data(), &bufferSize)) {
+        std::vector<ULONG_PTR> packages;
+        for (const auto& entry : entries) {
+            if (entry.Relationship == RelationProcessorPackage) {
+                packages.push_back(entry.ProcessorMask);
+            }
+        }
+        unsigned int core = 0;
+        for (const auto& entry : entries) {
+            if (entry.Relationship != RelationProcessorCore) {
+                continue;
+            }
+            for (unsigned int bit = 0; bit < sizeof(ULONG_PTR) * 8; bit++) {
+                ULONG_PTR mask = static_cast<ULONG_PTR>(1) << bit;
+                if ((entry.ProcessorMask & mask) == 0) {
+                    continue;
+                }
+                LogicalCpuInfo logical;
+                logical.id = bit;
+                logical.core = core;
+                for (size_t socket = 0; socket < packages.size(); socket++) {
+                    if ((packages[socket] & mask) != 0) {
+                        logical.socket = static_cast<unsigned int>(socket);
+                    }
+                }
+                cpu.logicalCpus.push_back(logical);
+            }
+            core++;
+        }
+    }
+
+    // 拓扑不可用时每个逻辑 CPU 视为一个物理核心
+    if (cpu.logicalCpus.empty()) {
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        for (DWORD i = 0; i < systemInfo.dwNumberOfProcessors; i++) {
+            LogicalCpuInfo logical;
+            logical.id = i;
+            logical.core = i;
+            cpu.logicalCpus.push_back(logical);
+        }
+    }
+
+    SortLogicalCpus(cpu);
+
+    // PDH 只提供标称频率，作为每个逻辑 CPU 的最大频率（睿频时频率百分比会超过 100）
+    PDH_FMT_COUNTERVALUE counterVal;
+    PdhCollectQueryData(cpuQuery_);
+    if (baseFrequencyCounter_ != nullptr &&
+        PdhGetFormattedCounterValue(baseFrequencyCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        for (LogicalCpuInfo& logical : cpu.logicalCpus) {
+            logical.maxFrequency = static_cast<float>(counterVal.doubleValue);
+        }
+    }
+
+    unsigned int maxId = 0;
+    for (const LogicalCpuInfo& logical : cpu.logicalCpus) {
+        maxId = std::max(maxId, logical.id);
+    }
+    cpuIndex_.assign(cpu.logicalCpus.empty() ? 0 : maxId + 1, -1);
+    for (size_t i = 0; i < cpu.logicalCpus.size(); i++) {
+        cpuIndex_[cpu.logicalCpus[i].id] = static_cast<int>(i);
+    }
+    return true;
+}
+
+void WindowsHostCollector::UpdateCPU(CPUInfo& cpu) {
+    // 使用PDH获取CPU利用率
+    PDH_FMT_COUNTERVALUE counterVal;
+    PdhCollectQueryData(cpuQuery_);
+    
+    if (PdhGetFormattedCounterValue(cpuCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        cpu.utilization = static_cast<float>(counterVal.doubleValue);
+    }
+
+    // 每个逻辑 CPU 的利用率：实例名为处理器编号（"_Total" 等非数字实例跳过）
+    if (coreCounter_ == nullptr || cpu.coreUtilization.size() != cpu.logicalCpus.size()) {
+        return;
+    }
+    DWORD itemCount = 0;
+    const PDH_FMT_COUNTERVALUE_ITEM_A* items = GetCounterArray(coreCounter_, coreValues_, itemCount);
+    if (items == nullptr) {
+        return;
+    }
+    for (DWORD i = 0; i < itemCount; i++) {
+        const char* name = items[i].szName;
+        if (name[0] < '0' || name[0] > '9') {
+            continue;
+        }
+        size_t id = static_cast<size_t>(strtoul(name, nullptr, 10));
+        if (id < cpuIndex_.size() && cpuIndex_[id] >= 0) {
+            cpu.coreUtilization[cpuIndex_[id]] = static_cast<float>(items[i].FmtValue.doubleValue);
+        }
+    }
+}
+
+void WindowsHostCollector::UpdateCPUThermal(CPUInfo& cpu) {
+    // 计数器由 UpdateCPU 统一采集，这里只读取格式化值
+    // 实例名为 "组,编号"（"_Total" 和 "0,_Total" 等汇总实例跳过）；温度和降频计数没有不需要管理员权限的来源，保持为 0
+    if (performanceCounter_ == nullptr || cpu.coreFrequency.size() != cpu.logicalCpus.size()) {
+        return;
+    }
+    DWORD itemCount = 0;
+    const PDH_FMT_COUNTERVALUE_ITEM_A* items = GetCounterArray(performanceCounter_, performanceValues_, itemCount);
+    if (items == nullptr) {
+        return;
+    }
+    double sum = 0.0;
+    size_t count = 0;
+    for (DWORD i = 0; i < itemCount; i++) {
+        char* end = nullptr;
+        unsigned long group = strtoul(items[i].szName, &end, 10);
+        if (end == items[i].szName || *end != ',' || end[1] < '0' || end[1] > '9') {
+            continue;
+        }
+        size_t id = static_cast<size_t>(group * 64 + strtoul(end + 1, nullptr, 10));
+        if (id >= cpuIndex_.size() || cpuIndex_[id] < 0) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(cpuIndex_[id]);
+        float frequency = cpu.logicalCpus[index].maxFrequency * static_cast<float>(items[i].FmtValue.doubleValue) / 100.0f;
+        cpu.coreFrequency[index] = frequency;
+        sum += frequency;
+        count++;
+    }
+    if (count > 0) {
+        cpu.frequency = static_cast<float>(sum / static_cast<double>(count));
+    }
+}
+
+void WindowsHostCollector::UpdateMemory(MemoryInfo& memory) {
+    MEMORYSTATUSEX memInfo;
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    GlobalMemoryStatusEx(&memInfo);
+
+    memory.total = static_cast<float>(memInfo.ullTotalPhys) / (1024.0f * 1024.0f * 1024.0f);  // GB
+    memory.available = static_cast<float>(memInfo.ullAvailPhys) / (1024.0f * 1024.0f * 1024.0f);  // GB
+    memory.used = memory.total - memory.available;
+    memory.percent = static_cast<float>(memInfo.dwMemoryLoad);
+
+    // 换页：Pages Input/Output 包含页面文件和映射文件的读写（不区分换入换出，swap 速率保持为 0），
+    // Page Reads/sec 为需要读磁盘的缺页次数，Modified Page List 为等待写回的页
+    if (memoryQuery_ == nullptr || PdhCollectQueryData(memoryQuery_) != ERROR_SUCCESS) {
+        return;
+    }
+    constexpr double kPageMb = 4096.0 / (1024.0 * 1024.0);
+    PDH_FMT_COUNTERVALUE counterVal;
+    if (PdhGetFormattedCounterValue(pageInCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        memory.pageInRate = static_cast<float>(counterVal.doubleValue * kPageMb);
+    }
+    if (PdhGetFormattedCounterValue(pageOutCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        memory.pageOutRate = static_cast<float>(counterVal.doubleValue * kPageMb);
+    }
+    if (PdhGetFormattedCounterValue(majorFaultCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        memory.majorFaultRate = static_cast<float>(counterVal.doubleValue);
+    }
+    if (PdhGetFormattedCounterValue(modifiedCounter_, PDH_FMT_DOUBLE, NULL, &counterVal) == ERROR_SUCCESS) {
+        memory.dirty = static_cast<float>(counterVal.doubleValue / (1024.0 * 1024.0));  // MB
+    }
+}
+
+bool WindowsHostCollector::UpdateMemoryModules(MemoryInfo& memory) {
+    // 使用WMI获取真实的内存条信息
+    static bool wmiInitialized = false;
+    static bool wmiAvailable = false;
+    
+    if (!wmiInitialized) {
+        // 尝试初始化WMI（只初始化一次）
+        HRESULT hres = CoInitializeEx(0, COINIT_MULTITHREADED);
+        if (SUCCEEDED(hres) || hres == RPC_E_CHANGED_MODE) {
+            hres = CoInitializeSecurity(NULL, -1, NULL, NULL,
+                RPC_C_AUTHN_LEVEL_DEFAULT, RPC_C_IMP_LEVEL_IMPERSONATE,
+                NULL, EOAC_NONE, NULL);
+            wmiAvailable = (SUCCEEDED(hres) || hres == RPC_E_TOO_LATE);
+        }
+        wmiInitialized = true;
+    }
+    
+    bool modulesUpdated = false;
+    
+    if (wmiAvailable) {
+        // 使用WMI获取内存条信息
+        IWbemLocator* pLoc = nullptr;
+        HRESULT hres = CoCreateInstance(CLSID_WbemLocator, 0, CLSCTX_INPROC_SERVER,
+            IID_IWbemLocator, (LPVOID*)&pLoc);
+        
+        if (SUCCEEDED(hres)) {
+            IWbemServices* pSvc = nullptr;
+            hres = pLoc->ConnectServer(_bstr_t(L"ROOT\\CIMV2"), NULL, NULL, 0, NULL, 0, 0, &pSvc);
+            
+            if (SUCCEEDED(hres)) {
+                hres = CoSetProxyBlanket(pSvc, RPC_C_AUTHN_WINNT, RPC_C_AUTHZ_NONE, NULL,
+                    RPC_C_AUTHN_LEVEL_CALL, RPC_C_IMP_LEVEL_IMPERSONATE, NULL, EOAC_NONE);
+                
+                if (SUCCEEDED(hres)) {
+                    IEnumWbemClassObject* pEnumerator = nullptr;
+                    hres = pSvc->ExecQuery(bstr_t("WQL"),
+                        bstr_t("SELECT Capacity, Speed, MemoryType, DeviceLocator FROM Win32_PhysicalMemory"),
+                        WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY, NULL, &pEnumerator);
+                    
+                    if (SUCCEEDED(hres)) {
+                        memory.modules.clear();
+                        IWbemClassObject* pclsObj = nullptr;
+                        ULONG uReturn = 0;
+                        size_t moduleIndex = 0;
+                        
+                        while (pEnumerator->Next(WBEM_INFINITE, 1, &pclsObj, &uReturn) == WBEM_S_NO_ERROR && uReturn > 0) {
+                            MemoryModuleInfo module;
+                            
+                            // 获取容量
+                            VARIANT vtProp;
+                            if (SUCCEEDED(pclsObj->Get(L"Capacity", 0, &vtProp, 0, 0))) {
+                                if (vtProp.vt == VT_BSTR) {
+                                    unsigned long long capacity = _wtoi64(vtProp.bstrVal);
+                                    module.capacity = static_cast<float>(capacity) / (1024.0f * 1024.0f * 1024.0f); // GB
+                                } else if (vtProp.vt == VT_I8 || vtProp.vt == VT_UI8) {
+                                    module.capacity = static_cast<float>(vtProp.ullVal) / (1024.0f * 1024.0f * 1024.0f); // GB
+                                }
+                                VariantClear(&vtProp);
+                            }
+                            
+                            // 获取速度
+                            if (SUCCEEDED(pclsObj->Get(L"Speed", 0, &vtProp, 0, 0))) {
+                                if (vtProp.vt == VT_UI4) {
+                                    module.speed = vtProp.ulVal;
+                                } else if (vtProp.vt == VT_UI2) {
+                                    module.speed = vtProp.uiVal;
+                                }
+                                VariantClear(&vtProp);
+                            }
+                            
+                            // 获取内存类型
+                            if (SUCCEEDED(pclsObj->Get(L"MemoryType", 0, &vtProp, 0, 0))) {
+                                unsigned int memType = 0;
+                                if (vtProp.vt == VT_UI2) {
+                                    memType = vtProp.uiVal;
+                                } else if (vtProp.vt == VT_UI4) {
+                                    memType = vtProp.ulVal;
+                                }
+                                
+                                // 转换内存类型代码为字符串
+                                switch (memType) {
+                                case 20: module.type = "DDR"; break;
+                                case 21: module.type = "DDR2"; break;
+                                case 24: module.type = "DDR3"; break;
+                                case 26: module.type = "DDR4"; break;
+                                case 34: case 35: module.type = "DDR5"; break;
+                                default: module.type = "Unknown"; break;
+                                }
+                                VariantClear(&vtProp);
+                            }
+                            
+                            // 获取设备位置
+                            if (SUCCEEDED(pclsObj->Get(L"DeviceLocator", 0, &vtProp, 0, 0))) {
+                                if (vtProp.vt == VT_BSTR && vtProp.bstrVal) {
+                                    _bstr_t bstrLocator(vtProp.bstrVal);
+                                    char* pLocator = bstrLocator;
+                                    if (pLocator) {
+                                        module.name = std::string(pLocator);
+                                    } else {
+                                        module.name = "内存条 " + std::to_string(moduleIndex + 1);
+                                    }
+                                } else {
+                                    module.name = "内存条 " + std::to_string(moduleIndex + 1);
+                                }
+                                VariantClear(&vtProp);
+                            } else {
+                                module.name = "内存条 " + std::to_string(moduleIndex + 1);
+                            }
+                            
+                            // 估算通道（基于索引，假设双通道）
+                            module.channel = static_cast<unsigned int>(moduleIndex % 2);
+                            
+                            // 如果没有获取到速度，使用默认值
+                            if (module.speed == 0) {
+                                if (module.type == "DDR5") {
+                                    module.speed = 4800;
+                                } else if (module.type == "DDR4") {
+                                    module.speed = 3200;
+                                } else if (module.type == "DDR3") {
+                                    module.speed = 1600;
+                                } else {
+                                    module.speed = 2400;
+                                }
+                            }
+                            
+                            // 计算单条内存的最大带宽
+                            // 单通道带宽 = 速度(MHz) * 64bit / 8 / 1000
+                            module.maxBandwidth = (static_cast<float>(module.speed) * 64.0f) / 8.0f / 1000.0f; // GB/s
+                            
+                            memory.modules.push_back(module);
+                            moduleIndex++;
+                            
+                            pclsObj->Release();
+                        }
+                        
+                        pEnumerator->Release();
+                        modulesUpdated = true;
+                    }
+                    
+                    pSvc->Release();
+                }
+                
+                pLoc->Release();
+            }
+        }
+    }
+    
+    // 如果WMI失败或未初始化，使用估算方法
+    if (!modulesUpdated) {
+        MEMORYSTATUSEX memInfo;
+        memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+        GlobalMemoryStatusEx(&memInfo);
+        
+        float totalMemGB = static_cast<float>(memInfo.ullTotalPhys) / (1024.0f * 1024.0f * 1024.0f);
+        modulesUpdated = EstimateMemoryModules(memory, totalMemGB);
+    }
+    return modulesUpdated;
+}
+
+bool WindowsHostCollector::UpdateDisks(std::vector<DiskInfo>& disks) {
+    bool inventoryChanged = false;
+
+    // 初始化磁盘查询（如果尚未初始化）
+    if (diskQuery_ == nullptr) {
+        PdhOpenQuery(nullptr, NULL, &diskQuery_);
+        
+        // 枚举所有逻辑磁盘
+        DWORD bufferSize = 0;
+        GetLogicalDriveStrings(bufferSize, nullptr);
+        bufferSize += 1;
+        std::vector<char> driveBuffer(bufferSize);
+        GetLogicalDriveStrings(bufferSize, driveBuffer.data());
+        
+        disks.clear();
+        diskCounters_.clear();
+        inventoryChanged = true;
+        
+        for (char* drive = driveBuffer.data(); *drive; drive += strlen(drive) + 1) {
+            UINT driveType = GetDriveTypeA(drive);
+            if (driveType == DRIVE_FIXED) { // 只监控固定磁盘
+                DiskInfo disk;
+                disk.name = std::string(1, drive[0]) + ":";
+                
+                // 获取磁盘容量
+                ULARGE_INTEGER freeBytes, totalBytes;
+                if (GetDiskFreeSpaceExA(drive, nullptr, &totalBytes, &freeBytes)) {
+                    disk.totalSize = static_cast<float>(totalBytes.QuadPart) / (1024.0f * 1024.0f * 1024.0f); // GB
+                }
+                
+                // 估算磁盘类型和最大带宽
+                if (disk.totalSize > 1000.0f) {
+                    // 大容量，可能是HDD
+                    disk.type = "HDD";
+                    disk.model = "机械硬盘";
+                    disk.maxReadBandwidth = 0.2f;  // GB/s
+                    disk.maxWriteBandwidth = 0.15f; // GB/s
+                } else {
+                    // 较小容量，可能是SSD
+                    disk.type = "SSD";
+                    disk.model = "固态硬盘";
+                    disk.maxReadBandwidth = 3.5f;  // GB/s (NVMe PCIe 3.0估算)
+                    disk.maxWriteBandwidth = 2.5f; // GB/s
+                }
+                
+                disks.push_back(disk);
+                
+                // 创建PDH计数器 - 使用正确的路径格式
+                DiskCounter counter;
+                counter.diskName = disk.name;
+                
+                // PDH路径格式: \PhysicalDisk(0 C:)\Disk Read Bytes/sec
+                char driveLetter = drive[0];
+                std::string readPath = "\\PhysicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Read Bytes/sec";
+                std::string writePath = "\\PhysicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Write Bytes/sec";
+                
+                // 尝试添加计数器，如果失败则跳过
+                PDH_STATUS status1 = PdhAddCounterA(diskQuery_, readPath.c_str(), NULL, &counter.readCounter);
+                PDH_STATUS status2 = PdhAddCounterA(diskQuery_, writePath.c_str(), NULL, &counter.writeCounter);
+                
+                if (status1 == ERROR_SUCCESS && status2 == ERROR_SUCCESS) {
+                    diskCounters_.push_back(counter);
+                } else {
+                    // 如果PDH路径失败，尝试使用逻辑磁盘路径
+                    readPath = "\\LogicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Read Bytes/sec";
+                    writePath = "\\LogicalDisk(" + std::string(1, driveLetter) + ":)\\Disk Write Bytes/sec";
+                    
+                    counter.readCounter = nullptr;
+                    counter.writeCounter = nullptr;
+                    status1 = PdhAddCounterA(diskQuery_, readPath.c_str(), NULL, &counter.readCounter);
+                    status2 = PdhAddCounterA(diskQuery_, writePath.c_str(), NULL, &counter.writeCounter);
+                    
+                    if (status1 == ERROR_SUCCESS && status2 == ERROR_SUCCESS) {
+                        diskCounters_.push_back(counter);
+                    }
+                }
+            }
+        }
+        
+        if (diskQuery_ != nullptr && !diskCounters_.empty()) {
+            PdhCollectQueryData(diskQuery_);
+        }
+    }
+    
+    // 更新磁盘IO数据
+    if (diskQuery_ != nullptr && !diskCounters_.empty()) {
+        PdhCollectQueryData(diskQuery_);
+        
+        for (size_t i = 0; i < disks.size() && i < diskCounters_.size(); i++) {
+            DiskInfo& disk = disks[i];
+            DiskCounter& counter = diskCounters_[i];
+            
+            // 读取读取速度
+            if (counter.readCounter != nullptr) {
+                PDH_FMT_COUNTERVALUE readValue;
+                if (PdhGetFormattedCounterValue(counter.readCounter, PDH_FMT_DOUBLE, NULL, &readValue) == ERROR_SUCCESS) {
+                    // 转换为GB/s
+                    disk.realTimeReadBandwidth = static_cast<float>(readValue.doubleValue) / (1024.0f * 1024.0f * 1024.0f);
+                    disk.readUtilization = (disk.maxReadBandwidth > 0.0f) ? 
+                        (disk.realTimeReadBandwidth / disk.maxReadBandwidth * 100.0f) : 0.0f;
+                }
+            }
+            
+            // 读取写入速度
+            if (counter.writeCounter != nullptr) {
+                PDH_FMT_COUNTERVALUE writeValue;
+                if (PdhGetFormattedCounterValue(counter.writeCounter, PDH_FMT_DOUBLE, NULL, &writeValue) == ERROR_SUCCESS) {
+                    // 转换为GB/s
+                    disk.realTimeWriteBandwidth = static_cast<float>(writeValue.doubleValue) / (1024.0f * 1024.0f * 1024.0f);
+                    disk.writeUtilization = (disk.maxWriteBandwidth > 0.0f) ? 
+                        (disk.realTimeWriteBandwidth / disk.maxWriteBandwidth * 100.0f) : 0.0f;
+                }
+            }
+        }
+    }
+
+    return inventoryChanged;
+}
+#endif
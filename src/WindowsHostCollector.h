@@ -0,0 +1,50 @@
+#pragma once
+
+#ifdef _WIN32
+#include <string>
+#include <vector>
+#include <windows.h>
+#include <pdh.h>
+#include "HostCollector.h"
+
+// Windows 采集后端：CPU（含频率）和磁盘使用 PDH 性能计数器，CPU 拓扑使用 GetLogicalProcessorInformation，内存使用 GlobalMemoryStatusEx（换页速率使用 PDH），内存条清单使用 WMI
+class WindowsHostCollector : public HostCollector {
+public:
+    const char* Name() const override { return "Windows PDH/WMI"; }
+    bool Initialize() override;
+    void Shutdown() override;
+
+    bool UpdateCPUTopology(CPUInfo& cpu) override;
+    void UpdateCPU(CPUInfo& cpu) override;
+    void UpdateCPUThermal(CPUInfo& cpu) override;
+    void UpdateMemory(MemoryInfo& memory) override;
+    bool UpdateMemoryModules(MemoryInfo& memory) override;
+    bool UpdateDisks(std::vector<DiskInfo>& disks) override;
+    // Windows 没有对应 PSI 的停顿统计
+    bool UpdatePressure(std::vector<PressureInfo>&) override { return false; }
+
+private:
+    PDH_HQUERY cpuQuery_ = nullptr;
+    PDH_HCOUNTER cpuCounter_ = nullptr;
+    PDH_HCOUNTER coreCounter_ = nullptr;       // \Processor(*) 通配计数器，一次取回所有逻辑 CPU
+    std::vector<BYTE> coreValues_;             // PdhGetFormattedCounterArray 的缓冲区（只增长）
+    PDH_HCOUNTER baseFrequencyCounter_ = nullptr;   // 标称频率 (MHz)
+    PDH_HCOUNTER performanceCounter_ = nullptr;     // \Processor Information(*) 的 % Processor Performance
+    std::vector<BYTE> performanceValues_;
+    std::vector<int> cpuIndex_;                // 处理器编号 → logicalCpus 中的下标，-1 表示不在清单中
+    PDH_HQUERY memoryQuery_ = nullptr;
+    PDH_HCOUNTER pageInCounter_ = nullptr;
+    PDH_HCOUNTER pageOutCounter_ = nullptr;
+    PDH_HCOUNTER majorFaultCounter_ = nullptr;
+    PDH_HCOUNTER modifiedCounter_ = nullptr;
+    PDH_HQUERY diskQuery_ = nullptr;
+
+    // 磁盘性能计数器
+    struct DiskCounter {
+        PDH_HCOUNTER readCounter = nullptr;
+        PDH_HCOUNTER writeCounter = nullptr;
+        std::string diskName;
+    };
+    std::vector<DiskCounter> diskCounters_;
+};
+#endif
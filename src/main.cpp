@@ -1,45 +1,146 @@
 #include <iostream>
-#include <thread>
 #include <chrono>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
 #include "HardwareMonitor.h"
+#include "MetricsExporter.h"
 #include "ImGuiApp.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+    // 命令行参数：
+    //   --record <文件>        把每次采样追加到会话录制文件
+    //   --replay <文件>        回放录制文件代替实时采集
+    //   --speed <倍速|max>     回放倍速，默认 1（实时）；max 表示不等待，同时界面不限帧率，用于基准测试
+    //   --metrics-port <端口>  启动 Prometheus 指标导出（HTTP /metrics）
+    //   --metrics-address <地址> 指标导出监听地址，默认 127.0.0.1（供其他机器抓取时用 0.0.0.0）
+    //   --shm <名称>           把快照发布到共享内存快照总线，供本机其他进程只读挂载
+    //   --attach <名称>        挂载另一个采样进程的共享内存快照总线代替实时采集
+    std::string recordPath;
+    std::string replayPath;
+    std::string busName;
+    std::string attachName;
+    double replaySpeed = 1.0;
+    int metricsPort = -1;
+    std::string metricsAddress = "127.0.0.1";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            busName = argv[++i];
+        } else if (arg == "--attach" && i + 1 < argc) {
+            attachName = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            metricsPort = std::atoi(argv[++i]);
+        } else if (arg == "--metrics-address" && i + 1 < argc) {
+            metricsAddress = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            std::string speed = argv[++i];
+            replaySpeed = speed == "max" ? 0.0 : std::atof(speed.c_str());
+            if (speed != "max" && replaySpeed <= 0.0) {
+                std::cerr << "无效的回放倍速: " << speed << std::endl;
+                return -1;
+            }
+        }
+    }
+    bool benchmark = !replayPath.empty() && replaySpeed == 0.0;
+
     try {
+        // 导出器在监控对象之前构造，保证采样线程停止后才销毁
+        MetricsExporter exporter;
+
         // 初始化硬件监控
         HardwareMonitor monitor;
-        if (!monitor.Initialize()) {
+        if (!replayPath.empty()) {
+            if (!monitor.InitializeReplay(replayPath, replaySpeed)) {
+                std::cerr << "录制文件打开失败: " << replayPath << std::endl;
+                return -1;
+            }
+        } else if (!attachName.empty()) {
+            if (!monitor.InitializeAttach(attachName)) {
+                std::cerr << "共享内存快照总线挂载失败: " << attachName << std::endl;
+                return -1;
+            }
+        } else if (!monitor.Initialize()) {
             std::cerr << "硬件监控初始化失败！" << std::endl;
             return -1;
         }
 
+        if (!recordPath.empty() && !monitor.StartRecording(recordPath)) {
+            std::cerr << "会话录制启动失败: " << recordPath << std::endl;
+            return -1;
+        }
+
+        if (!busName.empty() && !monitor.StartSnapshotBus(busName)) {
+            std::cerr << "共享内存快照总线创建失败: " << busName << std::endl;
+            return -1;
+        }
+
+        if (metricsPort >= 0) {
+            if (!exporter.Start(metricsAddress, static_cast<uint16_t>(metricsPort))) {
+                std::cerr << "指标导出启动失败: " << metricsAddress << ":" << metricsPort << std::endl;
+                return -1;
+            }
+            monitor.AddSnapshotReader(&exporter.GetSnapshotBuffer());
+        }
+
         // 初始化图形界面
         ImGuiApp app("DeepInsight Blackwell - 硬件资源监控", 1280, 720);
         if (!app.Initialize()) {
-            std::cerr << "图形界面初始化失败！" << std::endl;
+            std::cerr << "图形界面初始化失败！没有显示环境时请使用 DeepInsightBlackwellHeadless" << std::endl;
+            return -1;
+        }
+
+        // 每次发布新快照都唤醒界面线程（窗口隐藏或失去焦点时除外）；没有新数据也没有操作时界面线程一直休眠
+        if (!benchmark) {
+            monitor.SetSnapshotListener([&app] { app.Wake(); });
+        }
+        app.SetArchive(&monitor.GetArchive());
+
+        // 启动后台采样线程，采样频率与渲染帧率相互独立
+        if (!monitor.Start()) {
+            std::cerr << "采样线程启动失败！" << std::endl;
             return -1;
         }
 
         // 主循环
+        uint64_t frameCount = 0;
+        std::chrono::steady_clock::duration renderTime{};
         while (!app.ShouldClose()) {
-            // 更新硬件信息
-            monitor.Update();
+            // 等待输入事件或新快照（垂直同步限制交互时的帧率）；基准测试时不等待、每轮都渲染
+            app.WaitEvents(!benchmark);
+
+            // 获取最新的完整快照（无锁，不会等待采样线程）
+            bool updated = false;
+            const HardwareSnapshot& snapshot = monitor.AcquireSnapshot(&updated);
+            if (!benchmark && !app.NeedsFrame(updated)) {
+                continue;
+            }
 
             // 渲染界面
+            auto frameStart = std::chrono::steady_clock::now();
             app.BeginFrame();
-            app.Render(monitor);
+            app.Render(snapshot);
             app.EndFrame();
+            renderTime += std::chrono::steady_clock::now() - frameStart;
+            frameCount++;
+        }
 
-            // 控制更新频率（约60 FPS）
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        if (benchmark && frameCount > 0) {
+            double averageMs = std::chrono::duration<double, std::milli>(renderTime).count() / frameCount;
+            std::cout << "渲染 " << frameCount << " 帧，平均每帧 " << std::fixed << std::setprecision(3)
+                      << averageMs << " ms" << std::endl;
         }
 
-        app.Shutdown();
+        // 先停止采样线程（之后不会再调用 app.Wake），再关闭窗口
         monitor.Shutdown();
+        app.Shutdown();
+        exporter.Stop();
     }
     catch (const std::exception& e) {
         std::cerr << "错误: " << e.what() << std::endl;
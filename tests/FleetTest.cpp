@@ -0,0 +1,515 @@
+#include "TestSupport.h"
+#include "TestData.h"
+#include <cstring>
+#include <limits>
+#include "FleetAggregator.h"
+#include "FleetProtocol.h"
+#include "FleetUplink.h"
+#include "SessionRecorder.h"
+#include "SnapshotDelta.h"
+
+// 差分编码按显示精度量化（见 SessionFormat.cpp 中的 kStep*），解码值与原值的差不超过半个步长
+static void CheckQuantized(const TestHost& expected, const TestHost& decoded) {
+    REQUIRE(decoded.gpus.size() == expected.gpus.size());
+    for (size_t i = 0; i < expected.gpus.size(); i++) {
+        const GPUInfo& a = expected.gpus[i];
+        const GPUInfo& b = decoded.gpus[i];
+        CHECK(b.available == a.available);
+        CHECK_NEAR(b.utilization, a.utilization, 0.5 + 1e-4);
+        CHECK_NEAR(b.memoryUsed, a.memoryUsed, 0.5 + 1e-2);
+        CHECK_NEAR(b.temperature, a.temperature, 0.05 + 1e-4);
+        CHECK_NEAR(b.currentVoltage, a.currentVoltage, 0.0005 + 1e-6);
+        CHECK_NEAR(b.pcieRxThroughput, a.pcieRxThroughput, 0.05 + 1e-3);
+        CHECK_NEAR(b.dataTransferWaitTime, a.dataTransferWaitTime, 0.005 + 1e-5);
+        CHECK(b.gpuClock == a.gpuClock);
+        CHECK(b.powerUsage == a.powerUsage);
+    }
+    REQUIRE(decoded.cpu.coreUtilization.size() == expected.cpu.coreUtilization.size());
+    for (size_t i = 0; i < expected.cpu.coreUtilization.size(); i++) {
+        CHECK_NEAR(decoded.cpu.coreUtilization[i], expected.cpu.coreUtilization[i], 0.5 + 1e-4);
+        CHECK_NEAR(decoded.cpu.coreFrequency[i], expected.cpu.coreFrequency[i], 0.5 + 1e-3);
+    }
+    CHECK_NEAR(decoded.cpu.temperature, expected.cpu.temperature, 0.05 + 1e-4);
+    CHECK_NEAR(decoded.memory.used, expected.memory.used, 0.005 + 1e-4);
+    CHECK_NEAR(decoded.disks[0].realTimeReadBandwidth, expected.disks[0].realTimeReadBandwidth, 0.0005 + 1e-6);
+    CHECK_NEAR(decoded.pressures[1].io.someStall, expected.pressures[1].io.someStall, 0.05 + 1e-4);
+    CHECK_NEAR(decoded.pressures[1].cpu.someAvg10, expected.pressures[1].cpu.someAvg10, 0.005 + 1e-5);
+}
+
+TEST(Fleet, DeltaRoundTripAcrossKeyframes) {
+    TestHost host;
+    MakeInventory(host, 4, 16);
+    SessionState state = host.State();
+    std::mt19937 rng(7);
+
+    TestHost decoded;
+    SessionState decodedState = decoded.State();
+    SnapshotDeltaEncoder encoder;
+    SnapshotDeltaDecoder decoder;
+    std::vector<uint8_t> frame(64 * 1024);
+
+    size_t bytes = encoder.EncodeInventory(state, 0, frame.data(), frame.size());
+    REQUIRE(bytes > 0);
+    DeltaFrameType type;
+    int64_t timestampMs = 0;
+    bool error = false;
+    REQUIRE(decoder.Decode(frame.data(), bytes, decodedState, type, timestampMs, error));
+    CHECK(type == DeltaFrameType::Inventory);
+    CHECK(decoded.gpus[3].uuid == "GPU-1003");
+    CHECK(decoded.cpu.coreUtilization.size() == 16);
+
+    // 跨过两个 Keyframe 周期：第 0、100、200 帧为 Keyframe，其余为 Delta
+    const int frames = 2 * static_cast<int>(SnapshotDeltaEncoder::kKeyframeInterval) + 50;
+    for (int i = 0; i < frames; i++) {
+        MakeSample(host, i, rng);
+        bytes = encoder.EncodeSample(state, 1000 + 100 * i, frame.data(), frame.size());
+        REQUIRE(bytes > 0);
+        bool keyframe = i % SnapshotDeltaEncoder::kKeyframeInterval == 0;
+        CHECK(static_cast<DeltaFrameType>(frame[0]) == (keyframe ? DeltaFrameType::Keyframe : DeltaFrameType::Delta));
+
+        bool frameError = false;
+        CHECK(DeltaFrameSize(frame.data(), bytes, bytes, frameError) == bytes);
+        REQUIRE(decoder.Decode(frame.data(), bytes, decodedState, type, timestampMs, error));
+        CHECK(!error);
+        CHECK(timestampMs == 1000 + 100 * i);
+        CheckQuantized(host, decoded);
+    }
+}
+
+TEST(Fleet, DecoderResyncsAtNextKeyframe) {
+    TestHost host;
+    MakeInventory(host, 2, 4);
+    SessionState state = host.State();
+    std::mt19937 rng(11);
+    SnapshotDeltaEncoder encoder;
+    std::vector<uint8_t> frame(64 * 1024);
+    size_t inventoryBytes = encoder.EncodeInventory(state, 0, frame.data(), frame.size());
+    std::vector<uint8_t> inventory(frame.begin(), frame.begin() + inventoryBytes);
+
+    // 中途加入的解码端：有清单但错过了 Keyframe，Delta 帧被丢弃（不算错误），直到下一个 Keyframe
+    TestHost decoded;
+    SessionState decodedState = decoded.State();
+    SnapshotDeltaDecoder decoder;
+    DeltaFrameType type;
+    int64_t timestampMs = 0;
+    bool error = false;
+    REQUIRE(decoder.Decode(inventory.data(), inventory.size(), decodedState, type, timestampMs, error));
+
+    int firstDecoded = -1;
+    for (int i = 0; i < 150; i++) {
+        MakeSample(host, i, rng);
+        size_t bytes = encoder.EncodeSample(state, 100 * i, frame.data(), frame.size());
+        if (i < 40) {
+            continue;   // 丢失的帧
+        }
+        bool ok = decoder.Decode(frame.data(), bytes, decodedState, type, timestampMs, error);
+        CHECK(!error);
+        if (ok && firstDecoded < 0) {
+            firstDecoded = i;
+        }
+        if (ok) {
+            CheckQuantized(host, decoded);
+        }
+    }
+    CHECK(firstDecoded == static_cast<int>(SnapshotDeltaEncoder::kKeyframeInterval));
+
+    // 设备数量与清单不一致的 Keyframe 是错误，解码端回到未同步状态
+    TestHost other;
+    MakeInventory(other, 3, 4);
+    MakeSample(other, 0, rng);
+    SnapshotDeltaEncoder otherEncoder;
+    size_t bytes = otherEncoder.EncodeSample(other.State(), 0, frame.data(), frame.size());
+    CHECK(!decoder.Decode(frame.data(), bytes, decodedState, type, timestampMs, error));
+    CHECK(error);
+}
+
+// 同名的两个连接：解码状态属于最新的连接，旧连接的帧不会与新连接的差分帧交错解码
+TEST(Fleet, NewestConnectionOwnsNode) {
+    TestHost host;
+    MakeInventory(host, 2, 4);
+    std::mt19937 rng(13);
+    std::vector<uint8_t> frame(64 * 1024);
+    FleetStore store;
+
+    SnapshotDeltaEncoder oldEncoder;
+    uint64_t oldConnection = store.Connect("node-x", "10.0.0.1", kFleetEncodingDelta);
+    MakeSample(host, 0, rng);
+    size_t bytes = oldEncoder.EncodeInventory(host.State(), 0, frame.data(), frame.size());
+    REQUIRE(store.Apply("node-x", oldConnection, frame.data(), bytes));
+    bytes = oldEncoder.EncodeSample(host.State(), 100, frame.data(), frame.size());
+    REQUIRE(store.Apply("node-x", oldConnection, frame.data(), bytes));
+
+    SnapshotDeltaEncoder newEncoder;
+    uint64_t newConnection = store.Connect("node-x", "10.0.0.2", kFleetEncodingDelta);
+    CHECK(newConnection != oldConnection);
+    bytes = newEncoder.EncodeInventory(host.State(), 0, frame.data(), frame.size());
+    REQUIRE(store.Apply("node-x", newConnection, frame.data(), bytes));
+
+    for (int i = 1; i < 20; i++) {
+        MakeSample(host, i, rng);
+        bytes = newEncoder.EncodeSample(host.State(), 100 * i, frame.data(), frame.size());
+        CHECK(store.Apply("node-x", newConnection, frame.data(), bytes));
+        bytes = oldEncoder.EncodeSample(host.State(), 100 * i + 1, frame.data(), frame.size());
+        CHECK(!store.Apply("node-x", oldConnection, frame.data(), bytes));
+    }
+
+    // 旧连接断开不影响新连接
+    store.Disconnect("node-x", oldConnection);
+    bool checked = false;
+    store.ForEachNode([&](const FleetNode& node) {
+        checked = true;
+        CHECK(node.connection == newConnection);
+        CHECK(node.address == "10.0.0.2");
+        CHECK(node.samples == 20);
+        CHECK(node.decodeErrors == 0);
+        CHECK_NEAR(node.gpus[1].utilization, host.gpus[1].utilization, 0.5 + 1e-4);
+    });
+    CHECK(checked);
+    store.Disconnect("node-x", newConnection);
+    store.ForEachNode([&](const FleetNode& node) { CHECK(node.connection == 0); });
+}
+
+// ===== 本机回环：汇总服务 + 两个节点 =====
+
+static void PublishHost(FleetUplink& uplink, uint64_t sequence, const TestHost& host) {
+    HardwareSnapshot& snapshot = uplink.GetSnapshotBuffer().WriteBuffer();
+    snapshot.sequence = sequence;
+    snapshot.inventoryVersion = 1;
+    snapshot.gpus = host.gpus;
+    snapshot.cpu = host.cpu;
+    snapshot.memory = host.memory;
+    snapshot.bandwidth = host.bandwidth;
+    snapshot.disks = host.disks;
+    snapshot.pressures = host.pressures;
+    uplink.GetSnapshotBuffer().Publish();
+}
+
+struct NodeStatus {
+    bool found = false;
+    bool connected = false;
+    uint64_t samples = 0;
+    uint64_t decodeErrors = 0;
+    float utilization = 0.0f;
+};
+
+static NodeStatus GetNode(const FleetAggregator& aggregator, const std::string& name) {
+    NodeStatus status;
+    aggregator.GetStore().ForEachNode([&](const FleetNode& node) {
+        if (node.name == name) {
+            status.found = true;
+            status.connected = node.connection != 0;
+            status.samples = node.samples;
+            status.decodeErrors = node.decodeErrors;
+            status.utilization = node.gpus.empty() ? 0.0f : node.gpus[0].utilization;
+        }
+    });
+    return status;
+}
+
+// 发布一个样本并等待汇总服务收到（上报线程每 20ms 取一次最新快照，不等待会被下一个样本覆盖）
+static bool SendAndWait(FleetAggregator& aggregator, FleetUplink& uplink, uint64_t& sequence, TestHost& host) {
+    uint64_t before = GetNode(aggregator, uplink.GetNodeName()).samples;
+    PublishHost(uplink, ++sequence, host);
+    return WaitUntil([&] { return GetNode(aggregator, uplink.GetNodeName()).samples > before; }, 5000);
+}
+
+TEST(Fleet, LoopbackTwoNodes) {
+    FleetAggregator aggregator;
+    REQUIRE(aggregator.Start("127.0.0.1", 0, 0, 2));
+
+    FleetUplink uplinkA;
+    FleetUplink uplinkB;
+    REQUIRE(uplinkA.Start("127.0.0.1", aggregator.GetIngestPort(), "node-a"));
+    REQUIRE(uplinkB.Start("127.0.0.1", aggregator.GetIngestPort(), "node-b"));
+    REQUIRE(WaitUntil([&] { return uplinkA.IsConnected() && uplinkB.IsConnected(); }, 5000));
+    CHECK(uplinkA.GetEncoding() == kFleetEncodingDelta);
+
+    TestHost hostA;
+    TestHost hostB;
+    MakeInventory(hostA, 2, 8);
+    MakeInventory(hostB, 4, 8);
+    std::mt19937 rng(3);
+    uint64_t sequenceA = 0;
+    uint64_t sequenceB = 0;
+    for (int i = 0; i < 5; i++) {
+        MakeSample(hostA, i, rng);
+        MakeSample(hostB, i + 100, rng);
+        REQUIRE(SendAndWait(aggregator, uplinkA, sequenceA, hostA));
+        REQUIRE(SendAndWait(aggregator, uplinkB, sequenceB, hostB));
+    }
+    hostA.gpus[0].utilization = 42.0f;
+    REQUIRE(SendAndWait(aggregator, uplinkA, sequenceA, hostA));
+
+    int status = 0;
+    std::string fleet = HttpGet(aggregator.GetHttpPort(), "/fleet", &status);
+    CHECK(status == 200);
+    CHECK(fleet.find("\"gpu_count\":6,") != std::string::npos);
+    size_t nodeA = fleet.find("{\"name\":\"node-a\",\"address\":\"127.0.0.1");
+    size_t nodeB = fleet.find("{\"name\":\"node-b\",\"address\":\"127.0.0.1");
+    REQUIRE(nodeA != std::string::npos && nodeB != std::string::npos);
+    CHECK(nodeA < nodeB);
+    CHECK(fleet.find("\"connected\":true", nodeA) < nodeB);
+    CHECK(fleet.find("{\"name\":\"NVIDIA B200\",\"utilization\":42.00,", nodeA) < nodeB);
+
+    // 强制重连：新连接重新发送清单，解码端重置后从第一个 Keyframe 开始同步
+    uplinkA.Stop();
+    REQUIRE(WaitUntil([&] { return !GetNode(aggregator, "node-a").connected; }, 5000));
+    CHECK(HttpGet(aggregator.GetHttpPort(), "/fleet").find("\"gpu_count\":4,") != std::string::npos);
+    REQUIRE(uplinkA.Start("127.0.0.1", aggregator.GetIngestPort(), "node-a"));
+    REQUIRE(WaitUntil([&] { return uplinkA.IsConnected(); }, 5000));
+    hostA.gpus[0].utilization = 77.0f;
+    REQUIRE(SendAndWait(aggregator, uplinkA, sequenceA, hostA));
+    for (int i = 0; i < 3; i++) {
+        MakeSample(hostA, 200 + i, rng);
+        REQUIRE(SendAndWait(aggregator, uplinkA, sequenceA, hostA));
+    }
+
+    NodeStatus a = GetNode(aggregator, "node-a");
+    CHECK(a.connected);
+    CHECK(a.decodeErrors == 0);
+    CHECK(a.samples == 10);
+    CHECK(a.utilization == hostA.gpus[0].utilization);
+    CHECK(GetNode(aggregator, "node-b").decodeErrors == 0);
+    fleet = HttpGet(aggregator.GetHttpPort(), "/fleet");
+    CHECK(fleet.find("\"gpu_count\":6,") != std::string::npos);
+
+    uplinkA.Stop();
+    uplinkB.Stop();
+    aggregator.Stop();
+}
+
+// 连接上报端口并完成握手，返回套接字（连接被拒绝或关闭时为 kInvalidSocket），encoding 为汇总服务选定的编码
+static SocketHandle OpenIngest(uint16_t port, const std::string& name, uint32_t encodings, uint32_t schemaId,
+                               uint32_t& encoding) {
+    encoding = 0;
+    SocketHandle socket = ConnectTcp("127.0.0.1", port);
+    if (socket == kInvalidSocket) {
+        return kInvalidSocket;
+    }
+    SetSocketTimeout(socket, 5000);
+    std::vector<uint8_t> hello(sizeof(FleetHello) + name.size());
+    FleetHello header{};
+    std::memcpy(header.magic, kFleetMagic, sizeof(header.magic));
+    header.version = kFleetVersion;
+    header.nameLength = static_cast<uint32_t>(name.size());
+    header.encodings = encodings;
+    header.schemaId = schemaId;
+    std::memcpy(hello.data(), &header, sizeof(header));
+    std::memcpy(hello.data() + sizeof(header), name.data(), name.size());
+    FleetAccept accept{};
+    if (!SendAll(socket, hello.data(), hello.size()) ||
+        ReceiveSome(socket, &accept, sizeof(accept)) != static_cast<ptrdiff_t>(sizeof(accept))) {
+        CloseSocket(socket);
+        return kInvalidSocket;
+    }
+    encoding = accept.encoding;
+    return socket;
+}
+
+// 发送握手并读取汇总服务的回复，返回选定的编码（连接被拒绝或关闭时为 0）
+static uint32_t Handshake(uint16_t port, uint32_t encodings, uint32_t schemaId) {
+    uint32_t encoding = 0;
+    SocketHandle socket = OpenIngest(port, "schema-test", encodings, schemaId, encoding);
+    if (socket != kInvalidSocket) {
+        CloseSocket(socket);
+    }
+    return encoding;
+}
+
+TEST(Fleet, SchemaMismatchRejectsDelta) {
+    FleetAggregator aggregator;
+    REQUIRE(aggregator.Start("127.0.0.1", 0, 0, 1));
+    uint16_t port = aggregator.GetIngestPort();
+    uint32_t schemaId = SampleSchemaId();
+
+    CHECK(Handshake(port, kFleetEncodingRecords | kFleetEncodingDelta, schemaId) == kFleetEncodingDelta);
+    // 样本字段布局不一致：不使用差分编码，退回完整记录；只支持差分编码的节点被拒绝
+    CHECK(Handshake(port, kFleetEncodingRecords | kFleetEncodingDelta, schemaId + 1) == kFleetEncodingRecords);
+    CHECK(Handshake(port, kFleetEncodingDelta, schemaId + 1) == 0);
+    aggregator.Stop();
+}
+
+// 只检查语法的 JSON 解析（不构建值）：数字必须符合 JSON 的数字语法，nan/inf 之类的裸词不合法
+class JsonChecker {
+public:
+    explicit JsonChecker(const std::string& text) : text_(text) {}
+
+    bool Check() {
+        SkipSpace();
+        if (!Value()) {
+            return false;
+        }
+        SkipSpace();
+        return pos_ == text_.size();
+    }
+
+private:
+    bool Value() {
+        SkipSpace();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        char c = text_[pos_];
+        if (c == '{') {
+            return Container('}', true);
+        }
+        if (c == '[') {
+            return Container(']', false);
+        }
+        if (c == '"') {
+            return String();
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return Number();
+        }
+        return Literal("true") || Literal("false") || Literal("null");
+    }
+
+    bool Container(char close, bool object) {
+        pos_++;
+        SkipSpace();
+        if (Peek(close)) {
+            pos_++;
+            return true;
+        }
+        while (true) {
+            if (object) {
+                SkipSpace();
+                if (!String()) {
+                    return false;
+                }
+                SkipSpace();
+                if (!Peek(':')) {
+                    return false;
+                }
+                pos_++;
+            }
+            if (!Value()) {
+                return false;
+            }
+            SkipSpace();
+            if (Peek(close)) {
+                pos_++;
+                return true;
+            }
+            if (!Peek(',')) {
+                return false;
+            }
+            pos_++;
+        }
+    }
+
+    bool String() {
+        if (!Peek('"')) {
+            return false;
+        }
+        for (pos_++; pos_ < text_.size(); pos_++) {
+            char c = text_[pos_];
+            if (c == '"') {
+                pos_++;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;
+            }
+            if (c == '\\') {
+                pos_++;
+            }
+        }
+        return false;
+    }
+
+    bool Number() {
+        size_t start = pos_;
+        if (Peek('-')) {
+            pos_++;
+        }
+        if (Digits() == 0) {
+            return false;
+        }
+        if (Peek('.')) {
+            pos_++;
+            if (Digits() == 0) {
+                return false;
+            }
+        }
+        if (Peek('e') || Peek('E')) {
+            pos_++;
+            if (Peek('+') || Peek('-')) {
+                pos_++;
+            }
+            if (Digits() == 0) {
+                return false;
+            }
+        }
+        return pos_ > start;
+    }
+
+    size_t Digits() {
+        size_t start = pos_;
+        while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+            pos_++;
+        }
+        return pos_ - start;
+    }
+
+    bool Literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (text_.compare(pos_, length, word) != 0) {
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    bool Peek(char c) const { return pos_ < text_.size() && text_[pos_] == c; }
+
+    void SkipSpace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\t' ||
+                                       text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+TEST(Fleet, NonFiniteValuesRenderAsNull) {
+    FleetAggregator aggregator;
+    REQUIRE(aggregator.Start("127.0.0.1", 0, 0, 1));
+
+    // 完整记录编码保存原始浮点数：传感器读数异常时的 NaN/Inf 会原样到达汇总服务
+    uint32_t encoding = 0;
+    SocketHandle socket = OpenIngest(aggregator.GetIngestPort(), "node-sensor", kFleetEncodingRecords,
+                                     SampleSchemaId(), encoding);
+    REQUIRE(socket != kInvalidSocket);
+    CHECK(encoding == kFleetEncodingRecords);
+
+    TestHost host;
+    MakeInventory(host, 2, 4);
+    std::mt19937 rng(5);
+    MakeSample(host, 0, rng);
+    host.gpus[0].temperature = std::numeric_limits<float>::quiet_NaN();
+    host.gpus[1].utilization = std::numeric_limits<float>::infinity();
+    std::vector<uint8_t> buffer(SessionRecorder::kMaxRecordBytes * 2);
+    size_t bytes = EncodeSessionRecord(SessionRecordType::Inventory, 0, host.State(), buffer.data(), buffer.size());
+    REQUIRE(bytes > 0);
+    size_t sampleBytes = EncodeSessionRecord(SessionRecordType::Sample, 100, host.State(), buffer.data() + bytes,
+                                             buffer.size() - bytes);
+    REQUIRE(sampleBytes > 0);
+    REQUIRE(SendAll(socket, buffer.data(), bytes + sampleBytes));
+    REQUIRE(WaitUntil([&] { return GetNode(aggregator, "node-sensor").samples == 1; }, 5000));
+
+    int status = 0;
+    std::string fleet = HttpGet(aggregator.GetHttpPort(), "/fleet", &status);
+    CHECK(status == 200);
+    CHECK(JsonChecker(fleet).Check());
+    CHECK(fleet.find("nan") == std::string::npos);
+    CHECK(fleet.find("inf") == std::string::npos);
+    CHECK(fleet.find("\"temperature\":null") != std::string::npos);
+    CHECK(fleet.find("\"utilization\":null") != std::string::npos);
+
+    CloseSocket(socket);
+    aggregator.Stop();
+}
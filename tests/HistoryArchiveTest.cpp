@@ -0,0 +1,227 @@
+#include "TestSupport.h"
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+#include "CompressedBlock.h"
+#include "HistoryArchive.h"
+
+static uint32_t Bits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// 把 samples 依次写入块直到写满，返回写入的个数；解码结果应与写入的样本逐位相同
+static size_t FillAndCompare(const std::vector<ArchiveSample>& samples) {
+    CompressedBlock block;
+    size_t written = 0;
+    while (written < samples.size() && block.Append(samples[written].timestampMs, samples[written].value)) {
+        written++;
+    }
+    CHECK(block.Count() == written);
+    CHECK(block.BitsUsed() <= CompressedBlock::kWords * 64);
+    if (written == 0) {
+        return 0;
+    }
+    CHECK(block.FirstTimestamp() == samples[0].timestampMs);
+    CHECK(block.LastTimestamp() == samples[written - 1].timestampMs);
+
+    std::vector<ArchiveSample> decoded(written);
+    CHECK(block.Decode(decoded.data()) == written);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < written; i++) {
+        if (decoded[i].timestampMs != samples[i].timestampMs || Bits(decoded[i].value) != Bits(samples[i].value)) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+    return written;
+}
+
+TEST(HistoryArchive, BlockRoundTripRandomValues) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint32_t> anyBits;
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::normal_distribution<float> noise(0.0f, 3.0f);
+
+    // 任意位模式（包括 NaN、Inf、非规格化数、-0）、重复值和带噪声的慢变值混合，按位还原
+    for (int round = 0; round < 20; round++) {
+        std::vector<ArchiveSample> samples;
+        int64_t timestamp = 1000 + round;
+        float value = 50.0f;
+        for (int i = 0; i < 5000; i++) {
+            switch (kind(rng)) {
+            case 0: {
+                uint32_t bits = anyBits(rng);
+                std::memcpy(&value, &bits, sizeof(value));
+                break;
+            }
+            case 1: value = std::numeric_limits<float>::quiet_NaN(); break;
+            case 2: value = -std::numeric_limits<float>::infinity(); break;
+            case 3: value = std::numeric_limits<float>::denorm_min(); break;
+            case 4: value = -0.0f; break;
+            case 5: case 6: break;   // 与上一个值相同
+            default: value = 50.0f + noise(rng); break;
+            }
+            samples.push_back(ArchiveSample{timestamp, value});
+            timestamp += 100;
+        }
+        CHECK(FillAndCompare(samples) > 300);
+    }
+}
+
+TEST(HistoryArchive, BlockRoundTripIrregularTimestamps) {
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> jitter(-3, 3);
+    std::uniform_int_distribution<int> gap(0, 49);
+    std::uniform_int_distribution<int64_t> longGap(3000, 2000000000);
+
+    // 采样抖动、漏掉的周期和长时间停顿覆盖时间戳编码的每一档（1 bit、7/9/12 bit 和 32 bit）
+    std::vector<ArchiveSample> samples;
+    int64_t timestamp = -5000;
+    for (int i = 0; i < 3000; i++) {
+        samples.push_back(ArchiveSample{timestamp, static_cast<float>(i % 17)});
+        int g = gap(rng);
+        int64_t step = g == 0 ? longGap(rng) : g < 5 ? 100 * (1 + g) : g < 10 ? 100 + 30 * jitter(rng) : 100;
+        timestamp += step + (g >= 10 ? jitter(rng) : 0);
+    }
+    size_t written = FillAndCompare(samples);
+    CHECK(written > 100);
+
+    // 刚好写满：最后一次 Append 失败时块内容不变
+    CompressedBlock block;
+    size_t count = 0;
+    int64_t t = 0;
+    while (block.Append(t, static_cast<float>(count) * 1.5f)) {
+        count++;
+        t += 100 + static_cast<int64_t>(count % 7);
+    }
+    size_t bits = block.BitsUsed();
+    CHECK(!block.Append(t, 1.0f));
+    CHECK(block.BitsUsed() == bits);
+    CHECK(block.Count() == count);
+    std::vector<ArchiveSample> decoded(count);
+    REQUIRE(block.Decode(decoded.data()) == count);
+    CHECK(decoded[count - 1].value == static_cast<float>(count - 1) * 1.5f);
+}
+
+TEST(HistoryArchive, BlockRejectsUnencodableTimestamps) {
+    CompressedBlock block;
+    CHECK(block.Append(1000, 1.0f));
+    CHECK(block.Append(1100, 2.0f));
+    // 时间倒退、差值的差值超出 32 位：需要换新块，已有内容不受影响
+    CHECK(!block.Append(1099, 3.0f));
+    CHECK(!block.Append(1100 + (int64_t(1) << 33), 3.0f));
+    CHECK(block.Count() == 2);
+    CHECK(block.Append(1200, 3.0f));
+    ArchiveSample decoded[3];
+    REQUIRE(block.Decode(decoded) == 3);
+    CHECK(decoded[2].timestampMs == 1200);
+    CHECK(decoded[2].value == 3.0f);
+
+    CompressedBlock empty;
+    CHECK(empty.Empty());
+    CHECK(empty.Decode(decoded) == 0);
+}
+
+// 逐行写入 rows 行：指标 0 为慢变整数，指标 1 为噪声，第 t 行的时间戳为 t * 100ms
+static void AppendRows(HistoryArchive& archive, SeriesStore& store, MetricId a, MetricId b, int from, int to) {
+    for (int row = from; row < to; row++) {
+        store.Set(a, static_cast<float>(row / 10));
+        store.Set(b, static_cast<float>((row * 2654435761u) % 1000) / 7.0f);
+        HistoryArchive::Clock::time_point t = archive.ToTimePoint(int64_t(row) * 100);
+        store.Append(t);
+        archive.AppendRow(t, store);
+    }
+}
+
+TEST(HistoryArchive, ReadReturnsExactRange) {
+    SeriesStore store;
+    MetricId a = store.Register("a", "");
+    MetricId b = store.Register("b", "");
+    HistoryArchive archive;
+    AppendRows(archive, store, a, b, 0, 20000);
+    CHECK(archive.GetSampleCount() == 40000);
+
+    // 跨越多个封存块和正在写入的块
+    std::vector<ArchiveSample> out;
+    size_t count = archive.Read(b, archive.ToTimePoint(150), archive.ToTimePoint(1999900), out);
+    REQUIRE(count == 19999 - 1);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        int row = static_cast<int>(i) + 2;
+        float expected = static_cast<float>((row * 2654435761u) % 1000) / 7.0f;
+        if (out[i].timestampMs != int64_t(row) * 100 || out[i].value != expected) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    out.clear();
+    CHECK(archive.Read(a, archive.ToTimePoint(5000), archive.ToTimePoint(5000), out) == 1);
+    CHECK(out[0].value == 5.0f);
+    out.clear();
+    CHECK(archive.Read(a, archive.ToTimePoint(-1000), archive.ToTimePoint(-1), out) == 0);
+    CHECK(archive.Read(99, archive.ToTimePoint(0), archive.ToTimePoint(1000000), out) == 0);
+    CHECK(archive.Covers(a, archive.ToTimePoint(0)));
+    CHECK(!archive.Covers(99, archive.ToTimePoint(0)));
+}
+
+TEST(HistoryArchive, EvictsOldestBlocksWithinBudget) {
+    SeriesStore store;
+    MetricId a = store.Register("a", "");
+    MetricId b = store.Register("b", "");
+    const size_t maxBlocks = 6;
+    HistoryArchive archive(maxBlocks * sizeof(CompressedBlock));
+    AppendRows(archive, store, a, b, 0, 50000);
+
+    // 内存是硬上限；淘汰后最旧的样本不再保留，最近的样本完整保留
+    CHECK(archive.GetMemoryBytes() <= maxBlocks * sizeof(CompressedBlock));
+    CHECK(archive.GetSampleCount() < 100000);
+    CHECK(!archive.Covers(b, archive.ToTimePoint(0)));
+    CHECK(archive.Covers(b, archive.ToTimePoint(4999000)));
+
+    std::vector<ArchiveSample> out;
+    archive.Read(b, archive.ToTimePoint(0), archive.ToTimePoint(5000000), out);
+    REQUIRE(!out.empty());
+    CHECK(out.back().timestampMs == 4999900);
+    CHECK(out.front().timestampMs > 0);
+    bool contiguous = true;
+    for (size_t i = 1; i < out.size(); i++) {
+        contiguous = contiguous && out[i].timestampMs == out[i - 1].timestampMs + 100;
+    }
+    CHECK(contiguous);
+}
+
+TEST(HistoryArchive, ReadWhileAppending) {
+    SeriesStore store;
+    MetricId a = store.Register("a", "");
+    MetricId b = store.Register("b", "");
+    HistoryArchive archive(8 * sizeof(CompressedBlock));
+    AppendRows(archive, store, a, b, 0, 1000);
+
+    // 读取方在锁外解码它复制的块引用，同时写入方封存新块并淘汰旧块
+    std::atomic<bool> done{false};
+    std::atomic<int> badReads{0};
+    std::thread reader([&] {
+        std::vector<ArchiveSample> out;
+        while (!done.load()) {
+            out.clear();
+            archive.Read(a, archive.ToTimePoint(0), archive.ToTimePoint(int64_t(10000000000)), out);
+            for (size_t i = 1; i < out.size(); i++) {
+                if (out[i].timestampMs != out[i - 1].timestampMs + 100 ||
+                    out[i].value != static_cast<float>(out[i].timestampMs / 1000)) {
+                    badReads++;
+                    break;
+                }
+            }
+        }
+    });
+    AppendRows(archive, store, a, b, 1000, 60000);
+    done.store(true);
+    reader.join();
+    CHECK(badReads.load() == 0);
+}
@@ -0,0 +1,254 @@
+#include "TestSupport.h"
+
+#ifdef __linux__
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include "HostCollector.h"
+
+// 样例目录树（tests/fixtures/linux-host）的可写副本，与 --host-root 指向的目录结构相同：
+// 采集后端常开计数器文件并用 pread 重读，因此第二次采样前就地改写文件内容（保持同一个 inode）
+struct HostRoot {
+    std::string path;
+
+    HostRoot() {
+        path = MakeTempDirectory("deepinsight-host");
+        std::filesystem::copy(TEST_FIXTURE_DIR "/linux-host", path, std::filesystem::copy_options::recursive);
+    }
+    ~HostRoot() { RemoveDirectory(path); }
+
+    void Write(const std::string& relative, const std::string& text) const {
+        std::ofstream file(path + relative, std::ios::trunc);
+        file << text;
+    }
+};
+
+// 两次采样之间的间隔落在 [earliest, latest] 之内：速率的期望值按这两个间隔给出上下界
+struct SampleWindow {
+    double earliest = 0.0;
+    double latest = 0.0;
+
+    void CheckRate(double rate, double delta) const {
+        CHECK(rate >= delta / latest * 0.999);
+        CHECK(rate <= delta / earliest * 1.001);
+    }
+};
+
+struct CollectedHost {
+    CPUInfo cpu;
+    MemoryInfo memory;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;
+
+    void Update(HostCollector& collector) {
+        collector.UpdateCPU(cpu);
+        collector.UpdateCPUThermal(cpu);
+        collector.UpdateMemory(memory);
+        collector.UpdateDisks(disks);
+        collector.UpdatePressure(pressures);
+    }
+};
+
+// 第一次采样、改写计数器、第二次采样，返回两次采样间隔的上下界
+template <typename Advance>
+static SampleWindow SampleTwice(HostCollector& collector, CollectedHost& host, Advance advance) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point t0 = Clock::now();
+    host.Update(collector);
+    Clock::time_point t1 = Clock::now();
+    advance();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    Clock::time_point t2 = Clock::now();
+    host.Update(collector);
+    Clock::time_point t3 = Clock::now();
+    SampleWindow window;
+    window.earliest = std::chrono::duration<double>(t2 - t1).count();
+    window.latest = std::chrono::duration<double>(t3 - t0).count();
+    return window;
+}
+
+// 计数器在两次采样之间的变化
+static void AdvanceCounters(const HostRoot& root) {
+    // 每个逻辑 CPU 100 个时钟周期：cpu0 忙 75，cpu1 空闲（含 iowait），cpu2 忙 50，cpu3 全忙
+    root.Write("proc/stat",
+               "cpu  1180 0 545 8160 115 0 0 0 0 0\n"
+               "cpu0 310 0 140 2020 30 0 0 0 0 0\n"
+               "cpu1 250 0 125 2090 35 0 0 0 0 0\n"
+               "cpu2 290 0 135 2050 25 0 0 0 0 0\n"
+               "cpu3 330 0 145 2000 25 0 0 0 0 0\n"
+               "intr 123999 0 0 0\n");
+    // 核心计数只读每个物理核心的第一个线程，插槽计数只读插槽的第一个 CPU：兄弟线程上的变化不应重复计入
+    root.Write("sys/devices/system/cpu/cpu0/thermal_throttle/core_throttle_count", "13\n");
+    root.Write("sys/devices/system/cpu/cpu2/thermal_throttle/core_throttle_count", "13\n");
+    for (int i = 0; i < 4; i++) {
+        root.Write("sys/devices/system/cpu/cpu" + std::to_string(i) + "/thermal_throttle/package_throttle_count",
+                   "104\n");
+    }
+    root.Write("sys/devices/system/cpu/cpu3/cpufreq/scaling_cur_freq", "1900000\n");
+    root.Write("sys/class/hwmon/hwmon1/temp3_input", "72000\n");
+    // pgpgin/pgpgout 单位为 KB，pswpin/pswpout 单位为页
+    root.Write("proc/vmstat",
+               "nr_free_pages 524000\n"
+               "nr_dirty 5200\n"
+               "nr_writeback 256\n"
+               "pgpgin 1102400\n"
+               "pgpgout 2051200\n"
+               "pswpin 2660\n"
+               "pswpout 200\n"
+               "pgalloc_normal 7100000\n"
+               "pgfault 9100000\n"
+               "pgmajfault 5300\n");
+    // nvme0n1 读 1 GiB、写 0.5 GiB，sda 写 10 MiB；分区和 loop 设备的变化不计入
+    root.Write("proc/diskstats",
+               "   7       0 loop0 60 0 99999 10 0 0 0 0 0 20 10 0 0 0 0\n"
+               " 259       0 nvme0n1 12000 0 6097152 5200 21000 0 9048576 9300 0 10200 14500 0 0 0 0\n"
+               " 259       1 nvme0n1p1 11000 0 5997152 5100 20000 0 8948576 9200 0 10100 14300 0 0 0 0\n"
+               "   8       0 sda 100 0 8000 50 260 0 36480 130 0 180 180 0 0 0 0\n");
+    root.Write("proc/pressure/cpu",
+               "some avg10=2.50 avg60=1.00 avg300=0.25 total=1020000\n"
+               "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    root.Write("proc/pressure/io",
+               "some avg10=20.00 avg60=9.00 avg300=3.50 total=5100000\n"
+               "full avg10=15.00 avg60=7.00 avg300=2.50 total=4060000\n");
+    // cgroup 的累计停顿超过墙钟时间（计数在两次读取之间跳变）：停顿占比截断为 100%
+    root.Write("sys/fs/cgroup/system.slice/train.service/cpu.pressure",
+               "some avg10=5.00 avg60=2.50 avg300=1.10 total=310000\n"
+               "full avg10=3.50 avg60=1.60 avg300=0.55 total=255000\n");
+    root.Write("sys/fs/cgroup/system.slice/train.service/io.pressure",
+               "some avg10=90.00 avg60=40.00 avg300=10.00 total=99000000\n"
+               "full avg10=80.00 avg60=30.00 avg300=8.00 total=0\n");
+}
+
+TEST(LinuxHostCollector, ParsesFixtureTree) {
+    HostRoot root;
+    std::unique_ptr<HostCollector> collector = CreateHostCollector(root.path, "");
+    REQUIRE(collector->Initialize());
+    CollectedHost host;
+
+    // 拓扑：按插槽、物理核心、编号排序，离线的 cpu4 没有 topology 目录不在清单中
+    REQUIRE(collector->UpdateCPUTopology(host.cpu));
+    REQUIRE(host.cpu.logicalCpus.size() == 4);
+    const unsigned int expectedIds[] = {0, 2, 1, 3};
+    for (size_t i = 0; i < 4; i++) {
+        CHECK(host.cpu.logicalCpus[i].id == expectedIds[i]);
+        CHECK(host.cpu.logicalCpus[i].core == (i < 2 ? 0u : 1u));
+        CHECK(host.cpu.logicalCpus[i].thread == i % 2);
+        CHECK(host.cpu.logicalCpus[i].maxFrequency == 3800.0f);
+    }
+
+    SampleWindow window = SampleTwice(*collector, host, [&] { AdvanceCounters(root); });
+
+    // CPU 利用率（iowait 算作空闲）
+    CHECK_NEAR(host.cpu.utilization, 56.25, 1e-3);
+    CHECK_NEAR(host.cpu.coreUtilization[0], 75.0, 1e-3);
+    CHECK_NEAR(host.cpu.coreUtilization[1], 50.0, 1e-3);
+    CHECK_NEAR(host.cpu.coreUtilization[2], 0.0, 1e-3);
+    CHECK_NEAR(host.cpu.coreUtilization[3], 100.0, 1e-3);
+
+    // cpufreq 单位为 kHz，按清单顺序；平均频率取第二次读取的值
+    CHECK(host.cpu.coreFrequency[0] == 3000.0f);
+    CHECK(host.cpu.coreFrequency[1] == 3500.0f);
+    CHECK(host.cpu.coreFrequency[2] == 2000.0f);
+    CHECK(host.cpu.coreFrequency[3] == 1900.0f);
+    CHECK_NEAR(host.cpu.frequency, 2600.0, 1e-3);
+
+    // coretemp 的插槽温度和最高核心温度，nvme 的 hwmon 不计入
+    CHECK(host.cpu.temperature == 65.0f);
+    CHECK(host.cpu.maxCoreTemperature == 72.0f);
+    // 核心计数 +3（cpu0），插槽计数 +4（cpu0）
+    window.CheckRate(host.cpu.throttleRate, 7.0);
+
+    // meminfo：16 GB 中可用 12 GB
+    CHECK_NEAR(host.memory.total, 16.0, 1e-4);
+    CHECK_NEAR(host.memory.available, 12.0, 1e-4);
+    CHECK_NEAR(host.memory.used, 4.0, 1e-4);
+    CHECK_NEAR(host.memory.percent, 25.0, 1e-3);
+    CHECK_NEAR(host.memory.dirty, 20.0, 1e-4);
+    CHECK_NEAR(host.memory.writeback, 1.0, 1e-4);
+
+    // vmstat：换入 100 MB、换出 50 MB，换入交换区 2560 页，主缺页 300 次
+    double pageMb = static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+    window.CheckRate(host.memory.pageInRate, 100.0);
+    window.CheckRate(host.memory.pageOutRate, 50.0);
+    window.CheckRate(host.memory.swapInRate, 2560.0 * pageMb);
+    CHECK(host.memory.swapOutRate == 0.0f);
+    window.CheckRate(host.memory.majorFaultRate, 300.0);
+
+    // 磁盘清单来自 /sys/block 中有 device 的设备，型号去掉末尾空白
+    REQUIRE(host.disks.size() == 2);
+    const DiskInfo& nvme = host.disks[0];
+    const DiskInfo& sda = host.disks[1];
+    CHECK(nvme.name == "nvme0n1");
+    CHECK(nvme.type == "NVMe");
+    CHECK(nvme.model == "Samsung PM1743");
+    CHECK_NEAR(nvme.totalSize, 2000000000.0 * 512.0 / (1024.0 * 1024.0 * 1024.0), 0.01);
+    CHECK(sda.name == "sda");
+    CHECK(sda.type == "HDD");
+    CHECK(sda.model == "ST4000NM0035-1V4107");
+    window.CheckRate(nvme.realTimeReadBandwidth, 1.0);
+    window.CheckRate(nvme.realTimeWriteBandwidth, 0.5);
+    CHECK(sda.realTimeReadBandwidth == 0.0f);
+    window.CheckRate(sda.realTimeWriteBandwidth, 10.0 / 1024.0);
+
+    // PSI：系统范围和 /proc/self/cgroup 中的 cgroup（没有 memory.pressure）
+    REQUIRE(host.pressures.size() == 2);
+    const PressureInfo& system = host.pressures[0];
+    const PressureInfo& cgroup = host.pressures[1];
+    CHECK(system.scope == "system");
+    CHECK(cgroup.scope == "/system.slice/train.service");
+    CHECK_NEAR(system.cpu.someAvg10, 2.5, 1e-5);
+    CHECK_NEAR(system.io.someAvg10, 20.0, 1e-5);
+    CHECK_NEAR(system.io.fullAvg10, 15.0, 1e-5);
+    CHECK_NEAR(system.memory.someAvg10, 0.25, 1e-5);
+    // 停顿占比 = total 的差值 (µs) / 墙钟时间 × 100
+    window.CheckRate(system.cpu.someStall, 20000.0 * 1e-6 * 100.0);
+    CHECK(system.cpu.fullStall == 0.0f);
+    window.CheckRate(system.io.someStall, 100000.0 * 1e-6 * 100.0);
+    window.CheckRate(system.io.fullStall, 60000.0 * 1e-6 * 100.0);
+    CHECK(system.memory.someStall == 0.0f);
+    window.CheckRate(cgroup.cpu.someStall, 10000.0 * 1e-6 * 100.0);
+    window.CheckRate(cgroup.cpu.fullStall, 5000.0 * 1e-6 * 100.0);
+    CHECK(cgroup.io.someStall == 100.0f);
+    CHECK(cgroup.io.fullStall == 0.0f);   // 计数回绕按 0 计
+    CHECK(cgroup.memory.someAvg10 == 0.0f);
+    CHECK(cgroup.memory.someStall == 0.0f);
+    collector->Shutdown();
+}
+
+TEST(LinuxHostCollector, FallsBackWithoutHwmonAndCpufreq) {
+    HostRoot root;
+    // 没有 coretemp 驱动时使用 x86_pkg_temp 温区；没有 cpufreq 时频率保持未知
+    std::filesystem::remove_all(root.path + "sys/class/hwmon/hwmon1");
+    for (int i = 0; i < 4; i++) {
+        std::filesystem::remove_all(root.path + "sys/devices/system/cpu/cpu" + std::to_string(i) + "/cpufreq");
+    }
+    // 显式指定的 cgroup 可以不带开头的 '/'
+    std::unique_ptr<HostCollector> collector = CreateHostCollector(root.path, "system.slice/train.service");
+    REQUIRE(collector->Initialize());
+    CollectedHost host;
+    REQUIRE(collector->UpdateCPUTopology(host.cpu));
+    REQUIRE(host.cpu.logicalCpus.size() == 4);
+    CHECK(host.cpu.logicalCpus[0].maxFrequency == 0.0f);
+    host.Update(*collector);
+    CHECK(host.cpu.temperature == 70.0f);
+    CHECK(host.cpu.maxCoreTemperature == 0.0f);
+    CHECK(host.cpu.frequency == 0.0f);
+    REQUIRE(host.pressures.size() == 2);
+    CHECK(host.pressures[1].scope == "/system.slice/train.service");
+    CHECK_NEAR(host.pressures[1].cpu.someAvg10, 4.0, 1e-5);
+
+    // sysfs 不可用（如只挂载了 /proc）：拓扑按 /proc/stat 平铺，每个逻辑 CPU 视为一个物理核心
+    std::filesystem::remove_all(root.path + "sys");
+    CPUInfo flat;
+    REQUIRE(collector->UpdateCPUTopology(flat));
+    REQUIRE(flat.logicalCpus.size() == 4);
+    for (unsigned int i = 0; i < 4; i++) {
+        CHECK(flat.logicalCpus[i].id == i);
+        CHECK(flat.logicalCpus[i].core == i);
+        CHECK(flat.logicalCpus[i].thread == 0u);
+    }
+    collector->Shutdown();
+}
+#endif
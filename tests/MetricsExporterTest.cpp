@@ -0,0 +1,85 @@
+#include "TestSupport.h"
+#include "MetricsExporter.h"
+
+static void PublishSnapshot(MetricsExporter& exporter, uint64_t sequence, float utilization) {
+    HardwareSnapshot& snapshot = exporter.GetSnapshotBuffer().WriteBuffer();
+    snapshot.sequence = sequence;
+    snapshot.gpus.assign(2, GPUInfo());
+    snapshot.gpus[0].available = true;
+    snapshot.gpus[0].name = "NVIDIA \"B200\"\\SXM\nrev2";
+    snapshot.gpus[0].uuid = "GPU-0000";
+    snapshot.gpus[0].utilization = utilization;
+    snapshot.gpus[1].available = true;
+    snapshot.gpus[1].name = "NVIDIA B200";
+    snapshot.gpus[1].uuid = "GPU-1111";
+    snapshot.gpus[1].utilization = 7.0f;
+    snapshot.disks.assign(1, DiskInfo());
+    snapshot.disks[0].name = "nvme0n1";
+    snapshot.disks[0].realTimeReadBandwidth = 1.5f;
+    exporter.GetSnapshotBuffer().Publish();
+}
+
+TEST(MetricsExporter, RespondsBeforeFirstSnapshot) {
+    MetricsExporter exporter;
+    REQUIRE(exporter.Start("127.0.0.1", 0));
+    REQUIRE(exporter.GetPort() != 0);
+
+    int status = 0;
+    HttpGet(exporter.GetPort(), "/metrics", &status);
+    CHECK(status == 503);
+    HttpGet(exporter.GetPort(), "/nope", &status);
+    CHECK(status == 404);
+    HttpGet(exporter.GetPort(), "/", &status);
+    CHECK(status == 200);
+    exporter.Stop();
+}
+
+TEST(MetricsExporter, RendersLabelsAndEscapes) {
+    MetricsExporter exporter;
+    REQUIRE(exporter.Start("127.0.0.1", 0));
+    PublishSnapshot(exporter, 1, 42.0f);
+
+    int status = 0;
+    std::string body = HttpGet(exporter.GetPort(), "/metrics", &status);
+    CHECK(status == 200);
+    CHECK(body.find("# TYPE deepinsight_gpu_utilization_percent gauge\n") != std::string::npos);
+    // 标签值中的双引号、反斜杠和换行按文本格式转义
+    CHECK(body.find("deepinsight_gpu_utilization_percent{gpu=\"0\",name=\"NVIDIA \\\"B200\\\"\\\\SXM\\nrev2\","
+                    "uuid=\"GPU-0000\"} 42\n") != std::string::npos);
+    CHECK(body.find("deepinsight_gpu_utilization_percent{gpu=\"1\",name=\"NVIDIA B200\",uuid=\"GPU-1111\"} 7\n") !=
+          std::string::npos);
+    CHECK(body.find("deepinsight_disk_read_bandwidth_gigabytes_per_second{disk=\"nvme0n1\"") != std::string::npos);
+    CHECK(body.find("deepinsight_snapshot_sequence 1\n") != std::string::npos);
+    // 每一行都是注释或 "名称[{标签}] 数值"，不会因为未转义的换行断开
+    size_t start = 0;
+    while (start < body.size()) {
+        size_t end = body.find('\n', start);
+        REQUIRE(end != std::string::npos);
+        std::string line = body.substr(start, end - start);
+        CHECK(line.rfind("# ", 0) == 0 || line.rfind("deepinsight_", 0) == 0);
+        start = end + 1;
+    }
+    CHECK(exporter.GetScrapeCount() == 1);
+    exporter.Stop();
+}
+
+TEST(MetricsExporter, RerendersOnlyOnNewSequence) {
+    MetricsExporter exporter;
+    REQUIRE(exporter.Start("127.0.0.1", 0));
+    PublishSnapshot(exporter, 1, 10.0f);
+    std::string first = HttpGet(exporter.GetPort(), "/metrics");
+    CHECK(first.find("uuid=\"GPU-0000\"} 10\n") != std::string::npos);
+
+    // 序号不变：沿用上一次的渲染结果，即使数值变了
+    PublishSnapshot(exporter, 1, 55.0f);
+    std::string same = HttpGet(exporter.GetPort(), "/metrics");
+    CHECK(same == first);
+
+    // 新序号：重新渲染
+    PublishSnapshot(exporter, 2, 55.0f);
+    std::string next = HttpGet(exporter.GetPort(), "/metrics");
+    CHECK(next.find("uuid=\"GPU-0000\"} 55\n") != std::string::npos);
+    CHECK(next.find("deepinsight_snapshot_sequence 2\n") != std::string::npos);
+    CHECK(exporter.GetScrapeCount() == 3);
+    exporter.Stop();
+}
@@ -0,0 +1,153 @@
+#include "TestSupport.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "QuantileSketch.h"
+
+// 估计值在精确排序数据中的秩（按分位数表示）与 q 的差：t-digest 的误差按秩衡量，与数据的量纲无关
+static double RankError(const std::vector<float>& sorted, float estimate, double q) {
+    auto lower = std::lower_bound(sorted.begin(), sorted.end(), estimate);
+    auto upper = std::upper_bound(sorted.begin(), sorted.end(), estimate);
+    double n = static_cast<double>(sorted.size());
+    double rankLow = static_cast<double>(lower - sorted.begin()) / n;
+    double rankHigh = static_cast<double>(upper - sorted.begin()) / n;
+    if (q < rankLow) {
+        return rankLow - q;
+    }
+    return q > rankHigh ? q - rankHigh : 0.0;
+}
+
+// 尾部（p1/p99）的允许误差比中位数附近小一个数量级：这正是按 asin 刻度压缩质心的目的
+static double RankTolerance(double q) {
+    return q <= 0.01 || q >= 0.99 ? 0.002 : 0.01;
+}
+
+static const double kQuantiles[] = {0.001, 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99, 0.999};
+
+template <typename Distribution>
+static void CheckAccuracy(Distribution distribution, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<float> values(100000);
+    QuantileSketch sketch;
+    for (float& value : values) {
+        value = static_cast<float>(distribution(rng));
+        sketch.Add(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    CHECK(sketch.Count() == values.size());
+    CHECK(sketch.Min() == values.front());
+    CHECK(sketch.Max() == values.back());
+    CHECK(sketch.Quantile(0.0) == values.front());
+    CHECK(sketch.Quantile(1.0) == values.back());
+    for (double q : kQuantiles) {
+        double error = RankError(values, sketch.Quantile(q), q);
+        if (error > RankTolerance(q)) {
+            std::cerr << "q=" << q << " 秩误差 " << error << std::endl;
+        }
+        CHECK(error <= RankTolerance(q));
+    }
+}
+
+TEST(QuantileSketch, AccuracyOnUniformNormalAndSkewedData) {
+    CheckAccuracy(std::uniform_real_distribution<double>(0.0, 100.0), 1);
+    CheckAccuracy(std::normal_distribution<double>(60.0, 8.0), 2);
+    // 长尾：少数很慢的迭代（p99 正是要看的部分）
+    CheckAccuracy(std::lognormal_distribution<double>(0.0, 1.5), 3);
+    CheckAccuracy(std::exponential_distribution<double>(0.1), 4);
+}
+
+TEST(QuantileSketch, DiscreteAndConstantData) {
+    // 利用率是整数百分比：大量重复值
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> percent(0, 100);
+    std::vector<float> values(50000);
+    QuantileSketch sketch;
+    for (float& value : values) {
+        value = static_cast<float>(percent(rng));
+        sketch.Add(value);
+    }
+    std::sort(values.begin(), values.end());
+    for (double q : kQuantiles) {
+        CHECK(RankError(values, sketch.Quantile(q), q) <= RankTolerance(q));
+    }
+
+    QuantileSketch constant;
+    for (int i = 0; i < 10000; i++) {
+        constant.Add(42.5f);
+    }
+    for (double q : kQuantiles) {
+        CHECK(constant.Quantile(q) == 42.5f);
+    }
+
+    QuantileSketch empty;
+    CHECK(empty.Empty());
+    CHECK(empty.Quantile(0.5) == 0.0f);
+    QuantileSketch single;
+    single.Add(-3.0f);
+    CHECK(single.Quantile(0.01) == -3.0f);
+    CHECK(single.Quantile(0.99) == -3.0f);
+}
+
+TEST(QuantileSketch, MergedSketchMatchesWholeStream) {
+    // 60 个分钟草图合并成一小时（QuantileHistory 和汇总服务都这样合并），各段的分布不同
+    std::mt19937 rng(6);
+    std::vector<float> values;
+    QuantileSketch merged;
+    for (int minute = 0; minute < 60; minute++) {
+        std::normal_distribution<double> distribution(20.0 + minute, 2.0 + minute % 7);
+        QuantileSketch part;
+        for (int i = 0; i < 600; i++) {
+            float value = static_cast<float>(distribution(rng));
+            values.push_back(value);
+            part.Add(value);
+        }
+        if (minute % 2 == 0) {
+            part.Compact();   // 已结束的时间段
+        }
+        merged.Merge(part);
+    }
+    std::sort(values.begin(), values.end());
+    CHECK(merged.Count() == values.size());
+    CHECK(merged.Min() == values.front());
+    CHECK(merged.Max() == values.back());
+    for (double q : kQuantiles) {
+        CHECK(RankError(values, merged.Quantile(q), q) <= RankTolerance(q));
+    }
+
+    // 合并空草图不改变结果；Clear 之后可以重新使用
+    float p95 = merged.Quantile(0.95);
+    merged.Merge(QuantileSketch());
+    CHECK(merged.Quantile(0.95) == p95);
+    merged.Clear();
+    CHECK(merged.Empty());
+    merged.Add(1.0f);
+    CHECK(merged.Quantile(0.5) == 1.0f);
+}
+
+TEST(QuantileSketch, HistorySelectsWindowBySlots) {
+    // 每秒一个样本，第 m 分钟的样本值都是 m：窗口内的最小值说明合并了哪些分钟
+    QuantileHistory history;
+    QuantileHistory::Clock::time_point start{};
+    const int minutes = 150;
+    for (int second = 0; second < minutes * 60; second++) {
+        history.Add(start + std::chrono::seconds(second), static_cast<float>(second / 60));
+    }
+    QuantileSketch out;
+    // 5 分钟窗口：当前分钟 + 之前 5 分钟（窗口向上取整到整段）
+    history.Select(std::chrono::minutes(5), out);
+    CHECK(out.Min() == static_cast<float>(minutes - 6));
+    CHECK(out.Max() == static_cast<float>(minutes - 1));
+    CHECK(out.Count() == 6 * 60);
+
+    // 超过 60 分钟的窗口使用小时档位
+    history.Select(std::chrono::hours(2), out);
+    CHECK(out.Min() == 0.0f);
+    CHECK(out.Count() == static_cast<uint64_t>(minutes * 60));
+
+    // 超过 60 小时：整个会话
+    history.Select(std::chrono::hours(100), out);
+    CHECK(out.Count() == history.Session().Count());
+    CHECK_NEAR(out.Quantile(0.5), minutes / 2.0, 1.0);
+}
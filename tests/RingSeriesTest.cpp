@@ -0,0 +1,108 @@
+#include "TestSupport.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+#include "RingSeries.h"
+
+// 与 std::deque 模型逐项比较：每种读取方式都应按时间顺序给出最近的 N 个值
+template <size_t N>
+static size_t CompareWithModel(const RingSeries<int, N>& ring, const std::deque<int>& model) {
+    size_t mismatches = 0;
+    auto expect = [&](bool ok) { mismatches += ok ? 0 : 1; };
+    expect(ring.Size() == model.size());
+    expect(ring.Empty() == model.empty());
+    expect(ring.Full() == (model.size() == N));
+    for (size_t i = 0; i < model.size(); i++) {
+        expect(ring[i] == model[i]);
+    }
+    if (model.empty()) {
+        return mismatches;
+    }
+    expect(ring.Front() == model.front());
+    expect(ring.Back() == model.back());
+    expect(ring.Min() == *std::min_element(model.begin(), model.end()));
+    expect(ring.Max() == *std::max_element(model.begin(), model.end()));
+
+    // 两段连续视图拼起来就是整个序列
+    std::vector<int> spans(ring.First().data, ring.First().data + ring.First().size);
+    spans.insert(spans.end(), ring.Second().data, ring.Second().data + ring.Second().size);
+    expect(std::equal(spans.begin(), spans.end(), model.begin(), model.end()));
+
+    std::vector<int> visited;
+    ring.ForEach([&](int value) { visited.push_back(value); });
+    expect(std::equal(visited.begin(), visited.end(), model.begin(), model.end()));
+
+    // ImGui::PlotLines 的取值方式：values[(i + offset) % count]
+    for (int i = 0; i < ring.PlotCount(); i++) {
+        expect(ring.Data()[(i + ring.PlotOffset()) % ring.PlotCount()] == model[static_cast<size_t>(i)]);
+    }
+
+    std::vector<int> copied(model.size() + 2, -1);
+    expect(ring.CopyTo(copied.data(), copied.size()) == model.size());
+    expect(std::equal(model.begin(), model.end(), copied.begin()));
+    size_t partial = model.size() / 2;
+    expect(ring.CopyTo(copied.data(), partial) == partial);
+    return mismatches;
+}
+
+template <size_t N>
+static void RandomPushes(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> value(-1000, 1000);
+    std::uniform_int_distribution<int> action(0, 99);
+    RingSeries<int, N> ring;
+    std::deque<int> model;
+    size_t mismatches = CompareWithModel(ring, model);
+    for (int step = 0; step < 20 * static_cast<int>(N) + 500; step++) {
+        if (action(rng) == 0) {
+            ring.Clear();
+            model.clear();
+        } else {
+            int v = value(rng);
+            ring.Push(v);
+            model.push_back(v);
+            if (model.size() > N) {
+                model.pop_front();
+            }
+        }
+        mismatches += CompareWithModel(ring, model);
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(RingSeries, MatchesModelAcrossWraps) {
+    RandomPushes<1>(1);
+    RandomPushes<2>(2);
+    RandomPushes<7>(3);
+    RandomPushes<64>(4);
+    RandomPushes<300>(5);
+}
+
+TEST(RingSeries, SpansAtWrapBoundary) {
+    RingSeries<int, 4> ring;
+    for (int i = 0; i < 4; i++) {
+        ring.Push(i);
+    }
+    // 刚好写满：head 回到 0，第二段为空
+    CHECK(ring.Full());
+    CHECK(ring.First().size == 4);
+    CHECK(ring.Second().size == 0);
+    CHECK(ring.PlotOffset() == 0);
+
+    ring.Push(4);
+    CHECK(ring.First().size == 3);
+    CHECK(ring.First().data[0] == 1);
+    CHECK(ring.Second().size == 1);
+    CHECK(ring.Second().data[0] == 4);
+    CHECK(ring.PlotOffset() == 1);
+    CHECK(ring.Front() == 1);
+    CHECK(ring.Back() == 4);
+
+    ring.Clear();
+    CHECK(ring.Empty());
+    CHECK(ring.First().size == 0);
+    ring.Push(9);
+    CHECK(ring.Front() == 9);
+    CHECK(ring.Back() == 9);
+}
@@ -0,0 +1,220 @@
+#include "TestSupport.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "Downsample.h"
+#include "SeriesStore.h"
+
+static bool SameBucket(const HistoryBucket& a, const HistoryBucket& b) {
+    return std::memcmp(&a, &b, sizeof(HistoryBucket)) == 0;
+}
+
+// 两个存储对所有读取接口给出相同的结果（原始数据、各窗口的视图和统计、分位数）
+static size_t CompareStores(const SeriesStore& expected, const SeriesStore& actual) {
+    size_t mismatches = 0;
+    auto expect = [&](bool ok) { mismatches += ok ? 0 : 1; };
+    expect(actual.GetMetricCount() == expected.GetMetricCount());
+    expect(actual.Size() == expected.Size());
+    expect(actual.Revision() == expected.Revision());
+    if (mismatches > 0) {
+        return mismatches;
+    }
+    for (size_t row = 0; row < expected.Size(); row++) {
+        expect(actual.TimeAt(row) == expected.TimeAt(row));
+    }
+
+    const SeriesStore::Clock::duration windows[] = {
+        std::chrono::seconds(60), std::chrono::seconds(90), std::chrono::seconds(600), std::chrono::hours(1),
+        std::chrono::hours(2), std::chrono::hours(6), std::chrono::hours(24), std::chrono::hours(60),
+        std::chrono::hours(100)};
+    for (MetricId id = 0; id < expected.GetMetricCount(); id++) {
+        expect(actual.GetName(id) == expected.GetName(id));
+        expect(actual.HasQuantiles(id) == expected.HasQuantiles(id));
+        expect(actual.Empty(id) == expected.Empty(id));
+        if (expected.Empty(id)) {
+            continue;
+        }
+        expect(actual.Latest(id) == expected.Latest(id));
+        for (size_t row = 0; row < expected.Size(); row++) {
+            expect(actual.ValueAt(id, row) == expected.ValueAt(id, row));
+        }
+        for (SeriesStore::Clock::duration window : windows) {
+            SeriesStore::View a = expected.Select(id, window);
+            SeriesStore::View b = actual.Select(id, window);
+            expect(a.Tier() == b.Tier() && a.Count() == b.Count());
+            for (int i = 0; i < a.Count() && i < b.Count(); i++) {
+                expect(SameBucket(a.At(static_cast<size_t>(i)), b.At(static_cast<size_t>(i))));
+            }
+            HistoryBucket summaryA;
+            HistoryBucket summaryB;
+            expect(expected.Summarize(id, window, summaryA) && actual.Summarize(id, window, summaryB) &&
+                   SameBucket(summaryA, summaryB));
+            if (expected.HasQuantiles(id)) {
+                QuantileSketch sketchA;
+                QuantileSketch sketchB;
+                expect(expected.SelectQuantiles(id, window, sketchA) == actual.SelectQuantiles(id, window, sketchB));
+                expect(sketchA.Count() == sketchB.Count());
+                expect(sketchA.Quantile(0.5) == sketchB.Quantile(0.5) && sketchA.Quantile(0.99) == sketchB.Quantile(0.99));
+            }
+        }
+        if (expected.HasQuantiles(id)) {
+            QuantileSketch sessionA;
+            QuantileSketch sessionB;
+            expected.SessionQuantiles(id, sessionA);
+            actual.SessionQuantiles(id, sessionB);
+            expect(sessionA.Count() == sessionB.Count() && sessionA.Quantile(0.95) == sessionB.Quantile(0.95));
+        }
+    }
+    return mismatches;
+}
+
+// 快照缓冲区中的历史副本按不同的间隔同步（每次发布、隔几次发布、读端长时间持有后），
+// 都应与采样线程的存储完全相同；其间不断注册新指标，部分指标注册后过一段时间才有值
+TEST(SeriesStore, SyncFromMatchesSourceAtAnyLag) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::normal_distribution<float> noise(0.0f, 5.0f);
+    SeriesStore source;
+    std::vector<MetricId> metrics;
+    metrics.push_back(source.Register("gpu0.utilization", "%", true));
+    metrics.push_back(source.Register("gpu0.power", "W"));
+    MetricId late = source.Register("cpu.temperature", "°C");
+
+    const size_t periods[] = {1, 7, 400, 1500};   // 1500 行超过原始数据保留的行数：整体复制
+    SeriesStore copies[4];
+    size_t mismatches = 0;
+    SeriesStore::Clock::time_point time{};
+    for (int row = 1; row <= 30000; row++) {
+        if (row % 4000 == 0) {
+            metrics.push_back(source.Register("disk" + std::to_string(row) + ".read", "GB/s", row % 8000 == 0));
+        }
+        for (size_t i = 0; i < metrics.size(); i++) {
+            // 部分采集器本轮没有运行：沿用上一次的值
+            if (percent(rng) < 70) {
+                source.Set(metrics[i], 50.0f + 10.0f * static_cast<float>(i) + noise(rng));
+            }
+        }
+        if (row > 5000) {
+            source.Set(late, 60.0f + noise(rng));
+        }
+        // 大多数为 100ms 的采样间隔，偶尔停顿几十秒到二十分钟（覆盖各个聚合档位和时间段边界）
+        int gap = percent(rng);
+        time += gap == 0 ? std::chrono::milliseconds(30000 + 10000 * percent(rng)) : std::chrono::milliseconds(100);
+        source.Append(time);
+
+        for (size_t c = 0; c < 4; c++) {
+            if (row % periods[c] != 0) {
+                continue;
+            }
+            copies[c].SyncFrom(source);
+            if (periods[c] >= 400 || row % 2999 == 0) {
+                mismatches += CompareStores(source, copies[c]);
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+
+    // 不是 source 的旧副本（指标更多或行数更多）：整体复制
+    SeriesStore other;
+    for (int i = 0; i < 20; i++) {
+        other.Register("other" + std::to_string(i), "");
+    }
+    other.Append(time);
+    other.SyncFrom(source);
+    CHECK(CompareStores(source, other) == 0);
+    SeriesStore ahead = source;
+    ahead.Append(time + std::chrono::seconds(1));
+    ahead.SyncFrom(source);
+    CHECK(CompareStores(source, ahead) == 0);
+}
+
+TEST(SeriesStore, RollupFillsSkippedBuckets) {
+    SeriesRollup rollup;
+    SeriesRollup::Clock::time_point start{};
+    for (int second = 0; second < 60; second++) {
+        rollup.Add(start + std::chrono::seconds(second), 50.0f);
+    }
+    // 停顿 5 分钟：10 秒档跳过 30 个时间段，1 分钟档跳过 5 个，10 分钟档仍在同一个桶
+    rollup.Add(start + std::chrono::seconds(360), 70.0f);
+    REQUIRE(rollup.Size(0) == 37);
+    REQUIRE(rollup.Size(1) == 7);
+    CHECK(rollup.Size(2) == 1);
+    CHECK(rollup.At(0, 5).count == 10);
+    size_t gaps = 0;
+    for (size_t i = 6; i < 36; i++) {
+        gaps += rollup.At(0, i).count == 0 ? 1 : 0;
+    }
+    CHECK(gaps == 30);
+    CHECK(rollup.At(0, 36).count == 1);
+    CHECK(rollup.At(0, 36).mean == 70.0f);
+    CHECK(rollup.At(1, 0).count == 60);
+    CHECK(rollup.At(1, 1).count == 0);
+    CHECK(rollup.At(1, 6).mean == 70.0f);
+    CHECK_NEAR(rollup.At(2, 0).mean, (60 * 50.0 + 70.0) / 61.0, 1e-4);
+
+    // 挂起 100 小时：每档最多写入一整档的空桶，之后只剩新样本所在的当前桶
+    rollup.Add(start + std::chrono::hours(100), 80.0f);
+    for (size_t tier = 0; tier < SeriesRollup::kTierCount; tier++) {
+        CHECK(rollup.Full(tier));
+        CHECK(rollup.Size(tier) == SeriesRollup::kTierCapacity + 1);
+        CHECK(rollup.At(tier, 0).count == 0);
+        CHECK(rollup.At(tier, SeriesRollup::kTierCapacity - 1).count == 0);
+        CHECK(rollup.At(tier, SeriesRollup::kTierCapacity).mean == 80.0f);
+    }
+}
+
+TEST(SeriesStore, WindowSpansRealTimeAcrossStall) {
+    SeriesStore store;
+    MetricId id = store.Register("gpu0.utilization", "%");
+    SeriesStore::Clock::time_point time{};
+    for (int i = 0; i < 1300; i++) {
+        store.Set(id, 40.0f + static_cast<float>(i % 20));
+        time += std::chrono::seconds(1);
+        store.Append(time);
+    }
+    // 采样线程停顿 30 分钟后恢复
+    time += std::chrono::minutes(30);
+    for (int i = 0; i < 1300; i++) {
+        store.Set(id, 60.0f + static_cast<float>(i % 20));
+        store.Append(time);
+        time += std::chrono::seconds(1);
+    }
+
+    // 1 小时窗口超出原始数据，使用 10 秒档：恢复后的 1300 秒、停顿的 30 分钟和停顿前的 500 秒
+    SeriesStore::View view = store.Select(id, std::chrono::hours(1));
+    REQUIRE(view.Tier() == 0);
+    REQUIRE(view.Count() == 361);
+    size_t gaps = 0;
+    for (int i = 0; i < view.Count(); i++) {
+        gaps += view.Gap(static_cast<size_t>(i)) ? 1 : 0;
+    }
+    CHECK_NEAR(gaps, 180, 1);
+    CHECK(!view.Gap(0));
+    CHECK(std::isnan(SeriesStore::View::PlotMean(&view, 200)));
+
+    // 统计跳过空桶：最小值不会被空桶拉到 0，均值只按有样本的桶计算
+    CHECK(view.Min() == 40.0f);
+    CHECK(view.Max() == 79.0f);
+    HistoryBucket summary;
+    REQUIRE(store.Summarize(id, std::chrono::minutes(90), summary));
+    CHECK(summary.minValue == 40.0f);
+    CHECK(summary.mean > 49.0f && summary.mean < 70.0f);
+
+    // 降采样后空档仍然保留
+    std::vector<float> values(1000, 1.0f);
+    for (size_t i = 400; i < 420; i++) {
+        values[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    std::vector<float> points;
+    DownsampleLttb(values.data(), values.size(), 100, points);
+    REQUIRE(points.size() == 100);
+    size_t nanPoints = 0;
+    for (float point : points) {
+        nanPoints += std::isnan(point) ? 1 : 0;
+    }
+    CHECK(nanPoints >= 1 && nanPoints <= 4);
+    CHECK(points.front() == 1.0f && points.back() == 1.0f);
+}
@@ -0,0 +1,191 @@
+#include "TestSupport.h"
+#include "TestData.h"
+#include <cstddef>
+#include <limits>
+#include "SessionReplay.h"
+
+// 解码一条完整的记录（含记录头）到 state
+static bool DecodeRecord(const std::vector<uint8_t>& record, const SessionState& state) {
+    if (record.size() < sizeof(SessionRecordHeader)) {
+        return false;
+    }
+    SessionRecordHeader header;
+    std::memcpy(&header, record.data(), sizeof(header));
+    return header.size == record.size() && DecodeSessionRecord(header, record.data() + sizeof(header), state);
+}
+
+// 在慢变数值之外把一部分字段换成任意位模式（包括 NaN 和 Inf）：录制文件保存原始浮点数，应当逐位还原
+static void Scramble(TestHost& host, std::mt19937& rng) {
+    std::uniform_int_distribution<uint32_t> anyBits;
+    auto randomFloat = [&] {
+        uint32_t bits = anyBits(rng);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    };
+    for (GPUInfo& gpu : host.gpus) {
+        gpu.utilization = randomFloat();
+        gpu.temperature = std::numeric_limits<float>::quiet_NaN();
+        gpu.pcieRxThroughput = randomFloat();
+        gpu.gpuClock = anyBits(rng);
+    }
+    host.cpu.coreFrequency[0] = -std::numeric_limits<float>::infinity();
+    host.memory.pageInRate = randomFloat();
+    host.pressures[1].io.fullStall = randomFloat();
+}
+
+TEST(SessionFormat, RecordRoundTripIsExact) {
+    TestHost host;
+    MakeInventory(host, 3, 12);
+    host.gpus[1].name = "NVIDIA B200 \"SXM\"";
+    std::vector<uint8_t> inventory = EncodeRecord(SessionRecordType::Inventory, 5, host.State());
+    REQUIRE(!inventory.empty());
+
+    TestHost decoded;
+    REQUIRE(DecodeRecord(inventory, decoded.State()));
+    CHECK(decoded.gpus.size() == 3);
+    CHECK(decoded.gpus[1].name == host.gpus[1].name);
+    CHECK(decoded.gpus[2].uuid == "GPU-1002");
+    CHECK(decoded.gpus[0].memoryBusWidth == 8192);
+    REQUIRE(decoded.cpu.logicalCpus.size() == 12);
+    CHECK(decoded.cpu.logicalCpus[7].core == 3);
+    CHECK(decoded.cpu.logicalCpus[7].thread == 1);
+    CHECK(decoded.memory.modules[0].name == "DIMM_A1");
+    CHECK(decoded.disks[0].model == "Samsung PM1743");
+    CHECK(decoded.pressures[1].scope == "/system.slice/train.service");
+    CHECK(EncodeRecord(SessionRecordType::Inventory, 5, decoded.State()) == inventory);
+
+    // N 个随机样本：解码后重新编码得到相同的字节，说明每个录制的字段都原样还原
+    std::mt19937 rng(17);
+    size_t mismatches = 0;
+    for (int i = 0; i < 500; i++) {
+        MakeSample(host, i, rng);
+        if (i % 3 == 0) {
+            Scramble(host, rng);
+        }
+        std::vector<uint8_t> sample = EncodeRecord(SessionRecordType::Sample, 100 * i, host.State());
+        REQUIRE(!sample.empty());
+        REQUIRE(DecodeRecord(sample, decoded.State()));
+        if (EncodeRecord(SessionRecordType::Sample, 100 * i, decoded.State()) != sample) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(decoded.gpus[2].utilization == host.gpus[2].utilization);
+    CHECK(decoded.cpu.coreUtilization[11] == host.cpu.coreUtilization[11]);
+    CHECK(decoded.memory.used == host.memory.used);
+    CHECK(decoded.pressures[0].cpu.someAvg10 == host.pressures[0].cpu.someAvg10);
+}
+
+TEST(SessionFormat, RejectsMismatchedAndTruncatedRecords) {
+    TestHost host;
+    MakeInventory(host, 2, 4);
+    std::mt19937 rng(19);
+    MakeSample(host, 0, rng);
+    std::vector<uint8_t> sample = EncodeRecord(SessionRecordType::Sample, 0, host.State());
+    REQUIRE(!sample.empty());
+
+    // 样本要求设备数量与当前清单一致
+    TestHost other;
+    MakeInventory(other, 3, 4);
+    CHECK(!DecodeRecord(sample, other.State()));
+    MakeInventory(other, 2, 8);
+    CHECK(!DecodeRecord(sample, other.State()));
+
+    // 负载不完整（记录头中的长度被截短）时解码失败，而不是读出界
+    TestHost same;
+    MakeInventory(same, 2, 4);
+    for (size_t size = sizeof(SessionRecordHeader); size < sample.size(); size += 7) {
+        std::vector<uint8_t> truncated(sample.begin(), sample.begin() + size);
+        uint32_t length = static_cast<uint32_t>(size);
+        std::memcpy(truncated.data() + offsetof(SessionRecordHeader, size), &length, sizeof(length));
+        CHECK(!DecodeRecord(truncated, same.State()));
+    }
+    CHECK(DecodeRecord(sample, same.State()));
+
+    // 空间不足时不写入
+    std::vector<uint8_t> small(sample.size() - 1);
+    CHECK(EncodeSessionRecord(SessionRecordType::Sample, 0, host.State(), small.data(), small.size()) == 0);
+}
+
+TEST(SessionFormat, SampleValuesQuantizeWithinStep) {
+    TestHost host;
+    MakeInventory(host, 2, 8);
+    std::mt19937 rng(23);
+    MakeSample(host, 3, rng);
+    host.gpus[0].temperature = std::numeric_limits<float>::quiet_NaN();
+    host.gpus[1].pcieRxThroughput = std::numeric_limits<float>::infinity();
+
+    std::vector<int64_t> values(CountSampleValues(host.State()));
+    ExtractSampleValues(host.State(), values.data());
+    TestHost decoded;
+    MakeInventory(decoded, 2, 8);
+    ApplySampleValues(decoded.State(), values.data());
+
+    // 非有限值：NaN 记为 0，Inf 截断为有限的大数
+    CHECK(decoded.gpus[0].temperature == 0.0f);
+    CHECK(std::isfinite(decoded.gpus[1].pcieRxThroughput) && decoded.gpus[1].pcieRxThroughput > 1e9f);
+    CHECK_NEAR(decoded.gpus[1].temperature, host.gpus[1].temperature, 0.05 + 1e-4);
+    CHECK_NEAR(decoded.gpus[0].currentVoltage, host.gpus[0].currentVoltage, 0.0005 + 1e-6);
+    CHECK_NEAR(decoded.cpu.coreFrequency[5], host.cpu.coreFrequency[5], 0.5 + 1e-3);
+    CHECK_NEAR(decoded.memory.dirty, host.memory.dirty, 0.5 + 1e-3);
+    CHECK(decoded.gpus[1].gpuClock == host.gpus[1].gpuClock);
+
+    // 再次提取得到相同的整数（量化是幂等的）
+    std::vector<int64_t> again(values.size());
+    ExtractSampleValues(decoded.State(), again.data());
+    CHECK(again == values);
+}
+
+TEST(SessionFormat, SampleSchemaIdMatchesLayout) {
+    uint32_t schemaId = SampleSchemaId();
+    CHECK(schemaId == SampleSchemaId());
+
+    // 样本数值个数按设备数量线性增长：schema 只需记录每类设备的字段数
+    TestHost one;
+    TestHost two;
+    TestHost three;
+    MakeInventory(one, 1, 2);
+    MakeInventory(two, 2, 2);
+    MakeInventory(three, 3, 2);
+    size_t perGpu = CountSampleValues(two.State()) - CountSampleValues(one.State());
+    CHECK(perGpu > 0);
+    CHECK(CountSampleValues(three.State()) - CountSampleValues(two.State()) == perGpu);
+    MakeInventory(two, 1, 4);
+    size_t perCpu = (CountSampleValues(two.State()) - CountSampleValues(one.State())) / 2;
+    CHECK(perCpu == 2);   // 每个逻辑 CPU 的利用率和频率
+    two.pressures.resize(3);
+    CHECK(CountSampleValues(two.State()) > CountSampleValues(one.State()) + 2 * perCpu);
+}
+
+TEST(SessionFormat, RecorderReplayRoundTrip) {
+    std::string directory = MakeTempDirectory("deepinsight-session");
+    std::string path = directory + "session.rec";
+    TestHost host;
+    MakeInventory(host, 4, 32);
+    std::vector<std::vector<uint8_t>> records;
+    // 样本远多于一个块能容纳的记录数，跨越多个块
+    REQUIRE(RecordSession(path, host, 2000, 29, records));
+
+    SessionReplay replay;
+    REQUIRE(replay.Open(path, 0.0));
+    SessionRecordHeader header;
+    const uint8_t* payload = nullptr;
+    size_t index = 0;
+    size_t mismatches = 0;
+    while (replay.Next(SessionReplay::Clock::now(), header, payload)) {
+        if (index >= records.size() || header.size != records[index].size() ||
+            std::memcmp(payload, records[index].data() + sizeof(SessionRecordHeader),
+                        header.size - sizeof(SessionRecordHeader)) != 0) {
+            mismatches++;
+        }
+        index++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(index == records.size());
+    CHECK(replay.Finished());
+    CHECK(replay.GetRecordCount() == records.size());
+    CHECK(replay.GetCorruptBlockCount() == 0);
+    replay.Close();
+    RemoveDirectory(directory);
+}
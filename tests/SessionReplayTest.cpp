@@ -0,0 +1,190 @@
+#include "TestSupport.h"
+#include "TestData.h"
+#include <filesystem>
+#include <fstream>
+#include "SessionReplay.h"
+
+// 读出文件中 offset 处的 size 字节 / 覆盖写入
+static void ReadAt(const std::string& path, uint64_t offset, void* data, size_t size) {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+}
+
+static void WriteAt(const std::string& path, uint64_t offset, const void* data, size_t size) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+static uint64_t BlockOffset(uint64_t block) {
+    return kSessionHeaderSize + block * kSessionBlockSize;
+}
+
+static SessionBlockHeader ReadBlockHeader(const std::string& path, uint64_t block) {
+    SessionBlockHeader header{};
+    ReadAt(path, BlockOffset(block), &header, sizeof(header));
+    return header;
+}
+
+// 尽快回放整个文件，返回每条记录（含记录头）
+static std::vector<std::vector<uint8_t>> ReplayAll(SessionReplay& replay) {
+    std::vector<std::vector<uint8_t>> records;
+    SessionRecordHeader header;
+    const uint8_t* payload = nullptr;
+    while (replay.Next(SessionReplay::Clock::now(), header, payload)) {
+        std::vector<uint8_t> record(header.size);
+        std::memcpy(record.data(), &header, sizeof(header));
+        std::memcpy(record.data() + sizeof(header), payload, header.size - sizeof(header));
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+// 录制一个至少 minBlocks 个块的会话
+struct Recording {
+    std::string directory;
+    std::string path;
+    std::vector<std::vector<uint8_t>> records;
+
+    bool Create(uint64_t minBlocks) {
+        directory = MakeTempDirectory("deepinsight-replay");
+        path = directory + "session.rec";
+        TestHost host;
+        MakeInventory(host, 4, 32);
+        return RecordSession(path, host, 1500, 31, records) &&
+               std::filesystem::file_size(path) >= BlockOffset(minBlocks);
+    }
+    ~Recording() {
+        if (!directory.empty()) {
+            RemoveDirectory(directory);
+        }
+    }
+};
+
+TEST(SessionReplay, SkipsBlockWithBadChecksum) {
+    Recording recording;
+    REQUIRE(recording.Create(4));
+    SessionBlockHeader first = ReadBlockHeader(recording.path, 0);
+    SessionBlockHeader second = ReadBlockHeader(recording.path, 1);
+    REQUIRE(first.recordCount > 0 && second.recordCount > 0);
+    CHECK(second.sequence == 1);
+
+    // 第 1 块负载中间的一个字节被破坏：整块跳过，前后的块照常回放
+    uint8_t byte = 0;
+    uint64_t offset = BlockOffset(1) + sizeof(SessionBlockHeader) + second.payloadBytes / 2;
+    ReadAt(recording.path, offset, &byte, 1);
+    byte ^= 0x40;
+    WriteAt(recording.path, offset, &byte, 1);
+
+    SessionReplay replay;
+    REQUIRE(replay.Open(recording.path, 0.0));
+    std::vector<std::vector<uint8_t>> replayed = ReplayAll(replay);
+    CHECK(replay.Finished());
+    CHECK(replay.GetCorruptBlockCount() == 1);
+    REQUIRE(replayed.size() == recording.records.size() - second.recordCount);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < replayed.size(); i++) {
+        size_t original = i < first.recordCount ? i : i + second.recordCount;
+        mismatches += replayed[i] == recording.records[original] ? 0 : 1;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(SessionReplay, StopsAtTruncatedTail) {
+    Recording recording;
+    REQUIRE(recording.Create(4));
+    SessionBlockHeader first = ReadBlockHeader(recording.path, 0);
+    SessionBlockHeader second = ReadBlockHeader(recording.path, 1);
+
+    // 掉电时最后一个块只落盘了一部分：该块校验失败被跳过，之前的块完整回放
+    std::filesystem::resize_file(recording.path, BlockOffset(2) + kSessionBlockSize / 3);
+    SessionReplay replay;
+    REQUIRE(replay.Open(recording.path, 0.0));
+    std::vector<std::vector<uint8_t>> replayed = ReplayAll(replay);
+    CHECK(replay.Finished());
+    CHECK(replay.GetCorruptBlockCount() == 1);
+    REQUIRE(replayed.size() == first.recordCount + second.recordCount);
+    CHECK(replayed.back() == recording.records[replayed.size() - 1]);
+
+    // 只剩半个块头：直接结束，不算损坏
+    std::filesystem::resize_file(recording.path, BlockOffset(1) + sizeof(SessionBlockHeader) / 2);
+    REQUIRE(replay.Open(recording.path, 0.0));
+    CHECK(ReplayAll(replay).size() == first.recordCount);
+    CHECK(replay.GetCorruptBlockCount() == 0);
+}
+
+TEST(SessionReplay, IgnoresBytesAfterLastCompleteRecord) {
+    Recording recording;
+    REQUIRE(recording.Create(2));
+    uint64_t lastBlock = std::filesystem::file_size(recording.path) / kSessionBlockSize - 1;
+    while (ReadBlockHeader(recording.path, lastBlock).magic != kSessionBlockMagic) {
+        lastBlock--;
+    }
+    SessionBlockHeader last = ReadBlockHeader(recording.path, lastBlock);
+    REQUIRE(last.payloadBytes + 64 <= kSessionBlockPayload);
+
+    // 进程在写记录时被杀：记录数据已部分写入，但块头（长度和校验和）还停留在上一条完整记录
+    std::vector<uint8_t> partial(64, 0xAB);
+    WriteAt(recording.path, BlockOffset(lastBlock) + sizeof(SessionBlockHeader) + last.payloadBytes,
+            partial.data(), partial.size());
+    SessionReplay replay;
+    REQUIRE(replay.Open(recording.path, 0.0));
+    std::vector<std::vector<uint8_t>> replayed = ReplayAll(replay);
+    CHECK(replay.GetCorruptBlockCount() == 0);
+    CHECK(replayed.size() == recording.records.size());
+    CHECK(replayed.back() == recording.records.back());
+}
+
+TEST(SessionReplay, RejectsBadFileHeader) {
+    Recording recording;
+    REQUIRE(recording.Create(1));
+    SessionReplay replay;
+    CHECK(!replay.Open(recording.directory + "missing.rec", 0.0));
+
+    SessionFileHeader header{};
+    ReadAt(recording.path, 0, &header, sizeof(header));
+    SessionFileHeader corrupted = header;
+    corrupted.startUnixMs++;
+    WriteAt(recording.path, 0, &corrupted, sizeof(corrupted));
+    CHECK(!replay.Open(recording.path, 0.0));
+
+    // 校验和正确但版本不同
+    corrupted = header;
+    corrupted.version = kSessionVersion + 1;
+    corrupted.checksum = 0;
+    corrupted.checksum = SessionCrc32(&corrupted, sizeof(corrupted));
+    WriteAt(recording.path, 0, &corrupted, sizeof(corrupted));
+    CHECK(!replay.Open(recording.path, 0.0));
+
+    WriteAt(recording.path, 0, &header, sizeof(header));
+    CHECK(replay.Open(recording.path, 0.0));
+    CHECK(!replay.Finished());
+}
+
+TEST(SessionReplay, PacesRecordsAtRecordedIntervals) {
+    Recording recording;
+    REQUIRE(recording.Create(1));
+    SessionReplay replay;
+    REQUIRE(replay.Open(recording.path, 10.0));
+
+    // 清单和第一个样本的时间戳都为 0，立即播放；之后每 100ms 一个样本，10 倍速时间隔 10ms
+    SessionRecordHeader header;
+    const uint8_t* payload = nullptr;
+    SessionReplay::Clock::time_point start = replay.NextDeadline();   // 播放起点
+    REQUIRE(replay.Next(start, header, payload));
+    CHECK(header.type == static_cast<uint32_t>(SessionRecordType::Inventory));
+    REQUIRE(replay.Next(start, header, payload));
+    SessionReplay::Clock::time_point deadline = replay.NextDeadline();
+    CHECK_NEAR(std::chrono::duration_cast<std::chrono::microseconds>(deadline - start).count(), 10000, 1);
+    CHECK(!replay.Next(deadline - std::chrono::microseconds(1), header, payload));
+    REQUIRE(replay.Next(deadline, header, payload));
+    CHECK(header.timestampMs == 100);
+    CHECK_NEAR(std::chrono::duration_cast<std::chrono::microseconds>(replay.NextDeadline() - deadline).count(),
+               10000, 1);
+
+    // 回放时间线按录制间隔排列，与播放速度无关
+    SessionReplay::Clock::time_point t1 = replay.RecordTime(100);
+    CHECK(replay.RecordTime(1100) - t1 == std::chrono::seconds(1));
+    CHECK(replay.RecordTime(500) == t1 + std::chrono::seconds(1));   // 时间倒退时保持单调
+}
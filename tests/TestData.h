@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "HardwareMonitor.h"
+#include "SessionFormat.h"
+#include "SessionRecorder.h"
+#include "TestSupport.h"
+
+// 测试用的一台主机：设备清单和样本数值，结构与 HardwareMonitor 的工作状态相同
+struct TestHost {
+    std::vector<GPUInfo> gpus;
+    CPUInfo cpu;
+    MemoryInfo memory;
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;
+
+    SessionState State() { return SessionState{&gpus, &cpu, &memory, &bandwidth, &disks, &pressures}; }
+};
+
+// gpuCount 块 GPU、cpuCount 个逻辑 CPU（两个超线程一个物理核心）、一条内存、一块磁盘、系统和一个 cgroup 的压力停顿
+inline void MakeInventory(TestHost& host, size_t gpuCount, size_t cpuCount) {
+    host = TestHost();
+    host.gpus.resize(gpuCount);
+    for (size_t i = 0; i < gpuCount; i++) {
+        GPUInfo& gpu = host.gpus[i];
+        gpu.name = "NVIDIA B200";
+        gpu.uuid = "GPU-" + std::to_string(1000 + i);
+        gpu.maxGpuClock = 1965;
+        gpu.maxMemoryClock = 3996;
+        gpu.pcieMaxLinkGeneration = 5;
+        gpu.pcieMaxLinkWidth = 16;
+        gpu.memoryBusWidth = 8192;
+    }
+    host.cpu.logicalCpus.resize(cpuCount);
+    for (size_t i = 0; i < cpuCount; i++) {
+        LogicalCpuInfo& logical = host.cpu.logicalCpus[i];
+        logical.id = static_cast<unsigned int>(i);
+        logical.core = static_cast<unsigned int>(i / 2);
+        logical.thread = static_cast<unsigned int>(i % 2);
+        logical.maxFrequency = 3800.0f;
+    }
+    host.cpu.coreUtilization.assign(cpuCount, 0.0f);
+    host.cpu.coreFrequency.assign(cpuCount, 0.0f);
+    host.memory.modules.resize(1);
+    host.memory.modules[0].name = "DIMM_A1";
+    host.memory.modules[0].type = "DDR5";
+    host.memory.modules[0].capacity = 64.0f;
+    host.memory.modules[0].speed = 5600;
+    host.memory.modules[0].maxBandwidth = 44.8f;
+    host.bandwidth.memoryType = "DDR5";
+    host.bandwidth.memorySpeed = 5600;
+    host.disks.resize(1);
+    host.disks[0].name = "nvme0n1";
+    host.disks[0].model = "Samsung PM1743";
+    host.disks[0].type = "NVMe";
+    host.disks[0].totalSize = 3840.0f;
+    host.pressures.resize(2);
+    host.pressures[0].scope = "system";
+    host.pressures[1].scope = "/system.slice/train.service";
+}
+
+// 第 step 个样本：慢变的数值随 step 变化，其余数值带传感器噪声
+inline void MakeSample(TestHost& host, int step, std::mt19937& rng) {
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (size_t i = 0; i < host.gpus.size(); i++) {
+        GPUInfo& gpu = host.gpus[i];
+        gpu.available = true;
+        gpu.utilization = static_cast<float>((step * 7 + static_cast<int>(i) * 13) % 101);
+        gpu.memoryTotal = 184320.0f;
+        gpu.memoryUsed = 90000.0f + 10.0f * static_cast<float>(step % 50);
+        gpu.memoryPercent = gpu.memoryUsed / gpu.memoryTotal * 100.0f;
+        gpu.temperature = 60.0f + 5.0f * noise(rng);
+        gpu.gpuClock = 1800 + static_cast<unsigned int>(step % 20);
+        gpu.memoryClock = 3996;
+        gpu.fanSpeed = 40;
+        gpu.powerUsage = 700 + static_cast<unsigned int>(step % 30);
+        gpu.powerLimit = 1000.0f;
+        gpu.powerPercent = static_cast<float>(gpu.powerUsage) / 10.0f;
+        gpu.memoryControllerLoad = 30.0f + 10.0f * noise(rng);
+        gpu.currentVoltage = 0.875f + 0.01f * noise(rng);
+        gpu.maxVoltage = 1.1f;
+        gpu.voltagePercent = gpu.currentVoltage / gpu.maxVoltage * 100.0f;
+        gpu.pcieLinkWidth = 16;
+        gpu.pcieLinkSpeed = 32;
+        gpu.pcieBandwidth = 63.015f;
+        gpu.pcieRxThroughput = 1200.0f + 100.0f * noise(rng);
+        gpu.pcieTxThroughput = 300.0f + 50.0f * noise(rng);
+        gpu.dataTransferWaitTime = 1.5f + noise(rng);
+    }
+    for (size_t i = 0; i < host.cpu.coreUtilization.size(); i++) {
+        host.cpu.coreUtilization[i] = 50.0f + 40.0f * noise(rng);
+        host.cpu.coreFrequency[i] = 3000.0f + 200.0f * noise(rng);
+    }
+    host.cpu.utilization = 50.0f + 10.0f * noise(rng);
+    host.cpu.temperature = 55.0f + noise(rng);
+    host.cpu.frequency = 3000.0f + 100.0f * noise(rng);
+    host.cpu.maxCoreTemperature = 70.0f + noise(rng);
+    host.cpu.throttleRate = step % 10 == 0 ? 2.0f : 0.0f;
+    host.memory.total = 503.5f;
+    host.memory.used = 200.0f + 0.01f * static_cast<float>(step);
+    host.memory.percent = host.memory.used / host.memory.total * 100.0f;
+    host.memory.available = host.memory.total - host.memory.used;
+    host.memory.pageInRate = 100.0f + 20.0f * noise(rng);
+    host.memory.dirty = 12.0f + noise(rng);
+    host.memory.modules[0].realTimeBandwidth = 20.0f + noise(rng);
+    host.memory.modules[0].utilization = host.memory.modules[0].realTimeBandwidth / 44.8f * 100.0f;
+    host.bandwidth.pcieRealTimeBandwidth = 10.0f + noise(rng);
+    host.bandwidth.memoryRealTimeBandwidth = 20.0f + noise(rng);
+    host.disks[0].realTimeReadBandwidth = 2.5f + 0.5f * noise(rng);
+    host.disks[0].readUtilization = 35.0f + 5.0f * noise(rng);
+    for (PressureInfo& pressure : host.pressures) {
+        pressure.cpu.someAvg10 = 3.25f;
+        pressure.io.someStall = 12.0f + 3.0f * noise(rng);
+        pressure.io.fullStall = 4.0f + noise(rng);
+    }
+}
+
+// 编码一条记录，返回完整的记录字节（含记录头）
+inline std::vector<uint8_t> EncodeRecord(SessionRecordType type, int64_t timestampMs, const SessionView& state) {
+    std::vector<uint8_t> record(SessionRecorder::kMaxRecordBytes);
+    record.resize(EncodeSessionRecord(type, timestampMs, state, record.data(), record.size()));
+    return record;
+}
+
+// 用 SessionRecorder 录制一个会话：一条清单 + samples 个样本（时间戳间隔 100ms），
+// records 返回按顺序写入的每条记录，供与回放结果比较
+inline bool RecordSession(const std::string& path, TestHost& host, int samples, uint32_t seed,
+                          std::vector<std::vector<uint8_t>>& records) {
+    SessionRecorder recorder;
+    if (!recorder.Open(path)) {
+        return false;
+    }
+    std::mt19937 rng(seed);
+    records.clear();
+    records.push_back(EncodeRecord(SessionRecordType::Inventory, 0, host.State()));
+    for (int i = 0; i < samples; i++) {
+        MakeSample(host, i, rng);
+        records.push_back(EncodeRecord(SessionRecordType::Sample, 100 * int64_t(i), host.State()));
+    }
+    for (const std::vector<uint8_t>& record : records) {
+        // 队列满时等写入线程腾出位置，保证不丢记录
+        if (!WaitUntil([&] { return recorder.GetQueuedCount() < SessionRecorder::kQueueSlots; }, 5000)) {
+            return false;
+        }
+        uint8_t* slot = recorder.BeginRecord();
+        if (slot == nullptr) {
+            return false;
+        }
+        std::memcpy(slot, record.data(), record.size());
+        recorder.CommitRecord(record.size());
+    }
+    recorder.Close();
+    return recorder.GetDroppedCount() == 0;
+}
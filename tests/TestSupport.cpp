@@ -0,0 +1,104 @@
+#include "TestSupport.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+#include "NetSocket.h"
+
+struct TestCase {
+    const char* suite;
+    const char* name;
+    TestFunction run;
+};
+
+static std::vector<TestCase>& Registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+static int g_failures = 0;
+
+TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction run) {
+    Registry().push_back(TestCase{suite, name, run});
+}
+
+void ReportTestFailure(const char* file, int line, const char* expression) {
+    std::cerr << file << ":" << line << ": 检查失败: " << expression << std::endl;
+    g_failures++;
+}
+
+std::string HttpGet(uint16_t port, const std::string& path, int* status) {
+    if (status != nullptr) {
+        *status = 0;
+    }
+    SocketHandle socket = ConnectTcp("127.0.0.1", port);
+    if (socket == kInvalidSocket) {
+        return std::string();
+    }
+    SetSocketTimeout(socket, 5000);
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+    if (!SendAll(socket, request.data(), request.size())) {
+        CloseSocket(socket);
+        return std::string();
+    }
+    std::string response;
+    char buffer[4096];
+    for (;;) {
+        ptrdiff_t received = ReceiveSome(socket, buffer, sizeof(buffer));
+        if (received <= 0) {
+            break;
+        }
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    CloseSocket(socket);
+
+    size_t headerEnd = response.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        return std::string();
+    }
+    if (status != nullptr) {
+        std::sscanf(response.c_str(), "HTTP/1.1 %d", status);
+    }
+    return response.substr(headerEnd + 4);
+}
+
+std::string MakeTempDirectory(const std::string& prefix) {
+    static std::atomic<int> counter{0};
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        (prefix + "-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" +
+         std::to_string(counter.fetch_add(1)));
+    std::filesystem::create_directories(path);
+    return path.generic_string() + "/";
+}
+
+void RemoveDirectory(const std::string& path) {
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+}
+
+int main(int argc, char** argv) {
+    // 测试用到回环套接字；Winsock 在整个测试期间保持初始化
+    InitializeSockets();
+
+    const char* suite = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const TestCase& test : Registry()) {
+        if (suite != nullptr && std::strcmp(test.suite, suite) != 0) {
+            continue;
+        }
+        int failuresBefore = g_failures;
+        test.run();
+        std::cout << (g_failures == failuresBefore ? "[通过] " : "[失败] ")
+                  << test.suite << "." << test.name << std::endl;
+        run++;
+    }
+    ShutdownSockets();
+
+    if (run == 0) {
+        std::cerr << "没有匹配的测试: " << (suite != nullptr ? suite : "") << std::endl;
+        return 1;
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// 最小的测试框架（不依赖第三方库）
+//
+//   TEST(Suite, Name) { CHECK(...); REQUIRE(...); }
+//
+// 所有用例编译进同一个测试程序，按套件名运行：DeepInsightTests <Suite>（不带参数时运行全部）。
+// CHECK 失败时记录位置并继续，REQUIRE 失败时结束当前用例。任何用例失败时程序返回非零。
+
+using TestFunction = void (*)();
+
+struct TestRegistrar {
+    TestRegistrar(const char* suite, const char* name, TestFunction run);
+};
+
+void ReportTestFailure(const char* file, int line, const char* expression);
+
+#define TEST(suite, name)                                                              \
+    static void suite##_##name();                                                      \
+    static TestRegistrar suite##_##name##_registrar(#suite, #name, &suite##_##name);   \
+    static void suite##_##name()
+
+#define CHECK(condition)                                                               \
+    do {                                                                               \
+        if (!(condition)) ReportTestFailure(__FILE__, __LINE__, #condition);           \
+    } while (0)
+
+#define REQUIRE(condition)                                                             \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            ReportTestFailure(__FILE__, __LINE__, #condition);                         \
+            return;                                                                    \
+        }                                                                              \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                        \
+    CHECK(std::fabs(static_cast<double>(actual) - static_cast<double>(expected)) <=    \
+          static_cast<double>(tolerance))
+
+// ===== 辅助函数 =====
+
+// 向 127.0.0.1:port 发送 GET 请求并读取完整响应（对端关闭连接为止），status 返回状态码，失败时返回空串
+std::string HttpGet(uint16_t port, const std::string& path, int* status = nullptr);
+
+// 在系统临时目录下创建一个空目录，返回其路径（以 / 结尾）
+std::string MakeTempDirectory(const std::string& prefix);
+// 删除目录及其中的所有内容
+void RemoveDirectory(const std::string& path);
+
+// 每隔 10ms 检查一次 condition，直到成立或超时（超时返回 false），用于等待后台线程
+template <typename Condition>
+bool WaitUntil(Condition&& condition, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
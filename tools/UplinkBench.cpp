@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "HardwareMonitor.h"
+#include "SessionReplay.h"
+#include "SnapshotDelta.h"
+
+// 上报带宽测量工具：把一段样本流交给与 FleetUplink 相同的编码器，统计平均每秒的字节数（只计帧本身，不含 TCP/IP 头），
+// 同时给出全部用完整记录发送时的字节数作为对照。不需要汇总服务，也不需要 GPU。
+//   DeepInsightBlackwellUplinkBench               合成的 8 GPU 训练负载（不带 / 带 64 个逻辑 CPU）
+//   DeepInsightBlackwellUplinkBench <录制文件>    录制文件中的真实样本
+
+struct UplinkUsage {
+    uint64_t deltaBytes = 0;
+    uint64_t recordBytes = 0;
+    uint64_t samples = 0;
+    int64_t firstMs = 0;
+    int64_t lastMs = 0;
+};
+
+static void MeasureUplinkFrame(const SessionView& state, int64_t timestampMs, bool inventory,
+                               SnapshotDeltaEncoder& encoder, std::vector<uint8_t>& buffer, UplinkUsage& usage) {
+    if (inventory) {
+        usage.deltaBytes += encoder.EncodeInventory(state, timestampMs, buffer.data(), buffer.size());
+        usage.recordBytes += EncodeSessionRecord(SessionRecordType::Inventory, timestampMs, state,
+                                                 buffer.data(), buffer.size());
+        return;
+    }
+    usage.deltaBytes += encoder.EncodeSample(state, timestampMs, buffer.data(), buffer.size());
+    usage.recordBytes += EncodeSessionRecord(SessionRecordType::Sample, timestampMs, state,
+                                             buffer.data(), buffer.size());
+    usage.firstMs = usage.samples == 0 ? timestampMs : usage.firstMs;
+    usage.lastMs = timestampMs;
+    usage.samples++;
+}
+
+// 近似正态分布的噪声（4 个均匀分布之和），不依赖标准库分布的实现，各平台结果一致
+static float SensorNoise(std::mt19937& rng, float sigma) {
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        sum += static_cast<float>(rng()) / 4294967296.0f - 0.5f;
+    }
+    return sum * sigma * 1.7320508f;
+}
+
+// 合成的训练负载（固定种子，结果可复现）：10 Hz 采样，各类数值按 HardwareMonitor 中采集器的周期更新，
+// 以真实传感器的粒度在稳定的工作点附近带噪声：
+//   GPU（100ms）：利用率 97±2%、显存控制器负载 60±3%（NVML 为整数）、GPU 时钟 1980±15 MHz、功耗 650±10 W（整数瓦），
+//                 PCIe 接收/发送 2000±100 / 500±25 MB/s（NVML 以 KB/s 报告），温度 70°C 每 30 秒变化 1°C
+//   CPU（500ms）：每个逻辑 CPU 的利用率 40±5%；频率（1s）3000±20 MHz
+//   内存（1s）：已用内存随页缓存变化 ±50 MB
+static void MeasureSyntheticUplink(int gpuCount, int cpuCount, int seconds, UplinkUsage& usage) {
+    std::vector<GPUInfo> gpus(static_cast<size_t>(gpuCount));
+    CPUInfo cpu;
+    MemoryInfo memory;
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;
+    SessionState state{&gpus, &cpu, &memory, &bandwidth, &disks, &pressures};
+
+    for (size_t i = 0; i < gpus.size(); i++) {
+        GPUInfo& gpu = gpus[i];
+        gpu.name = "Synthetic GPU";
+        gpu.uuid = "GPU-synthetic-" + std::to_string(i);
+        gpu.available = true;
+        gpu.maxGpuClock = 2100;
+        gpu.maxMemoryClock = 4000;
+        gpu.memoryClock = 4000;
+        gpu.memoryTotal = 81559.0f;
+        gpu.memoryUsed = 65210.0f;
+        gpu.memoryPercent = gpu.memoryUsed / gpu.memoryTotal * 100.0f;
+        gpu.powerLimit = 700.0f;
+        gpu.pcieLinkWidth = 16;
+        gpu.pcieLinkSpeed = 32;
+        gpu.pcieBandwidth = 63.0f;
+    }
+    cpu.logicalCpus.resize(static_cast<size_t>(cpuCount));
+    for (size_t i = 0; i < cpu.logicalCpus.size(); i++) {
+        cpu.logicalCpus[i].id = static_cast<unsigned int>(i);
+        cpu.logicalCpus[i].core = static_cast<unsigned int>(i / 2);
+        cpu.logicalCpus[i].thread = static_cast<unsigned int>(i % 2);
+        cpu.logicalCpus[i].maxFrequency = 3800.0f;
+    }
+    cpu.coreUtilization.assign(cpu.logicalCpus.size(), 0.0f);
+    cpu.coreFrequency.assign(cpu.logicalCpus.size(), 0.0f);
+    memory.total = 1007.5f;
+    memory.used = 412.0f;
+
+    std::mt19937 rng(20261017);
+    SnapshotDeltaEncoder encoder;
+    std::vector<uint8_t> buffer(SessionRecorder::kMaxRecordBytes);
+    const int ticks = seconds * 10;
+    for (int tick = 0; tick < ticks; tick++) {
+        for (GPUInfo& gpu : gpus) {
+            gpu.utilization = std::min(100.0f, std::round(97.0f + SensorNoise(rng, 2.0f)));
+            gpu.memoryControllerLoad = std::round(60.0f + SensorNoise(rng, 3.0f));
+            gpu.gpuClock = static_cast<unsigned int>(std::lround(1980.0f + SensorNoise(rng, 15.0f)));
+            gpu.powerUsage = static_cast<unsigned int>(std::lround(650.0f + SensorNoise(rng, 10.0f)));
+            gpu.powerPercent = static_cast<float>(gpu.powerUsage) / gpu.powerLimit * 100.0f;
+            gpu.pcieRxThroughput = std::round(2000.0f * 1024.0f + SensorNoise(rng, 100.0f * 1024.0f)) / 1024.0f;
+            gpu.pcieTxThroughput = std::round(500.0f * 1024.0f + SensorNoise(rng, 25.0f * 1024.0f)) / 1024.0f;
+            gpu.temperature = 70.0f + static_cast<float>((tick / 300) % 2);
+        }
+        if (tick % 5 == 0 && !cpu.coreUtilization.empty()) {
+            float sum = 0.0f;
+            for (float& utilization : cpu.coreUtilization) {
+                utilization = std::max(0.0f, 40.0f + SensorNoise(rng, 5.0f));
+                sum += utilization;
+            }
+            cpu.utilization = sum / static_cast<float>(cpu.coreUtilization.size());
+        }
+        if (tick % 10 == 0) {
+            float sum = 0.0f;
+            for (float& frequency : cpu.coreFrequency) {
+                frequency = std::round(3000.0f + SensorNoise(rng, 20.0f));
+                sum += frequency;
+            }
+            cpu.frequency = cpu.coreFrequency.empty() ? 0.0f : sum / static_cast<float>(cpu.coreFrequency.size());
+            memory.used += SensorNoise(rng, 0.05f);
+            memory.available = memory.total - memory.used;
+            memory.percent = memory.used / memory.total * 100.0f;
+        }
+        HardwareMonitor::UpdateDerived(state);
+
+        int64_t timestampMs = static_cast<int64_t>(tick) * 100;
+        if (tick == 0) {
+            MeasureUplinkFrame(state, timestampMs, true, encoder, buffer, usage);
+        }
+        MeasureUplinkFrame(state, timestampMs, false, encoder, buffer, usage);
+    }
+}
+
+// 用录制文件中的真实样本测量
+static bool MeasureRecordedUplink(const std::string& path, UplinkUsage& usage) {
+    SessionReplay replay;
+    if (!replay.Open(path, 0.0)) {
+        return false;
+    }
+    std::vector<GPUInfo> gpus;
+    CPUInfo cpu;
+    MemoryInfo memory;
+    SystemBandwidthInfo bandwidth;
+    std::vector<DiskInfo> disks;
+    std::vector<PressureInfo> pressures;
+    SessionState state{&gpus, &cpu, &memory, &bandwidth, &disks, &pressures};
+
+    SnapshotDeltaEncoder encoder;
+    std::vector<uint8_t> buffer(SessionRecorder::kMaxRecordBytes);
+    bool hasInventory = false;
+    SessionRecordHeader header;
+    const uint8_t* payload = nullptr;
+    while (replay.Next(SessionReplay::Clock::now(), header, payload)) {
+        bool inventory = header.type == static_cast<uint32_t>(SessionRecordType::Inventory);
+        if (!DecodeSessionRecord(header, payload, state) || (!inventory && !hasInventory)) {
+            continue;
+        }
+        hasInventory = hasInventory || inventory;
+        HardwareMonitor::UpdateDerived(state);
+        MeasureUplinkFrame(state, header.timestampMs, inventory, encoder, buffer, usage);
+    }
+    return true;
+}
+
+static void PrintUplinkUsage(const char* label, const UplinkUsage& usage) {
+    // 样本之间的间隔数 + 1 个间隔，即每个样本代表一个采样周期
+    double seconds = usage.samples > 1
+        ? (usage.lastMs - usage.firstMs) / 1000.0 * usage.samples / (usage.samples - 1) : 0.0;
+    if (seconds <= 0.0) {
+        std::cout << label << ": 样本不足" << std::endl;
+        return;
+    }
+    std::cout << label << ": 差分编码 " << std::fixed << std::setprecision(0) << usage.deltaBytes / seconds
+              << " B/s，完整记录 " << usage.recordBytes / seconds << " B/s（" << usage.samples << " 个样本，"
+              << std::setprecision(1) << seconds << " 秒）" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        UplinkUsage usage;
+        if (!MeasureRecordedUplink(argv[1], usage)) {
+            std::cerr << "无法打开录制文件: " << argv[1] << std::endl;
+            return -1;
+        }
+        PrintUplinkUsage(argv[1], usage);
+        return 0;
+    }
+    constexpr int kBenchmarkSeconds = 600;
+    UplinkUsage gpuOnly;
+    MeasureSyntheticUplink(8, 0, kBenchmarkSeconds, gpuOnly);
+    PrintUplinkUsage("8 GPU", gpuOnly);
+    UplinkUsage withCpus;
+    MeasureSyntheticUplink(8, 64, kBenchmarkSeconds, withCpus);
+    PrintUplinkUsage("8 GPU + 64 逻辑 CPU", withCpus);
+    return 0;
+}